@@ -22,6 +22,8 @@
 #include <openssl/obj_mac.h>
 #include <openssl/sha.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -81,15 +83,18 @@ struct BigNumClass {
 
   std::string ToString() const {
     std::string bn_string(LENGTH_32, '\0');
-    BN_bn2binpad(bn_ptr.get(), reinterpret_cast<uint8_t *>(bn_string.data()), LENGTH_32);
+    ToBytes(reinterpret_cast<uint8_t *>(bn_string.data()));
     return bn_string;
   }
 
+  // Write the big-endian LENGTH_32 bytes of the number to out.
+  void ToBytes(uint8_t *out) const { BN_bn2binpad(bn_ptr.get(), out, LENGTH_32); }
+
   void FromString(const std::string &key_string) const {
     if (key_string.size() != LENGTH_32) {
       MS_LOG(ERROR) << "ERROR, input string length is " << key_string.size() << ", not equal to " << LENGTH_32;
     } else {
-      BN_bin2bn((const uint8_t *)key_string.data(), LENGTH_32, bn_ptr.get());
+      FromBytes(reinterpret_cast<const uint8_t *>(key_string.data()));
     }
   }
 
@@ -99,6 +104,16 @@ struct BigNumClass {
     BN_nnmod(bn_ptr.get(), bn_id.get(), p.get(), bn_ctx.get());
   }
 
+  // Read the big-endian LENGTH_32 bytes at data.
+  void FromBytes(const uint8_t *data) const { BN_bin2bn(data, LENGTH_32, bn_ptr.get()); }
+
+  void FromBytes(const uint8_t *data, const BigNumClass &p) const {
+    BigNumClass bn_id;
+    bn_id.FromBytes(data);
+    BnCtxPtr bn_ctx(BN_CTX_new());
+    BN_nnmod(bn_ptr.get(), bn_id.get(), p.get(), bn_ctx.get());
+  }
+
   BigNumPtr bn_ptr;
 };
 
@@ -138,12 +153,29 @@ struct ECPointClass {
     DecompressToPoint(compress_p_x, compress_length);
   }
 
+  ECPointClass(const ECGroupClass &ec_group, const uint8_t *compress_p_x, size_t compress_length)
+      : this_group(ec_group), point_ptr(EC_POINT_new(this_group.get())) {
+    DecompressFromBytes(compress_p_x, compress_length);
+  }
+
   // HashToCurve
   // if add_or_rehash is true, we'll use +1 method to solve the problem that is not on the curve.
   static ECPointClass GenPointFromString(const ECGroupClass &group, const std::string &id_string, bool add_or_rehash) {
+    BigNumClass bn_x(id_string, group.bn_p);
+    return GenPointFromX(group, &bn_x, add_or_rehash);
+  }
+
+  // The same as GenPointFromString, with the LENGTH_32 bytes hash at id_bytes.
+  static ECPointClass GenPointFromBytes(const ECGroupClass &group, const uint8_t *id_bytes, bool add_or_rehash) {
+    BigNumClass bn_x;
+    bn_x.FromBytes(id_bytes, group.bn_p);
+    return GenPointFromX(group, &bn_x, add_or_rehash);
+  }
+
+  static ECPointClass GenPointFromX(const ECGroupClass &group, BigNumClass *bn_x_ptr, bool add_or_rehash) {
     BnCtxPtr bn_ctx(BN_CTX_new());
     ECPointClass point(group);
-    BigNumClass bn_x(id_string, group.bn_p);
+    BigNumClass &bn_x = *bn_x_ptr;
     size_t try_times = 0;
     constexpr size_t MAX_TRY_TIMES = 1000;
     while (true) {
@@ -196,6 +228,39 @@ struct ECPointClass {
     return compress_p_a;
   }
 
+  // Write the first out_len bytes of the compressed point to out, without allocating the string.
+  void CompressToBytes(size_t compress_length, uint8_t *out, size_t out_len) {
+    uint8_t compress_p_a[LENGTH_33];
+    BnCtxPtr bn_ctx(BN_CTX_new());
+    if (compress_length == LENGTH_33) {
+      EC_POINT_point2oct(this_group.get(), point_ptr.get(), POINT_CONVERSION_COMPRESSED, compress_p_a, LENGTH_33,
+                         bn_ctx.get());
+    } else if (compress_length == LENGTH_32) {
+      BigNumClass bn_x;
+      BigNumClass bn_y;
+      EC_POINT_get_affine_coordinates(this_group.get(), point_ptr.get(), bn_x.get(), bn_y.get(), bn_ctx.get());
+      bn_x.ToBytes(compress_p_a);
+    } else {
+      MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
+      return;
+    }
+    (void)memcpy(out, compress_p_a, std::min(out_len, compress_length));
+  }
+
+  // Decompress the point from the compress_length bytes at compress_p_a.
+  void DecompressFromBytes(const uint8_t *compress_p_a, size_t compress_length) {
+    BnCtxPtr bn_ctx(BN_CTX_new());
+    if (compress_length == LENGTH_33) {
+      EC_POINT_oct2point(this_group.get(), point_ptr.get(), compress_p_a, LENGTH_33, bn_ctx.get());
+    } else if (compress_length == LENGTH_32) {
+      BigNumClass bn_x;
+      bn_x.FromBytes(compress_p_a);
+      EC_POINT_set_compressed_coordinates(this_group.get(), point_ptr.get(), bn_x.get(), 0, bn_ctx.get());
+    } else {
+      MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
+    }
+  }
+
   void DecompressToPoint(const std::string &compress_p_a, size_t compress_length) {
     if (compress_length == LENGTH_33) {
       DecompressToPointByOpenssl(compress_p_a);
@@ -18,122 +18,237 @@
 #define MINDSPORE_FEDERATED_BLOOM_FILTER_H
 
 #include <vector>
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <string>
 
+#include "armour/base_crypto/digest_set.h"
+#include "armour/base_crypto/point_buffer.h"
 #include "common/parallel_for.h"
 
 namespace mindspore {
 namespace fl {
 namespace psi {
 constexpr size_t LENGTH_8 = 8;
-
-const unsigned char TO_BINARY[LENGTH_8] = {
-  0b10000000, 0b01000000, 0b00100000, 0b00010000, 0b00001000, 0b00000100, 0b00000010, 0b00000001,
-};
+// The filter is split into blocks of one cache line, each item sets and tests bits in kBloomBlocksPerItem blocks
+// only, instead of hash_num random cache lines.
+constexpr size_t kBloomBlockBits = 512;
+constexpr size_t kBloomBlockWords = kBloomBlockBits / 64;
+constexpr size_t kBloomBlocksPerItem = 4;
+// The number of items whose blocks are prefetched ahead when inserting or looking up a range of items.
+constexpr size_t kBloomPrefetchDistance = 16;
 
 struct BloomFilter {
   // negLogfpRate = -log(fpRate), default fpRate is 2^-40
   explicit BloomFilter(const std::vector<std::string> &intup_vct, size_t thread_num, int neg_log_fp_ate)
       : BloomFilter("", intup_vct.size(), neg_log_fp_ate) {
-    time_t time_start;
-    time_t time_end;
-    time(&time_start);
-
-    std::vector<unsigned char> long_array(array_bit_length_ + LENGTH_8 - 1, 0);
-    ParallelSync parallel_sync(thread_num);
-    parallel_sync.parallel_for(0, input_num_, 1, [&](size_t beg, size_t end) {
-      for (size_t i = beg; i < end; i++) {
-        for (size_t j = 0; j < hash_num_; j++) {
-          size_t hashResult = ezHash(intup_vct[i], j);
-          long_array[hashResult] = 1;
-        }
-      }
-    });
-    time(&time_end);
-    MS_LOG(INFO) << "Hash and insert time cost: " << difftime(time_end, time_start) << " s.";
-
-    time(&time_start);
-    // compress
-    parallel_sync.parallel_for(0, long_array.size() / LENGTH_8, 1, [&](size_t beg, size_t end) {
-      for (size_t i = beg; i < end; i++) {
-        unsigned char tmp = 0;
-        for (size_t j = 0; j < LENGTH_8; j++) {
-          tmp <<= 1;
-          tmp += long_array[i * LENGTH_8 + j];
-        }
-        bit_array_[i] = tmp;
-      }
-    });
+    Insert(intup_vct, thread_num);
+  }
 
-    time(&time_end);
-    MS_LOG(INFO) << "Generate filter time cost: " << difftime(time_end, time_start)
-                 << " s. Bloom filter bit array size is: " << bitArrayByteLen() << "bytes.";
+  BloomFilter(const PointBuffer &input_buf, size_t thread_num, int neg_log_fp_ate)
+      : BloomFilter("", input_buf.size(), neg_log_fp_ate) {
+    Insert(input_buf, thread_num);
   }
 
   BloomFilter(const std::string &bit_array, size_t input_num, int neg_log_fp_rate) {
     input_num_ = input_num;
-    hash_num_ = neg_log_fp_rate;
-    bits_of_per_item_ = (size_t)(neg_log_fp_rate / M_LN2) + 1;
-    array_bit_length_ = input_num * bits_of_per_item_;
-    hash_out_of_bits_ = (size_t)log2(static_cast<double>(array_bit_length_));
-    bit_array_ = new unsigned char[bitArrayByteLen()];
+    InitSize(neg_log_fp_rate);
+    blocks_.assign(block_num_ * kBloomBlockWords, 0);
     if (!bit_array.empty()) {
-      if (bit_array.size() != bitArrayByteLen())
+      if (bit_array.size() != bitArrayByteLen()) {
         MS_LOG(ERROR) << "(BloomFilter) Received bit array size does not match the peer input number.";
-      bit_array_ = reinterpret_cast<uint8_t *>(memcpy(bit_array_, bit_array.c_str(), bit_array.size()));
+      }
+      (void)memcpy(blocks_.data(), bit_array.data(), std::min(bit_array.size(), bitArrayByteLen()));
     }
   }
 
-  ~BloomFilter() { delete[] bit_array_; }
+  ~BloomFilter() = default;
 
-  void set_empty() { bit_array_ = new unsigned char[0]; }
+  void set_empty() { std::vector<uint64_t>().swap(blocks_); }
 
-  size_t ezHash(const std::string &inputStr, size_t startPos) const {
-    size_t ret = 0;
-    size_t i = 0;
-    while (LENGTH_8 * (i + 1) <= hash_out_of_bits_) {
-      ret <<= LENGTH_8;
-      ret += (unsigned char)inputStr[(startPos + i) % inputStr.size()];
-      i++;
+  bool LookUp(const std::string &lookupStr) const {
+    if (blocks_.empty()) {
+      return false;
     }
-    size_t tmp = (unsigned char)inputStr[(startPos + i) % inputStr.size()];
-    size_t mov = hash_out_of_bits_ - LENGTH_8 * i + startPos / inputStr.size();
-    ret <<= mov;
-    ret += (tmp >> (LENGTH_8 - mov));
-    ret %= array_bit_length_;
-    return ret;
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+    HashItem(lookupStr, &h1, &h2);
+    return LookUpHash(h1, h2);
   }
 
-  bool LookUp(const std::string &lookupStr) const {
-    bool ret = true;
-    for (size_t i = 0; i < hash_num_; i++) {
-      size_t hashResult = ezHash(lookupStr, i);
-      size_t index = hashResult / LENGTH_8;
-      ret &= static_cast<bool>(bit_array_[index] & TO_BINARY[hashResult % LENGTH_8]);
+  // Look up the items in [begin, end) and set (*results)[i - begin] to 1 if items[i] may be in the filter. The items
+  // are a vector of strings or a PointBuffer.
+  template <typename Items>
+  void LookUp(const Items &items, size_t begin, size_t end, std::vector<uint8_t> *results) const {
+    results->assign(end - begin, 0);
+    if (blocks_.empty()) {
+      return;
     }
-    return ret;
+    ForEachHash(items, begin, end, [&](size_t i, uint64_t h1, uint64_t h2) {
+      (*results)[i - begin] = static_cast<uint8_t>(LookUpHash(h1, h2));
+    });
   }
 
-  size_t bitArrayByteLen() const { return (array_bit_length_ + LENGTH_8 - 1) / LENGTH_8; }
+  size_t bitArrayByteLen() const { return block_num_ * kBloomBlockBits / LENGTH_8; }
 
   std::string GetData() const {
-    std::string ret;
-    ret.reserve(bitArrayByteLen());
-    for (size_t i = 0; i < bitArrayByteLen(); i++) {
-      ret += static_cast<char>(bit_array_[i]);
+    if (blocks_.empty()) {
+      return "";
     }
-    return ret;
+    return std::string(reinterpret_cast<const char *>(blocks_.data()), bitArrayByteLen());
   }
 
   size_t input_num_;
-  uint8_t *bit_array_;
   size_t array_bit_length_;
   size_t bits_of_per_item_;
+  // The number of bits set in each block of an item.
   size_t hash_num_;
-  size_t hash_out_of_bits_;
+  size_t block_num_;
+
+ private:
+  template <typename Items>
+  void Insert(const Items &items, size_t thread_num) {
+    time_t time_start;
+    time_t time_end;
+    time(&time_start);
+
+    // The bits are set in the bit array directly, the threads inserting into the same block are serialized by the
+    // atomic or.
+    ParallelSync parallel_sync(thread_num);
+    parallel_sync.parallel_for(0, input_num_, 1, [&](size_t beg, size_t end) {
+      uint64_t mask[kBloomBlockWords];
+      ForEachHash(items, beg, end, [&](size_t, uint64_t h1, uint64_t h2) {
+        for (size_t j = 0; j < kBloomBlocksPerItem; j++) {
+          uint64_t *block = &blocks_[BlockMask(h1, h2, j, mask)];
+          for (size_t w = 0; w < kBloomBlockWords; w++) {
+            if (mask[w] != 0) {
+              (void)__atomic_fetch_or(&block[w], mask[w], __ATOMIC_RELAXED);
+            }
+          }
+        }
+      });
+    });
+    time(&time_end);
+    MS_LOG(INFO) << "Hash and insert time cost: " << difftime(time_end, time_start)
+                 << " s. Bloom filter bit array size is: " << bitArrayByteLen() << "bytes.";
+  }
+
+  // The two base hashes of the double hashing, the probes of the item are all derived from them.
+  static void HashItem(const std::string &item, uint64_t *h1, uint64_t *h2) {
+    HashDigest(Digest(item), h1, h2);
+  }
+
+  static void HashItem(const std::vector<std::string> &items, size_t i, uint64_t *h1, uint64_t *h2) {
+    HashDigest(Digest(items[i]), h1, h2);
+  }
+
+  static void HashItem(const PointBuffer &items, size_t i, uint64_t *h1, uint64_t *h2) {
+    HashDigest(Digest(items.record(i), items.record_len()), h1, h2);
+  }
+
+  static void HashDigest(uint64_t digest, uint64_t *h1, uint64_t *h2) {
+    constexpr uint64_t kSeed = 0x9e3779b97f4a7c15ULL;
+    *h1 = digest;
+    *h2 = Mix64(*h1 ^ kSeed) | 1;
+  }
+
+  // Call func(i, h1, h2) for the items in [begin, end). The blocks of the following items are prefetched while the
+  // current item is handled, to hide the cache misses.
+  template <typename Items, typename F>
+  void ForEachHash(const Items &items, size_t begin, size_t end, const F &func) const {
+    uint64_t hashes[kBloomPrefetchDistance][2];
+    auto prefetch = [&](size_t i) {
+      auto &hash = hashes[i % kBloomPrefetchDistance];
+      HashItem(items, i, &hash[0], &hash[1]);
+      for (size_t j = 0; j < kBloomBlocksPerItem; j++) {
+        __builtin_prefetch(&blocks_[BlockIndex(hash[0], hash[1], j) * kBloomBlockWords]);
+      }
+    };
+    for (size_t i = begin; i < std::min(end, begin + kBloomPrefetchDistance); i++) {
+      prefetch(i);
+    }
+    for (size_t i = begin; i < end; i++) {
+      auto &hash = hashes[i % kBloomPrefetchDistance];
+      func(i, hash[0], hash[1]);
+      if (i + kBloomPrefetchDistance < end) {
+        prefetch(i + kBloomPrefetchDistance);
+      }
+    }
+  }
+
+  size_t BlockIndex(uint64_t h1, uint64_t h2, size_t j) const {
+    uint64_t h = h1 + j * h2;
+    return static_cast<size_t>((static_cast<unsigned __int128>(h) * block_num_) >> 64);
+  }
+
+  // Build the mask of the bits the item sets in its j-th block, and return the offset of the block in blocks_.
+  size_t BlockMask(uint64_t h1, uint64_t h2, size_t j, uint64_t *mask) const {
+    uint64_t x = Mix64(h1 + j * h2 + j);
+    // The step is odd, so the hash_num_ positions are distinct modulo the block size.
+    uint64_t step = (x >> 32) | 1;
+    for (size_t w = 0; w < kBloomBlockWords; w++) {
+      mask[w] = 0;
+    }
+    for (size_t i = 0; i < hash_num_; i++) {
+      uint64_t pos = (x + i * step) & (kBloomBlockBits - 1);
+      mask[pos >> 6] |= 1ULL << (pos & 63);
+    }
+    return BlockIndex(h1, h2, j) * kBloomBlockWords;
+  }
+
+  bool LookUpHash(uint64_t h1, uint64_t h2) const {
+    uint64_t mask[kBloomBlockWords];
+    for (size_t j = 0; j < kBloomBlocksPerItem; j++) {
+      const uint64_t *block = &blocks_[BlockMask(h1, h2, j, mask)];
+      uint64_t missed = 0;
+      for (size_t w = 0; w < kBloomBlockWords; w++) {
+        missed |= mask[w] & ~block[w];
+      }
+      if (missed != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The false positive rate of the blocked filter with bits_per_item bits per item and hash_num bits per block: the
+  // number of items in a block follows the poisson distribution, and an item is positive if all its blocks are.
+  static double BlockedFpRate(size_t bits_per_item, size_t hash_num) {
+    double lambda = static_cast<double>(kBloomBlockBits * kBloomBlocksPerItem) / bits_per_item;
+    double log_unset = log1p(-1.0 / kBloomBlockBits) * hash_num;
+    double prob = exp(-lambda);
+    double block_fp = 0;
+    size_t max_load = static_cast<size_t>(lambda + 20 * sqrt(lambda)) + 64;
+    for (size_t load = 0; load <= max_load; load++) {
+      block_fp += prob * pow(1 - exp(log_unset * load), hash_num);
+      prob *= lambda / (load + 1);
+    }
+    return pow(block_fp, kBloomBlocksPerItem);
+  }
+
+  // Choose the least bits per item, and the bits set per block, which reach the false positive rate 2^-neg_log_fp_rate.
+  // Both parties compute the same size from the input number of alice.
+  void InitSize(int neg_log_fp_rate) {
+    size_t neg_log = static_cast<size_t>(std::max(neg_log_fp_rate, 1));
+    double target = pow(2.0, -static_cast<double>(neg_log));
+    bits_of_per_item_ = 0;
+    hash_num_ = 1;
+    for (size_t bits = (size_t)(neg_log / M_LN2) + 1; bits_of_per_item_ == 0; bits++) {
+      for (size_t k = 1; k <= neg_log; k++) {
+        if (BlockedFpRate(bits, k) <= target) {
+          bits_of_per_item_ = bits;
+          hash_num_ = k;
+          break;
+        }
+      }
+    }
+    block_num_ = std::max<size_t>((input_num_ * bits_of_per_item_ + kBloomBlockBits - 1) / kBloomBlockBits, 1);
+    array_bit_length_ = block_num_ * kBloomBlockBits;
+  }
+
+  std::vector<uint64_t> blocks_;
 };
 
 }  // namespace psi
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_DIGEST_SET_H
+#define MINDSPORE_FEDERATED_DIGEST_SET_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/parallel_for.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+// The finalizer of MurmurHash3, which spreads every input bit over the output.
+inline uint64_t Mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// The 64-bit digest of the item, mixing it 8 bytes at a time. It's not cryptographic, the items of PSI are already
+// hashes or points, it only needs to spread them uniformly.
+inline uint64_t Digest(const uint8_t *data, size_t size) {
+  constexpr uint64_t kSeed = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = kSeed ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    (void)memcpy(&word, data + i, sizeof(uint64_t));
+    h = Mix64(h ^ word);
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    (void)memcpy(&word, data + i, size - i);
+    h = Mix64(h ^ word);
+  }
+  return h;
+}
+
+inline uint64_t Digest(const std::string &item) {
+  return Digest(reinterpret_cast<const uint8_t *>(item.data()), item.size());
+}
+
+// DigestSet indexes a vector of strings by the 64-bit digest of each item, in an open addressing table whose load
+// factor is at most 1/2. The items are not copied: a slot keeps the digest and the index of the item, and the lookup
+// compares the item itself only when the digests are equal, so the result is exact. The duplicated items are kept in
+// different slots. The items must outlive the set.
+class DigestSet {
+ public:
+  DigestSet(const std::vector<std::string> &items, size_t thread_num) : items_(items) {
+    size_t capacity = 1;
+    while (capacity < items.size() * 2) {
+      capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    digests_.resize(capacity, 0);
+    indexes_ = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+    for (size_t i = 0; i < capacity; i++) {
+      indexes_[i].store(kEmptySlot, std::memory_order_relaxed);
+    }
+    // The threads claim the slots with compare and swap, the digest of a slot is only read after the build.
+    ParallelSync parallel_sync(thread_num);
+    parallel_sync.parallel_for(0, items.size(), 1, [&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; i++) {
+        uint64_t digest = Digest(items[i]);
+        for (size_t pos = digest & mask_;; pos = (pos + 1) & mask_) {
+          uint64_t expected = kEmptySlot;
+          if (indexes_[pos].compare_exchange_strong(expected, i, std::memory_order_relaxed)) {
+            digests_[pos] = digest;
+            break;
+          }
+        }
+      }
+    });
+  }
+  ~DigestSet() = default;
+
+  // Call func(index) for each index of the items equal to item, until func returns true.
+  template <typename F>
+  void ForEach(const std::string &item, const F &func) const {
+    uint64_t digest = Digest(item);
+    for (size_t pos = digest & mask_;; pos = (pos + 1) & mask_) {
+      uint64_t index = indexes_[pos].load(std::memory_order_relaxed);
+      if (index == kEmptySlot) {
+        return;
+      }
+      if (digests_[pos] == digest && items_[index] == item && func(static_cast<size_t>(index))) {
+        return;
+      }
+    }
+  }
+
+  bool Contains(const std::string &item) const {
+    bool found = false;
+    ForEach(item, [&found](size_t) { return found = true; });
+    return found;
+  }
+
+ private:
+  static constexpr uint64_t kEmptySlot = UINT64_MAX;
+
+  const std::vector<std::string> &items_;
+  size_t mask_ = 0;
+  std::vector<uint64_t> digests_;
+  std::unique_ptr<std::atomic<uint64_t>[]> indexes_;
+};
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
+
+#endif  // MINDSPORE_FEDERATED_DIGEST_SET_H
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <memory>
 #include <string>
 
 #include "armour/base_crypto/ecc.h"
@@ -23,73 +24,107 @@ namespace fl {
 namespace psi {
 std::vector<std::string> ECC::HashToCurveAndMul(const std::vector<std::string> &hash_inputs, size_t compress_length,
                                                 size_t compare_length) {
+  return HashToCurveAndMul(PointBuffer::FromStrings(hash_inputs, LENGTH_32), compress_length, compare_length)
+    .ToStrings();
+}
+
+std::vector<std::string> ECC::DcpsAndMul(const std::vector<std::string> &compress_vct, size_t compress_length,
+                                         size_t compare_length) {
+  return DcpsAndMul(PointBuffer::FromStrings(compress_vct, compress_length), compare_length).ToStrings();
+}
+
+std::vector<std::string> ECC::DcpsAndInverseMul(const std::vector<std::string> &compress_vct, size_t compress_length,
+                                                size_t compare_length) {
+  return DcpsAndInverseMul(PointBuffer::FromStrings(compress_vct, compress_length), compare_length).ToStrings();
+}
+
+PointBuffer ECC::HashToCurveAndMul(const PointBuffer &hash_buf, size_t compress_length, size_t compare_length) {
+  PointBuffer p_k_buf(hash_buf.size(), compare_length);
+  HashToCurveAndMul(hash_buf.data(), hash_buf.size(), compress_length, compare_length, p_k_buf.mutable_data());
+  return p_k_buf;
+}
+
+PointBuffer ECC::DcpsAndMul(const PointBuffer &compress_buf, size_t compare_length) {
+  PointBuffer p_a_b_buf(compress_buf.size(), compare_length);
+  DcpsAndMul(compress_buf.data(), compress_buf.size(), compress_buf.record_len(), compare_length,
+             p_a_b_buf.mutable_data());
+  return p_a_b_buf;
+}
+
+PointBuffer ECC::DcpsAndInverseMul(const PointBuffer &compress_buf, size_t compare_length) {
+  PointBuffer p_a_b_bI_buf(compress_buf.size(), compare_length);
+  DcpsAndInverseMul(compress_buf.data(), compress_buf.size(), compress_buf.record_len(), compare_length,
+                    p_a_b_bI_buf.mutable_data());
+  return p_a_b_bI_buf;
+}
+
+const EccEngine &ECC::GetEngine(bool inverse) {
+  auto create_engine = [this](std::unique_ptr<EccEngine> *engine, bool inverse) {
+    ECGroupClass group(nid_);
+    BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
+    if (inverse) {
+      *engine = std::make_unique<EccEngine>(nid_, bn_priv_Key.Inverse(group.bn_n));
+    } else {
+      *engine = std::make_unique<EccEngine>(nid_, bn_priv_Key);
+    }
+  };
+  if (inverse) {
+    std::call_once(inverse_engine_flag_, create_engine, &inverse_engine_, true);
+    return *inverse_engine_;
+  }
+  std::call_once(engine_flag_, create_engine, &engine_, false);
+  return *engine_;
+}
+
+void ECC::HashToCurveAndMul(const uint8_t *hash_buf, size_t num, size_t compress_length, size_t compare_length,
+                            uint8_t *out) {
   time_t time_start;
   time_t time_end;
   time(&time_start);
 
-  std::vector<std::string> p_k_vct(hash_inputs.size());
-  ECGroupClass group(nid_);
-  BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
+  const auto &engine = GetEngine(false);
   ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, hash_inputs.size(), chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      p_k_vct[i] = ECPointClass::GenPointFromString(group, hash_inputs[i], true)
-                     .BNMul(bn_priv_Key)
-                     .CompressToString(compress_length)
-                     .substr(0, compare_length);
-    }
+  parallel_sync.parallel_for(0, num, chunk_size_, [&](size_t beg, size_t end) {
+    engine.Mul(hash_buf + beg * LENGTH_32, end - beg, LENGTH_32, true, compress_length, compare_length,
+               out + beg * compare_length);
   });
 
   time(&time_end);
   MS_LOG(INFO) << "Compute p^k, time cost: " << difftime(time_end, time_start) << " s.";
-  return p_k_vct;
 }
 
-std::vector<std::string> ECC::DcpsAndMul(const std::vector<std::string> &compress_vct, size_t compress_length,
-                                         size_t compare_length) {
+void ECC::DcpsAndMul(const uint8_t *compress_buf, size_t num, size_t compress_length, size_t compare_length,
+                     uint8_t *out) {
   time_t time_start;
   time_t time_end;
   time(&time_start);
 
-  size_t input_num = compress_vct.size();
-  std::vector<std::string> p_a_b_vector(input_num);
-  ECGroupClass group(nid_);
-  BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
+  const auto &engine = GetEngine(false);
   ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, input_num, chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      ECPointClass decompress_point(group, compress_vct[i], compress_length);
-      p_a_b_vector[i] = decompress_point.BNMul(bn_priv_Key).CompressToString(compress_length).substr(0, compare_length);
-    }
+  parallel_sync.parallel_for(0, num, chunk_size_, [&](size_t beg, size_t end) {
+    engine.Mul(compress_buf + beg * compress_length, end - beg, compress_length, false, compress_length,
+               compare_length, out + beg * compare_length);
   });
 
   time(&time_end);
   MS_LOG(INFO) << "Decompress and compute p^k, time cost: " << difftime(time_end, time_start) << " s.";
-  return p_a_b_vector;
 }
 
-std::vector<std::string> ECC::DcpsAndInverseMul(const std::vector<std::string> &compress_vct, size_t compress_length,
-                                                size_t compare_length) {
+void ECC::DcpsAndInverseMul(const uint8_t *compress_buf, size_t num, size_t compress_length, size_t compare_length,
+                            uint8_t *out) {
   time_t time_start;
   time_t time_end;
   time(&time_start);
 
-  size_t input_num = compress_vct.size();
-  std::vector<std::string> p_a_b_bI_vector(input_num);
-  ECGroupClass group(nid_);
-  BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
-  BigNumClass bn_priv_Key_I = bn_priv_Key.Inverse(group.bn_n);
+  const auto &engine = GetEngine(true);
   ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, input_num, chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      ECPointClass decompress_point(group, compress_vct[i], compress_length);
-      p_a_b_bI_vector[i] = decompress_point.BNMul(bn_priv_Key_I).CompressToString(LENGTH_32).substr(0, compare_length);
-    }
+  parallel_sync.parallel_for(0, num, chunk_size_, [&](size_t beg, size_t end) {
+    engine.Mul(compress_buf + beg * compress_length, end - beg, compress_length, false, LENGTH_32, compare_length,
+               out + beg * compare_length);
   });
 
   time(&time_end);
   MS_LOG(INFO) << "Bob decompress and compute p2^b^a^(b^-1), time cost: " << difftime(time_end, time_start) << " s.";
-  return p_a_b_bI_vector;
 }
 
 }  // namespace psi
@@ -17,6 +17,8 @@
 #ifndef MINDSPORE_FEDERATED_ECC_H
 #define MINDSPORE_FEDERATED_ECC_H
 
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -24,6 +26,8 @@
 #include "openssl/rand.h"
 
 #include "armour/base_crypto/base_unit.h"
+#include "armour/base_crypto/ecc_engine.h"
+#include "armour/base_crypto/point_buffer.h"
 #include "common/parallel_for.h"
 
 namespace mindspore {
@@ -66,12 +70,38 @@ class ECC {
   std::vector<std::string> HashToCurveAndMul(const std::vector<std::string> &hash_inputs, size_t compress_length,
                                              size_t compare_length);
 
+  // The batch operations on contiguous buffers. The input is num records of compress_length bytes (LENGTH_32 bytes
+  // for the hash inputs), and the first compare_length bytes of the i-th result are written at out + i *
+  // compare_length, so out must hold num * compare_length bytes.
+  void DcpsAndInverseMul(const uint8_t *compress_buf, size_t num, size_t compress_length, size_t compare_length,
+                         uint8_t *out);
+
+  void DcpsAndMul(const uint8_t *compress_buf, size_t num, size_t compress_length, size_t compare_length,
+                  uint8_t *out);
+
+  void HashToCurveAndMul(const uint8_t *hash_buf, size_t num, size_t compress_length, size_t compare_length,
+                         uint8_t *out);
+
+  // The same as above, returning the results in a new buffer.
+  PointBuffer DcpsAndInverseMul(const PointBuffer &compress_buf, size_t compare_length);
+
+  PointBuffer DcpsAndMul(const PointBuffer &compress_buf, size_t compare_length);
+
+  PointBuffer HashToCurveAndMul(const PointBuffer &hash_buf, size_t compress_length, size_t compare_length);
+
   size_t thread_num_ = 1;
   size_t chunk_size_ = 1;
 
  private:
+  // The engines of the private key and its inverse, created on the first use.
+  const EccEngine &GetEngine(bool inverse);
+
   int nid_ = NID_sm2;
   uint8_t private_key_[LENGTH_32];
+  std::once_flag engine_flag_;
+  std::once_flag inverse_engine_flag_;
+  std::unique_ptr<EccEngine> engine_;
+  std::unique_ptr<EccEngine> inverse_engine_;
 };
 
 }  // namespace psi
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "armour/base_crypto/ecc_engine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+namespace {
+constexpr size_t kMaxHashToCurveTimes = 1000;
+}  // namespace
+
+// The BN_CTX and the points reused for all the inputs of one call of Mul.
+struct EccEngine::Workspace {
+  Workspace(const EC_GROUP *group, size_t batch_size) : bn_ctx(BN_CTX_new()), input(EC_POINT_new(group)) {
+    for (size_t i = 0; i < batch_size; i++) {
+      results.emplace_back(EC_POINT_new(group));
+      result_ptrs.emplace_back(results.back().get());
+    }
+  }
+
+  BnCtxPtr bn_ctx;
+  ECPointPtr input;
+  std::vector<ECPointPtr> results;
+  std::vector<EC_POINT *> result_ptrs;
+};
+
+EccEngine::EccEngine(int nid, const BigNumClass &scalar) : group_(nid) { BN_copy(scalar_.get(), scalar.get()); }
+
+void EccEngine::Mul(const uint8_t *in, size_t num, size_t in_len, bool hash_input, size_t compress_length,
+                    size_t out_len, uint8_t *out) const {
+  if (group_.get() == nullptr) {
+    (void)memset(out, 0, num * out_len);
+    return;
+  }
+  const EC_GROUP *group = group_.get();
+  Workspace ws(group, std::min(kEccBatchSize, num));
+  BN_CTX *bn_ctx = ws.bn_ctx.get();
+  for (size_t batch_begin = 0; batch_begin < num; batch_begin += kEccBatchSize) {
+    size_t batch_num = std::min(kEccBatchSize, num - batch_begin);
+    for (size_t i = 0; i < batch_num; i++) {
+      const uint8_t *input = in + (batch_begin + i) * in_len;
+      EC_POINT *result = ws.results[i].get();
+      bool loaded = hash_input ? HashToCurve(input, ws.input.get(), bn_ctx)
+                               : Decompress(input, in_len, ws.input.get(), bn_ctx);
+      if (!loaded) {
+        EC_POINT_set_to_infinity(group, result);
+      } else {
+        EC_POINT_mul(group, result, nullptr, ws.input.get(), scalar_.get(), bn_ctx);
+      }
+    }
+    // The points are affine afterwards, so compressing them needs no more inversion.
+    EC_POINTs_make_affine(group, batch_num, ws.result_ptrs.data(), bn_ctx);
+    for (size_t i = 0; i < batch_num; i++) {
+      Compress(ws.results[i].get(), compress_length, out_len, out + (batch_begin + i) * out_len, bn_ctx);
+    }
+  }
+}
+
+// The same as ECPointClass::GenPointFromBytes with add_or_rehash, without allocating per try.
+bool EccEngine::HashToCurve(const uint8_t *hash, EC_POINT *point, BN_CTX *bn_ctx) const {
+  BN_CTX_start(bn_ctx);
+  BIGNUM *bn_x = BN_CTX_get(bn_ctx);
+  bool found = false;
+  if (bn_x != nullptr && BN_bin2bn(hash, LENGTH_32, bn_x) != nullptr &&
+      BN_nnmod(bn_x, bn_x, group_.bn_p.get(), bn_ctx) == 1) {
+    for (size_t try_times = 0; try_times <= kMaxHashToCurveTimes; try_times++) {
+      if (EC_POINT_set_compressed_coordinates(group_.get(), point, bn_x, 0, bn_ctx) == 1) {
+        found = true;
+        break;
+      }
+      BN_add_word(bn_x, 1);
+      BN_mod(bn_x, bn_x, group_.bn_p.get(), bn_ctx);
+    }
+  }
+  BN_CTX_end(bn_ctx);
+  if (!found) {
+    MS_LOG(ERROR) << "Try times >= MAX_TRY_TIMES, Hash_To_Curve Failed.";
+  }
+  return found;
+}
+
+bool EccEngine::Decompress(const uint8_t *compress_p, size_t compress_length, EC_POINT *point, BN_CTX *bn_ctx) const {
+  if (compress_length == LENGTH_33) {
+    return EC_POINT_oct2point(group_.get(), point, compress_p, LENGTH_33, bn_ctx) == 1;
+  }
+  if (compress_length != LENGTH_32) {
+    MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
+    return false;
+  }
+  BN_CTX_start(bn_ctx);
+  BIGNUM *bn_x = BN_CTX_get(bn_ctx);
+  bool ret = bn_x != nullptr && BN_bin2bn(compress_p, LENGTH_32, bn_x) != nullptr &&
+             EC_POINT_set_compressed_coordinates(group_.get(), point, bn_x, 0, bn_ctx) == 1;
+  BN_CTX_end(bn_ctx);
+  return ret;
+}
+
+void EccEngine::Compress(const EC_POINT *point, size_t compress_length, size_t out_len, uint8_t *out,
+                         BN_CTX *bn_ctx) const {
+  uint8_t compress_p[LENGTH_33] = {0};
+  if (EC_POINT_is_at_infinity(group_.get(), point) == 1) {
+    // Compressing the point at infinity gives zeros, as ECPointClass::CompressToString.
+  } else if (compress_length == LENGTH_33) {
+    EC_POINT_point2oct(group_.get(), point, POINT_CONVERSION_COMPRESSED, compress_p, LENGTH_33, bn_ctx);
+  } else if (compress_length == LENGTH_32) {
+    BN_CTX_start(bn_ctx);
+    BIGNUM *bn_x = BN_CTX_get(bn_ctx);
+    BIGNUM *bn_y = BN_CTX_get(bn_ctx);
+    if (bn_y != nullptr && EC_POINT_get_affine_coordinates(group_.get(), point, bn_x, bn_y, bn_ctx) == 1) {
+      BN_bn2binpad(bn_x, compress_p, LENGTH_32);
+    }
+    BN_CTX_end(bn_ctx);
+  } else {
+    MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
+  }
+  (void)memcpy(out, compress_p, std::min(out_len, compress_length));
+  if (out_len > compress_length) {
+    (void)memset(out + compress_length, 0, out_len - compress_length);
+  }
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,62 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_ECC_ENGINE_H
+#define MINDSPORE_FEDERATED_ECC_ENGINE_H
+
+#include "armour/base_crypto/base_unit.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+// The number of points normalized to affine together, sharing one field inversion.
+constexpr size_t kEccBatchSize = 256;
+
+// EccEngine multiplies many points by one fixed secret scalar, as all the ECDH PSI phases do.
+// - The scalar multiplication is EC_POINT_mul, whose ladder is constant time for the generic curves, so the secret key
+//   is not leaked by the timing or the cache accesses.
+// - The results are normalized to affine coordinates kEccBatchSize at a time, with the Montgomery's trick in
+//   EC_POINTs_make_affine, instead of one field inversion per point when compressing.
+// - The BN_CTX and the EC_POINTs are created once per call of Mul, which runs in one thread, instead of per point.
+// The engine is immutable after construction, so it's shared by the threads.
+class EccEngine {
+ public:
+  EccEngine(int nid, const BigNumClass &scalar);
+  ~EccEngine() = default;
+
+  // Multiply the num inputs at in, in_len bytes each, by the scalar, and write the first out_len bytes of each result
+  // compressed with compress_length to out. The inputs are LENGTH_32 bytes hashes mapped to the curve if hash_input
+  // is true, or else the compressed points. An invalid input results in zeros, as the point at infinity.
+  void Mul(const uint8_t *in, size_t num, size_t in_len, bool hash_input, size_t compress_length, size_t out_len,
+           uint8_t *out) const;
+
+  const ECGroupClass &group() const { return group_; }
+
+ private:
+  struct Workspace;
+
+  bool HashToCurve(const uint8_t *hash, EC_POINT *point, BN_CTX *bn_ctx) const;
+  bool Decompress(const uint8_t *compress_p, size_t compress_length, EC_POINT *point, BN_CTX *bn_ctx) const;
+  void Compress(const EC_POINT *point, size_t compress_length, size_t out_len, uint8_t *out, BN_CTX *bn_ctx) const;
+
+  ECGroupClass group_;
+  BigNumClass scalar_;
+};
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
+
+#endif  // MINDSPORE_FEDERATED_ECC_ENGINE_H
@@ -50,6 +50,30 @@ std::vector<std::string> HashInputs(const std::vector<std::string> *items, size_
   return ret;
 }
 
+PointBuffer HashInputsToBuffer(const std::vector<std::string> *items, size_t thread_num, size_t chunk_size) {
+  if (items == nullptr) {
+    MS_LOG(ERROR) << "input items is null, please check input vector!";
+    return PointBuffer();
+  }
+  time_t time_start;
+  time_t time_end;
+  time(&time_start);
+  PointBuffer ret(items->size(), LENGTH_32);
+
+  ParallelSync parallel_sync(thread_num);
+  parallel_sync.parallel_for(0, ret.size(), chunk_size, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      const auto &item = items->at(i);
+      SHA256(reinterpret_cast<const uint8_t *>(item.data()), item.size(), ret.mutable_record(i));
+    }
+  });
+
+  time(&time_end);
+  MS_LOG(INFO) << "Thread num is " << parallel_sync.get_thread_num() << ", Task num is " << parallel_sync.get_task_num()
+               << ", HashInputs time cost: " << difftime(time_end, time_start) << " s.";
+  return ret;
+}
+
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
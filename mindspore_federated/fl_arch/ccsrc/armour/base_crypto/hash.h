@@ -24,6 +24,7 @@
 
 #include "common/parallel_for.h"
 #include "armour/base_crypto/base_unit.h"
+#include "armour/base_crypto/point_buffer.h"
 
 namespace mindspore {
 namespace fl {
@@ -33,6 +34,9 @@ std::string HashInput(const std::string &item);
 
 std::vector<std::string> HashInputs(const std::vector<std::string> *items, size_t thread_num, size_t chunk_size);
 
+// The same as above, with the hashes of LENGTH_32 bytes packed in one buffer.
+PointBuffer HashInputsToBuffer(const std::vector<std::string> *items, size_t thread_num, size_t chunk_size);
+
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_POINT_BUFFER_H
+#define MINDSPORE_FEDERATED_POINT_BUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+// PointBuffer keeps fixed-width records, such as the hashes and the compressed points of PSI, back to back in one
+// buffer, so a batch of n points costs one allocation instead of n strings. The bytes are kept in a string to be moved
+// into and out of the bytes field of the protos.
+class PointBuffer {
+ public:
+  PointBuffer() = default;
+  PointBuffer(size_t num, size_t record_len) : record_len_(record_len), data_(num * record_len, '\0') {}
+  PointBuffer(std::string data, size_t record_len) : record_len_(record_len), data_(std::move(data)) {
+    if (record_len_ == 0 || data_.size() % record_len_ != 0) {
+      MS_LOG(ERROR) << "The buffer size " << data_.size() << " is not a multiple of the record length " << record_len_;
+      data_.resize(record_len_ == 0 ? 0 : data_.size() / record_len_ * record_len_);
+    }
+  }
+  ~PointBuffer() = default;
+
+  // The records shorter than record_len are padded with zero, the longer ones are truncated.
+  static PointBuffer FromStrings(const std::vector<std::string> &items, size_t record_len) {
+    PointBuffer buffer(items.size(), record_len);
+    for (size_t i = 0; i < items.size(); i++) {
+      if (items[i].size() != record_len) {
+        MS_LOG(ERROR) << "The length of item " << i << " is " << items[i].size() << ", not equal to " << record_len;
+      }
+      (void)memcpy(buffer.mutable_record(i), items[i].data(), std::min(items[i].size(), record_len));
+    }
+    return buffer;
+  }
+
+  std::vector<std::string> ToStrings() const {
+    std::vector<std::string> items(size());
+    for (size_t i = 0; i < items.size(); i++) {
+      items[i] = Get(i);
+    }
+    return items;
+  }
+
+  size_t size() const { return record_len_ == 0 ? 0 : data_.size() / record_len_; }
+  bool empty() const { return data_.empty(); }
+  size_t record_len() const { return record_len_; }
+
+  const uint8_t *data() const { return reinterpret_cast<const uint8_t *>(data_.data()); }
+  uint8_t *mutable_data() { return reinterpret_cast<uint8_t *>(&data_[0]); }
+  const uint8_t *record(size_t i) const { return data() + i * record_len_; }
+  uint8_t *mutable_record(size_t i) { return mutable_data() + i * record_len_; }
+  std::string Get(size_t i) const { return data_.substr(i * record_len_, record_len_); }
+
+  const std::string &bytes() const { return data_; }
+
+  void Reserve(size_t num) { data_.reserve(num * record_len_); }
+
+  // Append the records packed with the same record length.
+  void Append(const std::string &records) {
+    if (record_len_ == 0 || records.size() % record_len_ != 0) {
+      MS_LOG(ERROR) << "The appended size " << records.size() << " is not a multiple of the record length "
+                    << record_len_;
+      return;
+    }
+    data_.append(records);
+  }
+
+  void set_empty() { std::string().swap(data_); }
+
+ private:
+  size_t record_len_ = 0;
+  std::string data_;
+};
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
+
+#endif  // MINDSPORE_FEDERATED_POINT_BUFFER_H
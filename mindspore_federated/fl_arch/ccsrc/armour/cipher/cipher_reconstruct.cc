@@ -20,27 +20,80 @@
 #include "armour/secure_protocol/key_agreement.h"
 #include "armour/cipher/cipher_meta_storage.h"
 #include "distributed_cache/client_infos.h"
+#include "common/parallel_for.h"
 
 namespace mindspore {
 namespace fl {
 namespace armour {
-bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
-                                    std::map<std::string, std::vector<float>> *client_noise,
+bool CipherReconStruct::CombineMask(std::map<std::string, std::vector<float>> *client_noise,
                                     const std::vector<std::string> &clients_share_list,
                                     const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
                                     const std::map<std::string, std::vector<clientshare_str>> &reconstruct_secret_list,
                                     const std::vector<std::string> &client_list,
                                     const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs) {
-  bool retcode = true;
-  if (shares_tmp == nullptr) {
-    MS_LOG(ERROR) << "shares_tmp is nullptr.";
-    return false;
-  }
   if (client_noise == nullptr) {
     MS_LOG(ERROR) << "client_noise is nullptr.";
     return false;
   }
   for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end(); ++iter) {
+    if (iter->second.size() < cipher_init_->secrets_minnums_) {
+      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << iter->first
+                    << " is not enough";
+      MS_LOG(ERROR) << "get " << iter->second.size()
+                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
+      return false;
+    }
+  }
+  // Combine the secrets of all the clients in one batch, so that the lagrange coefficients are computed once for the
+  // clients sharing the same share indexes.
+  bool retcode = true;
+  std::vector<std::vector<Share *>> shares_list(reconstruct_secret_list.size());
+  size_t client_index = 0;
+  MS_LOG(INFO) << "start assign secrets shares to public shares ";
+  for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end(); ++iter, ++client_index) {
+    auto &shares = shares_list[client_index];
+    if (!MallocShares(&shares, cipher_init_->secrets_minnums_)) {
+      MS_LOG(ERROR) << "Reconstruct malloc shares invalid.";
+      retcode = false;
+      break;
+    }
+    for (size_t i = 0; i < cipher_init_->secrets_minnums_; ++i) {
+      shares[i]->index = (iter->second)[i].index;
+      shares[i]->len = (iter->second)[i].share.size();
+      if (memcpy_s(shares[i]->data, IntToSize(SHARE_MAX_SIZE), (iter->second)[i].share.data(), shares[i]->len) != 0) {
+        MS_LOG(ERROR) << "shares copy failed";
+        retcode = false;
+      }
+    }
+  }
+  MS_LOG(INFO) << "end assign secrets shares to public shares ";
+
+  std::vector<std::vector<uint8_t>> secrets;
+  if (retcode) {
+    BIGNUM *prime = BN_new();
+    if (prime == nullptr) {
+      retcode = false;
+    } else {
+      auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
+      (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
+      SecretSharing combine(prime);
+      if (combine.CombineBatch(cipher_init_->secrets_minnums_, shares_list, &secrets) < 0) {
+        MS_LOG(ERROR) << "combine secrets shares failed.";
+        retcode = false;
+      }
+      BN_clear_free(prime);
+    }
+  }
+  for (auto &shares : shares_list) {
+    DeleteShares(&shares);
+  }
+  if (!retcode) {
+    return false;
+  }
+  MS_LOG(INFO) << "combine secrets shares Success.";
+
+  client_index = 0;
+  for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end(); ++iter, ++client_index) {
     // define flag_share: judge we need b or s
     bool flag_share = true;
     const std::string fl_id = iter->first;
@@ -49,76 +102,49 @@ bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
       flag_share = false;
     }
     MS_LOG(INFO) << "fl_id_src : " << fl_id;
-    BIGNUM *prime = BN_new();
-    if (prime == nullptr) {
-      return false;
+    size_t length = SECRET_MAX_LEN;
+    uint8_t secret[SECRET_MAX_LEN] = {0};
+    auto &combined = secrets[client_index];
+    if (!combined.empty() && memcpy_s(secret, SECRET_MAX_LEN, combined.data(), combined.size()) != 0) {
+      MS_LOG(ERROR) << "secret copy failed";
+      retcode = false;
+    }
+    if (memset_s(combined.data(), combined.size(), 0, combined.size()) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
     }
-    auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
-    (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
-    if (iter->second.size() >= cipher_init_->secrets_minnums_) {  // combine private key seed.
-      MS_LOG(INFO) << "start assign secrets shares to public shares ";
-      for (int i = 0; i < static_cast<int>(cipher_init_->secrets_minnums_); ++i) {
-        shares_tmp->at(i)->index = (iter->second)[i].index;
-        shares_tmp->at(i)->len = (iter->second)[i].share.size();
-        if (memcpy_s(shares_tmp->at(i)->data, IntToSize(SHARE_MAX_SIZE), (iter->second)[i].share.data(),
-                     shares_tmp->at(i)->len) != 0) {
-          MS_LOG(ERROR) << "shares_tmp copy failed";
-          retcode = false;
-        }
-      }
-      MS_LOG(INFO) << "end assign secrets shares to public shares ";
-
-      size_t length;
-      uint8_t secret[SECRET_MAX_LEN] = {0};
-      SecretSharing combine(prime);
-      if (combine.Combine(cipher_init_->secrets_minnums_, *shares_tmp, secret, &length) < 0) retcode = false;
-      length = SECRET_MAX_LEN;
-      MS_LOG(INFO) << "combine secrets shares Success.";
 
-      if (flag_share) {
-        // reconstruct pairwise noise
-        MS_LOG(INFO) << "start reconstruct pairwise noise.";
-        std::vector<float> noise(cipher_init_->featuremap_, 0.0);
-        if (GetSuvNoise(clients_share_list, record_public_keys, client_ivs, fl_id, &noise, secret, length) == false) {
-          MS_LOG(ERROR) << "GetSuvNoise failed";
-          BN_clear_free(prime);
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          return false;
+    std::vector<float> noise;
+    if (flag_share) {
+      // reconstruct pairwise noise
+      MS_LOG(INFO) << "start reconstruct pairwise noise.";
+      noise.resize(cipher_init_->featuremap_, 0.0);
+      if (GetSuvNoise(clients_share_list, record_public_keys, client_ivs, fl_id, &noise, secret, length) == false) {
+        MS_LOG(ERROR) << "GetSuvNoise failed";
+        if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
+          MS_LOG(EXCEPTION) << "Memset failed.";
         }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
-      } else {
-        // reconstruct individual noise
-        MS_LOG(INFO) << "start reconstruct individual noise.";
-        std::vector<float> noise;
-
-        std::vector<uint8_t> ind_iv = GetIndiIV(fl_id, client_ivs);
+        return false;
+      }
+    } else {
+      // reconstruct individual noise
+      MS_LOG(INFO) << "start reconstruct individual noise.";
+      std::vector<uint8_t> ind_iv = GetIndiIV(fl_id, client_ivs);
 
-        if (Masking::GetMasking(&noise, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret, SECRET_MAX_LEN,
-                                ind_iv.data(), SizeToInt(ind_iv.size())) < 0) {
-          MS_LOG(ERROR) << "Get Masking failed";
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          BN_clear_free(prime);
-          return false;
-        }
-        for (size_t index_noise = 0; index_noise < cipher_init_->featuremap_; index_noise++) {
-          noise[index_noise] *= -1;
+      if (Masking::GetMasking(&noise, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret, SECRET_MAX_LEN,
+                              ind_iv.data(), SizeToInt(ind_iv.size())) < 0) {
+        MS_LOG(ERROR) << "Get Masking failed";
+        if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
+          MS_LOG(EXCEPTION) << "Memset failed.";
         }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
+        return false;
       }
-      BN_clear_free(prime);
-      if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-        MS_LOG(EXCEPTION) << "Memset failed.";
+      for (size_t index_noise = 0; index_noise < cipher_init_->featuremap_; index_noise++) {
+        noise[index_noise] *= -1;
       }
-    } else {
-      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << fl_id
-                    << " is not enough";
-      MS_LOG(ERROR) << "get " << iter->second.size()
-                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
-      return false;
+    }
+    (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
+    if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
     }
   }
   return retcode;
@@ -174,18 +200,10 @@ bool CipherReconStruct::ReconstructSecretsGenNoise(const std::vector<std::string
     MS_LOG(INFO) << "fl_id: " << iter->first;
     MS_LOG(INFO) << "share size: " << iter->second.size();
   }
-  std::vector<Share *> shares_tmp;
-  if (!MallocShares(&shares_tmp, (SizeToInt)(cipher_init_->secrets_minnums_))) {
-    MS_LOG(ERROR) << "Reconstruct malloc shares_tmp invalid.";
-    DeleteShares(&shares_tmp);
-    return false;
-  }
-
   MS_LOG(INFO) << "Reconstruct secrets shares: ";
   std::map<std::string, std::vector<float>> client_noise;
-  retcode = CombineMask(&shares_tmp, &client_noise, clients_share_list, record_public_keys, reconstruct_secret_list,
-                        client_list, client_ivs);
-  DeleteShares(&shares_tmp);
+  retcode =
+    CombineMask(&client_noise, clients_share_list, record_public_keys, reconstruct_secret_list, client_list, client_ivs);
   if (retcode) {
     std::vector<float> noise;
     if (!GetNoiseMasksSum(&noise, client_noise)) {
@@ -320,68 +338,98 @@ bool CipherReconStruct::GetSuvNoise(const std::vector<std::string> &clients_shar
                                     const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs,
                                     const std::string &fl_id, std::vector<float> *noise, const uint8_t *secret,
                                     size_t length) {
-  for (auto p_key = clients_share_list.begin(); p_key != clients_share_list.end(); ++p_key) {
-    if (*p_key != fl_id) {
-      PrivateKey *privKey = KeyAgreement::FromPrivateBytes(secret, length);
-      if (privKey == NULL) {
-        MS_LOG(ERROR) << "create privKey failed\n";
-        return false;
-      }
-      std::vector<uint8_t> public_key = record_public_keys.at(*p_key)[1];
-      std::string iv_fl_id;
-      if (fl_id < *p_key) {
-        iv_fl_id = fl_id;
-      } else {
-        iv_fl_id = *p_key;
-      }
-      auto iter = client_ivs.find(iv_fl_id);
-      if (iter == client_ivs.end()) {
-        MS_LOG(ERROR) << "cannot get ivs for client: " << iv_fl_id;
-        delete privKey;
-        return false;
-      }
-      if (iter->second.size() != IV_NUM) {
-        MS_LOG(ERROR) << "get " << iter->second.size() << " ivs, the iv num required is: " << IV_NUM;
-        return false;
-      }
-      std::vector<uint8_t> pw_iv = iter->second[PW_IV_INDEX];
-      std::vector<uint8_t> pw_salt = iter->second[PW_SALT_INDEX];
-      PublicKey *pubKey = KeyAgreement::FromPublicBytes(public_key.data(), public_key.size());
-      if (pubKey == NULL) {
-        MS_LOG(ERROR) << "create pubKey failed\n";
-        return false;
+  MS_ERROR_IF_NULL_W_RET_VAL(noise, false);
+  // The pairwise mask of each peer: the shared key, the iv and the sign.
+  struct PeerMask {
+    std::string peer_id;
+    uint8_t secret[SECRET_MAX_LEN] = {0};
+    std::vector<uint8_t> iv;
+    float sign = 1.0f;
+  };
+  std::vector<PeerMask> peer_masks;
+  for (const auto &peer_id : clients_share_list) {
+    if (peer_id == fl_id) {
+      continue;
+    }
+    PeerMask peer_mask;
+    peer_mask.peer_id = peer_id;
+    peer_mask.sign = GetSymbol(fl_id, peer_id) ? 1.0f : -1.0f;
+    peer_masks.emplace_back(std::move(peer_mask));
+  }
+  // Compute the shared keys of the peers in parallel.
+  std::atomic<bool> key_failed = false;
+  ParallelSync parallel_sync(0);
+  parallel_sync.parallel_for(0, peer_masks.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end && !key_failed; i++) {
+      if (!GetPeerSharedKey(record_public_keys, client_ivs, fl_id, peer_masks[i].peer_id, secret, length,
+                            peer_masks[i].secret, &peer_masks[i].iv)) {
+        key_failed = true;
       }
-      MS_LOG(INFO) << "private_key fl_id : " << fl_id << " public_key fl_id : " << *p_key;
-      uint8_t secret1[SECRET_MAX_LEN] = {0};
-      int ret = KeyAgreement::ComputeSharedKey(privKey, pubKey, SECRET_MAX_LEN, pw_salt.data(),
-                                               SizeToInt(pw_salt.size()), secret1);
-      delete privKey;
-      delete pubKey;
-      if (ret < 0) {
-        MS_LOG(ERROR) << "ComputeSharedKey failed\n";
-        return false;
+    }
+  });
+  if (key_failed) {
+    return false;
+  }
+  // Regenerate the masks chunk by chunk in parallel, and accumulate them into noise directly. Each element adds the
+  // peers in the same order, so the noise is the same as adding the masks one by one.
+  std::atomic<bool> mask_failed = false;
+  parallel_sync.parallel_for(0, noise->size(), kMaskingGrainSize, [&](size_t begin, size_t end) {
+    for (const auto &peer_mask : peer_masks) {
+      if (mask_failed) {
+        return;
       }
-
-      std::vector<float> noise_tmp;
-      if (Masking::GetMasking(&noise_tmp, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret1,
-                              SECRET_MAX_LEN, pw_iv.data(), pw_iv.size()) < 0) {
+      if (Masking::AddMasking(noise->data(), begin, end, peer_mask.sign, peer_mask.secret, SECRET_MAX_LEN,
+                              peer_mask.iv.data(), SizeToInt(peer_mask.iv.size())) < 0) {
         MS_LOG(ERROR) << "Get Masking failed\n";
-        return false;
-      }
-      bool symbol_noise = GetSymbol(fl_id, *p_key);
-      size_t index = 0;
-      size_t size_noise = noise_tmp.size();
-      if (symbol_noise == false) {
-        for (; index < size_noise; ++index) {
-          noise_tmp[index] = noise_tmp[index] * -1;
-          noise->at(index) += noise_tmp[index];
-        }
-      } else {
-        for (; index < size_noise; ++index) {
-          noise->at(index) += noise_tmp[index];
-        }
+        mask_failed = true;
       }
     }
+  });
+  for (auto &peer_mask : peer_masks) {
+    (void)memset_s(peer_mask.secret, SECRET_MAX_LEN, 0, SECRET_MAX_LEN);
+  }
+  return !mask_failed;
+}
+
+bool CipherReconStruct::GetPeerSharedKey(
+  const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
+  const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs, const std::string &fl_id,
+  const std::string &peer_id, const uint8_t *secret, size_t length, uint8_t *shared_key,
+  std::vector<uint8_t> *pw_iv) const {
+  auto key_iter = record_public_keys.find(peer_id);
+  if (key_iter == record_public_keys.end() || key_iter->second.size() <= 1) {
+    MS_LOG(ERROR) << "cannot get public key for client: " << peer_id;
+    return false;
+  }
+  const std::vector<uint8_t> &public_key = key_iter->second[1];
+  const std::string &iv_fl_id = fl_id < peer_id ? fl_id : peer_id;
+  auto iter = client_ivs.find(iv_fl_id);
+  if (iter == client_ivs.end()) {
+    MS_LOG(ERROR) << "cannot get ivs for client: " << iv_fl_id;
+    return false;
+  }
+  if (iter->second.size() != IV_NUM) {
+    MS_LOG(ERROR) << "get " << iter->second.size() << " ivs, the iv num required is: " << IV_NUM;
+    return false;
+  }
+  *pw_iv = iter->second[PW_IV_INDEX];
+  const std::vector<uint8_t> &pw_salt = iter->second[PW_SALT_INDEX];
+  std::unique_ptr<PrivateKey> privKey(KeyAgreement::FromPrivateBytes(secret, length));
+  if (privKey == nullptr) {
+    MS_LOG(ERROR) << "create privKey failed\n";
+    return false;
+  }
+  std::unique_ptr<PublicKey> pubKey(KeyAgreement::FromPublicBytes(public_key.data(), public_key.size()));
+  if (pubKey == nullptr) {
+    MS_LOG(ERROR) << "create pubKey failed\n";
+    return false;
+  }
+  MS_LOG(INFO) << "private_key fl_id : " << fl_id << " public_key fl_id : " << peer_id;
+  int ret = KeyAgreement::ComputeSharedKey(privKey.get(), pubKey.get(), SECRET_MAX_LEN, pw_salt.data(),
+                                           SizeToInt(pw_salt.size()), shared_key);
+  if (ret < 0) {
+    MS_LOG(ERROR) << "ComputeSharedKey failed\n";
+    return false;
   }
   return true;
 }
@@ -28,6 +28,8 @@
 #include "armour/cipher/cipher_meta_storage.h"
 
 #define IV_NUM 3
+// The number of the noise elements regenerated by one task at least.
+constexpr size_t kMaskingGrainSize = 16384;
 
 namespace mindspore {
 namespace fl {
@@ -65,6 +67,11 @@ class CipherReconStruct {
                    const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
                    const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs, const std::string &fl_id,
                    std::vector<float> *noise, const uint8_t *secret, size_t length);
+  // compute the pairwise shared key between fl_id and peer_id, and get the iv of the pairwise mask.
+  bool GetPeerSharedKey(const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
+                        const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs,
+                        const std::string &fl_id, const std::string &peer_id, const uint8_t *secret, size_t length,
+                        uint8_t *shared_key, std::vector<uint8_t> *pw_iv) const;
   // malloc shares.
   bool MallocShares(std::vector<Share *> *shares_tmp, size_t shares_size);
   // delete shares.
@@ -76,7 +83,7 @@ class CipherReconStruct {
   bool GetNoiseMasksSum(std::vector<float> *result, const std::map<std::string, std::vector<float>> &client_noise);
 
   // combine noise mask.
-  bool CombineMask(std::vector<Share *> *shares_tmp, std::map<std::string, std::vector<float>> *client_noise,
+  bool CombineMask(std::map<std::string, std::vector<float>> *client_noise,
                    const std::vector<std::string> &clients_share_list,
                    const std::map<std::string, std::vector<std::vector<unsigned char>>> &record_public_keys,
                    const std::map<std::string, std::vector<clientshare_str>> &reconstruct_secret_list,
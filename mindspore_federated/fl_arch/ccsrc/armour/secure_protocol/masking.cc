@@ -15,6 +15,9 @@
  */
 
 #include "armour/secure_protocol/masking.h"
+#include <algorithm>
+#include <cstring>
+#include "common/utils/convert_utils_base.h"
 
 namespace mindspore {
 namespace fl {
@@ -49,6 +52,69 @@ int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t
   }
   return 0;
 }
+
+namespace {
+constexpr size_t kAesBlockSize = 16;
+// The bytes of the key stream generated by one AES-CTR call.
+constexpr size_t kMaskingBatchBytes = 64 * 1024;
+
+// Add block_num to the 128 bits big-endian counter, the same as the counter increment of AES-CTR.
+void AddCounter(uint8_t *counter, uint64_t block_num) {
+  for (int i = AES_IV_SIZE - 1; i >= 0 && block_num > 0; i--) {
+    uint64_t sum = static_cast<uint64_t>(counter[i]) + (block_num & 0xff);
+    counter[i] = static_cast<uint8_t>(sum);
+    block_num = (block_num >> 8) + (sum >> 8);
+  }
+}
+}  // namespace
+
+int Masking::AddMasking(float *noise, size_t begin, size_t end, float sign, const uint8_t *secret, int secret_len,
+                        const uint8_t *ivec, int ivec_size) {
+  if ((secret_len != KEY_LENGTH_16 && secret_len != KEY_LENGTH_32) || secret == NULL) {
+    MS_LOG(ERROR) << "secret is invalid!";
+    return -1;
+  }
+  if (noise == NULL || begin > end) {
+    MS_LOG(ERROR) << "noise is invalid!";
+    return -1;
+  }
+  if (ivec == NULL || ivec_size != AES_IV_SIZE) {
+    MS_LOG(ERROR) << "ivec is invalid!";
+    return -1;
+  }
+  thread_local std::vector<uint8_t> data(kMaskingBatchBytes + kAesBlockSize, 0);
+  thread_local std::vector<uint8_t> encrypt_data(kMaskingBatchBytes + kAesBlockSize, 0);
+  size_t byte_begin = begin * sizeof(int32_t);
+  size_t byte_end = end * sizeof(int32_t);
+  // Generate from the block containing begin, and skip the bytes before it.
+  size_t block_begin = byte_begin / kAesBlockSize * kAesBlockSize;
+  uint8_t counter[AES_IV_SIZE];
+  if (memcpy_s(counter, AES_IV_SIZE, ivec, AES_IV_SIZE) != 0) {
+    MS_LOG(ERROR) << "Memcpy failed.";
+    return -1;
+  }
+  AddCounter(counter, block_begin / kAesBlockSize);
+  size_t index = begin;
+  for (size_t offset = block_begin; offset < byte_end; offset += kMaskingBatchBytes) {
+    size_t batch_bytes = std::min(kMaskingBatchBytes, byte_end - offset);
+    // Round up to whole blocks, so the counter of the next batch is continuous.
+    size_t encrypt_bytes = (batch_bytes + kAesBlockSize - 1) / kAesBlockSize * kAesBlockSize;
+    int encrypt_len = 0;
+    AESEncrypt encrypt(secret, secret_len, counter, AES_IV_SIZE, AES_CTR);
+    if (encrypt.EncryptData(data.data(), SizeToInt(encrypt_bytes), encrypt_data.data(), &encrypt_len) != 0) {
+      MS_LOG(ERROR) << "call AES-CTR failed!";
+      return -1;
+    }
+    AddCounter(counter, encrypt_bytes / kAesBlockSize);
+    size_t batch_end = std::min(end, (offset + batch_bytes) / sizeof(int32_t));
+    for (; index < batch_end; index++) {
+      int32_t value;
+      (void)memcpy(&value, encrypt_data.data() + (index * sizeof(int32_t) - offset), sizeof(int32_t));
+      noise[index] += sign * (static_cast<float>(value) / INT32_MAX);
+    }
+  }
+  return 0;
+}
 }  // namespace armour
 }  // namespace fl
 }  // namespace mindspore
@@ -28,6 +28,11 @@ class MS_EXPORT Masking {
  public:
   static int GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
                         const uint8_t *ivec, int ivec_size);
+  // Add sign times the masking of the elements in [begin, end) to noise, which is the same as the elements of
+  // GetMasking. The key stream of begin is located by the AES-CTR counter, so a long masking can be generated in
+  // chunks by several threads.
+  static int AddMasking(float *noise, size_t begin, size_t end, float sign, const uint8_t *secret, int secret_len,
+                        const uint8_t *ivec, int ivec_size);
 };
 }  // namespace armour
 }  // namespace fl
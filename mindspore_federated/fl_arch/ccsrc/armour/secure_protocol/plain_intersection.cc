@@ -43,7 +43,7 @@ std::vector<std::string> PlainIntersection(const std::vector<std::string> &input
   if (comm_role == "server") {
     MS_LOG(INFO) << "-------------------------- 0.2. server receive clientPsiInit -----------------------";
     ClientPSIInit client_psi_init_recv;
-    verticalServer.Receive(target_server_name, &client_psi_init_recv);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &client_psi_init_recv);
     MS_LOG(INFO) << "-------------------------- 0.3. server send serverPsiInit -----------------------";
     ServerPSIInit server_psi_init(psi_ctx.bin_id, psi_ctx.self_num, psi_ctx.role);
     verticalServer.Send(target_server_name, server_psi_init);
@@ -54,7 +54,7 @@ std::vector<std::string> PlainIntersection(const std::vector<std::string> &input
 
     MS_LOG(INFO) << "-------------------------- 2. server receive clientPlain -----------------------";
     PlainData clientPlain;
-    verticalServer.Receive(target_server_name, &clientPlain);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &clientPlain);
     std::vector<std::string> recv_vct = clientPlain.plain_data_vct();
     clientPlain.set_empty();
     ret = Align(&recv_vct, input_hash_vct, psi_ctx);
@@ -70,7 +70,7 @@ std::vector<std::string> PlainIntersection(const std::vector<std::string> &input
     verticalServer.Send(target_server_name, client_psi_init);
     MS_LOG(INFO) << "-------------------------- 0.4. client receive serverPsiInit -----------------------";
     ServerPSIInit server_psi_init_recv;
-    verticalServer.Receive(target_server_name, &server_psi_init_recv);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &server_psi_init_recv);
     if (server_psi_init_recv.bin_id() != psi_ctx.bin_id) {
       MS_LOG(ERROR) << "The bin_id is not same, please check bin_id: " << server_psi_init_recv.bin_id();
       return ret;
@@ -81,7 +81,7 @@ std::vector<std::string> PlainIntersection(const std::vector<std::string> &input
     verticalServer.Send(target_server_name, clientPlain);
     MS_LOG(INFO) << "-------------------------- 4. client receive alignResult -----------------------";
     PlainData alignResult;
-    verticalServer.Receive(target_server_name, &alignResult);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &alignResult);
     return alignResult.plain_data_vct();
   }
 
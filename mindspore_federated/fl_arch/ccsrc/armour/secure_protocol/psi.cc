@@ -14,11 +14,18 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <random>
 #include <vector>
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <set>
+#include <utility>
+#include "armour/base_crypto/digest_set.h"
 #include "armour/base_crypto/hash.h"
 #include "armour/util/io_util.h"
 #include "armour/secure_protocol/psi.h"
@@ -27,6 +34,15 @@
 namespace mindspore {
 namespace fl {
 namespace psi {
+namespace {
+// The points from the peer are decompressed with their record length, which must be the configured compress length.
+void CheckPeerPoints(const PointBuffer &points, const PsiCtx &psi_ctx) {
+  if (!points.empty() && points.record_len() != psi_ctx.compress_length) {
+    MS_LOG(EXCEPTION) << "The record length " << points.record_len() << " of the points from the peer is not equal to "
+                      << "the compress length " << psi_ctx.compress_length << ".";
+  }
+}
+}  // namespace
 
 std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::vector<std::string> &bob_vct,
                                const PsiCtx &psi_ctx) {
@@ -40,9 +56,9 @@ std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::v
   time_t time_end;
   time(&time_start);
 
-  std::sort(alice_vct->begin(), alice_vct->end());
+  DigestSet alice_set(*alice_vct, psi_ctx.thread_num);
   time(&time_end);
-  MS_LOG(INFO) << "Sort alice's data, time cost: " << difftime(time_end, time_start) << " s.";
+  MS_LOG(INFO) << "Index alice's data, time cost: " << difftime(time_end, time_start) << " s.";
 
   time(&time_start);
   std::vector<std::string> align_results_vector(std::min(alice_vct->size(), bob_vct.size()));
@@ -50,7 +66,7 @@ std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::v
   ParallelSync parallel_sync(psi_ctx.thread_num);
   parallel_sync.parallel_for(0, bob_vct.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
     for (size_t i = beg; i < end; i++) {
-      if (std::binary_search(alice_vct->begin(), alice_vct->end(), bob_vct[i])) {
+      if (alice_set.Contains(bob_vct[i])) {
         align_results_vector[idx++] = psi_ctx.input_vct->at(i);
       }
     }
@@ -63,19 +79,20 @@ std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::v
   return align_results_vector;
 }
 
-std::vector<std::string> Align(const std::vector<std::string> &p_b_a_bI_vct, const BloomFilter &bf,
-                               const PsiCtx &psi_ctx) {
+std::vector<std::string> Align(const PointBuffer &p_b_a_bI_buf, const BloomFilter &bf, const PsiCtx &psi_ctx) {
   MS_LOG(INFO) << "Bob start doing filter_align";
   time_t time_start;
   time_t time_end;
   time(&time_start);
 
-  std::vector<std::string> align_results_vector(std::min(p_b_a_bI_vct.size(), bf.input_num_));
+  std::vector<std::string> align_results_vector(std::min(p_b_a_bI_buf.size(), bf.input_num_));
   std::atomic<size_t> idx(0);
   ParallelSync parallel_sync(psi_ctx.thread_num);
-  parallel_sync.parallel_for(0, p_b_a_bI_vct.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
+  parallel_sync.parallel_for(0, p_b_a_bI_buf.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
+    std::vector<uint8_t> hits;
+    bf.LookUp(p_b_a_bI_buf, beg, end, &hits);
     for (size_t i = beg; i < end; i++) {
-      if (bf.LookUp(p_b_a_bI_vct[i])) {
+      if (hits[i - beg] != 0) {
         align_results_vector[idx++] = psi_ctx.input_vct->at(i);
       }
     }
@@ -96,14 +113,14 @@ void FindWrong(const PsiCtx &psi_ctx, const std::vector<std::string> &align_resu
   time(&time_start);
 
   std::vector<unsigned char> flag_vct(align_result.size(), 0);
+  DigestSet align_set(align_result, psi_ctx.thread_num);
   ParallelSync parallel_sync(psi_ctx.thread_num);
   parallel_sync.parallel_for(0, psi_ctx.self_num, psi_ctx.chunk_size, [&](size_t beg, size_t end) {
     for (size_t i = beg; i < end; i++) {
-      size_t index = distance(align_result.begin(),
-                              std::lower_bound(align_result.begin(), align_result.end(), psi_ctx.input_vct->at(i)));
-      if (index < align_result.size() && align_result[index] == psi_ctx.input_vct->at(i)) {
+      align_set.ForEach(psi_ctx.input_vct->at(i), [&flag_vct](size_t index) {
         flag_vct[index] = 1;
-      }
+        return false;
+      });
     }
   });
   for (size_t i = 0; i < flag_vct.size(); i++) {
@@ -127,16 +144,32 @@ void DelWrong(std::vector<std::string> *align_results_vector, const std::vector<
   time_t time_start;
   time_t time_end;
   time(&time_start);
+  // Each wrong id deletes the first align result equal to it which is not deleted yet, the order of the remaining
+  // results is kept.
+  DigestSet wrong_set(recv_wrong_vct, 1);
+  std::vector<unsigned char> used_vct(recv_wrong_vct.size(), 0);
   size_t del_num = 0;
-  for (const auto &item : recv_wrong_vct) {
-    for (auto iter = align_results_vector->begin(); iter != align_results_vector->end(); iter++) {
-      if (*iter == item) {
-        align_results_vector->erase(iter);
-        del_num++;
-        break;
+  size_t kept_num = 0;
+  for (size_t i = 0; i < align_results_vector->size(); i++) {
+    bool is_wrong = false;
+    wrong_set.ForEach(align_results_vector->at(i), [&used_vct, &is_wrong](size_t index) {
+      if (used_vct[index] != 0) {
+        return false;
       }
+      used_vct[index] = 1;
+      is_wrong = true;
+      return true;
+    });
+    if (is_wrong) {
+      del_num++;
+      continue;
+    }
+    if (kept_num != i) {
+      align_results_vector->at(kept_num) = std::move(align_results_vector->at(i));
     }
+    kept_num++;
   }
+  align_results_vector->resize(kept_num);
   if (del_num != recv_wrong_vct.size()) {
     MS_LOG(ERROR) << "Bob receives some id that Bob doesn't have.";
   }
@@ -148,49 +181,51 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
   // bob
   MS_LOG(INFO)
     << "  -------------------------- 0.[offline] Bob start hashing and computing p2^b...----------------------";
-  std::vector<std::string> bob_input_hash_vct =
-    HashInputs(psi_ctx_bob.input_vct, psi_ctx_bob.thread_num, psi_ctx_bob.chunk_size);
-  auto p_b_vct =
-    psi_ctx_bob.ecc->HashToCurveAndMul(bob_input_hash_vct, psi_ctx_bob.compress_length, psi_ctx_bob.compress_length);
-  std::vector<std::string>().swap(bob_input_hash_vct);
+  PointBuffer bob_input_hash_buf =
+    HashInputsToBuffer(psi_ctx_bob.input_vct, psi_ctx_bob.thread_num, psi_ctx_bob.chunk_size);
+  auto p_b_buf =
+    psi_ctx_bob.ecc->HashToCurveAndMul(bob_input_hash_buf, psi_ctx_bob.compress_length, psi_ctx_bob.compress_length);
+  bob_input_hash_buf.set_empty();
   MS_LOG(INFO) << "  -------------------------- 1. bob send bobPb -----------------------";
-  BobPb bob_p_b(psi_ctx_bob.bin_id, p_b_vct);
+  BobPb bob_p_b(psi_ctx_bob.bin_id, std::move(p_b_buf));
   Send(bob_p_b);
+  bob_p_b.set_empty();
 
   // alice
   MS_LOG(INFO)
     << "  -------------------------- 0.[offline] Alice start hashing and computing p1^a...----------------------";
-  std::vector<std::string> alice_input_hash_vct =
-    HashInputs(psi_ctx_alice.input_vct, psi_ctx_alice.thread_num, psi_ctx_alice.chunk_size);
-  auto p_a_vct = psi_ctx_alice.ecc->HashToCurveAndMul(alice_input_hash_vct, LENGTH_32, psi_ctx_alice.compare_length);
-  std::vector<std::string>().swap(alice_input_hash_vct);
-  BloomFilter bf_alice(p_a_vct, psi_ctx_alice.thread_num, psi_ctx_alice.neg_log_fp_rate);
-  std::vector<std::string>().swap(p_a_vct);
+  PointBuffer alice_input_hash_buf =
+    HashInputsToBuffer(psi_ctx_alice.input_vct, psi_ctx_alice.thread_num, psi_ctx_alice.chunk_size);
+  auto p_a_buf = psi_ctx_alice.ecc->HashToCurveAndMul(alice_input_hash_buf, LENGTH_32, psi_ctx_alice.compare_length);
+  alice_input_hash_buf.set_empty();
+  BloomFilter bf_alice(p_a_buf, psi_ctx_alice.thread_num, psi_ctx_alice.neg_log_fp_rate);
+  p_a_buf.set_empty();
 
   MS_LOG(INFO) << "  -------------------------- 2. alice receive bob_p_b -----------------------";
   BobPb bob_p_b_recv;
   Recv(&bob_p_b_recv);
   MS_LOG(INFO) << "Alice start decompress and compute p2^b^a ";
-  auto p_b_a_vct =
-    psi_ctx_alice.ecc->DcpsAndMul(bob_p_b_recv.p_b_vct(), psi_ctx_alice.compress_length, psi_ctx_alice.compress_length);
+  CheckPeerPoints(bob_p_b_recv.p_b_buf(), psi_ctx_alice);
+  auto p_b_a_buf = psi_ctx_alice.ecc->DcpsAndMul(bob_p_b_recv.p_b_buf(), psi_ctx_alice.compress_length);
   bob_p_b_recv.set_empty();
 
   MS_LOG(INFO) << "  -------------------------- 3. alice send AlicePbaAndBFProto -----------------------";
-  AlicePbaAndBF alice_p_b_a_bf(psi_ctx_alice.bin_id, p_b_a_vct, bf_alice.GetData());
+  AlicePbaAndBF alice_p_b_a_bf(psi_ctx_alice.bin_id, std::move(p_b_a_buf), bf_alice.GetData());
   Send(alice_p_b_a_bf);
+  alice_p_b_a_bf.set_empty();
 
   // bob
   MS_LOG(INFO) << "  -------------------------- 4. bob receive alice_p_b_a_bf -----------------------";
   AlicePbaAndBF alice_p_b_a_bf_recv;
   Recv(&alice_p_b_a_bf_recv);
   MS_LOG(INFO) << "Bob start decompress and compute p2^b^a^(b^-1) ";
-  auto p_b_a_bI_vct =
-    psi_ctx_bob.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_vct(), LENGTH_32, psi_ctx_bob.compare_length);
+  CheckPeerPoints(alice_p_b_a_bf_recv.p_b_a_buf(), psi_ctx_bob);
+  auto p_b_a_bI_buf = psi_ctx_bob.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_buf(), psi_ctx_bob.compare_length);
 
   BloomFilter bf_alice_recv(alice_p_b_a_bf_recv.bf_alice(), psi_ctx_bob.peer_num, psi_ctx_bob.neg_log_fp_rate);
   alice_p_b_a_bf_recv.set_empty();
-  auto align_results_vector = Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx_bob);
-  std::vector<std::string>().swap(p_b_a_bI_vct);
+  auto align_results_vector = Align(p_b_a_bI_buf, bf_alice_recv, psi_ctx_bob);
+  p_b_a_bI_buf.set_empty();
   MS_LOG(INFO) << "Number of false positive cases: "
                << static_cast<int>(align_results_vector.size() - psi_ctx_bob.input_vct->size() / 2);
 
@@ -234,9 +269,82 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
   }
 }
 
+namespace {
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+// The bucket of an id must be the same for both parties, so a fixed hash (FNV-1a) is used instead of std::hash.
+size_t StreamBucketIndex(const std::string &item, size_t bucket_num) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (unsigned char c : item) {
+    hash = (hash ^ c) * kFnvPrime;
+  }
+  return static_cast<size_t>(hash % bucket_num);
+}
+
+// The ids are partitioned by their buckets by index: the indexes of the ids are grouped by bucket with a counting
+// sort, so the input is neither copied nor spilled, and only the ids of the bucket in turn are gathered.
+// The indexes of the input ids grouped by bucket, the ids of bucket i are indexed by
+// indexes[bucket_begins[i], bucket_begins[i + 1]).
+struct StreamPartition {
+  size_t bucket_size(size_t bucket) const { return bucket_begins[bucket + 1] - bucket_begins[bucket]; }
+
+  std::vector<size_t> indexes;
+  std::vector<size_t> bucket_begins;
+};
+
+StreamPartition PartitionStreamBuckets(const std::vector<std::string> &input_vct, size_t bucket_num) {
+  StreamPartition partition;
+  partition.bucket_begins.assign(bucket_num + 1, 0);
+  for (const auto &item : input_vct) {
+    partition.bucket_begins[StreamBucketIndex(item, bucket_num) + 1]++;
+  }
+  for (size_t i = 0; i < bucket_num; i++) {
+    partition.bucket_begins[i + 1] += partition.bucket_begins[i];
+  }
+  std::vector<size_t> next(partition.bucket_begins.begin(), partition.bucket_begins.end() - 1);
+  partition.indexes.resize(input_vct.size());
+  for (size_t i = 0; i < input_vct.size(); i++) {
+    partition.indexes[next[StreamBucketIndex(input_vct[i], bucket_num)]++] = i;
+  }
+  return partition;
+}
+
+std::vector<std::string> GatherStreamBucket(const std::vector<std::string> &input_vct,
+                                            const StreamPartition &partition, size_t bucket) {
+  std::vector<std::string> items;
+  items.reserve(partition.bucket_size(bucket));
+  for (size_t i = partition.bucket_begins[bucket]; i < partition.bucket_begins[bucket + 1]; i++) {
+    items.emplace_back(input_vct[partition.indexes[i]]);
+  }
+  return items;
+}
+}  // namespace
+
 std::vector<std::string> RunPSIDemo(const std::vector<std::string> &alice_input,
-                                    const std::vector<std::string> &bob_input, size_t thread_num) {
+                                    const std::vector<std::string> &bob_input, size_t thread_num,
+                                    size_t stream_bucket_num) {
   std::vector<std::string> ret;
+  if (stream_bucket_num > 1) {
+    if (stream_bucket_num > kMaxStreamBucketNum) {
+      MS_LOG(ERROR) << "The stream_bucket_num should be not larger than " << kMaxStreamBucketNum << ", but get "
+                    << stream_bucket_num;
+      return ret;
+    }
+    // The streaming mode intersects the buckets of the same index one by one, as RunStreamingFilterEcdhPsi does.
+    auto alice_partition = PartitionStreamBuckets(alice_input, stream_bucket_num);
+    auto bob_partition = PartitionStreamBuckets(bob_input, stream_bucket_num);
+    for (size_t i = 0; i < stream_bucket_num; i++) {
+      if (alice_partition.bucket_size(i) == 0 || bob_partition.bucket_size(i) == 0) {
+        continue;
+      }
+      auto bucket_ret = RunPSIDemo(GatherStreamBucket(alice_input, alice_partition, i),
+                                   GatherStreamBucket(bob_input, bob_partition, i), thread_num);
+      ret.insert(ret.end(), std::make_move_iterator(bucket_ret.begin()), std::make_move_iterator(bucket_ret.end()));
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  }
   MS_LOG(INFO) << "Start RunEcdhPsi, init config...";
   PsiCtx psi_ctx_alice;
   psi_ctx_alice.thread_num = thread_num;
@@ -294,65 +402,104 @@ std::vector<std::string> RunPSIDemo(const std::vector<std::string> &alice_input,
   return ret;
 }
 
-std::vector<std::string> RunInverseFilterEcdhPsi(const std::string &target_server_name, const PsiCtx &psi_ctx) {
-  std::vector<std::string> align_results_vector;
-  auto &verticalServer = VerticalServer::GetInstance();
+namespace {
+// The computing phases of a bin hold the CPU budget shared by the concurrent bins, see PsiCtx::cpu_budget_mutex.
+class CpuBudgetGuard {
+ public:
+  explicit CpuBudgetGuard(const PsiCtx &psi_ctx) {
+    if (psi_ctx.cpu_budget_mutex != nullptr) {
+      lock_ = std::unique_lock<std::mutex>(*psi_ctx.cpu_budget_mutex);
+    }
+  }
+  ~CpuBudgetGuard() = default;
+
+ private:
+  std::unique_lock<std::mutex> lock_;
+};
+
+// Alice's offline phase: hash the input, compute p1^a and insert them into the bloom filter.
+std::unique_ptr<BloomFilter> AliceOffline(const PsiCtx &psi_ctx) {
+  CpuBudgetGuard cpu_budget_guard(psi_ctx);
   MS_LOG(INFO) << "Start hash input...";
-  std::vector<std::string> input_hash_vct = HashInputs(psi_ctx.input_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
+  PointBuffer input_hash_buf = HashInputsToBuffer(psi_ctx.input_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
+  MS_LOG(INFO) << "[offline] Alice start computing p1^a...";
+  auto p_a_buf = psi_ctx.ecc->HashToCurveAndMul(input_hash_buf, psi_ctx.compress_length, LENGTH_32);
+  input_hash_buf.set_empty();
+  return std::make_unique<BloomFilter>(p_a_buf, psi_ctx.thread_num, psi_ctx.neg_log_fp_rate);
+}
 
-  if (psi_ctx.role == "alice") {
-    MS_LOG(INFO) << "[offline] Alice start computing p1^a...";
-    auto p_a_vct = psi_ctx.ecc->HashToCurveAndMul(input_hash_vct, psi_ctx.compress_length, LENGTH_32);
-    std::vector<std::string>().swap(input_hash_vct);
-    BloomFilter bf_alice(p_a_vct, psi_ctx.thread_num, psi_ctx.neg_log_fp_rate);
-    std::vector<std::string>().swap(p_a_vct);
-
-    MS_LOG(INFO) << "----------------------- 2. alice receive bob_p_b -----------------------";
-    BobPb bob_p_b_recv;
-    verticalServer.Receive(target_server_name, &bob_p_b_recv);
-    MS_LOG(INFO) << "Alice start decompress and compute p2^b^a --------------------------";
-    auto p_b_a_vct = psi_ctx.ecc->DcpsAndMul(bob_p_b_recv.p_b_vct(), psi_ctx.compress_length, psi_ctx.compress_length);
-    bob_p_b_recv.set_empty();
-
-    MS_LOG(INFO) << " -------------------------- 3. alice send AlicePbaAndBFProto ------------------------";
-    AlicePbaAndBF alice_p_b_a_bf(psi_ctx.bin_id, p_b_a_vct, bf_alice.GetData());
-    verticalServer.Send(target_server_name, alice_p_b_a_bf);
-    std::vector<std::string>().swap(p_b_a_vct);
-    bf_alice.set_empty();
-    alice_p_b_a_bf.set_empty();
-
-    MS_LOG(INFO) << "-------------------------- 6. alice receive align_result -----------------------";
-    std::vector<std::string> wrong_vct;
-    std::vector<std::string> fix_vct;
-    BobAlignResult bob_align_result_recv;
-    verticalServer.Receive(target_server_name, &bob_align_result_recv);
+void AliceSendPbaAndBF(const std::string &target_server_name, const PsiCtx &psi_ctx, BloomFilter *bf_alice) {
+  auto &verticalServer = VerticalServer::GetInstance();
+  MS_LOG(INFO) << "----------------------- 2. alice receive bob_p_b -----------------------";
+  BobPb bob_p_b_recv;
+  verticalServer.Receive(target_server_name, psi_ctx.bin_id, &bob_p_b_recv);
+  CheckPeerPoints(bob_p_b_recv.p_b_buf(), psi_ctx);
+  MS_LOG(INFO) << "Alice start decompress and compute p2^b^a --------------------------";
+  PointBuffer p_b_a_buf;
+  {
+    CpuBudgetGuard cpu_budget_guard(psi_ctx);
+    p_b_a_buf = psi_ctx.ecc->DcpsAndMul(bob_p_b_recv.p_b_buf(), psi_ctx.compress_length);
+  }
+  bob_p_b_recv.set_empty();
+
+  MS_LOG(INFO) << " -------------------------- 3. alice send AlicePbaAndBFProto ------------------------";
+  AlicePbaAndBF alice_p_b_a_bf(psi_ctx.bin_id, std::move(p_b_a_buf), bf_alice->GetData());
+  verticalServer.Send(target_server_name, alice_p_b_a_bf);
+  bf_alice->set_empty();
+  alice_p_b_a_bf.set_empty();
+}
+
+std::vector<std::string> AliceCheckAlignResult(const std::string &target_server_name, const PsiCtx &psi_ctx) {
+  auto &verticalServer = VerticalServer::GetInstance();
+  MS_LOG(INFO) << "-------------------------- 6. alice receive align_result -----------------------";
+  std::vector<std::string> wrong_vct;
+  std::vector<std::string> fix_vct;
+  BobAlignResult bob_align_result_recv;
+  verticalServer.Receive(target_server_name, psi_ctx.bin_id, &bob_align_result_recv);
+  {
+    CpuBudgetGuard cpu_budget_guard(psi_ctx);
     FindWrong(psi_ctx, bob_align_result_recv.align_result(), &wrong_vct, &fix_vct);
-    bob_align_result_recv.set_empty();
+  }
+  bob_align_result_recv.set_empty();
 
-    MS_LOG(INFO) << "-------------------------- 7. alice send wrong_id -----------------------";
-    AliceCheck alice_check(psi_ctx.bin_id, wrong_vct.size(), wrong_vct);
-    verticalServer.Send(target_server_name, alice_check);
-    return fix_vct;
-  } else {
-    MS_LOG(INFO) << "[offline] Bob start computing p2^b...";
-    auto p_b_vct = psi_ctx.ecc->HashToCurveAndMul(input_hash_vct, psi_ctx.compress_length, psi_ctx.compress_length);
-    std::vector<std::string>().swap(input_hash_vct);
-    MS_LOG(INFO) << "-------------------------- 1. bob send bobPb -----------------------";
-    BobPb bob_p_b(psi_ctx.bin_id, p_b_vct);
-    verticalServer.Send(target_server_name, bob_p_b);
-    std::vector<std::string>().swap(p_b_vct);
-    bob_p_b.set_empty();
-
-    MS_LOG(INFO) << "-------------------------- 4. bob receive alice_p_b_a_bf -----------------------";
-    AlicePbaAndBF alice_p_b_a_bf_recv;
-    verticalServer.Receive(target_server_name, &alice_p_b_a_bf_recv);
-    MS_LOG(INFO) << "Bob start decompress and compute p2^b^a^(b^-1) --------------------------";
-    auto p_b_a_bI_vct =
-      psi_ctx.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_vct(), psi_ctx.compress_length, LENGTH_32);
+  MS_LOG(INFO) << "-------------------------- 7. alice send wrong_id -----------------------";
+  AliceCheck alice_check(psi_ctx.bin_id, wrong_vct.size(), wrong_vct);
+  verticalServer.Send(target_server_name, alice_check);
+  return fix_vct;
+}
+
+// Bob's offline phase: hash the input and compute p2^b.
+PointBuffer BobOffline(const PsiCtx &psi_ctx) {
+  CpuBudgetGuard cpu_budget_guard(psi_ctx);
+  MS_LOG(INFO) << "Start hash input...";
+  PointBuffer input_hash_buf = HashInputsToBuffer(psi_ctx.input_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
+  MS_LOG(INFO) << "[offline] Bob start computing p2^b...";
+  return psi_ctx.ecc->HashToCurveAndMul(input_hash_buf, psi_ctx.compress_length, psi_ctx.compress_length);
+}
+
+void BobSendPb(const std::string &target_server_name, const PsiCtx &psi_ctx, PointBuffer *p_b_buf) {
+  MS_LOG(INFO) << "-------------------------- 1. bob send bobPb -----------------------";
+  BobPb bob_p_b(psi_ctx.bin_id, std::move(*p_b_buf));
+  VerticalServer::GetInstance().Send(target_server_name, bob_p_b);
+  p_b_buf->set_empty();
+  bob_p_b.set_empty();
+}
+
+std::vector<std::string> BobAlignAndCheck(const std::string &target_server_name, const PsiCtx &psi_ctx) {
+  auto &verticalServer = VerticalServer::GetInstance();
+  MS_LOG(INFO) << "-------------------------- 4. bob receive alice_p_b_a_bf -----------------------";
+  AlicePbaAndBF alice_p_b_a_bf_recv;
+  verticalServer.Receive(target_server_name, psi_ctx.bin_id, &alice_p_b_a_bf_recv);
+  CheckPeerPoints(alice_p_b_a_bf_recv.p_b_a_buf(), psi_ctx);
+  MS_LOG(INFO) << "Bob start decompress and compute p2^b^a^(b^-1) --------------------------";
+  std::vector<std::string> align_results_vector;
+  {
+    CpuBudgetGuard cpu_budget_guard(psi_ctx);
+    auto p_b_a_bI_buf = psi_ctx.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_buf(), LENGTH_32);
     BloomFilter bf_alice_recv(alice_p_b_a_bf_recv.bf_alice(), psi_ctx.peer_num, psi_ctx.neg_log_fp_rate);
     alice_p_b_a_bf_recv.set_empty();
-    align_results_vector = Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx);
-    std::vector<std::string>().swap(p_b_a_bI_vct);
+    align_results_vector = Align(p_b_a_bI_buf, bf_alice_recv, psi_ctx);
+    p_b_a_bI_buf.set_empty();
     bf_alice_recv.set_empty();
 
     time_t time_start;
@@ -361,41 +508,170 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const std::string &target_serve
     std::sort(align_results_vector.begin(), align_results_vector.end());
     time(&time_end);
     MS_LOG(INFO) << "Bob sort align result, time cost: " << difftime(time_end, time_start) << " s.";
+  }
 
-    MS_LOG(INFO) << "-------------------------- 5. bob send align_result -----------------------";
-    BobAlignResult bob_align_result(psi_ctx.bin_id, align_results_vector);
-    verticalServer.Send(target_server_name, bob_align_result);
-    bob_align_result.set_empty();
+  MS_LOG(INFO) << "-------------------------- 5. bob send align_result -----------------------";
+  BobAlignResult bob_align_result(psi_ctx.bin_id, align_results_vector);
+  verticalServer.Send(target_server_name, bob_align_result);
+  bob_align_result.set_empty();
 
-    MS_LOG(INFO) << "-------------------------- 8. bob receive wrong_id -----------------------";
-    AliceCheck alice_check_recv;
-    verticalServer.Receive(target_server_name, &alice_check_recv);
-    DelWrong(&align_results_vector, alice_check_recv.wrong_id());
-    return align_results_vector;
+  MS_LOG(INFO) << "-------------------------- 8. bob receive wrong_id -----------------------";
+  AliceCheck alice_check_recv;
+  verticalServer.Receive(target_server_name, psi_ctx.bin_id, &alice_check_recv);
+  CpuBudgetGuard cpu_budget_guard(psi_ctx);
+  DelWrong(&align_results_vector, alice_check_recv.wrong_id());
+  return align_results_vector;
+}
+
+bool ExchangeBucketSizes(const std::string &target_server_name, const PsiCtx &psi_ctx,
+                         const std::vector<size_t> &self_sizes, std::vector<size_t> *peer_sizes) {
+  auto &verticalServer = VerticalServer::GetInstance();
+  StreamBucketSizes bucket_sizes(psi_ctx.bin_id, psi_ctx.role, self_sizes);
+  verticalServer.Send(target_server_name, bucket_sizes);
+  StreamBucketSizes bucket_sizes_recv;
+  verticalServer.Receive(target_server_name, psi_ctx.bin_id, psi_ctx.peer_role, &bucket_sizes_recv);
+  if (bucket_sizes_recv.sizes().size() != self_sizes.size()) {
+    MS_LOG(ERROR) << "The stream bucket number of the peer is " << bucket_sizes_recv.sizes().size()
+                  << ", but self is " << self_sizes.size() << ", please set the same stream_bucket_num.";
+    return false;
   }
+  *peer_sizes = bucket_sizes_recv.sizes();
+  return true;
 }
 
-std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const std::string &comm_role,
-                                const std::string &target_server_name, size_t bin_id, size_t thread_num) {
+// The input, the precomputed bloom filter (alice) or points (bob) of one bucket of the streaming mode.
+struct StreamBucket {
+  std::vector<std::string> input_vct;
+  size_t peer_num = 0;
+  std::unique_ptr<BloomFilter> bf_alice;
+  PointBuffer p_b_buf;
+};
+
+PsiCtx BucketCtx(const PsiCtx &psi_ctx, const StreamBucket &bucket) {
+  PsiCtx bucket_ctx = psi_ctx;
+  bucket_ctx.input_vct = &bucket.input_vct;
+  bucket_ctx.self_num = bucket.input_vct.size();
+  bucket_ctx.peer_num = bucket.peer_num;
+  return bucket_ctx;
+}
+}  // namespace
+
+std::vector<std::string> RunInverseFilterEcdhPsi(const std::string &target_server_name, const PsiCtx &psi_ctx) {
+  if (psi_ctx.role == "alice") {
+    auto bf_alice = AliceOffline(psi_ctx);
+    AliceSendPbaAndBF(target_server_name, psi_ctx, bf_alice.get());
+    return AliceCheckAlignResult(target_server_name, psi_ctx);
+  } else {
+    auto p_b_buf = BobOffline(psi_ctx);
+    BobSendPb(target_server_name, psi_ctx, &p_b_buf);
+    return BobAlignAndCheck(target_server_name, psi_ctx);
+  }
+}
+
+std::vector<std::string> RunStreamingFilterEcdhPsi(const std::string &target_server_name, const PsiCtx &psi_ctx) {
   std::vector<std::string> ret;
-  auto &verticalServer = VerticalServer::GetInstance();
-  verticalServer.StartVerticalCommunicator();
+  time_t time_start;
+  time_t time_end;
+  time(&time_start);
+  auto partition = PartitionStreamBuckets(*psi_ctx.input_vct, psi_ctx.stream_bucket_num);
+  time(&time_end);
+  MS_LOG(INFO) << "Partition input into " << psi_ctx.stream_bucket_num
+               << " buckets, time cost: " << difftime(time_end, time_start) << " s.";
+  std::vector<size_t> self_sizes;
+  for (size_t i = 0; i < psi_ctx.stream_bucket_num; i++) {
+    self_sizes.emplace_back(partition.bucket_size(i));
+  }
+  std::vector<size_t> peer_sizes;
+  if (!ExchangeBucketSizes(target_server_name, psi_ctx, self_sizes, &peer_sizes)) {
+    return ret;
+  }
+  // The buckets which are empty in either party have no intersection and are skipped by both parties.
+  std::vector<size_t> buckets;
+  for (size_t i = 0; i < self_sizes.size(); i++) {
+    if (self_sizes[i] != 0 && peer_sizes[i] != 0) {
+      buckets.emplace_back(i);
+    }
+  }
+  if (buckets.empty()) {
+    return ret;
+  }
 
-  MS_LOG(INFO) << "Start RunPSICommunicateTest, init psi context...";
+  bool is_alice = psi_ctx.role == "alice";
+  auto prepare = [&](size_t bucket) {
+    auto stream_bucket = std::make_unique<StreamBucket>();
+    stream_bucket->input_vct = GatherStreamBucket(*psi_ctx.input_vct, partition, bucket);
+    stream_bucket->peer_num = peer_sizes[bucket];
+    auto bucket_ctx = BucketCtx(psi_ctx, *stream_bucket);
+    if (is_alice) {
+      stream_bucket->bf_alice = AliceOffline(bucket_ctx);
+    } else {
+      stream_bucket->p_b_buf = BobOffline(bucket_ctx);
+    }
+    return stream_bucket;
+  };
+
+  // The offline phase of the next bucket runs in background while the current bucket is waiting for the peer, so at
+  // most two buckets are in memory.
+  auto current = prepare(buckets[0]);
+  if (!is_alice) {
+    BobSendPb(target_server_name, BucketCtx(psi_ctx, *current), &current->p_b_buf);
+  }
+  for (size_t i = 0; i < buckets.size(); i++) {
+    MS_LOG(INFO) << "Stream psi start bucket " << buckets[i] << ", self size is " << current->input_vct.size()
+                 << ", peer size is " << current->peer_num;
+    auto bucket_ctx = BucketCtx(psi_ctx, *current);
+    std::future<std::unique_ptr<StreamBucket>> next;
+    std::vector<std::string> bucket_ret;
+    if (is_alice) {
+      AliceSendPbaAndBF(target_server_name, bucket_ctx, current->bf_alice.get());
+      current->bf_alice.reset();
+      if (i + 1 < buckets.size()) {
+        next = std::async(std::launch::async, prepare, buckets[i + 1]);
+      }
+      bucket_ret = AliceCheckAlignResult(target_server_name, bucket_ctx);
+    } else {
+      if (i + 1 < buckets.size()) {
+        next = std::async(std::launch::async, prepare, buckets[i + 1]);
+      }
+      bucket_ret = BobAlignAndCheck(target_server_name, bucket_ctx);
+    }
+    ret.insert(ret.end(), std::make_move_iterator(bucket_ret.begin()), std::make_move_iterator(bucket_ret.end()));
+    if (next.valid()) {
+      current = next.get();
+      if (!is_alice) {
+        BobSendPb(target_server_name, BucketCtx(psi_ctx, *current), &current->p_b_buf);
+      }
+    }
+  }
+  // The results are sorted as the non-streaming mode, instead of being in the order of the buckets.
+  std::sort(ret.begin(), ret.end());
+  MS_LOG(INFO) << "Stream psi finished, PSI num is: " << ret.size();
+  return ret;
+}
+
+namespace {
+PsiCtx InitPsiCtx(const std::vector<std::string> &input_vct, size_t bin_id, size_t thread_num) {
   PsiCtx psi_ctx;
   psi_ctx.bin_id = bin_id;
   psi_ctx.thread_num = thread_num;
   psi_ctx.input_vct = &input_vct;
   psi_ctx.self_num = input_vct.size();
   psi_ctx.ecc = std::make_unique<ECC>(psi_ctx.curve_name, psi_ctx.thread_num, psi_ctx.chunk_size);
+  return psi_ctx;
+}
 
+// Exchange the init messages and run the protocol of one bin.
+std::vector<std::string> RunBinPSI(PsiCtx psi_ctx, const std::string &comm_role,
+                                   const std::string &target_server_name) {
+  std::vector<std::string> ret;
+  auto &verticalServer = VerticalServer::GetInstance();
   if (comm_role == "client") {
     MS_LOG(INFO) << "-------------------------- 1. client send clientPsiInit -----------------------";
     ClientPSIInit client_psi_init(psi_ctx.bin_id, psi_ctx.psi_type, psi_ctx.self_num);
     verticalServer.Send(target_server_name, client_psi_init);
     MS_LOG(INFO) << "-------------------------- 4. client receive serverPsiInit -----------------------";
     ServerPSIInit server_psi_init_recv;
-    verticalServer.Receive(target_server_name, &server_psi_init_recv);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &server_psi_init_recv);
     if (server_psi_init_recv.bin_id() != psi_ctx.bin_id) {
       MS_LOG(ERROR) << "The bin_id is not same, please check bin_id: " << server_psi_init_recv.bin_id();
       return ret;
@@ -404,7 +680,7 @@ std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const
   } else if (comm_role == "server") {
     MS_LOG(INFO) << "-------------------------- 2. server receive clientPsiInit -----------------------";
     ClientPSIInit client_psi_init_recv;
-    verticalServer.Receive(target_server_name, &client_psi_init_recv);
+    verticalServer.Receive(target_server_name, psi_ctx.bin_id, &client_psi_init_recv);
     psi_ctx.SetRole(client_psi_init_recv.self_size());
     MS_LOG(INFO) << "-------------------------- 3. server send serverPsiInit -----------------------";
     ServerPSIInit server_psi_init(psi_ctx.bin_id, psi_ctx.self_num, psi_ctx.role);
@@ -424,13 +700,109 @@ std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const
   }
   MS_LOG(INFO) << "Set PSI_CTX over, start computing...";
 
-  if (psi_ctx.psi_type == "filter_ecdh") {
+  if (psi_ctx.psi_type == "filter_ecdh" && psi_ctx.stream_bucket_num > 1) {
+    ret = RunStreamingFilterEcdhPsi(target_server_name, psi_ctx);
+  } else if (psi_ctx.psi_type == "filter_ecdh") {
     ret = RunInverseFilterEcdhPsi(target_server_name, psi_ctx);
   } else {
     MS_LOG(INFO) << "The psi protocol is not supported currently.";
   }
   return ret;
 }
+}  // namespace
+
+std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const std::string &comm_role,
+                                const std::string &target_server_name, size_t bin_id, size_t thread_num,
+                                size_t stream_bucket_num) {
+  if (stream_bucket_num > kMaxStreamBucketNum) {
+    MS_LOG(ERROR) << "The stream_bucket_num should be not larger than " << kMaxStreamBucketNum << ", but get "
+                  << stream_bucket_num;
+    return {};
+  }
+  auto &verticalServer = VerticalServer::GetInstance();
+  verticalServer.StartVerticalCommunicator();
+  verticalServer.StartPsiBins({bin_id});
+  MS_LOG(INFO) << "Start RunPSICommunicateTest, init psi context...";
+  std::vector<std::string> ret;
+  try {
+    PsiCtx psi_ctx = InitPsiCtx(input_vct, bin_id, thread_num);
+    psi_ctx.stream_bucket_num = stream_bucket_num;
+    ret = RunBinPSI(psi_ctx, comm_role, target_server_name);
+  } catch (...) {
+    verticalServer.FinishPsiBin(bin_id);
+    throw;
+  }
+  verticalServer.FinishPsiBin(bin_id);
+  return ret;
+}
+
+std::vector<std::vector<std::string>> RunMultiBinPSI(const std::vector<std::vector<std::string>> &bin_inputs,
+                                                     const std::vector<size_t> &bin_ids, const std::string &comm_role,
+                                                     const std::string &target_server_name, size_t thread_num,
+                                                     size_t concurrent_bin_num) {
+  std::vector<std::vector<std::string>> ret(bin_inputs.size());
+  if (bin_inputs.size() != bin_ids.size()) {
+    MS_LOG(ERROR) << "The number of the bin inputs is " << bin_inputs.size() << ", but the number of the bin ids is "
+                  << bin_ids.size();
+    return ret;
+  }
+  if (std::set<size_t>(bin_ids.begin(), bin_ids.end()).size() != bin_ids.size()) {
+    MS_LOG(ERROR) << "The bin ids should be different, since the messages are routed by the bin id.";
+    return ret;
+  }
+  if (concurrent_bin_num == 0) {
+    MS_LOG(ERROR) << "The concurrent_bin_num should be greater than 0.";
+    return ret;
+  }
+  auto &verticalServer = VerticalServer::GetInstance();
+  verticalServer.StartVerticalCommunicator();
+  verticalServer.StartPsiBins(bin_ids);
+
+  MS_LOG(INFO) << "Start multi-bin psi, bin num is " << bin_ids.size() << ", concurrent bin num is "
+               << concurrent_bin_num;
+  auto cpu_budget_mutex = std::make_shared<std::mutex>();
+  std::atomic<size_t> next_bin = 0;
+  // After a bin fails, the workers stop taking new bins, since the result is discarded anyway.
+  std::atomic<bool> has_failed = false;
+  auto run_bins = [&]() {
+    for (size_t i = next_bin.fetch_add(1); i < bin_ids.size() && !has_failed.load(); i = next_bin.fetch_add(1)) {
+      try {
+        PsiCtx psi_ctx = InitPsiCtx(bin_inputs[i], bin_ids[i], thread_num);
+        psi_ctx.cpu_budget_mutex = cpu_budget_mutex;
+        ret[i] = RunBinPSI(psi_ctx, comm_role, target_server_name);
+      } catch (...) {
+        has_failed = true;
+        throw;
+      }
+      verticalServer.FinishPsiBin(bin_ids[i]);
+      MS_LOG(INFO) << "The psi of bin " << bin_ids[i] << " finished, PSI num is: " << ret[i].size();
+    }
+  };
+  std::vector<std::future<void>> workers;
+  size_t worker_num = std::min(concurrent_bin_num, bin_ids.size());
+  for (size_t i = 0; i < worker_num; i++) {
+    workers.emplace_back(std::async(std::launch::async, run_bins));
+  }
+  // Wait for all the workers before rethrowing, since they reference the local variables.
+  std::exception_ptr error = nullptr;
+  for (auto &worker : workers) {
+    try {
+      worker.get();
+    } catch (...) {
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error != nullptr) {
+    // The bins failed or not run are finished, so that their queues are erased.
+    for (auto bin_id : bin_ids) {
+      verticalServer.FinishPsiBin(bin_id);
+    }
+    std::rethrow_exception(error);
+  }
+  return ret;
+}
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
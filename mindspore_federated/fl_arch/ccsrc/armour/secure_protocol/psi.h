@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "armour/base_crypto/ecc.h"
@@ -29,6 +30,10 @@
 namespace mindspore {
 namespace fl {
 namespace psi {
+// The upper limit of the bucket number of the streaming mode, whose bucket sizes are exchanged in one message.
+constexpr size_t kMaxStreamBucketNum = 4096;
+// The default number of the bins running concurrently in RunMultiBinPSI.
+constexpr size_t kDefaultConcurrentBinNum = 4;
 
 struct PsiCtx {
   bool SetRole(size_t peer_dataset_size) {
@@ -111,6 +116,13 @@ struct PsiCtx {
   int neg_log_fp_rate = STAT_SEC_PARA;  // default
   size_t chunk_size = 1;                // default
   bool need_check = true;
+  // The streaming mode is enabled if stream_bucket_num > 1: the input is hash-partitioned into stream_bucket_num
+  // buckets by index, and the protocol runs bucket by bucket, so the peak memory of the copied ids, hashes, points and
+  // bloom filter is bounded by the bucket size instead of the dataset size.
+  size_t stream_bucket_num = 0;
+  // The CPU budget shared by the bins running concurrently: a bin locks it while computing with thread_num threads,
+  // and unlocks it before waiting for the peer. It's nullptr if the bin runs alone.
+  std::shared_ptr<std::mutex> cpu_budget_mutex = nullptr;
 
   const std::vector<std::string> *input_vct;
   size_t self_num = 0;
@@ -126,12 +138,32 @@ void FindWrong(const PsiCtx &psi_ctx, const std::vector<std::string> &align_resu
 void DelWrong(std::vector<std::string> *align_results_vector, const std::vector<std::string> &recv_wrong_vct);
 
 MS_EXPORT std::vector<std::string> RunPSIDemo(const std::vector<std::string> &alice_input,
-                                              const std::vector<std::string> &bob_input, size_t thread_num);
+                                              const std::vector<std::string> &bob_input, size_t thread_num,
+                                              size_t stream_bucket_num = 0);
 
 std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, const PsiCtx &psi_ctx_bob);
 
+// Run the streaming mode of the filter ecdh psi with psi_ctx.stream_bucket_num buckets, see PsiCtx. The bin of psi_ctx
+// must be started in VerticalServer.
+std::vector<std::string> RunStreamingFilterEcdhPsi(const std::string &target_server_name, const PsiCtx &psi_ctx);
+
+// Both parties must set the same stream_bucket_num, the results of the streaming mode are sorted as the non-streaming
+// mode.
 MS_EXPORT std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const std::string &comm_role,
-                                          const std::string &target_server_name, size_t bin_id, size_t thread_num);
+                                          const std::string &target_server_name, size_t bin_id, size_t thread_num,
+                                          size_t stream_bucket_num = 0);
+
+// Run the PSI of several bins over the same communicator, at most concurrent_bin_num bins at a time, and return the
+// results in the order of bin_ids. Both parties must pass the same bin_ids, the bins are started in this order, so a
+// bin waiting for the peer never blocks the bins of the peer. The thread_num threads are shared by all the bins: the
+// computing phases of the bins take turns to use them, so the ECC of one bin runs while the others are waiting for
+// the network.
+MS_EXPORT std::vector<std::vector<std::string>> RunMultiBinPSI(const std::vector<std::vector<std::string>> &bin_inputs,
+                                                               const std::vector<size_t> &bin_ids,
+                                                               const std::string &comm_role,
+                                                               const std::string &target_server_name,
+                                                               size_t thread_num,
+                                                               size_t concurrent_bin_num = kDefaultConcurrentBinNum);
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
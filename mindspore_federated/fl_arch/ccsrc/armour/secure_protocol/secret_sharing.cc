@@ -15,6 +15,8 @@
  */
 
 #include "armour/secure_protocol/secret_sharing.h"
+#include <atomic>
+#include "common/parallel_for.h"
 
 namespace mindspore {
 namespace fl {
@@ -247,6 +249,155 @@ int SecretSharing::Combine(size_t k, const std::vector<Share *> &shares, uint8_t
   FreeBNVector(nums);
   return ret;
 }
+
+bool SecretSharing::LagrangeCoefficients(const std::vector<unsigned int> &indices, BN_MONT_CTX *mont, BN_CTX *ctx,
+                                         std::vector<BIGNUM *> *coefficients) {
+  size_t k = indices.size();
+  std::vector<BIGNUM *> x(k, nullptr);
+  std::vector<BIGNUM *> nums(k, nullptr);
+  std::vector<BIGNUM *> denses(k, nullptr);
+  // prefix[j] is the product of denses[0..j], so all the denses are inverted with one modular inversion.
+  std::vector<BIGNUM *> prefix(k, nullptr);
+  BIGNUM *tmp = BN_new();
+  BIGNUM *inv = BN_new();
+  bool ret = tmp != nullptr && inv != nullptr;
+  for (size_t i = 0; ret && i < k; i++) {
+    x[i] = BN_new();
+    nums[i] = BN_new();
+    denses[i] = BN_new();
+    prefix[i] = BN_new();
+    ret = x[i] != nullptr && nums[i] != nullptr && denses[i] != nullptr && prefix[i] != nullptr &&
+          BN_set_word(x[i], indices[i]) == 1;
+  }
+  for (size_t j = 0; ret && j < k; j++) {
+    ret = BN_one(nums[j]) == 1 && BN_one(denses[j]) == 1;
+    for (size_t m = 0; ret && m < k; m++) {
+      if (m != j) {
+        ret = LagrangeCal(nums[j], x[m], x[j], denses[j], tmp, ctx) == 0;
+      }
+    }
+    if (ret) {
+      ret = j == 0 ? BN_copy(prefix[j], denses[j]) != nullptr : field_mult(prefix[j], prefix[j - 1], denses[j], ctx);
+    }
+  }
+  // the denses are zero if the indices are duplicated.
+  if (ret && BN_mod_inverse(inv, prefix[k - 1], this->bn_prim_, ctx) == nullptr) {
+    MS_LOG(ERROR) << "the share indices are invalid for lagrange interpolation";
+    ret = false;
+  }
+  coefficients->assign(k, nullptr);
+  for (size_t j = k; ret && j > 0; j--) {
+    size_t i = j - 1;
+    // inv is the inverse of prefix[i] now.
+    BIGNUM *coefficient = BN_new();
+    coefficients->at(i) = coefficient;
+    ret = coefficient != nullptr;
+    if (ret && i > 0) {
+      ret = field_mult(tmp, inv, prefix[i - 1], ctx) && field_mult(inv, inv, denses[i], ctx);
+    } else if (ret) {
+      ret = BN_copy(tmp, inv) != nullptr;
+    }
+    // the field operations may leave negative remainders, the montgomery form requires [0, prime).
+    ret = ret && field_mult(coefficient, tmp, nums[i], ctx) && BN_nnmod(coefficient, coefficient, this->bn_prim_, ctx) &&
+          BN_to_montgomery(coefficient, coefficient, mont, ctx);
+  }
+  if (!ret) {
+    FreeBNVector(*coefficients);
+    coefficients->clear();
+  }
+  ReleaseNum(tmp);
+  ReleaseNum(inv);
+  FreeBNVector(x);
+  FreeBNVector(nums);
+  FreeBNVector(denses);
+  FreeBNVector(prefix);
+  return ret;
+}
+
+int SecretSharing::CombineBatch(size_t k, const std::vector<std::vector<Share *>> &shares_list,
+                                std::vector<std::vector<uint8_t>> *secrets) {
+  if (secrets == nullptr || k < 1 || this->bn_prim_ == nullptr) {
+    return -1;
+  }
+  for (const auto &shares : shares_list) {
+    if (shares.size() < k) {
+      return -1;
+    }
+    for (size_t i = 0; i < k; i++) {
+      if (shares[i] == nullptr || shares[i]->data == nullptr) {
+        return -1;
+      }
+    }
+  }
+  BN_CTX *ctx = BN_CTX_new();
+  BN_MONT_CTX *mont = BN_MONT_CTX_new();
+  if (ctx == nullptr || mont == nullptr || BN_MONT_CTX_set(mont, this->bn_prim_, ctx) != 1) {
+    MS_LOG(ERROR) << "new bn ctx failed";
+    BN_CTX_free(ctx);
+    BN_MONT_CTX_free(mont);
+    return -1;
+  }
+  // the lagrange coefficients of each set of share indices, and the coefficients used by each secret.
+  std::map<std::vector<unsigned int>, std::vector<BIGNUM *>> coefficient_sets;
+  std::vector<const std::vector<BIGNUM *> *> secret_coefficients(shares_list.size(), nullptr);
+  int ret = 0;
+  for (size_t i = 0; i < shares_list.size() && ret == 0; i++) {
+    std::vector<unsigned int> indices(k);
+    for (size_t j = 0; j < k; j++) {
+      indices[j] = shares_list[i][j]->index;
+    }
+    auto iter = coefficient_sets.find(indices);
+    if (iter == coefficient_sets.end()) {
+      std::vector<BIGNUM *> coefficients;
+      if (!LagrangeCoefficients(indices, mont, ctx, &coefficients)) {
+        ret = -1;
+        break;
+      }
+      iter = coefficient_sets.emplace(indices, coefficients).first;
+    }
+    secret_coefficients[i] = &iter->second;
+  }
+  BN_CTX_free(ctx);
+  std::atomic<bool> failed = ret != 0;
+  secrets->assign(shares_list.size(), {});
+  ParallelSync parallel_sync(0);
+  parallel_sync.parallel_for(0, failed ? 0 : shares_list.size(), 1, [&](size_t begin, size_t end) {
+    BN_CTX *local_ctx = BN_CTX_new();
+    BIGNUM *y = BN_new();
+    BIGNUM *term = BN_new();
+    BIGNUM *sum = BN_new();
+    bool ok = local_ctx != nullptr && y != nullptr && term != nullptr && sum != nullptr;
+    for (size_t i = begin; ok && i < end; i++) {
+      const auto &coefficients = *secret_coefficients[i];
+      ok = BN_set_word(sum, 0) == 1;
+      for (size_t j = 0; ok && j < k; j++) {
+        Share *share = shares_list[i][j];
+        ok = BN_bin2bn(share->data, SizeToInt(share->len), y) != nullptr &&
+             (BN_cmp(y, this->bn_prim_) < 0 || BN_mod(y, y, this->bn_prim_, local_ctx) == 1) &&
+             BN_mod_mul_montgomery(term, coefficients[j], y, mont, local_ctx) == 1 &&
+             BN_mod_add_quick(sum, sum, term, this->bn_prim_) == 1;
+      }
+      if (ok) {
+        auto &secret = secrets->at(i);
+        secret.resize(IntToSize(BN_num_bytes(sum)));
+        (void)BN_bn2bin(sum, secret.data());
+      }
+    }
+    if (!ok) {
+      MS_LOG(ERROR) << "combine secrets failed";
+      failed = true;
+    }
+    BN_CTX_free(local_ctx);
+    ReleaseNum(y);
+    ReleaseNum(term);
+    ReleaseNum(sum);
+  });
+  for (auto &item : coefficient_sets) {
+    FreeBNVector(item.second);
+  }
+  BN_MONT_CTX_free(mont);
+  return failed ? -1 : 0;
+}
 }  // namespace armour
 }  // namespace fl
 }  // namespace mindspore
@@ -16,6 +16,7 @@
 
 #ifndef MINDSPORE_SECRET_SHARING_H
 #define MINDSPORE_SECRET_SHARING_H
+#include <map>
 #include <string>
 #include <vector>
 #include "openssl/bn.h"
@@ -43,6 +44,10 @@ class SecretSharing {
   int Split(int n, const int k, const char *secret, size_t length, const std::vector<Share *> &shares);
   // reconstruct the secret from multiple shares
   int Combine(size_t k, const std::vector<Share *> &shares, uint8_t *secret, size_t *length);
+  // reconstruct the secrets of shares_list in parallel, each from its first k shares. The lagrange coefficients are
+  // computed once for each set of share indices, and applied by montgomery multiplication.
+  int CombineBatch(size_t k, const std::vector<std::vector<Share *>> &shares_list,
+                   std::vector<std::vector<uint8_t>> *secrets);
   int CheckShares(Share *share_i, BIGNUM *x_i, BIGNUM *y_i, BIGNUM *denses_i, BIGNUM *nums_i);
   int CheckSum(BIGNUM *sum) const;
   int LagrangeCal(BIGNUM *nums_j, BIGNUM *x_m, BIGNUM *x_j, BIGNUM *denses_j, BIGNUM *tmp, BN_CTX *ctx);
@@ -60,6 +65,9 @@ class SecretSharing {
   // convert secret sharing from Share type to BIGNUM type
   bool GetShare(BIGNUM *x, BIGNUM *share, Share *s_share);
   void FreeBNVector(std::vector<BIGNUM *> bns);
+  // compute the lagrange coefficients at 0 of the share indices, in montgomery form.
+  bool LagrangeCoefficients(const std::vector<unsigned int> &indices, BN_MONT_CTX *mont, BN_CTX *ctx,
+                            std::vector<BIGNUM *> *coefficients);
 };
 }  // namespace armour
 }  // namespace fl
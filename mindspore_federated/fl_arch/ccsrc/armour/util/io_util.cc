@@ -119,15 +119,9 @@ void Recv(BobPb *bob_p_b) {
   std::string bin_array = ReadBinFile("bob_p_b");
   datajoin::BobPbProto bob_p_b_proto;
   bob_p_b_proto.ParseFromArray(bin_array.data(), static_cast<int>(bin_array.size()));
-  bob_p_b->set_bin_id(bob_p_b_proto.bin_id());
-  std::vector<std::string> p_b_vct;
-  int p_b_vct_size = bob_p_b_proto.p_b_vct_size();
-  for (int i = 0; i < p_b_vct_size; i++) {
-    p_b_vct.push_back(bob_p_b_proto.p_b_vct(i));
-  }
-  bob_p_b->set_p_b_vct(p_b_vct);
+  *bob_p_b = ParseBobPbProto(bob_p_b_proto);
   MS_LOG(INFO) << "bob_p_b, bin_id is " << bob_p_b->bin_id();
-  MS_LOG(INFO) << "bob_p_b size is " << bob_p_b->p_b_vct().size();
+  MS_LOG(INFO) << "bob_p_b size is " << bob_p_b->p_b_buf().size();
 }
 
 bool Send(const AlicePbaAndBF &alice_pba_bf) {
@@ -149,16 +143,9 @@ void Recv(AlicePbaAndBF *alice_p_b_a_bf) {
   std::string bin_array = ReadBinFile("alice_pba_bf");
   datajoin::AlicePbaAndBFProto alice_p_b_a_bf_proto;
   alice_p_b_a_bf_proto.ParseFromArray(bin_array.data(), static_cast<int>(bin_array.size()));
-  alice_p_b_a_bf->set_bin_id(alice_p_b_a_bf_proto.bin_id());
-  std::vector<std::string> p_b_vct;
-  int p_b_a_vct_size = alice_p_b_a_bf_proto.p_b_a_vct_size();
-  for (int i = 0; i < p_b_a_vct_size; i++) {
-    p_b_vct.push_back(alice_p_b_a_bf_proto.p_b_a_vct(i));
-  }
-  alice_p_b_a_bf->set_p_b_a_vct(p_b_vct);
-  alice_p_b_a_bf->set_bf_alice(alice_p_b_a_bf_proto.bf_alice());
+  *alice_p_b_a_bf = ParseAlicePbaAndBFProto(alice_p_b_a_bf_proto);
   MS_LOG(INFO) << "alice_pba_bf, bin_id is " << alice_p_b_a_bf->bin_id();
-  MS_LOG(INFO) << "alice_p_b_a size is " << alice_p_b_a_bf->p_b_a_vct().size();
+  MS_LOG(INFO) << "alice_p_b_a size is " << alice_p_b_a_bf->p_b_a_buf().size();
   MS_LOG(INFO) << "bf_alice byte length is " << alice_p_b_a_bf->bf_alice().size();
 }
 
@@ -23,9 +23,11 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "armour/base_crypto/bloom_filter.h"
+#include "armour/base_crypto/point_buffer.h"
 #include "common/utils/log_adapter.h"
 #include "common/protos/data_join.pb.h"
 
@@ -92,19 +94,19 @@ struct BobPb {
  public:
   ~BobPb() = default;
   BobPb() = default;
-  BobPb(const size_t &bin_id, const std::vector<std::string> &p_b_vct) : bin_id_(bin_id), p_b_vct_(p_b_vct) {}
+  BobPb(const size_t &bin_id, PointBuffer p_b_buf) : bin_id_(bin_id), p_b_buf_(std::move(p_b_buf)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_p_b_vct(const std::vector<std::string> &p_b_vct) { p_b_vct_ = p_b_vct; }
-  std::vector<std::string> p_b_vct() const { return p_b_vct_; }
+  void set_p_b_buf(PointBuffer p_b_buf) { p_b_buf_ = std::move(p_b_buf); }
+  const PointBuffer &p_b_buf() const { return p_b_buf_; }
 
-  void set_empty() { std::vector<std::string>().swap(p_b_vct_); }
+  void set_empty() { p_b_buf_.set_empty(); }
 
  private:
   size_t bin_id_ = 0;
-  std::vector<std::string> p_b_vct_;
+  PointBuffer p_b_buf_;
 };
 
 bool Send(const BobPb &bob_p_b);
@@ -115,26 +117,26 @@ struct AlicePbaAndBF {
  public:
   ~AlicePbaAndBF() = default;
   AlicePbaAndBF() = default;
-  AlicePbaAndBF(const size_t &bin_id, const std::vector<std::string> &p_b_a_vct, const std::string &bf_alice)
-      : bin_id_(bin_id), p_b_a_vct_(p_b_a_vct), bf_alice_(bf_alice) {}
+  AlicePbaAndBF(const size_t &bin_id, PointBuffer p_b_a_buf, const std::string &bf_alice)
+      : bin_id_(bin_id), p_b_a_buf_(std::move(p_b_a_buf)), bf_alice_(bf_alice) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_p_b_a_vct(const std::vector<std::string> &p_b_a_vct) { p_b_a_vct_ = p_b_a_vct; }
-  std::vector<std::string> p_b_a_vct() const { return p_b_a_vct_; }
+  void set_p_b_a_buf(PointBuffer p_b_a_buf) { p_b_a_buf_ = std::move(p_b_a_buf); }
+  const PointBuffer &p_b_a_buf() const { return p_b_a_buf_; }
 
   void set_bf_alice(const std::string &bf_alice) { bf_alice_ = bf_alice; }
-  std::string bf_alice() const { return bf_alice_; }
+  const std::string &bf_alice() const { return bf_alice_; }
 
   void set_empty() {
-    std::vector<std::string>().swap(p_b_a_vct_);
+    p_b_a_buf_.set_empty();
     std::string().swap(bf_alice_);
   }
 
  private:
   size_t bin_id_ = 0;
-  std::vector<std::string> p_b_a_vct_;
+  PointBuffer p_b_a_buf_;
   std::string bf_alice_;
 };
 
@@ -221,6 +223,29 @@ struct PlainData {
   std::vector<std::string> plain_data_vct_;
   std::string msg_;
 };
+
+// The input size of each bucket of the streaming mode, exchanged by the parties before the buckets.
+struct StreamBucketSizes {
+ public:
+  ~StreamBucketSizes() = default;
+  StreamBucketSizes() = default;
+  StreamBucketSizes(const size_t &bin_id, const std::string &self_role, const std::vector<size_t> &sizes)
+      : bin_id_(bin_id), self_role_(self_role), sizes_(sizes) {}
+
+  void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
+  size_t bin_id() const { return bin_id_; }
+
+  void set_self_role(const std::string &self_role) { self_role_ = self_role; }
+  const std::string &self_role() const { return self_role_; }
+
+  void set_sizes(const std::vector<size_t> &sizes) { sizes_ = sizes; }
+  const std::vector<size_t> &sizes() const { return sizes_; }
+
+ private:
+  size_t bin_id_ = 0;
+  std::string self_role_ = "alice";
+  std::vector<size_t> sizes_;
+};
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
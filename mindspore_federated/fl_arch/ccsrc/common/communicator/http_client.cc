@@ -24,6 +24,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -32,6 +33,13 @@
 
 namespace mindspore {
 namespace fl {
+namespace {
+// Releases the data of an asynchronous request once libevent has sent it or freed the request.
+void ReleaseAsyncRequestData(const void *, size_t, void *owner) {
+  delete reinterpret_cast<std::shared_ptr<std::vector<uint8_t>> *>(owner);
+}
+}  // namespace
+
 HttpClient::HttpClient(const std::string &remote_server_address)
     : remote_server_address_(std::move(remote_server_address)),
       event_base_(nullptr),
@@ -42,22 +50,34 @@ HttpClient::HttpClient(const std::string &remote_server_address)
       response_track_(nullptr) {}
 
 HttpClient::~HttpClient() {
-  if (buffer_event_) {
-    bufferevent_free(buffer_event_);
-    buffer_event_ = nullptr;
-  }
+  StopAsyncLoop();
+  // The connection owns the buffer event it's created on.
   if (evhttp_conn_) {
     evhttp_connection_free(evhttp_conn_);
     evhttp_conn_ = nullptr;
+    buffer_event_ = nullptr;
+  }
+  if (buffer_event_) {
+    bufferevent_free(buffer_event_);
+    buffer_event_ = nullptr;
   }
   if (event_base_) {
     event_base_free(event_base_);
     event_base_ = nullptr;
   }
+  if (uri_) {
+    evhttp_uri_free(uri_);
+    uri_ = nullptr;
+  }
 }
 
 void HttpClient::Init() {
   std::lock_guard<std::mutex> lock(connection_mutex_);
+  if (evhttp_conn_) {
+    evhttp_connection_free(evhttp_conn_);
+    evhttp_conn_ = nullptr;
+    buffer_event_ = nullptr;
+  }
   if (buffer_event_) {
     bufferevent_free(buffer_event_);
     buffer_event_ = nullptr;
@@ -89,6 +109,9 @@ void HttpClient::Init() {
     MS_LOG(EXCEPTION) << "Buffer event enable read and write failed!";
   }
 
+  if (uri_) {
+    evhttp_uri_free(uri_);
+  }
   uri_ = evhttp_uri_parse(remote_server_address_.c_str());
   int port = evhttp_uri_get_port(uri_);
   if (port == -1) {
@@ -175,13 +198,9 @@ void HttpClient::ReadCallback(struct evhttp_request *http_req, void *const arg)
     case HTTP_OK: {
       struct evbuffer *evbuf = evhttp_request_get_input_buffer(http_req);
       MS_ERROR_IF_NULL_WO_RET_VAL(evbuf);
-      size_t length = evbuffer_get_length(evbuf);
-      MS_LOG(INFO) << "response message data length is:" << length;
-
-      auto response_msg = std::make_shared<std::vector<uint8_t>>(length);
-      int ret = memcpy_s(response_msg->data(), length, evbuffer_pullup(evbuf, -1), length);
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      MS_LOG(INFO) << "response message data length is:" << evbuffer_get_length(evbuf);
+      auto response_msg = ReadResponseMsg(http_req);
+      if (response_msg == nullptr) {
         return;
       }
       http_client->set_response_msg(response_msg);
@@ -198,6 +217,19 @@ void HttpClient::ReadCallback(struct evhttp_request *http_req, void *const arg)
   }
 }
 
+std::shared_ptr<std::vector<uint8_t>> HttpClient::ReadResponseMsg(struct evhttp_request *http_req) {
+  struct evbuffer *evbuf = evhttp_request_get_input_buffer(http_req);
+  MS_ERROR_IF_NULL_W_RET_VAL(evbuf, nullptr);
+  size_t length = evbuffer_get_length(evbuf);
+  auto response_msg = std::make_shared<std::vector<uint8_t>>(length);
+  // Copy the chained buffer out directly rather than making it contiguous first.
+  if (length > 0 && evbuffer_remove(evbuf, response_msg->data(), length) != static_cast<int>(length)) {
+    MS_LOG(ERROR) << "Read response message of length " << length << " failed.";
+    return nullptr;
+  }
+  return response_msg;
+}
+
 void HttpClient::OnReadHandler(const std::shared_ptr<ResponseTrack> &response_track, const std::string msg_type) {
   if (message_callback_ != nullptr) {
     message_callback_(response_track, msg_type);
@@ -288,6 +320,261 @@ bool HttpClient::SendMessage(const void *data, size_t data_size, const std::shar
   return true;
 }
 
+void HttpClient::set_max_connection_num(size_t max_connection_num) {
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  if (async_running_) {
+    MS_LOG(WARNING) << "The asynchronous connections to " << remote_server_address_ << " have been created.";
+    return;
+  }
+  max_connection_num_ = std::max<size_t>(max_connection_num, 1);
+}
+
+bool HttpClient::SendMessageAsync(const void *data, size_t data_size, const std::string &http_uri_path,
+                                  const std::string &target_msg_type, const std::string &message_source,
+                                  const std::string &message_offset, const std::string &content_type,
+                                  const OnResponse &on_response) {
+  MS_ERROR_IF_NULL_W_RET_VAL(data, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(on_response, false);
+  auto request = std::make_unique<AsyncRequest>();
+  auto data_ptr = reinterpret_cast<const uint8_t *>(data);
+  request->data = std::make_shared<std::vector<uint8_t>>(data_ptr, data_ptr + data_size);
+  request->http_uri_path = http_uri_path;
+  request->target_msg_type = target_msg_type;
+  request->message_source = message_source;
+  request->message_offset = message_offset;
+  request->content_type = content_type;
+  request->message_id =
+    message_source + ":" + target_msg_type + ":async:" + std::to_string(async_message_id_.fetch_add(1));
+  request->on_response = on_response;
+  MS_LOG(DEBUG) << "Send asynchronous message " << request->message_id << " of size " << data_size << " to "
+                << remote_server_address_;
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  if (!StartAsyncLoop()) {
+    return false;
+  }
+  submitted_requests_.emplace_back(std::move(request));
+  // The event is activated in the caller thread, the requests are sent in the async event loop.
+  event_active(async_dispatch_event_, EV_TIMEOUT, 0);
+  return true;
+}
+
+std::future<std::shared_ptr<std::vector<uint8_t>>> HttpClient::SendMessageAsync(
+  const void *data, size_t data_size, const std::string &http_uri_path, const std::string &target_msg_type,
+  const std::string &message_source, const std::string &message_offset, const std::string &content_type) {
+  auto promise = std::make_shared<std::promise<std::shared_ptr<std::vector<uint8_t>>>>();
+  auto future = promise->get_future();
+  auto on_response = [promise](const std::shared_ptr<std::vector<uint8_t>> &response_msg) {
+    promise->set_value(response_msg);
+  };
+  if (!SendMessageAsync(data, data_size, http_uri_path, target_msg_type, message_source, message_offset,
+                        content_type, on_response)) {
+    promise->set_value(nullptr);
+  }
+  return future;
+}
+
+bool HttpClient::StartAsyncLoop() {
+  if (async_running_) {
+    return true;
+  }
+  MS_ERROR_IF_NULL_W_RET_VAL(uri_, false);
+  if (async_event_base_ == nullptr) {
+    async_event_base_ = event_base_new();
+    MS_ERROR_IF_NULL_W_RET_VAL(async_event_base_, false);
+  }
+  if (async_dispatch_event_ == nullptr) {
+    async_dispatch_event_ = event_new(async_event_base_, -1, 0, AsyncDispatchCallback, this);
+    MS_ERROR_IF_NULL_W_RET_VAL(async_dispatch_event_, false);
+  }
+  async_connections_.clear();
+  for (size_t i = 0; i < max_connection_num_; i++) {
+    auto connection = std::make_unique<AsyncConnection>();
+    connection->client = this;
+    connection->closed = true;
+    async_connections_.emplace_back(std::move(connection));
+  }
+  async_running_ = true;
+  async_thread_ = std::thread([this]() {
+    MS_LOG(INFO) << "The asynchronous event loop of http client to " << remote_server_address_ << " starts.";
+    (void)event_base_loop(async_event_base_, EVLOOP_NO_EXIT_ON_EMPTY);
+    MS_LOG(INFO) << "The asynchronous event loop of http client to " << remote_server_address_ << " exits.";
+  });
+  return true;
+}
+
+void HttpClient::StopAsyncLoop() {
+  std::deque<std::unique_ptr<AsyncRequest>> failed_requests;
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!async_running_) {
+      return;
+    }
+    async_running_ = false;
+    (void)event_base_loopbreak(async_event_base_);
+  }
+  if (async_thread_.joinable()) {
+    async_thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    failed_requests.swap(submitted_requests_);
+  }
+  // The loop has exited, so the connections are released here and the unfinished requests are failed.
+  for (auto &connection : async_connections_) {
+    if (connection->evhttp_conn != nullptr) {
+      evhttp_connection_free(connection->evhttp_conn);
+      connection->evhttp_conn = nullptr;
+    }
+    if (connection->request != nullptr) {
+      failed_requests.emplace_back(std::move(connection->request));
+    }
+  }
+  for (auto &request : pending_requests_) {
+    failed_requests.emplace_back(std::move(request));
+  }
+  pending_requests_.clear();
+  async_connections_.clear();
+  event_free(async_dispatch_event_);
+  async_dispatch_event_ = nullptr;
+  event_base_free(async_event_base_);
+  async_event_base_ = nullptr;
+  for (const auto &request : failed_requests) {
+    MS_LOG(WARNING) << "The asynchronous message " << request->message_id << " is not sent for the client stopped.";
+    request->on_response(nullptr);
+  }
+}
+
+void HttpClient::AsyncDispatchCallback(evutil_socket_t, int16_t, void *arg) {
+  auto http_client = reinterpret_cast<HttpClient *>(arg);
+  MS_ERROR_IF_NULL_WO_RET_VAL(http_client);
+  {
+    std::lock_guard<std::mutex> lock(http_client->async_mutex_);
+    for (auto &request : http_client->submitted_requests_) {
+      http_client->pending_requests_.emplace_back(std::move(request));
+    }
+    http_client->submitted_requests_.clear();
+  }
+  http_client->DispatchAsyncRequests();
+}
+
+void HttpClient::DispatchAsyncRequests() {
+  for (auto &connection : async_connections_) {
+    if (pending_requests_.empty()) {
+      return;
+    }
+    if (connection->request != nullptr) {
+      continue;
+    }
+    if (connection->closed && !ResetAsyncConnection(connection.get())) {
+      continue;
+    }
+    auto request = std::move(pending_requests_.front());
+    pending_requests_.pop_front();
+    auto http_req = evhttp_request_new(AsyncReadCallback, connection.get());
+    if (http_req == nullptr) {
+      MS_LOG(ERROR) << "Create http request for asynchronous message " << request->message_id << " failed.";
+      request->on_response(nullptr);
+      continue;
+    }
+    if (!request->data->empty()) {
+      auto data_owner = new std::shared_ptr<std::vector<uint8_t>>(request->data);
+      if (evbuffer_add_reference(evhttp_request_get_output_buffer(http_req), request->data->data(),
+                                 request->data->size(), ReleaseAsyncRequestData, data_owner) != 0) {
+        delete data_owner;
+        MS_LOG(ERROR) << "Add the data of asynchronous message " << request->message_id << " failed.";
+        evhttp_request_free(http_req);
+        request->on_response(nullptr);
+        continue;
+      }
+    }
+    auto output_headers = evhttp_request_get_output_headers(http_req);
+    (void)evhttp_add_header(output_headers, "Content-Type", request->content_type.c_str());
+    (void)evhttp_add_header(output_headers, "Host", evhttp_uri_get_host(uri_));
+    (void)evhttp_add_header(output_headers, "Message-Type", request->target_msg_type.c_str());
+    (void)evhttp_add_header(output_headers, "Message-Source", request->message_source.c_str());
+    (void)evhttp_add_header(output_headers, "Message-Id", request->message_id.c_str());
+    (void)evhttp_add_header(output_headers, "Message-Offset", request->message_offset.c_str());
+    connection->request = std::move(request);
+    // The request is freed by libevent even if it fails.
+    if (evhttp_make_request(connection->evhttp_conn, http_req, EVHTTP_REQ_POST,
+                            connection->request->http_uri_path.c_str()) != 0) {
+      MS_LOG(ERROR) << "Make http request for asynchronous message " << connection->request->message_id << " failed.";
+      auto failed_request = std::move(connection->request);
+      connection->closed = true;
+      failed_request->on_response(nullptr);
+    }
+  }
+  if (!pending_requests_.empty()) {
+    MS_LOG(DEBUG) << pending_requests_.size() << " asynchronous messages are waiting for idle connections.";
+  }
+}
+
+bool HttpClient::ResetAsyncConnection(AsyncConnection *connection) {
+  MS_ERROR_IF_NULL_W_RET_VAL(connection, false);
+  // The closed connection is not in its callbacks now, since the dispatching runs in its own event.
+  if (connection->evhttp_conn != nullptr) {
+    evhttp_connection_free(connection->evhttp_conn);
+    connection->evhttp_conn = nullptr;
+  }
+  int port = evhttp_uri_get_port(uri_);
+  const char *host = evhttp_uri_get_host(uri_);
+  bufferevent *bev = nullptr;
+  if (FLContext::instance()->enable_ssl()) {
+    SSL *ssl = SSL_new(SSLClient::GetInstance().GetSSLCtx());
+    MS_ERROR_IF_NULL_W_RET_VAL(ssl, false);
+    bev = bufferevent_openssl_socket_new(async_event_base_, -1, ssl, BUFFEREVENT_SSL_CONNECTING,
+                                         BEV_OPT_CLOSE_ON_FREE | BEV_OPT_THREADSAFE);
+    MS_ERROR_IF_NULL_W_RET_VAL(bev, false);
+  }
+  // Without the buffer event given, libevent creates a plain socket one and reconnects it when needed.
+  connection->evhttp_conn = evhttp_connection_base_bufferevent_new(async_event_base_, nullptr, bev, host, port);
+  if (connection->evhttp_conn == nullptr) {
+    MS_LOG(ERROR) << "Create connection to " << remote_server_address_ << " failed.";
+    if (bev != nullptr) {
+      bufferevent_free(bev);
+    }
+    return false;
+  }
+  evhttp_connection_set_timeout(connection->evhttp_conn, kAsyncRequestTimeoutInSec);
+  evhttp_connection_set_closecb(connection->evhttp_conn, AsyncCloseCallback, connection);
+  connection->closed = false;
+  return true;
+}
+
+void HttpClient::AsyncReadCallback(struct evhttp_request *http_req, void *arg) {
+  auto connection = reinterpret_cast<AsyncConnection *>(arg);
+  MS_ERROR_IF_NULL_WO_RET_VAL(connection);
+  auto http_client = connection->client;
+  MS_ERROR_IF_NULL_WO_RET_VAL(http_client);
+  auto request = std::move(connection->request);
+  MS_ERROR_IF_NULL_WO_RET_VAL(request);
+  std::shared_ptr<std::vector<uint8_t>> response_msg = nullptr;
+  // The request is nullptr if the connection failed or timed out.
+  if (http_req == nullptr || evhttp_request_get_response_code(http_req) != HTTP_OK) {
+    MS_LOG(WARNING) << "The asynchronous message " << request->message_id << " to "
+                    << http_client->remote_server_address_ << " failed, response code is "
+                    << (http_req == nullptr ? 0 : evhttp_request_get_response_code(http_req));
+    connection->closed = true;
+  } else {
+    auto rsp_message_id = evhttp_find_header(evhttp_request_get_input_headers(http_req), "Message-Id");
+    if (rsp_message_id != nullptr && request->message_id != rsp_message_id) {
+      MS_LOG(WARNING) << "Response message id " << rsp_message_id << " is different from the expect message id "
+                      << request->message_id;
+    } else {
+      response_msg = ReadResponseMsg(http_req);
+    }
+  }
+  request->on_response(response_msg);
+  // Send the waiting requests in a new event, the connection can't be reset in its own callback.
+  event_active(http_client->async_dispatch_event_, EV_TIMEOUT, 0);
+}
+
+void HttpClient::AsyncCloseCallback(struct evhttp_connection *, void *arg) {
+  auto connection = reinterpret_cast<AsyncConnection *>(arg);
+  MS_ERROR_IF_NULL_WO_RET_VAL(connection);
+  connection->closed = true;
+}
+
 std::string HttpClient::CreateMessageId(const std::shared_ptr<ResponseTrack> &response_track,
                                         const std::string &target_msg_type, const std::string &message_source) {
   return message_source + ":" + target_msg_type + ":" + std::to_string(response_track->request_id());
@@ -26,7 +26,9 @@
 #include <event2/http_struct.h>
 #include <event2/keyvalq_struct.h>
 
+#include <deque>
 #include <functional>
+#include <future>
 #include <string>
 #include <memory>
 #include <vector>
@@ -45,6 +47,12 @@ namespace fl {
 #define HTTP_CONTENT_TYPE_FORM_DATA "multipart/form-data"
 #define HTTP_CONTENT_TYPE_TEXT_PLAIN "text/plain"
 
+// The default number of the keep-alive connections to the peer, which is the max number of the in-flight asynchronous
+// requests.
+constexpr size_t kDefaultAsyncConnectionNum = 4;
+// The timeout in seconds of the asynchronous requests.
+constexpr int kAsyncRequestTimeoutInSec = 60;
+
 class HttpClient {
  public:
   using OnConnected = std::function<void()>;
@@ -53,6 +61,9 @@ class HttpClient {
   using OnMessage =
     std::function<void(const std::shared_ptr<ResponseTrack> &response_track, const std::string &msg_type)>;
   using OnTimer = std::function<void()>;
+  // Called in the background event loop once the asynchronous request is done. The response message is nullptr if the
+  // request failed.
+  using OnResponse = std::function<void(const std::shared_ptr<std::vector<uint8_t>> &response_msg)>;
 
   explicit HttpClient(const std::string &http_server_address);
   virtual ~HttpClient();
@@ -67,6 +78,20 @@ class HttpClient {
   bool SendMessage(const void *data, size_t data_size, const std::shared_ptr<ResponseTrack> &response_track,
                    const std::string &http_uri_path, const std::string &message_type, const std::string &message_source,
                    const std::string &message_offset, const std::string &content_type);
+  // The asynchronous requests are sent by a background event loop over a pool of persistent HTTP/1.1 connections to
+  // the peer, so that several messages are in flight at the same time. The requests more than the connections are
+  // queued. The number of the connections should be set before the first asynchronous request.
+  void set_max_connection_num(size_t max_connection_num);
+  bool SendMessageAsync(const void *data, size_t data_size, const std::string &http_uri_path,
+                        const std::string &target_msg_type, const std::string &message_source,
+                        const std::string &message_offset, const std::string &content_type,
+                        const OnResponse &on_response);
+  std::future<std::shared_ptr<std::vector<uint8_t>>> SendMessageAsync(const void *data, size_t data_size,
+                                                                      const std::string &http_uri_path,
+                                                                      const std::string &target_msg_type,
+                                                                      const std::string &message_source,
+                                                                      const std::string &message_offset,
+                                                                      const std::string &content_type);
   event_base *get_event_base() const;
   bool BreakLoopEvent();
   void set_response_track(const std::shared_ptr<ResponseTrack> &response_track);
@@ -89,6 +114,35 @@ class HttpClient {
   std::string PeerRoleName() const;
 
  private:
+  struct AsyncRequest {
+    // Shared with the output buffer of the http request, which references the data instead of copying it.
+    std::shared_ptr<std::vector<uint8_t>> data;
+    std::string http_uri_path;
+    std::string target_msg_type;
+    std::string message_source;
+    std::string message_offset;
+    std::string content_type;
+    std::string message_id;
+    OnResponse on_response;
+  };
+  struct AsyncConnection {
+    HttpClient *client = nullptr;
+    evhttp_connection *evhttp_conn = nullptr;
+    // The request being sent on this connection, nullptr if the connection is idle.
+    std::unique_ptr<AsyncRequest> request = nullptr;
+    // The connection is closed by the peer or failed, it's created again before sending the next request.
+    bool closed = false;
+  };
+
+  static std::shared_ptr<std::vector<uint8_t>> ReadResponseMsg(struct evhttp_request *http_req);
+  bool StartAsyncLoop();
+  void StopAsyncLoop();
+  static void AsyncDispatchCallback(evutil_socket_t, int16_t, void *arg);
+  static void AsyncReadCallback(struct evhttp_request *http_req, void *arg);
+  static void AsyncCloseCallback(struct evhttp_connection *evhttp_conn, void *arg);
+  void DispatchAsyncRequests();
+  bool ResetAsyncConnection(AsyncConnection *connection);
+
   OnMessage message_callback_;
 
   OnConnected connected_callback_;
@@ -111,6 +165,19 @@ class HttpClient {
   std::shared_ptr<ResponseTrack> response_track_;
   std::shared_ptr<std::vector<uint8_t>> response_msg_;
   std::string message_id_;
+
+  size_t max_connection_num_ = kDefaultAsyncConnectionNum;
+  std::mutex async_mutex_;
+  bool async_running_ = false;
+  std::atomic<uint64_t> async_message_id_ = 0;
+  event_base *async_event_base_ = nullptr;
+  event *async_dispatch_event_ = nullptr;
+  std::thread async_thread_;
+  // The requests submitted by the callers, guarded by async_mutex_.
+  std::deque<std::unique_ptr<AsyncRequest>> submitted_requests_;
+  // The requests waiting for an idle connection, and the connections, accessed in the async event loop only.
+  std::deque<std::unique_ptr<AsyncRequest>> pending_requests_;
+  std::vector<std::unique_ptr<AsyncConnection>> async_connections_;
 };
 }  // namespace fl
 }  // namespace mindspore
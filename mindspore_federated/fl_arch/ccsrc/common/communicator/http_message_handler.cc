@@ -25,6 +25,7 @@
 #include <cstring>
 #include <string>
 #include <functional>
+#include <memory>
 
 namespace mindspore {
 namespace fl {
@@ -326,6 +327,27 @@ void HttpMessageHandler::set_http_base(const struct event_base *base) {
   event_base_ = const_cast<event_base *>(base);
 }
 
+bool HttpMessageHandler::RunInEventLoop(std::function<void()> &&task) {
+  MS_EXCEPTION_IF_NULL(event_base_);
+  auto task_ptr = new std::function<void()>(std::move(task));
+  auto run_task = [](evutil_socket_t, std::int16_t, void *arg) {
+    std::unique_ptr<std::function<void()>> func(reinterpret_cast<std::function<void()> *>(arg));
+    try {
+      (*func)();
+    } catch (const std::exception &e) {
+      MS_LOG(ERROR) << "Catch exception when running task in event loop: " << e.what();
+    }
+  };
+  struct timeval tv = {0, 0};
+  // The event base is created with the pthread lock, so event_base_once wakes up the event loop from other threads.
+  if (event_base_once(event_base_, -1, EV_TIMEOUT, run_task, task_ptr, &tv) != 0) {
+    MS_LOG(WARNING) << "Add task to the event loop failed.";
+    delete task_ptr;
+    return false;
+  }
+  return true;
+}
+
 void HttpMessageHandler::set_request(const struct evhttp_request *req) {
   MS_EXCEPTION_IF_NULL(req);
   event_request_ = const_cast<evhttp_request *>(req);
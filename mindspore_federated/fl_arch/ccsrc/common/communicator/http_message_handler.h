@@ -106,6 +106,9 @@ class HttpMessageHandler {
   uint64_t content_len() const;
   const event_base *http_base() const;
   void set_http_base(const struct event_base *base);
+  // Run the task in the thread of the event base which received this request. The evhttp request is not thread-safe,
+  // so the response of a request which is responded after the request callback has returned should be sent by this.
+  bool RunInEventLoop(std::function<void()> &&task);
   void set_request(const struct evhttp_request *req);
   const struct evhttp_request *request() const;
   void InitBodySize();
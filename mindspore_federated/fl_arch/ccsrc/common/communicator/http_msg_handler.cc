@@ -15,6 +15,7 @@
  */
 
 #include "common/communicator/http_msg_handler.h"
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -67,5 +68,10 @@ bool HttpMsgHandler::SendResponseInference(const void *data, const size_t &len,
   has_sent_response_ = true;
   return true;
 }
+
+bool HttpMsgHandler::RunInResponseThread(std::function<void()> &&task) {
+  MS_ERROR_IF_NULL_W_RET_VAL(http_msg_, false);
+  return http_msg_->RunInEventLoop(std::move(task));
+}
 }  // namespace fl
 }  // namespace mindspore
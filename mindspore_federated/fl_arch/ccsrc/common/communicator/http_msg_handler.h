@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_FL_COMMUNICATOR_HTTP_MSG_HANDLER_H_
 #define MINDSPORE_CCSRC_FL_COMMUNICATOR_HTTP_MSG_HANDLER_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include "common/communicator/http_message_handler.h"
@@ -41,6 +42,7 @@ class HttpMsgHandler : public MessageHandler {
   bool SendResponse(const void *data, const size_t &len) override;
   bool SendResponse(const void *data, const size_t &len, const std::string &message_id) override;
   bool SendResponseInference(const void *data, const size_t &len, RefBufferRelCallback cb) override;
+  bool RunInResponseThread(std::function<void()> &&task) override;
 
  private:
   std::shared_ptr<HttpMessageHandler> http_msg_;
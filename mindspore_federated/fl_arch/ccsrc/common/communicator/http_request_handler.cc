@@ -63,6 +63,7 @@ bool HttpRequestHandler::Initialize(int fd, const std::unordered_map<std::string
         auto httpReq = std::make_shared<HttpMessageHandler>();
         MS_EXCEPTION_IF_NULL(httpReq);
         httpReq->set_request(req);
+        httpReq->set_http_base(evhttp_connection_get_base(evhttp_request_get_connection(req)));
         httpReq->InitHttpMessage();
         OnRequestReceive *func = reinterpret_cast<OnRequestReceive *>(arg);
         MS_EXCEPTION_IF_NULL(func);
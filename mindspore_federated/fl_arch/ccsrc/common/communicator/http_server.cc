@@ -17,6 +17,8 @@
 #include "common/communicator/http_server.h"
 #include <arpa/inet.h>
 #include <event.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include <cstdlib>
 #include <cstring>
@@ -41,19 +43,50 @@ bool HttpServer::InitServer() {
     return false;
   }
 
-  fd_ = ::socket(static_cast<int>(AF_INET), static_cast<int>(SOCK_STREAM), 0);
-  if (fd_ < 0) {
+  reuse_port_ = FLContext::instance()->http_server_reuse_port();
+  if (!reuse_port_) {
+    fd_ = CreateListenSocket(false);
+    return fd_ >= 0;
+  }
+  MS_LOG(INFO) << "Each of the " << thread_num_ << " http server threads listens on its own socket.";
+  MS_LOG(WARNING) << "The http server listens on " << server_address_ << ":" << server_port_
+                  << " with SO_REUSEPORT, any other process of the same user, such as a stale or duplicate server, can "
+                     "bind the same port silently and take a part of the connections.";
+  for (size_t i = 0; i < thread_num_; i++) {
+    int fd = CreateListenSocket(true);
+    if (fd < 0) {
+      for (auto item : reuse_port_fds_) {
+        close(item);
+      }
+      reuse_port_fds_.clear();
+      return false;
+    }
+    reuse_port_fds_.push_back(fd);
+  }
+  return true;
+}
+
+int HttpServer::CreateListenSocket(bool reuse_port) {
+  int fd = ::socket(static_cast<int>(AF_INET), static_cast<int>(SOCK_STREAM), 0);
+  if (fd < 0) {
     MS_LOG(ERROR) << "Socker error!";
-    return false;
+    return -1;
   }
 
   int one = 1;
-  result = setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char *>(&one), sizeof(int));
+  int result = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char *>(&one), sizeof(int));
   if (result < 0) {
     MS_LOG(ERROR) << "Set sock opt error!";
-    close(fd_);
-    fd_ = -1;
-    return false;
+    close(fd);
+    return -1;
+  }
+  if (reuse_port) {
+    result = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<char *>(&one), sizeof(int));
+    if (result < 0) {
+      MS_LOG(ERROR) << "Set sock opt SO_REUSEPORT error!";
+      close(fd);
+      return -1;
+    }
   }
 
   struct sockaddr_in addr;
@@ -66,33 +99,54 @@ bool HttpServer::InitServer() {
   addr.sin_addr.s_addr = inet_addr(server_address_.c_str());
   addr.sin_port = htons(server_port_);
 
-  result = ::bind(fd_, (struct sockaddr *)&addr, sizeof(addr));
+  result = ::bind(fd, (struct sockaddr *)&addr, sizeof(addr));
   if (result < 0) {
     MS_LOG(ERROR) << "Bind ip:" << server_address_ << " port:" << server_port_ << "failed!";
-    close(fd_);
-    fd_ = -1;
-    return false;
+    close(fd);
+    return -1;
   }
 
   MS_LOG(INFO) << "Bind ip:" << server_address_ << " port:" << server_port_ << " successful!";
 
-  result = ::listen(fd_, backlog_);
+  result = ::listen(fd, backlog_);
   if (result < 0) {
     MS_LOG(ERROR) << "Listen ip:" << server_address_ << " port:" << server_port_ << "failed!";
-    close(fd_);
-    fd_ = -1;
-    return false;
+    close(fd);
+    return -1;
   }
 
   int flags = 0;
-  if ((flags = fcntl(fd_, F_GETFL, 0)) < 0 || fcntl(fd_, F_SETFL, (unsigned int)flags | O_NONBLOCK) < 0) {
+  if ((flags = fcntl(fd, F_GETFL, 0)) < 0 || fcntl(fd, F_SETFL, (unsigned int)flags | O_NONBLOCK) < 0) {
     MS_LOG(ERROR) << "Set fcntl O_NONBLOCK failed!";
-    close(fd_);
-    fd_ = -1;
-    return false;
+    close(fd);
+    return -1;
   }
+  return fd;
+}
 
-  return true;
+void HttpServer::BindCpu(size_t thread_index) const {
+  cpu_set_t allowed_cpus;
+  CPU_ZERO(&allowed_cpus);
+  if (sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) != 0) {
+    MS_LOG(WARNING) << "Get the cpus allowed for the http server failed.";
+    return;
+  }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed_cpus)) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpus[thread_index % cpus.size()], &cpu_set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+    MS_LOG(WARNING) << "Bind http server thread " << thread_index << " to cpu " << cpus[thread_index % cpus.size()]
+                    << " failed.";
+  }
 }
 
 bool HttpServer::RegisterRoute(const std::string &url, OnRequestReceive *function) {
@@ -120,15 +174,22 @@ bool HttpServer::Start() {
     return false;
   }
   MS_LOG(INFO) << "Start http server!";
+  bool bind_cpu = FLContext::instance()->http_server_bind_cpu();
   for (size_t i = 0; i < thread_num_; i++) {
     auto http_request_handler = std::make_shared<HttpRequestHandler>();
     MS_EXCEPTION_IF_NULL(http_request_handler);
-    if (!http_request_handler->Initialize(fd_, request_handlers_)) {
+    int fd = reuse_port_ ? reuse_port_fds_[i] : fd_;
+    if (!http_request_handler->Initialize(fd, request_handlers_)) {
       MS_LOG(ERROR) << "Http initialize failed.";
       return false;
     }
     http_request_handlers.push_back(http_request_handler);
-    auto thread = std::make_shared<std::thread>(&HttpRequestHandler::Run, http_request_handler);
+    auto thread = std::make_shared<std::thread>([this, http_request_handler, bind_cpu, i]() {
+      if (bind_cpu) {
+        BindCpu(i);
+      }
+      http_request_handler->Run();
+    });
     MS_EXCEPTION_IF_NULL(thread);
     worker_threads_.emplace_back(thread);
   }
@@ -151,6 +212,10 @@ void HttpServer::Stop() {
     close(fd_);
     fd_ = -1;
   }
+  for (auto fd : reuse_port_fds_) {
+    close(fd);
+  }
+  reuse_port_fds_.clear();
   for (auto &worker_thread : worker_threads_) {
     if (worker_thread && worker_thread->joinable()) {
       worker_thread->join();
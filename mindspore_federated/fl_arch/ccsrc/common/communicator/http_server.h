@@ -69,8 +69,14 @@ class HttpServer {
   int32_t backlog_;
   std::unordered_map<std::string, OnRequestReceive *> request_handlers_;
   int fd_;
+  // In the reuse port mode, each thread accepts on its own SO_REUSEPORT socket so that the kernel balances the
+  // connections between the threads, instead of waking up all the threads sharing fd_.
+  bool reuse_port_ = false;
+  std::vector<int> reuse_port_fds_;
 
   bool InitServer();
+  int CreateListenSocket(bool reuse_port);
+  void BindCpu(size_t thread_index) const;
 };
 }  // namespace fl
 }  // namespace mindspore
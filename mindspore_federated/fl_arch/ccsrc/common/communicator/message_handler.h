@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_FL_COMMUNICATOR_MESSAGE_HANDLER_H_
 #define MINDSPORE_CCSRC_FL_COMMUNICATOR_MESSAGE_HANDLER_H_
 
+#include <functional>
 #include <string>
 #include "common/utils/log_adapter.h"
 
@@ -59,6 +60,12 @@ class MessageHandler {
     has_sent_response_ = true;
     return ret;
   }
+  // Run the task in the thread which is allowed to send the response of this message. It's used to respond the message
+  // after the message callback has returned.
+  virtual bool RunInResponseThread(std::function<void()> &&task) {
+    task();
+    return true;
+  }
 
  protected:
   bool has_sent_response_ = false;
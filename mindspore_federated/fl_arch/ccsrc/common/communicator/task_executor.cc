@@ -36,6 +36,7 @@ TaskExecutor::TaskExecutor(size_t thread_num, size_t max_task_num, size_t submit
       auto task = task_queue_.front();
       task_queue_.pop();
       lock.unlock();
+      not_full_cv_.notify_one();
       task();
     }
   };
@@ -48,8 +49,12 @@ void TaskExecutor::Stop() {
   if (has_stopped_) {
     return;
   }
-  has_stopped_ = true;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    has_stopped_ = true;
+  }
   cv_.notify_all();
+  not_full_cv_.notify_all();
   for (auto &t : working_threads_) {
     if (t.joinable()) {
       t.join();
@@ -24,6 +24,7 @@
 #include <thread>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 
 #include "common/utils/log_adapter.h"
 #include "common/constants.h"
@@ -49,26 +50,22 @@ class TaskExecutor {
   // tasks until timeout.
   template <typename Fun, typename... Args>
   bool Submit(Fun &&function, Args &&...args) {
-    constexpr int64_t kSubmitTaskIntervalInMs = 1;
     auto callee = std::bind(function, args...);
     std::function<void()> task = [callee]() -> void { callee(); };
-    for (size_t i = 0; i < submit_timeout_; i++) {
-      std::unique_lock<std::mutex> lock(mtx_);
-      if (has_stopped_) {
-        MS_LOG(INFO) << "Submit task failed, task executor has stopped";
-        return false;
-      }
-      if (task_queue_.size() < max_task_num_) {
-        task_queue_.push(task);
-        lock.unlock();
-        cv_.notify_all();
-        return true;
-      }
-      lock.unlock();
-      std::this_thread::sleep_for(std::chrono::milliseconds(kSubmitTaskIntervalInMs));
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto can_submit = [this] { return has_stopped_.load() || task_queue_.size() < max_task_num_; };
+    if (!not_full_cv_.wait_for(lock, std::chrono::milliseconds(submit_timeout_), can_submit)) {
+      MS_LOG(WARNING) << "Submit task failed after " << submit_timeout_ << " ms.";
+      return false;
     }
-    MS_LOG(WARNING) << "Submit task failed after " << submit_timeout_ << " ms.";
-    return false;
+    if (has_stopped_) {
+      MS_LOG(INFO) << "Submit task failed, task executor has stopped";
+      return false;
+    }
+    task_queue_.push(std::move(task));
+    lock.unlock();
+    cv_.notify_one();
+    return true;
   }
 
   void Stop();
@@ -86,6 +83,8 @@ class TaskExecutor {
 
   std::mutex mtx_;
   std::condition_variable cv_;
+  // notified when a task is taken out of the queue, the blocked Submit calls wait on it
+  std::condition_variable not_full_cv_;
 
   std::vector<std::thread> working_threads_;
   std::queue<std::function<void()>> task_queue_;
@@ -274,7 +274,8 @@ bool TcpClient::Start(uint64_t timeout_in_seconds) {
 
 void TcpClient::SetMessageCallback(const TcpMessageHandler::MessageHandleFun &cb) { message_handler_.SetCallback(cb); }
 
-bool TcpClient::SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size) {
+bool TcpClient::SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size,
+                            const std::shared_ptr<const void> &data_owner) {
   if (buffer_event_ == nullptr) {
     MS_LOG(ERROR) << "Event buffer not inited!";
     return false;
@@ -284,26 +285,7 @@ bool TcpClient::SendMessage(const MessageMeta &meta, const Protos &protos, const
     return false;
   }
   bufferevent_lock(buffer_event_);
-  bool res = true;
-
-  const std::string &meta_str = meta.SerializeAsString();
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta_str.size());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta_str.data(), meta_str.size()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = TcpMessageHandler::WriteMessage(buffer_event_, meta, protos, data, size, data_owner);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     MS_LOG(ERROR) << "Bufferevent flush failed!";
@@ -83,7 +83,9 @@ class TcpClient {
   void Stop();
   bool Start(uint64_t timeout_in_seconds);
   void SetMessageCallback(const TcpMessageHandler::MessageHandleFun &cb);
-  bool SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size);
+  // If data_owner is not nullptr, the data is sent without copy and must not be modified until data_owner is released.
+  bool SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size,
+                   const std::shared_ptr<const void> &data_owner = nullptr);
   bool connected() const { return connected_; }
 
  protected:
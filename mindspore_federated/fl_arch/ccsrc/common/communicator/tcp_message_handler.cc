@@ -18,6 +18,47 @@
 
 namespace mindspore {
 namespace fl {
+namespace {
+void ReleaseDataOwner(const void *, size_t, void *extra) { delete static_cast<std::shared_ptr<const void> *>(extra); }
+}  // namespace
+
+bool TcpMessageHandler::WriteMessage(struct bufferevent *bev, const MessageMeta &meta, const Protos &protos,
+                                     const void *data, size_t size, const std::shared_ptr<const void> &data_owner) {
+  if (bev == nullptr || data == nullptr) {
+    return false;
+  }
+  const std::string &meta_str = meta.SerializeAsString();
+  MessageHeader header;
+  header.message_proto_ = protos;
+  header.message_meta_length_ = SizeToUint(meta_str.size());
+  header.message_length_ = size + header.message_meta_length_;
+
+  bool res = true;
+  if (bufferevent_write(bev, &header, sizeof(header)) == -1) {
+    MS_LOG(ERROR) << "Event buffer add header failed!";
+    res = false;
+  }
+  if (bufferevent_write(bev, meta_str.data(), meta_str.size()) == -1) {
+    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
+    res = false;
+  }
+  if (data_owner == nullptr) {
+    if (bufferevent_write(bev, data, size) == -1) {
+      MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
+      res = false;
+    }
+    return res;
+  }
+  // The holder is released by libevent through ReleaseDataOwner once the referenced data has been drained.
+  auto holder = new std::shared_ptr<const void>(data_owner);
+  if (evbuffer_add_reference(bufferevent_get_output(bev), data, size, ReleaseDataOwner, holder) == -1) {
+    delete holder;
+    MS_LOG(ERROR) << "Event buffer add data reference failed!";
+    res = false;
+  }
+  return res;
+}
+
 void TcpMessageHandler::ReceiveMessage(const ReadBufferFun &read_fun) {
   while (true) {
     bool end_read = false;
@@ -17,6 +17,9 @@
 #ifndef MINDSPORE_CCSRC_FL_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 #define MINDSPORE_CCSRC_FL_COMMUNICATOR_TCP_MESSAGE_HANDLER_H_
 
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+
 #include <functional>
 #include <iostream>
 #include <string>
@@ -41,6 +44,12 @@ class TcpMessageHandler {
   using ReadBufferFun = std::function<size_t(void *, size_t max_size)>;
   void ReceiveMessage(const ReadBufferFun &read_fun);
 
+  // Write the header, meta and data of a message to the output buffer of bev, which should be locked by the caller.
+  // If data_owner is not nullptr, the data is added by reference instead of being copied, and data_owner is held
+  // until the data has been written to the socket.
+  static bool WriteMessage(struct bufferevent *bev, const MessageMeta &meta, const Protos &protos, const void *data,
+                           size_t size, const std::shared_ptr<const void> &data_owner);
+
  private:
   size_t cur_header_len_ = 0;
   size_t cur_meta_len_ = 0;
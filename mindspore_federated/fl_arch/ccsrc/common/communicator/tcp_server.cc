@@ -55,29 +55,12 @@ const TcpServer *TcpConnection::GetServer() const { return server_; }
 
 const evutil_socket_t &TcpConnection::GetFd() const { return fd_; }
 
-bool TcpConnection::SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size) const {
+bool TcpConnection::SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size,
+                                const std::shared_ptr<const void> &data_owner) const {
   MS_EXCEPTION_IF_NULL(buffer_event_);
   MS_EXCEPTION_IF_NULL(data);
   bufferevent_lock(buffer_event_);
-  bool res = true;
-  std::string meta_data = meta.SerializeAsString();
-  MessageHeader header;
-  header.message_proto_ = protos;
-  header.message_meta_length_ = SizeToUint(meta_data.size());
-  header.message_length_ = size + header.message_meta_length_;
-
-  if (bufferevent_write(buffer_event_, &header, sizeof(header)) == -1) {
-    MS_LOG(ERROR) << "Event buffer add header failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, meta_data.data(), meta_data.size()) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
-  if (bufferevent_write(buffer_event_, data, size) == -1) {
-    MS_LOG(ERROR) << "Event buffer add protobuf data failed!";
-    res = false;
-  }
+  bool res = TcpMessageHandler::WriteMessage(buffer_event_, meta, protos, data, size, data_owner);
   int result = bufferevent_flush(buffer_event_, EV_READ | EV_WRITE, BEV_FLUSH);
   if (result < 0) {
     bufferevent_unlock(buffer_event_);
@@ -421,10 +404,10 @@ void TcpServer::SetTcpNoDelay(const evutil_socket_t &fd) {
 }
 
 bool TcpServer::SendMessage(const std::shared_ptr<TcpConnection> &conn, const MessageMeta &meta, const Protos &protos,
-                            const void *data, size_t size) {
+                            const void *data, size_t size, const std::shared_ptr<const void> &data_owner) {
   MS_EXCEPTION_IF_NULL(conn);
   MS_EXCEPTION_IF_NULL(data);
-  return conn->SendMessage(meta, protos, data, size);
+  return conn->SendMessage(meta, protos, data, size, data_owner);
 }
 
 uint16_t TcpServer::BoundPort() const { return server_port_; }
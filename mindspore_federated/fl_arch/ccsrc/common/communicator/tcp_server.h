@@ -56,7 +56,9 @@ class TcpConnection {
   void OnReadHandler(const TcpMessageHandler::ReadBufferFun &read_fun);
   void InitConnection(const TcpMessageHandler::MessageHandleFun &callback);
   void SendMessage(const void *buffer, size_t num) const;
-  bool SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size) const;
+  // If data_owner is not nullptr, the data is sent without copy and must not be modified until data_owner is released.
+  bool SendMessage(const MessageMeta &meta, const Protos &protos, const void *data, size_t size,
+                   const std::shared_ptr<const void> &data_owner = nullptr) const;
   void SimpleResponse(const MessageMeta &meta);
   void ErrorResponse(const MessageMeta &meta, const std::string &error_msg);
 
@@ -93,7 +95,7 @@ class TcpServer {
   OnServerReceiveMessage GetServerReceive() const;
   void SetMessageCallback(const OnServerReceiveMessage &cb);
   bool SendMessage(const std::shared_ptr<TcpConnection> &conn, const MessageMeta &meta, const Protos &protos,
-                   const void *data, size_t sizee);
+                   const void *data, size_t sizee, const std::shared_ptr<const void> &data_owner = nullptr);
   uint16_t BoundPort() const;
   std::string BoundIp() const;
   uint64_t ConnectionNum() const;
@@ -116,6 +116,11 @@ std::shared_ptr<ResponseTrack> AbstractNode::CollectiveSendAsync(const std::stri
   }
   auto request_track = AddMessageTrack(1, nullptr);
   message_meta.set_request_id(request_track->request_id());
+  // The data is copied instead of being referenced by a data_owner, and the copy is what makes the sends in flight safe.
+  // The pipelined ring AllReduce keeps up to kRingMaxInflightSends sends unacknowledged while it keeps reducing the
+  // received sub-chunks into the same buffer. It also returns early when a receive or Wait times out, after which the
+  // caller may free or overwrite the buffer while the sends are still queued in the output buffer. So every collective
+  // chunk is still copied here.
   auto ret = client->SendMessage(message_meta, Protos::RAW, data, size);
   if (!ret) {
     return nullptr;
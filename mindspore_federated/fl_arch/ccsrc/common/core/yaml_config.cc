@@ -49,6 +49,10 @@ void YamlConfig::InitCommonConfig() {
   Get("fl_iteration_num", SET_INT_CXT(set_fl_iteration_num), true, CheckInt(1, UINT32_MAX, INC_BOTH));
   Get("server_mode", SET_STR_CXT(set_server_mode), true);
   Get("enable_ssl", SET_BOOL_CXT(set_enable_ssl), true);
+  Get("http_server_reuse_port", SET_BOOL_CXT(set_http_server_reuse_port), false);
+  Get("http_server_bind_cpu", SET_BOOL_CXT(set_http_server_bind_cpu), false);
+  Get("checkpoint_sync_interval", SET_INT_CXT(set_checkpoint_sync_interval), false,
+      CheckInt(1, UINT32_MAX, INC_BOTH));
   // multi aggregation algorithm
   InitAggregationConfig();
   // distributed cache
@@ -64,14 +68,23 @@ void YamlConfig::InitAggregationConfig() {
       {kFedAvgAggregation, kFedProxAggregation, kScaffoldAggregation, kFedNovaAggregation});
   Get("aggregation.iid_rate", &aggregation_config.iid_rate, false, CheckFloat(0, 1, INC_RIGHT));
   Get("aggregation.total_client_num", &aggregation_config.total_client_num, false, CheckInt(1, UINT32_MAX, INC_BOTH));
+  Get("aggregation.aggregation_shard_num", &aggregation_config.aggregation_shard_num, false,
+      CheckInt(1, kMaxAggregationShardNum, INC_BOTH));
+  Get("aggregation.all_reduce_bucket_size", &aggregation_config.all_reduce_bucket_size, false,
+      CheckInt(0, UINT32_MAX, INC_BOTH));
+  Get("aggregation.all_reduce_pipeline_chunk_size", &aggregation_config.all_reduce_pipeline_chunk_size, false,
+      CheckInt(0, UINT32_MAX, INC_BOTH));
   FLContext::instance()->set_aggregation_config(aggregation_config);
 }
 
 void YamlConfig::InitDistributedCacheConfig() {
   DistributedCacheConfig distributed_cache_config;
   Get("distributed_cache.type", &distributed_cache_config.type, false);
-  Get("distributed_cache.address", &distributed_cache_config.address, true);
   Get("distributed_cache.plugin_lib_path", &distributed_cache_config.plugin_lib_path, false);
+  // The in-process memory cache and the plugins do not need the address of redis.
+  bool need_address = distributed_cache_config.type != cache::kMemoryCacheType &&
+                      distributed_cache_config.plugin_lib_path.empty();
+  Get("distributed_cache.address", &distributed_cache_config.address, need_address);
   std::string prefix = "distributed_cache.";
   for (const auto &item : items_) {
     if (item.first.length() <= prefix.length() || item.first.substr(0, prefix.length()) != prefix) {
@@ -125,6 +138,7 @@ void YamlConfig::InitRoundConfig() {
       CheckInt(1, UINT32_MAX, INC_BOTH));
   Get("round.global_iteration_time_window", SET_INT_CXT(set_global_iteration_time_window), true,
       CheckInt(1, UINT32_MAX, INC_BOTH));
+  Get("round.long_poll_timeout", SET_INT_CXT(set_long_poll_timeout), false, CheckInt(0, UINT32_MAX, INC_BOTH));
 }
 
 void YamlConfig::InitSummaryConfig() {
@@ -190,11 +204,14 @@ void YamlConfig::InitCompressionConfig() {
   Get("compression.upload_sparse_rate", &compression_config.upload_sparse_rate, false, CheckFloat(0, 1, INC_RIGHT));
   Get("compression.download_compress_type", &compression_config.download_compress_type, false,
       {kNoCompressType, kQuant});
+  Get("compression.download_sparse_rate", &compression_config.download_sparse_rate, false,
+      CheckFloat(0, 1, INC_BOTH));  // [0, 1]
   FLContext::instance()->set_compression_config(compression_config);
 
   MS_LOG(INFO) << "upload_compress_type is " << compression_config.upload_compress_type << ", upload_sparse_rate is "
                << compression_config.upload_sparse_rate << ", download_compress_type is "
-               << compression_config.download_compress_type;
+               << compression_config.download_compress_type << ", download_sparse_rate is "
+               << compression_config.download_sparse_rate;
 }
 
 void YamlConfig::InitClientVerifyConfig() {
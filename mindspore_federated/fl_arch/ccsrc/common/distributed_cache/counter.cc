@@ -15,6 +15,9 @@
  */
 #include "distributed_cache/counter.h"
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 #include "common/common.h"
 #include "distributed_cache/distributed_cache.h"
 #include "distributed_cache/redis_keys.h"
@@ -148,20 +151,24 @@ bool Counter::Count(const std::string &name, bool *trigger_first, bool *trigger_
   auto &info = it->second;
   uint64_t new_count = 0;
   if (info.server_hash_) {
-    auto key = RedisKeys::GetInstance().CountPerServerHash(name);
-    uint64_t temp_value = 0;
-    auto ret = client->HIncr(key, Server::Instance().node_id(), &temp_value);
-    if (!ret.IsSuccess()) {
-      MS_LOG_WARNING << "Get hash count " << name << " failed";
+    auto server_map = Server::Instance().GetAllServers();
+    if (server_map.empty()) {
+      MS_LOG_WARNING << "Get servers from cache failed";
       return false;
     }
-    if (temp_value == 1) {
-      (void)client->Expire(key, Timer::iteration_expire_time_in_seconds());
-    }
-    if (!GetCountInner(client, name, &new_count)) {
+    std::vector<std::string> server_ids;
+    std::transform(server_map.begin(), server_map.end(), std::back_inserter(server_ids),
+                   [](const auto &item) { return item.first; });
+    // Increase the count of this server, sum up the counts of all servers and check the exited servers in one call.
+    auto key = RedisKeys::GetInstance().CountPerServerHash(name);
+    bool has_server_exit = false;
+    auto ret = client->HIncrAndSum(key, Server::Instance().node_id(), Timer::iteration_expire_time_in_seconds(),
+                                   server_ids, &new_count, &has_server_exit);
+    if (!ret.IsSuccess()) {
       MS_LOG_WARNING << "Get hash count " << name << " failed";
       return false;
     }
+    info.has_server_exit = has_server_exit;
   } else {
     auto key = RedisKeys::GetInstance().CountHash();
     auto ret = client->HIncr(key, name, &new_count);
@@ -14,7 +14,18 @@
  * limitations under the License.
  */
 #include "distributed_cache/distributed_cache.h"
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include "common/common.h"
+#include "common/fl_context.h"
+#include "distributed_cache/memory/memory_cache.h"
 #include "distributed_cache/redis/redis.h"
 #include "distributed_cache/redis_keys.h"
 #include "distributed_cache/instance_context.h"
@@ -28,7 +39,10 @@ bool DistributedCacheLoader::InitCacheImpl(const DistributedCacheConfig &cache_c
     MS_LOG_ERROR << "InitCacheImpl should not be init twice";
     return true;
   }
-  auto cache_impl = std::make_shared<RedisDistributedCache>();
+  auto cache_impl = CreateCacheImpl(cache_config);
+  if (cache_impl == nullptr) {
+    return false;
+  }
   constexpr int64_t cache_timeout_in_secs = 15 * 60;  // 15 min
   if (!cache_impl->Init(cache_config, cache_timeout_in_secs)) {
     return false;
@@ -37,6 +51,68 @@ bool DistributedCacheLoader::InitCacheImpl(const DistributedCacheConfig &cache_c
   return true;
 }
 
+std::shared_ptr<DistributedCacheBase> DistributedCacheLoader::CreateCacheImpl(const DistributedCacheConfig &cache_config) {
+  if (!cache_config.plugin_lib_path.empty()) {
+    if (plugin_handle_ == nullptr) {
+      plugin_handle_ = dlopen(cache_config.plugin_lib_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+    if (plugin_handle_ == nullptr) {
+      MS_LOG_ERROR << "Failed to load the distributed cache plugin " << cache_config.plugin_lib_path << ": "
+                   << dlerror();
+      return nullptr;
+    }
+    auto create_func = reinterpret_cast<CachePluginCreateFunc>(dlsym(plugin_handle_, kCachePluginCreateFunc));
+    if (create_func == nullptr) {
+      MS_LOG_ERROR << "Failed to find the function " << kCachePluginCreateFunc << " in the distributed cache plugin "
+                   << cache_config.plugin_lib_path;
+      return nullptr;
+    }
+    std::shared_ptr<DistributedCacheBase> cache_impl(create_func());
+    if (cache_impl == nullptr) {
+      MS_LOG_ERROR << "The distributed cache plugin " << cache_config.plugin_lib_path << " returns nullptr";
+    }
+    return cache_impl;
+  }
+  if (cache_config.type == kMemoryCacheType) {
+    if (!LockMemoryCache()) {
+      return nullptr;
+    }
+    return std::make_shared<MemoryDistributedCache>();
+  }
+  return std::make_shared<RedisDistributedCache>();
+}
+
+bool DistributedCacheLoader::LockMemoryCache() {
+  if (memory_cache_lock_fd_ >= 0) {
+    return true;
+  }
+  auto fl_name = FLContext::instance()->fl_name();
+  std::replace_if(
+    fl_name.begin(), fl_name.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+  const char *tmp_dir = std::getenv("TMPDIR");
+  std::string lock_path = std::string(tmp_dir != nullptr && tmp_dir[0] != '\0' ? tmp_dir : "/tmp") +
+                          "/mindspore_federated_" + fl_name + "_memory_cache.lock";
+  int fd = open(lock_path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG_ERROR << "Failed to open the lock file " << lock_path << " of the memory cache: " << strerror(errno);
+    return false;
+  }
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    auto lock_errno = errno;
+    (void)close(fd);
+    if (lock_errno == EWOULDBLOCK) {
+      MS_LOG_ERROR << "Another server of fl job " << FLContext::instance()->fl_name() << " is running with the "
+                   << "memory cache on this host. The memory cache only supports one server, please use redis or a "
+                   << "plugin for more servers.";
+    } else {
+      MS_LOG_ERROR << "Failed to lock the file " << lock_path << " of the memory cache: " << strerror(lock_errno);
+    }
+    return false;
+  }
+  memory_cache_lock_fd_ = fd;
+  return true;
+}
+
 std::shared_ptr<RedisClientBase> DistributedCacheLoader::GetOneClient() {
   if (cache_impl_ == nullptr) {
     MS_LOG_ERROR << "GetOneClient should called after InitCacheImpl";
@@ -137,6 +213,38 @@ CacheStatus RedisClientBase::Get(const std::string &key, uint64_t default_val, u
   }
   return kCacheSuccess;
 }
+
+CacheStatus RedisClientBase::HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                                         const std::vector<std::string> &known_fileds, uint64_t *total,
+                                         bool *has_unknown_filed) {
+  if (total == nullptr || has_unknown_filed == nullptr) {
+    return kCacheInnerErr;
+  }
+  uint64_t new_value = 0;
+  auto status = HIncr(key, filed, &new_value);
+  if (!status.IsSuccess()) {
+    return status;
+  }
+  if (new_value == 1) {
+    (void)Expire(key, expire_seconds);
+  }
+  std::unordered_map<std::string, uint64_t> items;
+  status = HGetAll(key, &items);
+  if (!status.IsSuccess()) {
+    return status;
+  }
+  uint64_t total_value = 0;
+  bool has_unknown = false;
+  for (auto &item : items) {
+    if (std::find(known_fileds.begin(), known_fileds.end(), item.first) == known_fileds.end()) {
+      has_unknown = true;
+    }
+    total_value += item.second;
+  }
+  *total = total_value;
+  *has_unknown_filed = has_unknown;
+  return kCacheSuccess;
+}
 }  // namespace cache
 }  // namespace fl
 }  // namespace mindspore
@@ -28,6 +28,9 @@
 namespace mindspore {
 namespace fl {
 namespace cache {
+// The distributed cache type of the in-process memory cache, the other types use redis.
+constexpr auto kMemoryCacheType = "memory";
+
 struct DistributedCacheConfig {
   std::string type;
   std::string address;
@@ -81,6 +84,12 @@ class RedisClientBase {
   CacheStatus HGet(const std::string &key, const std::string &filed, uint64_t default_val, uint64_t *value);
   // Get String value and parse to int64
   CacheStatus Get(const std::string &key, uint64_t default_val, uint64_t *value);
+  // Increase the hash filed by 1, set the expire time of the hash when the filed is new, then sum up all fileds of the
+  // hash and check whether there is any filed not in known_fileds. Implementations can override it to finish in one
+  // round trip, the default one calls HIncr, Expire and HGetAll in turn.
+  virtual CacheStatus HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                                  const std::vector<std::string> &known_fileds, uint64_t *total,
+                                  bool *has_unknown_filed);
 };
 
 class DistributedCacheBase {
@@ -94,6 +103,11 @@ class DistributedCacheBase {
   virtual void Clear() = 0;
 };
 
+// The plugin library set by plugin_lib_path should export the function with C linkage and this name, which creates an
+// object of its DistributedCacheBase implementation.
+constexpr auto kCachePluginCreateFunc = "CreateDistributedCache";
+using CachePluginCreateFunc = DistributedCacheBase *(*)();
+
 class DistributedCacheLoader {
  public:
   static DistributedCacheLoader &Instance() {
@@ -110,7 +124,16 @@ class DistributedCacheLoader {
   bool available() const { return available_; }
 
  private:
+  std::shared_ptr<DistributedCacheBase> CreateCacheImpl(const DistributedCacheConfig &cache_config);
+  // The memory cache is private to the process, so every other server would run with its own empty cache. The server
+  // holds a lock file of the fl job on the host, and a second server of the job with the memory cache fails to start.
+  bool LockMemoryCache();
+
   std::shared_ptr<DistributedCacheBase> cache_impl_ = nullptr;
+  // The plugin library is kept loaded till the process exits, the objects created by it may still be referenced.
+  void *plugin_handle_ = nullptr;
+  // The lock of the memory cache is released when the process exits.
+  int memory_cache_lock_fd_ = -1;
   bool available_ = true;
 };
 }  // namespace cache
@@ -63,6 +63,7 @@ DEFINE_HYPER_VAR(sign_dim_out)
 DEFINE_HYPER_VAR(upload_compress_type)
 DEFINE_HYPER_VAR(upload_sparse_rate)
 DEFINE_HYPER_VAR(download_compress_type)
+DEFINE_HYPER_VAR(download_sparse_rate)
 
 DEFINE_HYPER_VAR(enable_ssl)
 DEFINE_HYPER_VAR(pki_verify)
@@ -157,6 +158,7 @@ CacheStatus HyperParams::SyncLocal2Cache(const std::shared_ptr<RedisClientBase>
   obj[HYPER_VAR(upload_compress_type)] = compression_config.upload_compress_type;
   obj[HYPER_VAR(upload_sparse_rate)] = compression_config.upload_sparse_rate;
   obj[HYPER_VAR(download_compress_type)] = compression_config.download_compress_type;
+  obj[HYPER_VAR(download_sparse_rate)] = compression_config.download_sparse_rate;
 
   obj[HYPER_VAR(enable_ssl)] = context->enable_ssl();
   obj[HYPER_VAR(pki_verify)] = context->pki_verify();
@@ -227,6 +229,7 @@ CacheStatus HyperParams::SyncCache2Local(const std::shared_ptr<RedisClientBase>
     compression_config.upload_compress_type = obj[HYPER_VAR(upload_compress_type)];
     compression_config.upload_sparse_rate = obj[HYPER_VAR(upload_sparse_rate)];
     compression_config.download_compress_type = obj[HYPER_VAR(download_compress_type)];
+    compression_config.download_sparse_rate = obj[HYPER_VAR(download_sparse_rate)];
     context->set_compression_config(compression_config);
 
     auto bool_as_str = [](bool val) -> std::string { return val ? "true" : "false"; };
@@ -0,0 +1,377 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "distributed_cache/memory/memory_cache.h"
+#include <algorithm>
+#include "common/common.h"
+#include "distributed_cache/common.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+using Shard = MemoryCacheStore::Shard;
+using Value = MemoryCacheStore::Value;
+
+namespace {
+bool IsType(const Value *value, MemoryCacheStore::ValueType type) { return value == nullptr || value->type == type; }
+
+void SetExpire(Value *value, uint64_t seconds) {
+  value->has_expire = true;
+  value->expire_time = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+}
+
+// Increase the integer stored in the str by 1, as INCR and HINCRBY.
+CacheStatus IncrStr(std::string *str, uint64_t *new_value) {
+  uint64_t value = 0;
+  if (!str->empty() && !Str2Uint64(*str, &value)) {
+    return kCacheTypeErr;
+  }
+  value += 1;
+  *str = std::to_string(value);
+  if (new_value != nullptr) {
+    *new_value = value;
+  }
+  return kCacheSuccess;
+}
+}  // namespace
+
+void MemoryCacheStore::Sweep(Shard *shard, const TimePoint &now) {
+  for (auto it = shard->values.begin(); it != shard->values.end();) {
+    if (it->second.has_expire && it->second.expire_time <= now) {
+      it = shard->values.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+CacheStatus MemoryClient::Del(const std::vector<std::string> &keys) {
+  for (auto &key : keys) {
+    (void)store_->Access(key, true, [&key](Shard *shard, const Value *value) -> CacheStatus {
+      if (value != nullptr) {
+        (void)shard->values.erase(key);
+      }
+      return kCacheSuccess;
+    });
+  }
+  return kCacheSuccess;
+}
+
+CacheStatus MemoryClient::Expire(const std::string &key, uint64_t seconds) {
+  return store_->Access(key, true, [seconds](Shard *, Value *value) -> CacheStatus {
+    if (value != nullptr) {
+      SetExpire(value, seconds);
+    }
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::SAdd(const std::string &key, const std::string &member) {
+  return store_->Access(
+    key, true,
+    [&member](Shard *, Value *value) -> CacheStatus {
+      if (!IsType(value, MemoryCacheStore::kSet)) {
+        return kCacheTypeErr;
+      }
+      if (!value->set.insert(member).second) {
+        return kCacheExist;
+      }
+      return kCacheSuccess;
+    },
+    MemoryCacheStore::kSet);
+}
+
+CacheStatus MemoryClient::SIsMember(const std::string &key, const std::string &member, bool *value) {
+  MS_EXCEPTION_IF_NULL(value);
+  return store_->Access(key, false, [&member, value](Shard *, const Value *item) -> CacheStatus {
+    if (!IsType(item, MemoryCacheStore::kSet)) {
+      return kCacheTypeErr;
+    }
+    *value = item != nullptr && item->set.count(member) != 0;
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::SMembers(const std::string &key, std::vector<std::string> *members) {
+  MS_EXCEPTION_IF_NULL(members);
+  return store_->Access(key, false, [members](Shard *, const Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kSet)) {
+      return kCacheTypeErr;
+    }
+    members->clear();
+    if (value != nullptr) {
+      members->assign(value->set.begin(), value->set.end());
+    }
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::HExists(const std::string &key, const std::string &filed, bool *bool_value) {
+  MS_EXCEPTION_IF_NULL(bool_value);
+  return store_->Access(key, false, [&filed, bool_value](Shard *, const Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kHash)) {
+      return kCacheTypeErr;
+    }
+    *bool_value = value != nullptr && value->hash.count(filed) != 0;
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::HSet(const std::string &key, const std::string &filed, const std::string &value) {
+  return HMSet(key, std::unordered_map<std::string, std::string>({{filed, value}}));
+}
+
+CacheStatus MemoryClient::HSetNx(const std::string &key, const std::string &filed, const std::string &value) {
+  return store_->Access(
+    key, true,
+    [&filed, &value](Shard *, Value *item) -> CacheStatus {
+      if (!IsType(item, MemoryCacheStore::kHash)) {
+        return kCacheTypeErr;
+      }
+      if (!item->hash.emplace(filed, value).second) {
+        return kCacheExist;
+      }
+      return kCacheSuccess;
+    },
+    MemoryCacheStore::kHash);
+}
+
+CacheStatus MemoryClient::HMSet(const std::string &key, const std::unordered_map<std::string, std::string> &items) {
+  return store_->Access(
+    key, true,
+    [&items](Shard *, Value *value) -> CacheStatus {
+      if (!IsType(value, MemoryCacheStore::kHash)) {
+        return kCacheTypeErr;
+      }
+      for (auto &item : items) {
+        value->hash[item.first] = item.second;
+      }
+      return kCacheSuccess;
+    },
+    MemoryCacheStore::kHash);
+}
+
+CacheStatus MemoryClient::HGet(const std::string &key, const std::string &filed, std::string *value) {
+  MS_EXCEPTION_IF_NULL(value);
+  return store_->Access(key, false, [&filed, value](Shard *, const Value *item) -> CacheStatus {
+    if (!IsType(item, MemoryCacheStore::kHash)) {
+      return kCacheTypeErr;
+    }
+    if (item == nullptr) {
+      return kCacheNil;
+    }
+    auto it = item->hash.find(filed);
+    if (it == item->hash.end()) {
+      return kCacheNil;
+    }
+    *value = it->second;
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::HGetAll(const std::string &key, std::unordered_map<std::string, std::string> *items) {
+  MS_EXCEPTION_IF_NULL(items);
+  return store_->Access(key, false, [items](Shard *, const Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kHash)) {
+      return kCacheTypeErr;
+    }
+    items->clear();
+    if (value != nullptr) {
+      *items = value->hash;
+    }
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::HIncr(const std::string &key, const std::string &filed, uint64_t *new_value) {
+  return store_->Access(
+    key, true,
+    [&filed, new_value](Shard *, Value *value) -> CacheStatus {
+      if (!IsType(value, MemoryCacheStore::kHash)) {
+        return kCacheTypeErr;
+      }
+      return IncrStr(&value->hash[filed], new_value);
+    },
+    MemoryCacheStore::kHash);
+}
+
+CacheStatus MemoryClient::HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                                      const std::vector<std::string> &known_fileds, uint64_t *total,
+                                      bool *has_unknown_filed) {
+  MS_EXCEPTION_IF_NULL(total);
+  MS_EXCEPTION_IF_NULL(has_unknown_filed);
+  return store_->Access(
+    key, true,
+    [&](Shard *, Value *value) -> CacheStatus {
+      if (!IsType(value, MemoryCacheStore::kHash)) {
+        return kCacheTypeErr;
+      }
+      uint64_t new_value = 0;
+      auto status = IncrStr(&value->hash[filed], &new_value);
+      if (!status.IsSuccess()) {
+        return status;
+      }
+      if (new_value == 1) {
+        SetExpire(value, expire_seconds);
+      }
+      uint64_t total_value = 0;
+      bool has_unknown = false;
+      for (auto &item : value->hash) {
+        uint64_t item_value = 0;
+        if (!Str2Uint64(item.second, &item_value)) {
+          return kCacheTypeErr;
+        }
+        if (std::find(known_fileds.begin(), known_fileds.end(), item.first) == known_fileds.end()) {
+          has_unknown = true;
+        }
+        total_value += item_value;
+      }
+      *total = total_value;
+      *has_unknown_filed = has_unknown;
+      return kCacheSuccess;
+    },
+    MemoryCacheStore::kHash);
+}
+
+CacheStatus MemoryClient::HDel(const std::string &key, const std::string &filed) {
+  return store_->Access(key, true, [&key, &filed](Shard *shard, Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kHash)) {
+      return kCacheTypeErr;
+    }
+    if (value != nullptr) {
+      (void)value->hash.erase(filed);
+      if (value->hash.empty()) {
+        (void)shard->values.erase(key);
+      }
+    }
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::Get(const std::string &key, std::string *value) {
+  MS_EXCEPTION_IF_NULL(value);
+  return store_->Access(key, false, [value](Shard *, const Value *item) -> CacheStatus {
+    if (!IsType(item, MemoryCacheStore::kString)) {
+      return kCacheTypeErr;
+    }
+    if (item == nullptr) {
+      return kCacheNil;
+    }
+    *value = item->str;
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::SetString(const std::string &key, const std::string &value, bool has_expire,
+                                    uint64_t seconds, bool only_not_exist) {
+  return store_->Access(key, true, [&](Shard *shard, Value *item) -> CacheStatus {
+    if (item != nullptr && only_not_exist) {
+      return kCacheExist;
+    }
+    // SET overwrites the key whatever its type is, and clears its expire time.
+    auto &new_item = shard->values[key];
+    new_item = Value();
+    new_item.str = value;
+    if (has_expire) {
+      SetExpire(&new_item, seconds);
+    }
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::SetEx(const std::string &key, const std::string &value, uint64_t seconds) {
+  return SetString(key, value, true, seconds, false);
+}
+
+CacheStatus MemoryClient::SetNx(const std::string &key, const std::string &value) {
+  return SetString(key, value, false, 0, true);
+}
+
+CacheStatus MemoryClient::SetExNx(const std::string &key, const std::string &value, uint64_t seconds) {
+  return SetString(key, value, true, seconds, true);
+}
+
+CacheStatus MemoryClient::Incr(const std::string &key, uint64_t *new_value) {
+  return store_->Access(
+    key, true,
+    [new_value](Shard *, Value *value) -> CacheStatus {
+      if (!IsType(value, MemoryCacheStore::kString)) {
+        return kCacheTypeErr;
+      }
+      return IncrStr(&value->str, new_value);
+    },
+    MemoryCacheStore::kString);
+}
+
+CacheStatus MemoryClient::LPush(const std::string &key, const std::string &value) {
+  return store_->Access(
+    key, true,
+    [&value](Shard *, Value *item) -> CacheStatus {
+      if (!IsType(item, MemoryCacheStore::kList)) {
+        return kCacheTypeErr;
+      }
+      item->list.push_front(value);
+      return kCacheSuccess;
+    },
+    MemoryCacheStore::kList);
+}
+
+CacheStatus MemoryClient::LRange(const std::string &key, size_t start, size_t end, std::vector<std::string> *items) {
+  MS_EXCEPTION_IF_NULL(items);
+  return store_->Access(key, false, [start, end, items](Shard *, const Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kList)) {
+      return kCacheTypeErr;
+    }
+    items->clear();
+    // The end is inclusive as LRANGE.
+    if (value == nullptr || start > end || start >= value->list.size()) {
+      return kCacheSuccess;
+    }
+    // The end may be the max size_t to take the rest of the list, so end + 1 is not used if it's out of the list.
+    auto stop = end < value->list.size() ? end + 1 : value->list.size();
+    items->assign(value->list.begin() + start, value->list.begin() + stop);
+    return kCacheSuccess;
+  });
+}
+
+CacheStatus MemoryClient::LTrim(const std::string &key, size_t start, size_t end) {
+  return store_->Access(key, true, [&key, start, end](Shard *shard, Value *value) -> CacheStatus {
+    if (!IsType(value, MemoryCacheStore::kList)) {
+      return kCacheTypeErr;
+    }
+    if (value == nullptr) {
+      return kCacheSuccess;
+    }
+    auto &list = value->list;
+    if (start > end || start >= list.size()) {
+      (void)shard->values.erase(key);
+      return kCacheSuccess;
+    }
+    auto stop = end < list.size() ? end + 1 : list.size();
+    (void)list.erase(list.begin() + stop, list.end());
+    (void)list.erase(list.begin(), list.begin() + start);
+    return kCacheSuccess;
+  });
+}
+
+bool MemoryDistributedCache::Init(const DistributedCacheConfig &, int64_t) {
+  client_ = std::make_shared<MemoryClient>(std::make_shared<MemoryCacheStore>());
+  MS_LOG_INFO << "Use the in-process memory cache as the distributed cache, it's only visible to the current process";
+  return true;
+}
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
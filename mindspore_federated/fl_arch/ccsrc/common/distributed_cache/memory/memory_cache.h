@@ -0,0 +1,165 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_MEMORY_CACHE_H
+#define MINDSPORE_CCSRC_FL_MEMORY_CACHE_H
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "distributed_cache/cache_status.h"
+#include "distributed_cache/distributed_cache.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+// The keys are spread over the shards by hash, each shard has its own lock.
+constexpr size_t kMemoryCacheShardNum = 16;
+// The expired keys of a shard are removed every kMemoryCacheSweepInterval writes to the shard, besides being removed
+// lazily when they are accessed.
+constexpr size_t kMemoryCacheSweepInterval = 1024;
+
+// MemoryCacheStore keeps the keys in the memory of the current process, with the same string, hash, set, list and
+// expire semantics as redis. The compound operations, such as HIncrAndSum, run under the lock of the key's shard, so
+// they are atomic as the redis scripts.
+class MemoryCacheStore {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+  enum ValueType { kString, kHash, kSet, kList };
+  struct Value {
+    ValueType type = kString;
+    std::string str;
+    std::unordered_map<std::string, std::string> hash;
+    std::unordered_set<std::string> set;
+    std::deque<std::string> list;
+    bool has_expire = false;
+    TimePoint expire_time;
+  };
+  struct Shard {
+    std::mutex lock;
+    std::unordered_map<std::string, Value> values;
+    size_t write_count = 0;
+  };
+
+  MemoryCacheStore() = default;
+  ~MemoryCacheStore() = default;
+
+  // Run func with the value of the key under the lock of its shard. The value is nullptr if the key does not exist or
+  // has expired. If create_type is given as the type, a missing key is created with it.
+  template <typename Func>
+  CacheStatus Access(const std::string &key, bool is_write, const Func &func, int create_type = -1) {
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto now = std::chrono::steady_clock::now();
+    if (is_write && ++shard.write_count % kMemoryCacheSweepInterval == 0) {
+      Sweep(&shard, now);
+    }
+    Value *value = nullptr;
+    auto it = shard.values.find(key);
+    if (it != shard.values.end()) {
+      if (it->second.has_expire && it->second.expire_time <= now) {
+        (void)shard.values.erase(it);
+      } else {
+        value = &it->second;
+      }
+    }
+    if (value == nullptr && create_type >= 0) {
+      value = &shard.values[key];
+      value->type = static_cast<ValueType>(create_type);
+    }
+    return func(&shard, value);
+  }
+
+ private:
+  Shard &GetShard(const std::string &key) { return shards_[std::hash<std::string>()(key) % kMemoryCacheShardNum]; }
+  static void Sweep(Shard *shard, const TimePoint &now);
+
+  Shard shards_[kMemoryCacheShardNum];
+};
+
+class MemoryClient : public RedisClientBase {
+ public:
+  explicit MemoryClient(const std::shared_ptr<MemoryCacheStore> &store) : store_(store) {}
+  ~MemoryClient() override = default;
+
+  bool IsValid() override { return store_ != nullptr; }
+  void Disconnect() override {}
+  CacheStatus Connect(bool) override { return kCacheSuccess; }
+  CacheStatus Reconnect() override { return kCacheSuccess; }
+  // Del
+  CacheStatus Del(const std::vector<std::string> &keys) override;
+  // expire
+  CacheStatus Expire(const std::string &key, uint64_t seconds) override;
+  // set operator
+  CacheStatus SAdd(const std::string &key, const std::string &member) override;
+  CacheStatus SIsMember(const std::string &key, const std::string &member, bool *value) override;
+  CacheStatus SMembers(const std::string &key, std::vector<std::string> *members) override;
+  // hash operator
+  CacheStatus HExists(const std::string &key, const std::string &filed, bool *bool_value) override;
+  CacheStatus HSet(const std::string &key, const std::string &filed, const std::string &value) override;
+  CacheStatus HSetNx(const std::string &key, const std::string &filed, const std::string &value) override;
+  CacheStatus HMSet(const std::string &key, const std::unordered_map<std::string, std::string> &items) override;
+  CacheStatus HGet(const std::string &key, const std::string &filed, std::string *value) override;
+  CacheStatus HGetAll(const std::string &key, std::unordered_map<std::string, std::string> *items) override;
+  CacheStatus HIncr(const std::string &key, const std::string &filed, uint64_t *new_value) override;
+  CacheStatus HDel(const std::string &key, const std::string &filed) override;
+  CacheStatus HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                          const std::vector<std::string> &known_fileds, uint64_t *total,
+                          bool *has_unknown_filed) override;
+  // string operator
+  CacheStatus Get(const std::string &key, std::string *value) override;
+  CacheStatus SetEx(const std::string &key, const std::string &value, uint64_t seconds) override;
+  CacheStatus SetNx(const std::string &key, const std::string &value) override;
+  CacheStatus SetExNx(const std::string &key, const std::string &value, uint64_t seconds) override;
+  CacheStatus Incr(const std::string &key, uint64_t *new_value) override;
+  CacheStatus LPush(const std::string &key, const std::string &value) override;
+  CacheStatus LRange(const std::string &key, size_t start, size_t end, std::vector<std::string> *items) override;
+  CacheStatus LTrim(const std::string &key, size_t start, size_t end) override;
+
+ private:
+  CacheStatus SetString(const std::string &key, const std::string &value, bool has_expire, uint64_t seconds,
+                        bool only_not_exist);
+
+  std::shared_ptr<MemoryCacheStore> store_;
+};
+
+// MemoryDistributedCache is selected by the distributed cache type "memory". The cache is only visible to the current
+// process, so it serves a single server deployment or a local benchmark without a redis server, and the other roles,
+// such as the scheduler, cannot see the states of the server.
+class MemoryDistributedCache : public DistributedCacheBase {
+ public:
+  MemoryDistributedCache() = default;
+  ~MemoryDistributedCache() override = default;
+  bool Init(const DistributedCacheConfig &cache_config, int64_t timeout) override;
+  std::shared_ptr<RedisClientBase> GetOneClient() override { return client_; }
+  bool HasInvalid() const override { return false; }
+  CacheStatus RetryConnect() override { return kCacheSuccess; }
+  void Clear() override { client_ = nullptr; }
+
+ private:
+  // The client is thread safe, it's shared by all the callers.
+  std::shared_ptr<MemoryClient> client_ = nullptr;
+};
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_MEMORY_CACHE_H
@@ -135,6 +135,35 @@ bool RedisReply::GetArray(std::vector<std::string> *value) const {
   return true;
 }
 
+bool RedisReply::GetIntegerArray(std::vector<uint64_t> *value) const {
+  if (value == nullptr) {
+    return false;
+  }
+  if (redis_reply_ == nullptr) {
+    return false;
+  }
+  if (redis_reply_->type != REDIS_REPLY_ARRAY) {
+    MS_LOG(ERROR) << "Get array value failed, reply type " << redis_reply_->type << " is not array "
+                  << REDIS_REPLY_ARRAY;
+    return false;
+  }
+  value->clear();
+  for (size_t i = 0; i < redis_reply_->elements; i++) {
+    auto member = redis_reply_->element[i];
+    if (member == nullptr) {
+      MS_LOG(ERROR) << "Get array value failed, element cannot be nullptr";
+      return false;
+    }
+    if (member->type != REDIS_REPLY_INTEGER) {
+      MS_LOG(ERROR) << "Get array value failed, elements type should be integer " << REDIS_REPLY_INTEGER
+                    << ", member type: " << member->type;
+      return false;
+    }
+    value->push_back(static_cast<uint64_t>(member->integer));
+  }
+  return true;
+}
+
 bool RedisReply::GetMap(std::unordered_map<std::string, std::string> *value) const {
   if (value == nullptr) {
     return false;
@@ -329,20 +358,10 @@ RedisReply RedisClient::RunCommand(const std::vector<std::string> &args) {
 
 RedisReply RedisClient::Eval(const std::string &script, const std::vector<std::string> &keys,
                              const std::vector<std::string> &args) {
-  std::vector<const char *> argv;
-  argv.push_back(script.c_str());
-  std::transform(keys.begin(), keys.end(), std::back_inserter(argv),
-                 [](const std::string &item) { return item.c_str(); });
-  std::transform(args.begin(), args.end(), std::back_inserter(argv),
-                 [](const std::string &item) { return item.c_str(); });
-
-  std::vector<size_t> argvlen;
-  argvlen.push_back(script.size());
-  std::transform(keys.begin(), keys.end(), std::back_inserter(argvlen),
-                 [](const std::string &item) { return item.size(); });
-  std::transform(args.begin(), args.end(), std::back_inserter(argvlen),
-                 [](const std::string &item) { return item.size(); });
-  return RunCommand(static_cast<int>(argv.size()), argv.data(), argvlen.data());
+  std::vector<std::string> command = {"EVAL", script, std::to_string(keys.size())};
+  std::copy(keys.begin(), keys.end(), std::back_inserter(command));
+  std::copy(args.begin(), args.end(), std::back_inserter(command));
+  return RunCommand(command);
 }
 
 CacheStatus RedisClient::Del(const std::vector<std::string> &keys) {
@@ -513,6 +532,45 @@ CacheStatus RedisClient::HIncr(const std::string &key, const std::string &filed,
   return kCacheSuccess;
 }
 
+// KEYS[1]: the hash key, ARGV[1]: the filed to be increased, ARGV[2]: expire time in seconds, ARGV[3...]: the known
+// fileds. Returns {new value of the filed, sum of all fileds, 1 if any filed is not known else 0}.
+constexpr const char *kHIncrAndSumScript =
+  "local new_value = redis.call('HINCRBY', KEYS[1], ARGV[1], 1)\n"
+  "if new_value == 1 then redis.call('EXPIRE', KEYS[1], ARGV[2]) end\n"
+  "local known = {}\n"
+  "for i = 3, #ARGV do known[ARGV[i]] = true end\n"
+  "local items = redis.call('HGETALL', KEYS[1])\n"
+  "local total = 0\n"
+  "local has_unknown = 0\n"
+  "for i = 1, #items, 2 do\n"
+  "  total = total + tonumber(items[i + 1])\n"
+  "  if not known[items[i]] then has_unknown = 1 end\n"
+  "end\n"
+  "return {new_value, total, has_unknown}\n";
+
+CacheStatus RedisClient::HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                                     const std::vector<std::string> &known_fileds, uint64_t *total,
+                                     bool *has_unknown_filed) {
+  MS_EXCEPTION_IF_NULL(total);
+  MS_EXCEPTION_IF_NULL(has_unknown_filed);
+  std::vector<std::string> args = {filed, std::to_string(expire_seconds)};
+  std::copy(known_fileds.begin(), known_fileds.end(), std::back_inserter(args));
+  RedisReply reply = Eval(kHIncrAndSumScript, {key}, args);
+  if (!reply.IsValid()) {
+    MS_LOG(WARNING) << "Reply invalid: " << reply.GetError();
+    return kCacheNetErr;
+  }
+  constexpr size_t kHIncrAndSumRetNum = 3;
+  std::vector<uint64_t> ret_values;
+  if (!reply.GetIntegerArray(&ret_values) || ret_values.size() != kHIncrAndSumRetNum) {
+    MS_LOG(WARNING) << "Failed to call HIncrAndSum script " << key;
+    return kCacheInnerErr;
+  }
+  *total = ret_values[1];
+  *has_unknown_filed = (ret_values[2] != 0);
+  return kCacheSuccess;
+}
+
 CacheStatus RedisClient::HDel(const std::string &key, const std::string &filed) {
   RedisReply reply = RunCommand({"HDEL", key, filed});
   if (!reply.IsValid()) {
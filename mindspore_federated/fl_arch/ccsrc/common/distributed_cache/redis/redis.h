@@ -51,6 +51,7 @@ class RedisReply {
   bool GetInteger(uint64_t *value) const;
   bool GetString(std::string *value) const;
   bool GetArray(std::vector<std::string> *value) const;
+  bool GetIntegerArray(std::vector<uint64_t> *value) const;
   bool GetMap(std::unordered_map<std::string, std::string> *value) const;
 
   bool IsNil() const;
@@ -102,6 +103,9 @@ class RedisClient : public RedisClientBase {
   CacheStatus HGetAll(const std::string &key, std::unordered_map<std::string, std::string> *items) override;
   CacheStatus HIncr(const std::string &key, const std::string &filed, uint64_t *new_value) override;
   CacheStatus HDel(const std::string &key, const std::string &filed) override;
+  CacheStatus HIncrAndSum(const std::string &key, const std::string &filed, uint64_t expire_seconds,
+                          const std::vector<std::string> &known_fileds, uint64_t *total,
+                          bool *has_unknown_filed) override;
   //
   CacheStatus Get(const std::string &key, std::string *value) override;
   CacheStatus SetEx(const std::string &key, const std::string &value, uint64_t seconds) override;
@@ -116,8 +120,9 @@ class RedisClient : public RedisClientBase {
   CacheStatus ReconnectInner();
   RedisReply RunCommand(int argc, const char **argv, const size_t *argvlen);
   RedisReply RunCommand(const std::vector<std::string> &args);
-  RedisReply Eval(const std::string &script, const std::vector<std::string> &keys,
-                  const std::vector<std::string> &args);
+  // Run the lua script atomically on the server, it's virtual for the tests to fake the reply of the script.
+  virtual RedisReply Eval(const std::string &script, const std::vector<std::string> &keys,
+                          const std::vector<std::string> &args);
 
   bool IsUnixAddress(const std::string &server_address);
 
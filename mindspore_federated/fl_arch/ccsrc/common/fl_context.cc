@@ -287,6 +287,14 @@ bool FLContext::enable_ssl() const { return enable_ssl_; }
 
 void FLContext::set_enable_ssl(bool enabled) { enable_ssl_ = enabled; }
 
+bool FLContext::http_server_reuse_port() const { return http_server_reuse_port_; }
+
+void FLContext::set_http_server_reuse_port(bool reuse_port) { http_server_reuse_port_ = reuse_port; }
+
+bool FLContext::http_server_bind_cpu() const { return http_server_bind_cpu_; }
+
+void FLContext::set_http_server_bind_cpu(bool bind_cpu) { http_server_bind_cpu_ = bind_cpu; }
+
 std::string FLContext::client_password() const { return client_password_; }
 void FLContext::set_client_password(const std::string &password) { client_password_ = password; }
 
@@ -303,10 +311,18 @@ void FLContext::set_global_iteration_time_window(const uint64_t &global_iteratio
 
 uint64_t FLContext::global_iteration_time_window() const { return global_iteration_time_window_; }
 
+void FLContext::set_long_poll_timeout(uint64_t long_poll_timeout) { long_poll_timeout_ = long_poll_timeout; }
+
+uint64_t FLContext::long_poll_timeout() const { return long_poll_timeout_; }
+
 std::string FLContext::checkpoint_dir() const { return checkpoint_dir_; }
 
 void FLContext::set_checkpoint_dir(const std::string &checkpoint_dir) { checkpoint_dir_ = checkpoint_dir; }
 
+uint64_t FLContext::checkpoint_sync_interval() const { return checkpoint_sync_interval_; }
+
+void FLContext::set_checkpoint_sync_interval(uint64_t sync_interval) { checkpoint_sync_interval_ = sync_interval; }
+
 void FLContext::set_instance_name(const std::string &instance_name) { instance_name_ = instance_name; }
 
 const std::string &FLContext::instance_name() const { return instance_name_; }
@@ -42,6 +42,14 @@ struct AggregationConfig {
   std::string aggregation_type = kFedAvgAggregation;
   float iid_rate = 0.0f;
   size_t total_client_num = 1;
+  // Number of contiguous shards the aggregation buffer is split into, each guarded by its own lock, so that
+  // concurrent updateModel requests can accumulate in parallel. 1 means all updates are serialized.
+  size_t aggregation_shard_num = 1;
+  // Bytes of the buckets all the parameters are packed into for the cross-server allreduce. 0 means every parameter is
+  // allreduced separately.
+  size_t all_reduce_bucket_size = 0;
+  // Bytes of the sub-chunks the ring allreduce is pipelined with. 0 means each chunk is sent and reduced as a whole.
+  size_t all_reduce_pipeline_chunk_size = 0;
 };
 
 struct EncryptConfig {
@@ -70,6 +78,8 @@ struct CompressionConfig {
   std::string upload_compress_type = kNoCompressType;
   float upload_sparse_rate = 0.4f;
   std::string download_compress_type = kNoCompressType;
+  // The rate of the weight elements sent in the download delta, 0 means the delta download is disabled.
+  float download_sparse_rate = 0.0f;
 };
 
 struct SslConfig {
@@ -219,6 +229,11 @@ class MS_EXPORT FLContext {
   bool enable_ssl() const;
   void set_enable_ssl(bool enabled);
 
+  bool http_server_reuse_port() const;
+  void set_http_server_reuse_port(bool reuse_port);
+  bool http_server_bind_cpu() const;
+  void set_http_server_bind_cpu(bool bind_cpu);
+
   void set_ssl_config(const SslConfig &config);
   const SslConfig &ssl_config() const;
 
@@ -234,9 +249,15 @@ class MS_EXPORT FLContext {
   void set_global_iteration_time_window(const uint64_t &global_iteration_time_window);
   uint64_t global_iteration_time_window() const;
 
+  void set_long_poll_timeout(uint64_t long_poll_timeout);
+  uint64_t long_poll_timeout() const;
+
   std::string checkpoint_dir() const;
   void set_checkpoint_dir(const std::string &checkpoint_dir);
 
+  uint64_t checkpoint_sync_interval() const;
+  void set_checkpoint_sync_interval(uint64_t sync_interval);
+
   void set_instance_name(const std::string &instance_name);
   const std::string &instance_name() const;
 
@@ -333,6 +354,9 @@ class MS_EXPORT FLContext {
 
   // Whether to enable ssl for network communication.
   bool enable_ssl_ = false;
+  // Whether each http server thread listens on its own SO_REUSEPORT socket, and whether the threads are bound to cpus.
+  bool http_server_reuse_port_ = false;
+  bool http_server_bind_cpu_ = false;
   // Password used to decode p12 file.
   std::string client_password_;
   // Password used to decode p12 file.
@@ -343,6 +367,10 @@ class MS_EXPORT FLContext {
   // The time window of startFLJob round in millisecond.
   uint64_t global_iteration_time_window_ = 3600000;
 
+  // The max time in millisecond that getModel and pullWeight requests are parked on server waiting for the model. 0
+  // means the requests which are not ready are responded at once.
+  uint64_t long_poll_timeout_ = 0;
+
   // Hyper parameters for upload compression.
   std::string upload_compress_type_ = kNoCompressType;
   float upload_sparse_rate_ = 0.4f;
@@ -351,6 +379,8 @@ class MS_EXPORT FLContext {
 
   // directory of server checkpoint
   std::string checkpoint_dir_;
+  // the checkpoints of the model store are synced to disk every checkpoint_sync_interval_ iterations
+  uint64_t checkpoint_sync_interval_ = 10;
 
   // The name of instance
   std::string instance_name_;
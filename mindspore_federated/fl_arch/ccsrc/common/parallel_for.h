@@ -20,8 +20,12 @@
 #include <atomic>
 #include <algorithm>
 #include <memory>
+#include <exception>
+#include <thread>
+#include <mutex>
 
-#include "common/communicator/task_executor.h"
+#include "common/utils/log_adapter.h"
+#include "common/thread_pool.h"
 
 namespace mindspore {
 namespace fl {
@@ -32,9 +36,9 @@ const size_t CORE_THREAD_NUM = std::thread::hardware_concurrency();
 struct ParallelSync {
  public:
   explicit ParallelSync(size_t thread_num_input) {
-    size_t available_thread_num = CORE_THREAD_NUM - RESERVE_THREAD_NUM;
-    if (available_thread_num <= 0) {
-      available_thread_num = CORE_THREAD_NUM;
+    size_t available_thread_num = CORE_THREAD_NUM;
+    if (CORE_THREAD_NUM > RESERVE_THREAD_NUM) {
+      available_thread_num = CORE_THREAD_NUM - RESERVE_THREAD_NUM;
     }
     if (thread_num_input > 0 && thread_num_input <= CORE_THREAD_NUM) {
       thread_num_ = thread_num_input;
@@ -44,7 +48,6 @@ struct ParallelSync {
       MS_LOG(WARNING) << "Input thread num is non-available, use default: " << available_thread_num;
       thread_num_ = available_thread_num;
     }
-    executor_ = std::make_shared<TaskExecutor>(thread_num_);
   }
 
   template <class F>
@@ -62,28 +65,54 @@ struct ParallelSync {
     if (thread_num_ == 0) {
       MS_LOG(EXCEPTION) << "Thread num must be greater than zero.";
     }
-    size_t chunk_size = (end - begin - 1) / thread_num_ + 1;
+    // Split the range into more chunks than threads and let the threads claim them dynamically, so the threads which
+    // finish early take over the remaining work instead of waiting for the slow ones.
+    size_t worker_num = std::min(thread_num_, ThreadPool::Instance().worker_num() + 1);
+    size_t chunk_size = (end - begin - 1) / (worker_num * kChunkNumPerThread) + 1;
     chunk_size = std::max(static_cast<size_t>(grain_size), chunk_size);
     if (chunk_size == 0) {
       MS_LOG(EXCEPTION) << "Chunk size must be greater than zero.";
     }
     task_num_ = (end - begin - 1) / chunk_size + 1;
-    std::atomic<size_t> finish_count(0);
-
-    auto task = [&f, &begin, &end, &chunk_size, &finish_count](size_t task_id) {
-      size_t local_start = begin + task_id * chunk_size;
-      if (local_start < end) {
+    // The helper tasks may start after this call returns, so the state they touch is shared. They only call f after
+    // claiming a chunk, and the caller waits for all chunks to finish.
+    struct ChunkState {
+      explicit ChunkState(size_t chunk_num) : latch(chunk_num) {}
+      std::atomic<size_t> next_chunk = 0;
+      CompletionLatch latch;
+      std::mutex error_mtx;
+      std::exception_ptr error = nullptr;
+    };
+    auto state = std::make_shared<ChunkState>(task_num_);
+    auto run_chunks = [state, &f, begin, end, chunk_size, chunk_num = task_num_]() {
+      while (true) {
+        size_t chunk = state->next_chunk.fetch_add(1);
+        if (chunk >= chunk_num) {
+          return;
+        }
+        size_t local_start = begin + chunk * chunk_size;
         size_t local_end = std::min(end, local_start + chunk_size);
-        f(local_start, local_end);
-        finish_count++;
+        try {
+          f(local_start, local_end);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(state->error_mtx);
+          if (state->error == nullptr) {
+            state->error = std::current_exception();
+          }
+        }
+        state->latch.Count();
       }
     };
-    for (size_t i = 1; i < task_num_; ++i) {
-      executor_->Submit(task, i);
+    size_t helper_num = std::min(worker_num, task_num_) - 1;
+    for (size_t i = 0; i < helper_num; ++i) {
+      ThreadPool::Instance().Submit(run_chunks);
     }
-    task(0);
-    while (finish_count < task_num_) {
-      std::this_thread::yield();
+    // The caller runs chunks as well, so nested parallel_for calls from pool workers cannot deadlock.
+    run_chunks();
+    state->latch.Wait();
+    // rethrow the first exception thrown by f in the calling thread
+    if (state->error != nullptr) {
+      std::rethrow_exception(state->error);
     }
   }
 
@@ -94,8 +123,7 @@ struct ParallelSync {
  private:
   size_t thread_num_ = 1;
   size_t task_num_ = 1;
-
-  std::shared_ptr<TaskExecutor> executor_;
+  static constexpr size_t kChunkNumPerThread = 4;
 };
 
 }  // namespace fl
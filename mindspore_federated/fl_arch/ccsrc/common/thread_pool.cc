@@ -0,0 +1,113 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "common/thread_pool.h"
+#include <algorithm>
+#include <exception>
+#include "common/utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace {
+// The index of the pool worker running on the current thread, or kNotWorker for other threads.
+constexpr size_t kNotWorker = SIZE_MAX;
+thread_local size_t g_worker_index = kNotWorker;
+}  // namespace
+
+ThreadPool::ThreadPool() {
+  size_t worker_num = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  for (size_t i = 0; i < worker_num; i++) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < worker_num; i++) {
+    threads_.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    has_stopped_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto &t : threads_) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> &&task) {
+  size_t index = g_worker_index;
+  if (index == kNotWorker) {
+    index = next_worker_.fetch_add(1) % workers_.size();
+  }
+  {
+    // Increase before pushing so that the pending number never underflows, a worker waked up before the task is
+    // pushed just retries.
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    pending_task_num_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mtx);
+    workers_[index]->tasks.emplace_back(std::move(task));
+  }
+  sleep_cv_.notify_one();
+}
+
+bool ThreadPool::PopTask(size_t worker_index, std::function<void()> *task) {
+  {
+    auto &own = *workers_[worker_index];
+    std::lock_guard<std::mutex> lock(own.mtx);
+    if (!own.tasks.empty()) {
+      *task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); i++) {
+    auto &victim = *workers_[(worker_index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mtx);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(size_t worker_index) {
+  g_worker_index = worker_index;
+  while (true) {
+    std::function<void()> task;
+    if (PopTask(worker_index, &task)) {
+      pending_task_num_--;
+      try {
+        task();
+      } catch (const std::exception &e) {
+        MS_LOG(WARNING) << "Catch exception when running task in thread pool: " << e.what();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mtx_);
+    sleep_cv_.wait(lock, [this] { return has_stopped_ || pending_task_num_ > 0; });
+    if (has_stopped_) {
+      return;
+    }
+  }
+}
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_COMMON_THREAD_POOL_H
+#define MINDSPORE_FEDERATED_COMMON_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+// Blocks the waiting thread until Count has been called count times.
+class CompletionLatch {
+ public:
+  explicit CompletionLatch(size_t count) : count_(count) {}
+
+  void Count() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (count_ > 0 && --count_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return count_ == 0; });
+  }
+
+ private:
+  size_t count_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+// The process-wide pool shared by the compute workloads such as PSI, hashing and compression. Each worker owns a task
+// deque: it pops tasks from the back of its own deque and steals from the front of the others when its deque is empty.
+// Tasks submitted from a worker are pushed to that worker's deque, others are distributed in round robin.
+// The tasks should not block on IO, which should be handled by TaskExecutor instead.
+class ThreadPool {
+ public:
+  static ThreadPool &Instance() {
+    static ThreadPool instance;
+    return instance;
+  }
+
+  void Submit(std::function<void()> &&task);
+
+  size_t worker_num() const { return workers_.size(); }
+
+ private:
+  ThreadPool();
+  ~ThreadPool();
+
+  struct Worker {
+    std::mutex mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WorkerLoop(size_t worker_index);
+  bool PopTask(size_t worker_index, std::function<void()> *task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_worker_ = 0;
+  // The number of tasks which have been submitted but not popped, used to sleep the idle workers.
+  std::atomic<size_t> pending_task_num_ = 0;
+  std::mutex sleep_mtx_;
+  std::condition_variable sleep_cv_;
+  bool has_stopped_ = false;
+};
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_FEDERATED_COMMON_THREAD_POOL_H
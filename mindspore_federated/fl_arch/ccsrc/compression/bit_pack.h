@@ -25,50 +25,58 @@ namespace mindspore {
 namespace fl {
 namespace compression {
 
-std::vector<int> real_vec_to_binary_vec(const std::vector<int>& real_vec, size_t bit_num) {
-  std::vector<int> binary_vec;
-  binary_vec.resize(real_vec.size() * bit_num);
+// Packs the low bit_num bits of each value in order, the most significant bit first, into packed_data which must hold
+// bit_packed_size(size, bit_num) bytes. The bits are gathered in a 64-bit word and stored word by word.
+inline bool bit_pack(const int *real_data, size_t size, size_t bit_num, char *packed_data) {
+  if (bit_num == 0 || bit_num > kMaxPackBitNum) {
+    MS_LOG(ERROR) << "The bit_num should be in [1, " << kMaxPackBitNum << "], but got " << bit_num;
+    return false;
+  }
+  const uint64_t mask = (uint64_t{1} << bit_num) - 1;
   size_t index = 0;
-  for (const auto &real_data : real_vec) {
-    for (size_t j = 0; j < bit_num; ++j) {
-      binary_vec[index] = (real_data >> (bit_num - 1 - j)) & 1;
-      index++;
+  char *dst = packed_data;
+  // If bit_num divides the word length, each word holds a fixed number of values and the inner loop has no branch.
+  if (kBitWordLength % bit_num == 0) {
+    size_t value_num_per_word = kBitWordLength / bit_num;
+    for (; index + value_num_per_word <= size; index += value_num_per_word) {
+      uint64_t word = 0;
+      for (size_t j = 0; j < value_num_per_word; ++j) {
+        word = (word << bit_num) | (static_cast<uint64_t>(real_data[index + j]) & mask);
+      }
+      store_bit_word(word, dst);
+      dst += kBitWordBytes;
     }
   }
-  return binary_vec;
-}
-
-std::vector<char> binary_vec_to_int8_vec(std::vector<int>* binary_vec) {
-  size_t binary_vec_size = binary_vec->size();
-  size_t remainder = binary_vec_size % k8;
-  if (remainder > 0) {
-    auto zero_nums = k8 - remainder;
-    for (size_t i = 0; i < zero_nums; ++i) {
-      binary_vec->emplace_back(0);
+  uint64_t word = 0;
+  size_t filled_bits = 0;
+  for (; index < size; ++index) {
+    uint64_t value = static_cast<uint64_t>(real_data[index]) & mask;
+    if (filled_bits + bit_num < kBitWordLength) {
+      word = (word << bit_num) | value;
+      filled_bits += bit_num;
+      continue;
     }
-    MS_LOG(INFO) << "Add " << zero_nums << " zeros in fake binary vector is done.";
+    // The value crosses the word boundary: its high bits complete the current word and the rest starts the next one.
+    size_t rest_bits = filled_bits + bit_num - kBitWordLength;
+    word = (word << (bit_num - rest_bits)) | (value >> rest_bits);
+    store_bit_word(word, dst);
+    dst += kBitWordBytes;
+    word = value & ((uint64_t{1} << rest_bits) - 1);
+    filled_bits = rest_bits;
   }
-  std::vector<char> int8_vec(binary_vec->size() / k8);
-  size_t index = 0;
-  for (char & int8_data : int8_vec) {
-    int8_data = static_cast<char>(-k128 * (*binary_vec)[index] +
-                                  k64 * (*binary_vec)[index + 1] +
-                                  k32 * (*binary_vec)[index + 2] +
-                                  k16 * (*binary_vec)[index + 3] +
-                                  k8 * (*binary_vec)[index + 4] +
-                                  k4 * (*binary_vec)[index + 5] +
-                                  k2 * (*binary_vec)[index + 6] +
-                                  k1 * (*binary_vec)[index + 7]);
-    index += 8;
+  if (filled_bits > 0) {
+    char tail[kBitWordBytes];
+    store_bit_word(word << (kBitWordLength - filled_bits), tail);
+    (void)memcpy(dst, tail, (filled_bits + k8 - 1) / k8);
   }
-  return int8_vec;
+  return true;
 }
 
-std::vector<char> bit_pack(const std::vector<int>& real_vec, size_t bit_num) {
-  std::vector<int> binary_vec = real_vec_to_binary_vec(real_vec, bit_num);
-  MS_LOG(INFO) << "Convert real vector to fake binary vector is done, and the size of fake binary vector is: "
-               << binary_vec.size();
-  std::vector<char> int8_vec = binary_vec_to_int8_vec(&binary_vec);
+inline std::vector<char> bit_pack(const std::vector<int> &real_vec, size_t bit_num) {
+  std::vector<char> int8_vec(bit_packed_size(real_vec.size(), bit_num));
+  if (!bit_pack(real_vec.data(), real_vec.size(), bit_num, int8_vec.data())) {
+    return {};
+  }
   return int8_vec;
 }
 
@@ -109,11 +117,14 @@ MS_EXPORT TensorItemPy run_bit_pack(const std::vector<float>& real_vec, size_t b
   MS_LOG(INFO) << "Cast float input to int is done.";
 
   // bit packing
-  std::vector<char> int8_vec = bit_pack(int_vec, bit_num);
-  MS_LOG(INFO) << "bit_pack complete, the packed vector size is: " << int8_vec.size();
+  std::string raw_data(bit_packed_size(real_vec_size, bit_num), '\0');
+  if (!bit_pack(int_vec.data(), real_vec_size, bit_num, raw_data.data())) {
+    tensor_item_py.set_compress_type(kNoCompress);
+    return tensor_item_py;
+  }
+  MS_LOG(INFO) << "bit_pack complete, the packed vector size is: " << raw_data.size();
 
   // set information into tensor_item
-  std::string raw_data(int8_vec.data(), int8_vec.size());
   tensor_item_py.set_offset(offset);
   tensor_item_py.set_raw_data(raw_data);
   tensor_item_py.set_compress_type(kBitPack);
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_FL_COMPRESSION_BIT_UNPACK_H_
 #define MINDSPORE_CCSRC_FL_COMPRESSION_BIT_UNPACK_H_
 
+#include <algorithm>
 #include <vector>
 #include "compression/compress_common.h"
 
@@ -24,41 +25,37 @@ namespace mindspore {
 namespace fl {
 namespace compression {
 
-template <typename T>
-std::vector<int> int8_vec_to_binary_vec(const T& int8_vec) {
-  std::vector<int> binary_vec;
-  binary_vec.resize(int8_vec.size() * k8);
-  size_t index = 0;
-  for (const auto &int8_data : int8_vec) {
-    for (size_t j = 0; j < k8; ++j) {
-      binary_vec[index] = (int8_data >> (k7 - j)) & 1;
-      index++;
-    }
+// Unpacks size values of bit_num bits packed by bit_pack, the values are sign extended and passed to func(index, value).
+// The packed_data must hold bit_packed_size(size, bit_num) bytes. Each value is extracted from the 64-bit word loaded at
+// its first byte, so no value crosses the loaded word as bit_num is not larger than 32.
+template <typename F>
+bool bit_unpack(const char *packed_data, size_t packed_len, size_t size, size_t bit_num, F &&func) {
+  if (bit_num == 0 || bit_num > kMaxPackBitNum) {
+    MS_LOG(ERROR) << "The bit_num should be in [1, " << kMaxPackBitNum << "], but got " << bit_num;
+    return false;
   }
-  return binary_vec;
-}
-
-std::vector<int> binary_vec_to_real_vec(const std::vector<int>& binary_vec, size_t bit_num) {
-  std::vector<int> real_vec(binary_vec.size() / bit_num);
+  if (packed_len < bit_packed_size(size, bit_num)) {
+    MS_LOG(ERROR) << "The packed data size " << packed_len << " is not enough to be unpacked to " << size
+                  << " values of " << bit_num << " bits.";
+    return false;
+  }
+  const size_t value_shift = kBitWordLength - bit_num;
+  auto extract = [value_shift](uint64_t word, size_t bit_offset) {
+    return static_cast<int>(static_cast<int64_t>(word << bit_offset) >> value_shift);
+  };
   size_t index = 0;
-  for (int & real_data : real_vec) {
-    real_data = -(1 << (bit_num - 1)) * binary_vec[index];
-    index++;
-    for (size_t j = 1; j < bit_num; ++j) {
-      real_data += (1 << (bit_num - 1 - j)) * binary_vec[index];
-      index++;
-    }
+  size_t bit_pos = 0;
+  // The words can be loaded from the packed data directly unless they exceed its end.
+  for (; index < size && bit_pos / k8 + kBitWordBytes <= packed_len; ++index, bit_pos += bit_num) {
+    func(index, extract(load_bit_word(packed_data + bit_pos / k8), bit_pos % k8));
   }
-  return real_vec;
-}
-
-template <typename T>
-std::vector<int> bit_unpack(const T& int8_vec, size_t bit_num) {
-  std::vector<int> binary_vec = int8_vec_to_binary_vec(int8_vec);
-  MS_LOG(INFO) << "Convert packed vector to fake binary vector is done, and the size of fake binary vector is: "
-               << binary_vec.size();
-  std::vector<int> real_vec = binary_vec_to_real_vec(binary_vec, bit_num);
-  return real_vec;
+  for (; index < size; ++index, bit_pos += bit_num) {
+    char tail[kBitWordBytes] = {0};
+    size_t byte_pos = bit_pos / k8;
+    (void)memcpy(tail, packed_data + byte_pos, std::min(kBitWordBytes, packed_len - byte_pos));
+    func(index, extract(load_bit_word(tail), bit_pos % k8));
+  }
+  return true;
 }
 
 MS_EXPORT std::vector<float> run_bit_unpack(const TensorItemPy& tensor_item_py) {
@@ -66,21 +63,16 @@ MS_EXPORT std::vector<float> run_bit_unpack(const TensorItemPy& tensor_item_py)
   size_t bit_num = tensor_item_py.bit_num();
   float offset = tensor_item_py.offset();
   auto raw_data = tensor_item_py.raw_data();
-
-  // bit packing
-  std::vector<int> int_vec = bit_unpack(raw_data, bit_num);
-  MS_LOG(INFO) << "bit_unpack complete, the unpacked vector size is: " << int_vec.size();
-
-  // post process
   size_t size = tensor_item_py.size();
-  if (int_vec.size() < size) {
+
+  // bit unpacking and post process
+  std::vector<float> real_vec(size);
+  if (!bit_unpack(raw_data.data(), raw_data.size(), size, bit_num,
+                  [&real_vec, offset](size_t i, int value) { real_vec[i] = static_cast<float>(value) - offset; })) {
     MS_LOG(ERROR) << "input is not enough to be unpacked.";
     return {};
   }
-  std::vector<float> real_vec(size);
-  for (size_t i = 0; i < size; ++i) {
-    real_vec[i] = static_cast<float>(int_vec[i]) - offset;
-  }
+  MS_LOG(INFO) << "bit_unpack complete, the unpacked vector size is: " << real_vec.size();
   return real_vec;
 }
 
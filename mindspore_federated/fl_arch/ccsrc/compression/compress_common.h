@@ -20,6 +20,7 @@
 #include <cmath>
 #include <cfloat>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <vector>
@@ -43,10 +44,34 @@ const int k1 = 1;
 
 const float kEps = 1e-10f;
 
+// The bit packing works on 64-bit words, and the bit number of each value is in [1, kMaxPackBitNum].
+constexpr size_t kBitWordLength = 64;
+constexpr size_t kBitWordBytes = 8;
+constexpr size_t kMaxPackBitNum = 32;
+
 constexpr auto kNoCompress = "no_compress";
 constexpr auto kMinMax = "min_max";
 constexpr auto kBitPack = "bit_pack";
 
+// The packed bits are in big-endian order, so the words are byte swapped on little-endian machines.
+inline void store_bit_word(uint64_t word, char *dst) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  (void)memcpy(dst, &word, kBitWordBytes);
+}
+
+inline uint64_t load_bit_word(const char *src) {
+  uint64_t word;
+  (void)memcpy(&word, src, kBitWordBytes);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+inline size_t bit_packed_size(size_t size, size_t bit_num) { return (size * bit_num + k8 - 1) / k8; }
+
 }  // namespace compression
 }  // namespace fl
 }  // namespace mindspore
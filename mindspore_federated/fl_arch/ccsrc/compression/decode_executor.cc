@@ -136,6 +136,46 @@ bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>>
   return true;
 }
 
+bool DecodeExecutor::DeQuantSparseDelta(std::map<std::string, std::vector<float>> *weight_map,
+                                        const ModelItemPtr &base_model,
+                                        const std::vector<CompressFeatureMap> &compress_feature_maps,
+                                        size_t num_bits) {
+  MS_EXCEPTION_IF_NULL(weight_map);
+  MS_EXCEPTION_IF_NULL(base_model);
+  auto temp1 = static_cast<float>(1 << num_bits) - 1.0f;
+  auto temp2 = static_cast<float>(1 << (num_bits - 1));
+  for (const auto &compress_feature_map : compress_feature_maps) {
+    auto it = base_model->weight_items.find(compress_feature_map.weight_fullname);
+    if (it == base_model->weight_items.end()) {
+      MS_LOG_WARNING << "Failed to find parameter " << compress_feature_map.weight_fullname << " in the base model";
+      return false;
+    }
+    size_t shape = it->second.size / sizeof(float);
+    const auto &indices = compress_feature_map.indices;
+    const auto &compress_data = compress_feature_map.compress_data;
+    if ((indices.empty() && compress_data.size() != shape) ||
+        (!indices.empty() && indices.size() != compress_data.size())) {
+      MS_LOG_WARNING << "The size of the delta of parameter " << compress_feature_map.weight_fullname
+                     << " does not match the base model";
+      return false;
+    }
+    auto base_data = reinterpret_cast<const float *>(base_model->weight_data.data() + it->second.offset);
+    auto &weight_item = (*weight_map)[compress_feature_map.weight_fullname];
+    weight_item.assign(base_data, base_data + shape);
+    float scale_val = (compress_feature_map.max_val - compress_feature_map.min_val) / temp1 + 1e-10f;
+    for (size_t i = 0; i < compress_data.size(); ++i) {
+      size_t index = indices.empty() ? i : static_cast<size_t>(indices[i]);
+      if (index >= shape) {
+        MS_LOG_WARNING << "The index " << index << " of the delta of parameter "
+                       << compress_feature_map.weight_fullname << " is out of range " << shape;
+        return false;
+      }
+      weight_item[index] += (static_cast<float>(compress_data[i]) + temp2) * scale_val + compress_feature_map.min_val;
+    }
+  }
+  return true;
+}
+
 bool DecodeExecutor::Decode(std::map<std::string, std::vector<float>> *weight_map,
                             const std::vector<CompressFeatureMap> &compress_feature_maps,
                             schema::CompressType upload_compress_type, float upload_sparse_rate, int seed,
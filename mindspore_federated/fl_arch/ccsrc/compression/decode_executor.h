@@ -42,6 +42,8 @@ struct CompressFeatureMap {
   std::vector<int8_t> compress_data;
   float min_val;
   float max_val;
+  // The ascending indices of the compressed elements of the download delta, empty if all the elements are compressed.
+  std::vector<int32_t> indices;
 };
 
 class DecodeExecutor {
@@ -60,6 +62,10 @@ class DecodeExecutor {
                          float upload_sparse_rate, int seed, const std::vector<std::string> &name_vec,
                          size_t data_size);
 
+  // decode the download delta: dequantize the sparse difference and add it to the weights of the base model
+  bool DeQuantSparseDelta(std::map<std::string, std::vector<float>> *weight_map, const ModelItemPtr &base_model,
+                          const std::vector<CompressFeatureMap> &compress_feature_maps, size_t num_bits);
+
   // decode
   bool Decode(std::map<std::string, std::vector<float>> *weight_map,
               const std::vector<CompressFeatureMap> &compress_feature_maps, schema::CompressType upload_compress_type,
@@ -17,6 +17,7 @@
 #include "compression/encode_executor.h"
 
 #include <arpa/inet.h>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -82,6 +83,82 @@ bool CompressExecutor::quant_min_max(std::map<std::string, CompressWeight> *comp
   return true;
 }
 
+bool CompressExecutor::sparse_diff_quant(std::map<std::string, CompressWeight> *compressWeights,
+                                         const ModelItemPtr &base_model, const ModelItemPtr &model, float sparse_rate,
+                                         size_t num_bits) {
+  MS_EXCEPTION_IF_NULL(compressWeights);
+  if (base_model == nullptr || model == nullptr || sparse_rate <= 0.0f || sparse_rate > 1.0f) {
+    return false;
+  }
+  auto temp1 = static_cast<float>(1 << num_bits) - 1.0f;
+  auto temp2 = static_cast<float>(1 << (num_bits - 1));
+  // A weight left out of the delta would silently keep its stale value in the client, so the whole delta fails and the
+  // full model should be downloaded instead.
+  if (base_model->weight_items.size() != model->weight_items.size()) {
+    MS_LOG(INFO) << "The weight number of the base model is " << base_model->weight_items.size()
+                 << ", but that of the model is " << model->weight_items.size();
+    return false;
+  }
+  std::vector<float> diff;
+  std::vector<int32_t> indices;
+  for (const auto &item : model->weight_items) {
+    const auto &weight_item = item.second;
+    auto base_it = base_model->weight_items.find(item.first);
+    if (base_it == base_model->weight_items.end() || base_it->second.size != weight_item.size) {
+      MS_LOG(INFO) << "The weight " << item.first << " is not in the base model or its size changed.";
+      return false;
+    }
+    size_t size = weight_item.size / sizeof(float);
+    if (size > INT32_MAX) {
+      MS_LOG(INFO) << "The size " << size << " of weight " << item.first << " is too large for the delta.";
+      return false;
+    }
+    if (size == 0) {
+      continue;
+    }
+    auto data = reinterpret_cast<const float *>(model->weight_data.data() + weight_item.offset);
+    auto base_data = reinterpret_cast<const float *>(base_model->weight_data.data() + base_it->second.offset);
+    diff.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      diff[i] = data[i] - base_data[i];
+    }
+    auto k = static_cast<size_t>(std::ceil(static_cast<double>(size) * sparse_rate));
+    k = std::min(std::max<size_t>(k, 1), size);
+    indices.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      indices[i] = static_cast<int32_t>(i);
+    }
+    if (k < size) {
+      auto greater = [&diff](int32_t a, int32_t b) { return std::fabs(diff[a]) > std::fabs(diff[b]); };
+      std::nth_element(indices.begin(), indices.begin() + k, indices.end(), greater);
+      indices.resize(k);
+      std::sort(indices.begin(), indices.end());
+    }
+    float min_value = diff[indices[0]];
+    float max_value = min_value;
+    for (auto index : indices) {
+      min_value = std::min(min_value, diff[index]);
+      max_value = std::max(max_value, diff[index]);
+    }
+    float scale_value = (max_value - min_value) / temp1 + 1e-10f;
+    CompressWeight compressWeight;
+    compressWeight.compress_data.reserve(k);
+    for (auto index : indices) {
+      auto round_data = round((diff[index] - min_value) / scale_value - temp2);
+      compressWeight.compress_data.emplace_back(int8_t(round_data));
+    }
+    compressWeight.min_val = min_value;
+    compressWeight.max_val = max_value;
+    compressWeight.compress_data_len = k;
+    // All the elements are kept, the indices are implied.
+    if (k < size) {
+      compressWeight.indices = indices;
+    }
+    (*compressWeights)[item.first] = std::move(compressWeight);
+  }
+  return true;
+}
+
 schema::CompressType CompressExecutor::GetCompressType(const flatbuffers::Vector<int8_t> *download_compress_types) {
   schema::CompressType compressType = schema::CompressType_NO_COMPRESS;
   schema::CompressType context_compress_type;
@@ -40,6 +40,8 @@ struct CompressWeight {
   size_t compress_data_len;
   float min_val;
   float max_val;
+  // The ascending indices of the compressed elements, empty if all the elements are compressed.
+  std::vector<int32_t> indices;
 };
 
 class CompressExecutor {
@@ -58,6 +60,12 @@ class CompressExecutor {
   bool quant_min_max(std::map<std::string, CompressWeight> *compressWeights,
                      std::map<std::string, std::vector<float>> feature_maps, size_t num_bits);
 
+  // Compress the difference between model and base_model: keep the sparse_rate elements with the largest absolute
+  // difference of each weight, then quantize them with min max. Returns false if any weight cannot be diffed, e.g. its
+  // size changed.
+  bool sparse_diff_quant(std::map<std::string, CompressWeight> *compressWeights, const ModelItemPtr &base_model,
+                         const ModelItemPtr &model, float sparse_rate, size_t num_bits);
+
   schema::CompressType GetCompressType(const flatbuffers::Vector<int8_t> *download_compress_types);
 };
 }  // namespace compression
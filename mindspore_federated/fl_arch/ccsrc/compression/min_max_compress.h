@@ -65,8 +65,11 @@ MS_EXPORT TensorItemPy run_min_max_compress(const std::vector<float>& origin_dat
       auto int_data = static_cast<int>(round_data);
       fake_compress_data[i] = int_data;
     }
-    std::vector<char>packed_data = mindspore::fl::compression::bit_pack(fake_compress_data, bit_num);
-    std::string raw_data(packed_data.data(), packed_data.size());
+    std::string raw_data(bit_packed_size(size, bit_num), '\0');
+    if (!mindspore::fl::compression::bit_pack(fake_compress_data.data(), size, bit_num, raw_data.data())) {
+      tensor_item_py.set_compress_type(kNoCompress);
+      return tensor_item_py;
+    }
     tensor_item_py.set_raw_data(raw_data);
   }
   tensor_item_py.set_bit_num(bit_num);
@@ -44,14 +44,13 @@ MS_EXPORT std::vector<float> run_min_max_decompress(const TensorItemPy& tensor_i
       decompress_data[i] = (static_cast<float>(raw_data[i]) + temp2) * scale_val + min_val;
     }
   } else {
-    std::vector<int> real_vec = mindspore::fl::compression::bit_unpack(raw_data, bit_num);
-    if (real_vec.size() < size) {
+    auto decompress = [&decompress_data, temp2, scale_val, min_val](size_t i, int value) {
+      decompress_data[i] = (static_cast<float>(value) + temp2) * scale_val + min_val;
+    };
+    if (!mindspore::fl::compression::bit_unpack(raw_data.data(), raw_data.size(), size, bit_num, decompress)) {
       MS_LOG(ERROR) << "The vector from remote cannot be decompressed.";
       return decompress_data;
     }
-    for (size_t i = 0; i < size; ++i) {
-      decompress_data[i] = (static_cast<float>(real_vec[i]) + temp2) * scale_val + min_val;
-    }
   }
   return decompress_data;
 }
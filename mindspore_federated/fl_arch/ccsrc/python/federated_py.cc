@@ -126,13 +126,16 @@ void InitVFLContext(const py::module &m) {
 }
 
 void InitTensorItemPy(const py::module &m) {
-  (void)py::class_<TensorItemPy, std::shared_ptr<TensorItemPy>>(m, "TensorItem_")
+  (void)py::class_<TensorItemPy, std::shared_ptr<TensorItemPy>>(m, "TensorItem_", py::buffer_protocol())
     .def(py::init<>())
+    .def_buffer([](const TensorItemPy &tensor) { return tensor.data_buffer(); })
     .def("set_name", &TensorItemPy::set_name, "Set name.")
     .def("set_ref_key", &TensorItemPy::set_ref_key, "Get tensors.")
     .def("set_shape", &TensorItemPy::set_shape, "Set shape.")
     .def("set_dtype", &TensorItemPy::set_dtype, "Set dtype.")
     .def("set_raw_data", &TensorItemPy::set_raw_data, "Set tensor raw data.")
+    .def("set_data", static_cast<void (TensorItemPy::*)(const py::buffer &)>(&TensorItemPy::set_data),
+         "Set tensor data sent as an attachment.")
     .def("set_compress_type", &TensorItemPy::set_compress_type, "Set compress type.")
     .def("set_min_val", &TensorItemPy::set_min_val, "Set min val with quant compress.")
     .def("set_max_val", &TensorItemPy::set_max_val, "Set max val with quant compress.")
@@ -150,7 +153,8 @@ void InitTensorItemPy(const py::module &m) {
     .def("bit_num", &TensorItemPy::bit_num, "Get bit number.")
     .def("size", &TensorItemPy::size, "Get size.")
     .def("offset", &TensorItemPy::offset, "Get offset.")
-    .def("raw_data_size", &TensorItemPy::raw_data_size, "Get raw data size.");
+    .def("raw_data_size", &TensorItemPy::raw_data_size, "Get raw data size.")
+    .def("data_size", &TensorItemPy::data_size, "Get tensor data size.");
 }
 
 void InitTensorListItemPy(const py::module &m) {
@@ -188,9 +192,13 @@ void InitWorkerRegisterItemPy(const py::module &m) {
 // cppcheck-suppress syntaxError
 PYBIND11_MODULE(_mindspore_federated, m) {
   m.def("_RunPSIDemo", &mindspore::fl::psi::RunPSIDemo, "run psi demo", py::arg("alice_list"), py::arg("bob_list"),
-        py::arg("thread_num"));
+        py::arg("thread_num"), py::arg("stream_bucket_num") = 0);
   m.def("RunPSI", &mindspore::fl::psi::RunPSI, "run psi with communication", py::arg("input_list"),
-        py::arg("comm_role"), py::arg("peer_comm_role"), py::arg("bucket_id"), py::arg("thread_num"));
+        py::arg("comm_role"), py::arg("peer_comm_role"), py::arg("bucket_id"), py::arg("thread_num"),
+        py::arg("stream_bucket_num") = 0);
+  m.def("RunMultiBinPSI", &mindspore::fl::psi::RunMultiBinPSI, "run psi of bins concurrently with communication",
+        py::arg("bin_inputs"), py::arg("bin_ids"), py::arg("comm_role"), py::arg("peer_comm_role"),
+        py::arg("thread_num"), py::arg("concurrent_bin_num") = mindspore::fl::psi::kDefaultConcurrentBinNum);
   m.def("PlainIntersection", &mindspore::fl::psi::PlainIntersection, "plain intersection with communication",
         py::arg("input_list"), py::arg("comm_role"), py::arg("peer_comm_role"), py::arg("bucket_id"),
         py::arg("thread_num"));
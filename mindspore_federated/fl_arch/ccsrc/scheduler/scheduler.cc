@@ -16,6 +16,7 @@
 
 #include "scheduler/scheduler.h"
 #include "common/exit_handler.h"
+#include "distributed_cache/distributed_cache.h"
 
 namespace mindspore {
 namespace fl {
@@ -44,6 +45,11 @@ void Scheduler::Run() {
 
 void Scheduler::InitAndLoadDistributedCache() {
   auto config = FLContext::instance()->distributed_cache_config();
+  // The memory cache is only visible to the server process, the scheduler cannot share the states through it.
+  if (config.type == cache::kMemoryCacheType) {
+    MS_LOG(EXCEPTION) << "Distributed cache type " << config.type << " is only supported by the server, please use "
+                      << "redis or a plugin for the scheduler.";
+  }
   if (config.address.empty()) {
     MS_LOG(EXCEPTION) << "Distributed cache address cannot be empty.";
   }
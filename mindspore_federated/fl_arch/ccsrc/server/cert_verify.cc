@@ -15,8 +15,10 @@
  */
 #include "server/cert_verify.h"
 #include <sys/time.h>
+#include <sys/stat.h>
 #include <iostream>
 #include <cstdio>
+#include <ctime>
 #include <cstring>
 #include <cstdlib>
 #include <vector>
@@ -29,7 +31,6 @@ namespace server {
 #ifndef _WIN32
 static const int64_t certStartTimeDiff = -600;
 static int64_t replayAttackTimeDiff;
-
 X509 *CertVerify::readCertFromFile(const std::string &certPath) {
   BIO *bio = BIO_new_file(certPath.c_str(), "r");
   X509 *certObj = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr);
@@ -135,8 +136,16 @@ bool CertVerify::verifyPublicKey(const X509 *keyAttestationCertObj, const X509 *
 bool CertVerify::verifyCAChain(const std::string &keyAttestation, const std::string &equipCert,
                                const std::string &equipCACert, const std::string &rootFirstCAPath,
                                const std::string &rootSecondCAPath) {
-  X509 *rootFirstCA = CertVerify::readCertFromFile(rootFirstCAPath);
-  X509 *rootSecondCA = CertVerify::readCertFromFile(rootSecondCAPath);
+  std::shared_ptr<X509> rootFirstCAHolder;
+  std::shared_ptr<X509> rootSecondCAHolder;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto now = static_cast<int64_t>(time(nullptr));
+    rootFirstCAHolder = getCachedPemObject(rootFirstCAPath, now, readCertFromFile, X509_free, &root_first_ca_);
+    rootSecondCAHolder = getCachedPemObject(rootSecondCAPath, now, readCertFromFile, X509_free, &root_second_ca_);
+  }
+  const X509 *rootFirstCA = rootFirstCAHolder.get();
+  const X509 *rootSecondCA = rootSecondCAHolder.get();
   X509 *keyAttestationCertObj = readCertFromPerm(keyAttestation);
   X509 *equipCertObj = readCertFromPerm(equipCert);
   X509 *equipCACertObj = readCertFromPerm(equipCACert);
@@ -193,8 +202,6 @@ bool CertVerify::verifyCAChain(const std::string &keyAttestation, const std::str
       break;
     }
   } while (0);
-  X509_free(rootFirstCA);
-  X509_free(rootSecondCA);
   X509_free(keyAttestationCertObj);
   X509_free(equipCertObj);
   X509_free(equipCACertObj);
@@ -330,26 +337,26 @@ bool CertVerify::verifyCertCommonName(const X509 *caCert, const X509 *subCert) c
 }
 
 bool CertVerify::verifyCRL(const std::string &equipCert, const std::string &equipCrlPath) {
-  if (!checkFileExists(equipCrlPath)) {
+  std::shared_ptr<X509_CRL> equipCrlHolder;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto now = static_cast<int64_t>(time(nullptr));
+    equipCrlHolder = getCachedPemObject(equipCrlPath, now, readCrlFromFile, X509_CRL_free, &equip_crl_);
+  }
+  X509_CRL *equipCrl = equipCrlHolder.get();
+  if (equipCrl == nullptr) {
+    MS_LOG(DEBUG) << "equipCrl is nullptr. return true.";
     return true;
   }
   bool result = true;
-  X509_CRL *equipCrl = nullptr;
   X509 *equipCertObj = nullptr;
   EVP_PKEY *evp_pkey = nullptr;
   do {
-    equipCrl = CertVerify::readCrlFromFile(equipCrlPath);
     equipCertObj = readCertFromPerm(equipCert);
     if (equipCertObj == nullptr) {
       result = false;
       break;
     }
-
-    if (equipCrl == nullptr) {
-      MS_LOG(DEBUG) << "equipCrl is nullptr. return true.";
-      result = true;
-      break;
-    }
     evp_pkey = X509_get_pubkey(equipCertObj);
     int ret = X509_CRL_verify(equipCrl, evp_pkey);
     if (ret == 1) {
@@ -361,7 +368,6 @@ bool CertVerify::verifyCRL(const std::string &equipCert, const std::string &equi
 
   EVP_PKEY_free(evp_pkey);
   X509_free(equipCertObj);
-  X509_CRL_free(equipCrl);
   MS_LOG(DEBUG) << "verifyCRL end.";
   return result;
 }
@@ -583,6 +589,12 @@ bool CertVerify::initRootCertAndCRL(const std::string rootFirstCaFilePath, const
     MS_LOG(WARNING) << "The equipCrlPath is not exist.";
   }
   replayAttackTimeDiff = UlongToLong(replay_attack_time_diff);
+  auto &certVerify = CertVerify::GetInstance();
+  std::lock_guard<std::mutex> lock(certVerify.cache_mutex_);
+  auto now = static_cast<int64_t>(time(nullptr));
+  (void)getCachedPemObject(rootFirstCaFilePath, now, readCertFromFile, X509_free, &certVerify.root_first_ca_);
+  (void)getCachedPemObject(rootSecondCaFilePath, now, readCertFromFile, X509_free, &certVerify.root_second_ca_);
+  (void)getCachedPemObject(equipCrlPath, now, readCrlFromFile, X509_CRL_free, &certVerify.equip_crl_);
   return true;
 }
 
@@ -18,6 +18,7 @@
 #define MINDSPORE_CCSRC_FL_SERVER_CERT_VERIFY_H
 
 #include <assert.h>
+#include <sys/stat.h>
 #include <openssl/evp.h>
 #include <openssl/rsa.h>
 #include <openssl/x509v3.h>
@@ -27,12 +28,17 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <memory>
+#include <mutex>
 #include "common/utils/log_adapter.h"
 #include "common/common.h"
 
 namespace mindspore {
 namespace fl {
 namespace server {
+// the interval in seconds to check whether the root CA certificates and CRL files have been modified
+constexpr int64_t certCacheCheckInterval = 10;
+
 class CertVerify {
  public:
   static CertVerify &GetInstance() {
@@ -60,14 +66,37 @@ class CertVerify {
   bool verifyTimeStamp(const std::string &flID, const std::string &timeStamp) const;
 
 #ifndef _WIN32
+  // The object parsed from a PEM file, the file is parsed again only when its path, size or modify time changes.
+  template <typename T>
+  struct CachedPemObject {
+    std::string path;
+    int64_t mtime = -1;
+    int64_t size = -1;
+    // the time in seconds when the file is checked last time
+    int64_t check_time = 0;
+    std::shared_ptr<T> object = nullptr;
+  };
+
+  // Get the object cached from the PEM file at the time now in seconds. The file is checked for modification again
+  // when the path changes, or the last check is certCacheCheckInterval seconds ago.
+  template <typename T, typename ReadFunc, typename FreeFunc>
+  static std::shared_ptr<T> getCachedPemObject(const std::string &path, int64_t now, ReadFunc readFunc,
+                                               FreeFunc freeFunc, CachedPemObject<T> *cache) {
+    if (cache->path == path && now - cache->check_time < certCacheCheckInterval) {
+      return cache->object;
+    }
+    cache->check_time = now;
+    reloadIfModified(path, readFunc, freeFunc, cache);
+    return cache->object;
+  }
 
- private:
   // read certificate from file path
   static X509 *readCertFromFile(const std::string &certPath);
 
   // read Certificate Revocation List from file absolute path
   static X509_CRL *readCrlFromFile(const std::string &crlPath);
 
+ private:
   // read certificate from pem string
   X509 *readCertFromPerm(std::string cert);
 
@@ -100,6 +129,41 @@ class CertVerify {
 
   bool verifyPublicKey(const X509 *keyAttestationCertObj, const X509 *equipCertObj, const X509 *equipCACertObj,
                        const X509 *rootFirstCA, const X509 *rootSecondCA) const;
+
+  template <typename T, typename ReadFunc, typename FreeFunc>
+  static void reloadIfModified(const std::string &path, ReadFunc readFunc, FreeFunc freeFunc,
+                               CachedPemObject<T> *cache) {
+    struct stat fileStat {};
+    int64_t mtime = -1;
+    int64_t size = -1;
+    if (stat(path.c_str(), &fileStat) == 0) {
+      mtime = static_cast<int64_t>(fileStat.st_mtime);
+      size = static_cast<int64_t>(fileStat.st_size);
+    }
+    if (cache->path == path && cache->mtime == mtime && cache->size == size) {
+      return;
+    }
+    cache->path = path;
+    cache->mtime = mtime;
+    cache->size = size;
+    cache->object = nullptr;
+    if (mtime < 0) {
+      return;
+    }
+    T *object = readFunc(path);
+    if (object == nullptr) {
+      MS_LOG(WARNING) << "Parse " << path << " failed.";
+      return;
+    }
+    cache->object = std::shared_ptr<T>(object, freeFunc);
+    MS_LOG(INFO) << "Load " << path << " into the cert cache.";
+  }
+
+  // the cached root CA certificates and CRL, accessed with cache_mutex_ held
+  std::mutex cache_mutex_;
+  CachedPemObject<X509> root_first_ca_;
+  CachedPemObject<X509> root_second_ca_;
+  CachedPemObject<X509_CRL> equip_crl_;
 #endif
 };
 }  // namespace server
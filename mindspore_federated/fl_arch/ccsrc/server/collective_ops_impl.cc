@@ -16,10 +16,12 @@
 
 #include "server/collective_ops_impl.h"
 #include <algorithm>
+#include <deque>
 #include <utility>
 #include "server/local_meta_store.h"
 #include "distributed_cache/server.h"
 #include "distributed_cache/instance_context.h"
+#include "server/kernel/vector_ops.h"
 
 namespace mindspore {
 namespace fl {
@@ -29,6 +31,27 @@ const char kCollectivePhaseRing[] = "ring";
 const char kCollectivePhaseGather[] = "gather";
 const char kCollectivePhaseReduce[] = "reduce";
 const char kCollectivePhaseBroadcast[] = "broadcast";
+
+class ServerNodeRingTransport : public RingTransport {
+ public:
+  ServerNodeRingTransport(const std::shared_ptr<ServerNode> &server_node, const std::string &send_address)
+      : server_node_(server_node), send_address_(send_address) {}
+  ~ServerNodeRingTransport() override = default;
+
+  std::shared_ptr<ResponseTrack> SendAsync(const CollectiveMessageMeta &meta, const void *data, size_t size) override {
+    return server_node_->CollectiveSendAsync(send_address_, meta, data, size);
+  }
+  bool RecvWait(const CollectiveMessageMeta &meta, size_t expect_size, VectorPtr *output) override {
+    return server_node_->CollectiveRecvWait(meta, expect_size, output, kCollectiveCommTimeout);
+  }
+  bool Wait(const std::shared_ptr<ResponseTrack> &request_track) override {
+    return server_node_->Wait(request_track, kCollectiveCommTimeout);
+  }
+
+ private:
+  std::shared_ptr<ServerNode> server_node_;
+  std::string send_address_;
+};
 }  // namespace
 
 void CollectiveOpsImpl::Initialize(const std::shared_ptr<ServerNode> &server_node) {
@@ -75,18 +98,8 @@ bool CollectiveOpsImpl::RingAllReduce(const std::string &data_name, const void *
                 << ", chunk_sizes:" << chunk_sizes << ", send_to_rank:" << send_to_rank
                 << ", recv_from_rank:" << recv_from_rank;
 
-  return RunRingAllReduce<T>(data_name, send_to_rank, recv_from_rank, chunk_sizes, chunk_offset, output_buff);
-}
-
-// Implementation of RingAllReduce.
-template <typename T>
-bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t send_to_rank, uint32_t recv_from_rank,
-                                         const std::vector<size_t> &chunk_sizes,
-                                         const std::vector<size_t> &chunk_offset, T *output_buff) {
   MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
-  MS_ERROR_IF_NULL_W_RET_VAL(output_buff, false);
   auto curr_iteration_num = cache::InstanceContext::Instance().iteration_num();
-
   const auto &send_to_node = server_nodes_[send_to_rank];
   const auto &recv_from_node = server_nodes_[recv_from_rank];
 
@@ -104,46 +117,65 @@ bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t
   recv_meta.set_iteration(curr_iteration_num);
   recv_meta.set_weight_name(data_name);
 
+  ServerNodeRingTransport transport(server_node_, send_to_node.second);
+  auto pipeline_chunk_size = FLContext::instance()->aggregation_config().all_reduce_pipeline_chunk_size;
+  if (pipeline_chunk_size > 0) {
+    size_t sub_chunk_elem_num = std::max<size_t>(1, pipeline_chunk_size / sizeof(T));
+    return RunPipelinedRingAllReduce<T>(&transport, rank_id_, rank_size_, send_meta, recv_meta, chunk_sizes,
+                                        chunk_offset, sub_chunk_elem_num, output_buff);
+  }
+  return RunRingAllReduce<T>(&transport, rank_id_, rank_size_, send_meta, recv_meta, chunk_sizes, chunk_offset,
+                             output_buff);
+}
+
+// Implementation of RingAllReduce.
+template <typename T>
+bool CollectiveOpsImpl::RunRingAllReduce(RingTransport *transport, size_t rank_id, size_t rank_size,
+                                         const CollectiveMessageMeta &send_meta_base,
+                                         const CollectiveMessageMeta &recv_meta_base,
+                                         const std::vector<size_t> &chunk_sizes,
+                                         const std::vector<size_t> &chunk_offset, T *output_buff) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(output_buff, false);
+  CollectiveMessageMeta send_meta = send_meta_base;
+  CollectiveMessageMeta recv_meta = recv_meta_base;
+
   // Ring ReduceScatter.
   MS_LOG(DEBUG) << "Start Ring ReduceScatter.";
   send_meta.set_phase(kCollectivePhaseRing);
   recv_meta.set_phase(kCollectivePhaseRing);
 
-  const auto &send_address = send_to_node.second;
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
+  for (size_t i = 0; i < rank_size - 1; i++) {
     // Step 1: Async send data to next rank.
-    size_t send_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
+    size_t send_chunk_index = (rank_id - i + rank_size) % rank_size;
     T *send_chunk = output_buff + chunk_offset[send_chunk_index];
     send_meta.set_chunk_index(send_chunk_index);
     send_meta.set_for_index(i);
     auto send_chunk_count = chunk_sizes[send_chunk_index];
-    auto send_req_id =
-      server_node_->CollectiveSendAsync(send_address, send_meta, send_chunk, send_chunk_count * sizeof(T));
+    auto send_req_id = transport->SendAsync(send_meta, send_chunk, send_chunk_count * sizeof(T));
 
     // Step 2: Async receive data to next rank and wait until it's done.
-    size_t recv_chunk_index = (rank_id_ - i - 1 + rank_size_) % rank_size_;
+    size_t recv_chunk_index = (rank_id - i - 1 + rank_size) % rank_size;
     recv_meta.set_chunk_index(recv_chunk_index);
     recv_meta.set_for_index(i);
     T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
     auto recv_chunk_count = chunk_sizes[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring ReduceScatter send_to_rank:" << send_to_node.first
-                  << ", recv_from_rank:" << recv_from_node.first << ", send chunk index:" << send_chunk_index
+    MS_LOG(DEBUG) << "Ring ReduceScatter send_to_rank:" << send_meta.recv_node()
+                  << ", recv_from_rank:" << recv_meta.send_node() << ", send chunk index:" << send_chunk_index
                   << ", send count:" << send_chunk_count << ", recv chunk index:" << recv_chunk_index
                   << ", recv count:" << recv_chunk_count << ", for index:" << i;
 
     VectorPtr recv_str;
     auto expect_size = recv_chunk_count * sizeof(T);
-    if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
+    if (!transport->RecvWait(recv_meta, expect_size, &recv_str)) {
       MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
       return false;
     }
     auto tmp_recv_chunk = reinterpret_cast<T *>(recv_str->data());
     // Step 3: Reduce the data so we can overlap the time cost of send.
-    for (size_t j = 0; j < recv_chunk_count; j++) {
-      recv_chunk[j] += tmp_recv_chunk[j];
-    }
+    kernel::VectorAddT(recv_chunk, tmp_recv_chunk, recv_chunk_count);
     // Step 4: Wait until send is done.
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    if (!transport->Wait(send_req_id)) {
       MS_LOG(ERROR) << "Wait response of rank " << send_req_id << " failed.";
       return false;
     }
@@ -154,28 +186,27 @@ bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t
   MS_LOG(DEBUG) << "Start Ring AllGather.";
   send_meta.set_phase(kCollectivePhaseGather);
   recv_meta.set_phase(kCollectivePhaseGather);
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
-    size_t send_chunk_index = (rank_id_ - i + 1 + rank_size_) % rank_size_;
+  for (size_t i = 0; i < rank_size - 1; i++) {
+    size_t send_chunk_index = (rank_id - i + 1 + rank_size) % rank_size;
     T *send_chunk = output_buff + chunk_offset[send_chunk_index];
     send_meta.set_chunk_index(send_chunk_index);
     send_meta.set_for_index(i);
     auto send_chunk_count = chunk_sizes[send_chunk_index];
-    auto send_req_id =
-      server_node_->CollectiveSendAsync(send_address, send_meta, send_chunk, send_chunk_count * sizeof(T));
+    auto send_req_id = transport->SendAsync(send_meta, send_chunk, send_chunk_count * sizeof(T));
 
-    size_t recv_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
+    size_t recv_chunk_index = (rank_id - i + rank_size) % rank_size;
     T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
     recv_meta.set_chunk_index(recv_chunk_index);
     recv_meta.set_for_index(i);
     auto recv_chunk_count = chunk_sizes[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring AllGather send_to_rank:" << send_to_node.first << ", recv_from_rank:" << recv_from_node.first
-                  << ", send chunk index:" << send_chunk_index << ", send count:" << send_chunk_count
-                  << ", recv chunk index:" << recv_chunk_index << ", recv count:" << recv_chunk_count
-                  << ", for index:" << i;
+    MS_LOG(DEBUG) << "Ring AllGather send_to_rank:" << send_meta.recv_node() << ", recv_from_rank:"
+                  << recv_meta.send_node() << ", send chunk index:" << send_chunk_index
+                  << ", send count:" << send_chunk_count << ", recv chunk index:" << recv_chunk_index
+                  << ", recv count:" << recv_chunk_count << ", for index:" << i;
 
     VectorPtr recv_str;
     auto expect_size = recv_chunk_count * sizeof(T);
-    if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
+    if (!transport->RecvWait(recv_meta, expect_size, &recv_str)) {
       MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
       return false;
     }
@@ -185,7 +216,7 @@ bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t
                     << ", dest size is " << recv_chunk_count * sizeof(T) << ", src size is " << recv_str->size();
       return false;
     }
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    if (!transport->Wait(send_req_id)) {
       MS_LOG(ERROR) << "Wait response of rank " << send_req_id << " failed.";
       return false;
     }
@@ -194,6 +225,129 @@ bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t
   return true;
 }
 
+template <typename T>
+bool CollectiveOpsImpl::RunPipelinedRingAllReduce(RingTransport *transport, size_t rank_id, size_t rank_size,
+                                                  const CollectiveMessageMeta &send_meta_base,
+                                                  const CollectiveMessageMeta &recv_meta_base,
+                                                  const std::vector<size_t> &chunk_sizes,
+                                                  const std::vector<size_t> &chunk_offset, size_t sub_chunk_elem_num,
+                                                  T *output_buff) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(output_buff, false);
+  if (sub_chunk_elem_num == 0) {
+    MS_LOG(ERROR) << "The element number of the sub-chunk of pipelined RingAllReduce should be positive.";
+    return false;
+  }
+  CollectiveMessageMeta send_meta = send_meta_base;
+  CollectiveMessageMeta recv_meta = recv_meta_base;
+
+  // The first chunk is the largest one, its sub-chunk number is used to number the sub-chunks of each step.
+  size_t max_sub_chunk_num = (chunk_sizes[0] + sub_chunk_elem_num - 1) / sub_chunk_elem_num;
+  auto sub_chunk_num = [&chunk_sizes, sub_chunk_elem_num](size_t chunk_index) {
+    return (chunk_sizes[chunk_index] + sub_chunk_elem_num - 1) / sub_chunk_elem_num;
+  };
+  auto sub_chunk_size = [&chunk_sizes, sub_chunk_elem_num](size_t chunk_index, size_t sub_index) {
+    return std::min(sub_chunk_elem_num, chunk_sizes[chunk_index] - sub_index * sub_chunk_elem_num);
+  };
+
+  // At most kRingMaxInflightSends sends wait for their responses: the oldest one is waited before a new one is issued,
+  // which bounds the requests queued in the node without stalling the pipeline on every send.
+  std::deque<std::shared_ptr<ResponseTrack>> send_tracks;
+  auto wait_oldest_send = [&]() {
+    auto send_req_id = send_tracks.front();
+    send_tracks.pop_front();
+    if (!transport->Wait(send_req_id)) {
+      MS_LOG(ERROR) << "Wait response of rank " << send_req_id << " failed.";
+      return false;
+    }
+    return true;
+  };
+  auto send_sub_chunk = [&](const char *phase, size_t step, size_t chunk_index, size_t sub_index) {
+    if (send_tracks.size() >= kRingMaxInflightSends && !wait_oldest_send()) {
+      return false;
+    }
+    send_meta.set_phase(phase);
+    send_meta.set_chunk_index(chunk_index);
+    send_meta.set_for_index(step * max_sub_chunk_num + sub_index);
+    T *send_data = output_buff + chunk_offset[chunk_index] + sub_index * sub_chunk_elem_num;
+    auto send_req_id = transport->SendAsync(send_meta, send_data, sub_chunk_size(chunk_index, sub_index) * sizeof(T));
+    if (send_req_id == nullptr) {
+      MS_LOG(ERROR) << "Send sub-chunk " << sub_index << " of chunk " << chunk_index << " to " << send_meta.recv_node()
+                    << " failed.";
+      return false;
+    }
+    send_tracks.push_back(send_req_id);
+    return true;
+  };
+  auto recv_sub_chunk = [&](const char *phase, size_t step, size_t chunk_index, size_t sub_index, VectorPtr *output) {
+    recv_meta.set_phase(phase);
+    recv_meta.set_chunk_index(chunk_index);
+    recv_meta.set_for_index(step * max_sub_chunk_num + sub_index);
+    auto expect_size = sub_chunk_size(chunk_index, sub_index) * sizeof(T);
+    if (!transport->RecvWait(recv_meta, expect_size, output)) {
+      MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
+      return false;
+    }
+    return true;
+  };
+
+  // Ring ReduceScatter. A reduced sub-chunk is forwarded at once in the next step, and the sub-chunks reduced in the
+  // last step are the first ones sent in AllGather.
+  MS_LOG(DEBUG) << "Start pipelined Ring ReduceScatter, sub-chunk element num:" << sub_chunk_elem_num;
+  size_t first_chunk_index = rank_id;
+  for (size_t k = 0; k < sub_chunk_num(first_chunk_index); k++) {
+    if (!send_sub_chunk(kCollectivePhaseRing, 0, first_chunk_index, k)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < rank_size - 1; i++) {
+    size_t recv_chunk_index = (rank_id - i - 1 + rank_size) % rank_size;
+    for (size_t k = 0; k < sub_chunk_num(recv_chunk_index); k++) {
+      VectorPtr recv_str;
+      if (!recv_sub_chunk(kCollectivePhaseRing, i, recv_chunk_index, k, &recv_str)) {
+        return false;
+      }
+      T *recv_chunk = output_buff + chunk_offset[recv_chunk_index] + k * sub_chunk_elem_num;
+      kernel::VectorAddT(recv_chunk, reinterpret_cast<const T *>(recv_str->data()),
+                         sub_chunk_size(recv_chunk_index, k));
+      bool ret = (i + 2 < rank_size) ? send_sub_chunk(kCollectivePhaseRing, i + 1, recv_chunk_index, k)
+                                     : send_sub_chunk(kCollectivePhaseGather, 0, recv_chunk_index, k);
+      if (!ret) {
+        return false;
+      }
+    }
+  }
+  MS_LOG(DEBUG) << "End pipelined Ring ReduceScatter.";
+
+  // Ring AllGather. A received sub-chunk is forwarded at once in the next step.
+  MS_LOG(DEBUG) << "Start pipelined Ring AllGather.";
+  for (size_t i = 0; i < rank_size - 1; i++) {
+    size_t recv_chunk_index = (rank_id - i + rank_size) % rank_size;
+    for (size_t k = 0; k < sub_chunk_num(recv_chunk_index); k++) {
+      VectorPtr recv_str;
+      if (!recv_sub_chunk(kCollectivePhaseGather, i, recv_chunk_index, k, &recv_str)) {
+        return false;
+      }
+      T *recv_chunk = output_buff + chunk_offset[recv_chunk_index] + k * sub_chunk_elem_num;
+      auto ret = memcpy_s(recv_chunk, recv_str->size(), recv_str->data(), recv_str->size());
+      if (ret != 0) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
+      if (i + 2 < rank_size && !send_sub_chunk(kCollectivePhaseGather, i + 1, recv_chunk_index, k)) {
+        return false;
+      }
+    }
+  }
+  while (!send_tracks.empty()) {
+    if (!wait_oldest_send()) {
+      return false;
+    }
+  }
+  MS_LOG(DEBUG) << "End pipelined Ring AllGather.";
+  return true;
+}
+
 template <typename T>
 bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff,
                                                  size_t count) {
@@ -344,6 +498,15 @@ template bool CollectiveOpsImpl::AllReduce<size_t>(const std::string &data_name,
                                                    size_t count, const std::map<std::string, std::string> &server_map);
 template bool CollectiveOpsImpl::AllReduce<int>(const std::string &data_name, void *sendbuff, void *recvbuff,
                                                 size_t count, const std::map<std::string, std::string> &server_map);
+template bool CollectiveOpsImpl::RunRingAllReduce<float>(RingTransport *transport, size_t rank_id, size_t rank_size,
+                                                         const CollectiveMessageMeta &send_meta_base,
+                                                         const CollectiveMessageMeta &recv_meta_base,
+                                                         const std::vector<size_t> &chunk_sizes,
+                                                         const std::vector<size_t> &chunk_offset, float *output_buff);
+template bool CollectiveOpsImpl::RunPipelinedRingAllReduce<float>(
+  RingTransport *transport, size_t rank_id, size_t rank_size, const CollectiveMessageMeta &send_meta_base,
+  const CollectiveMessageMeta &recv_meta_base, const std::vector<size_t> &chunk_sizes,
+  const std::vector<size_t> &chunk_offset, size_t sub_chunk_elem_num, float *output_buff);
 
 }  // namespace server
 }  // namespace fl
@@ -34,6 +34,22 @@ namespace server {
 constexpr uint32_t kCollectiveCommTimeout = 30;
 // The max timeout for server collective communication, used in disaster recovery to prevent networking flapping.
 constexpr uint32_t kCollectiveCommMaxTimeout = 300;
+// The max number of sends of the pipelined RingAllReduce waiting for their responses.
+constexpr size_t kRingMaxInflightSends = 2;
+
+// RingTransport is the point-to-point communication of a rank with its neighbours in the ring. The ring algorithms only
+// depend on it, so they can run without the server node.
+class RingTransport {
+ public:
+  virtual ~RingTransport() = default;
+  // Sends the data to the next rank asynchronously, returns nullptr if it fails.
+  virtual std::shared_ptr<ResponseTrack> SendAsync(const CollectiveMessageMeta &meta, const void *data,
+                                                   size_t size) = 0;
+  // Waits for the data matching the meta from the previous rank.
+  virtual bool RecvWait(const CollectiveMessageMeta &meta, size_t expect_size, VectorPtr *output) = 0;
+  // Waits for the response of a send.
+  virtual bool Wait(const std::shared_ptr<ResponseTrack> &request_track) = 0;
+};
 
 // CollectiveOpsImpl is the collective communication API of the server.
 // For now, it implements two AllReduce algorithms: RingAllReduce and BroadcastAllReduce. Elastic AllReduce is also
@@ -51,18 +67,29 @@ class CollectiveOpsImpl {
   bool AllReduce(const std::string &data_name, void *sendbuff, void *recvbuff, size_t count,
                  const std::map<std::string, std::string> &server_map);
 
+  // Implementation of RingAllReduce on the rank rank_id. The send_meta and recv_meta carry the nodes, the iteration and
+  // the data name of the messages.
+  template <typename T>
+  static bool RunRingAllReduce(RingTransport *transport, size_t rank_id, size_t rank_size,
+                               const CollectiveMessageMeta &send_meta, const CollectiveMessageMeta &recv_meta,
+                               const std::vector<size_t> &chunk_sizes, const std::vector<size_t> &chunk_offset,
+                               T *output_buff);
+
+  // Pipelined implementation of RingAllReduce. Each chunk is cut into sub-chunks of sub_chunk_elem_num elements, and a
+  // sub-chunk is forwarded to the next rank as soon as it is reduced, so that the reducing overlaps the transfer of the
+  // following sub-chunks.
+  template <typename T>
+  static bool RunPipelinedRingAllReduce(RingTransport *transport, size_t rank_id, size_t rank_size,
+                                        const CollectiveMessageMeta &send_meta, const CollectiveMessageMeta &recv_meta,
+                                        const std::vector<size_t> &chunk_sizes, const std::vector<size_t> &chunk_offset,
+                                        size_t sub_chunk_elem_num, T *output_buff);
+
  private:
   CollectiveOpsImpl() : server_node_(nullptr), node_(nullptr), node_role_(NodeRole::WORKER), rank_size_(0) {}
   ~CollectiveOpsImpl() = default;
   CollectiveOpsImpl(const CollectiveOpsImpl &) = delete;
   CollectiveOpsImpl &operator=(const CollectiveOpsImpl &) = delete;
 
-  // Implementation of RingAllReduce.
-  template <typename T>
-  bool RunRingAllReduce(const std::string &data_name, uint32_t send_to_rank, uint32_t recv_from_rank,
-                        const std::vector<size_t> &chunk_sizes, const std::vector<size_t> &chunk_offset,
-                        T *output_buff);
-
   // Implementation of RingAllReduce.
   template <typename T>
   bool RingAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff, size_t count);
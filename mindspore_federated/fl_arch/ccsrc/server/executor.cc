@@ -15,28 +15,39 @@
  */
 
 #include "server/executor.h"
+#include <cstdint>
 #include <set>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
 #include <utility>
 #include "distributed_cache/instance_context.h"
 #include "distributed_cache/server.h"
 #include "distributed_cache/counter.h"
 #include "server/model_store.h"
+#include "server/long_poll_service.h"
 #include "server/server.h"
 #include "server/kernel/fed_avg_kernel.h"
+#include "server/collective_ops_impl.h"
 
 namespace mindspore {
 namespace fl {
 namespace server {
+namespace {
+const char kFusedDataSizeName[] = "__fused_data_size";
+const char kFusedBucketPrefix[] = "__fused_bucket_";
+constexpr size_t kCacheLineSize = 64;
+}  // namespace
+
 void Executor::Initialize(const std::vector<InputWeight> &feature_map, const std::shared_ptr<ServerNode> &server_node) {
   ModelStore::GetInstance().Initialize(feature_map);
   if (!ResetAggregationStatus()) {
     MS_LOG_EXCEPTION << "Failed to reset aggregation status";
   }
   server_node_ = server_node;
+  MS_LOG_INFO << "Aggregation kernels use " << kernel::VectorOpsImplName() << " implementation";
   initialized_ = true;
 }
 
@@ -44,7 +55,7 @@ bool Executor::initialized() const { return initialized_; }
 
 FlStatus Executor::CheckUpdatedModel(const std::map<std::string, Address> &feature_map,
                                      const std::string &update_model_fl_id) {
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::shared_lock<std::shared_mutex> lock(parameter_mutex_);
   for (auto &param_item : param_aggregation_info_) {
     auto &param_name = param_item.first;
     auto &param_aggr = param_item.second;
@@ -69,22 +80,86 @@ FlStatus Executor::CheckUpdatedModel(const std::map<std::string, Address> &featu
 }
 
 void Executor::HandleModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size) {
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
-  for (auto &param_item : param_aggregation_info_) {
-    auto &param_name = param_item.first;
-    auto &param_aggr = param_item.second;
-    if (!*(param_aggr.require_aggr)) {
-      continue;
-    }
-    auto it = feature_map.find(param_name);
-    if (it == feature_map.end()) {
-      continue;
+  std::shared_lock<std::shared_mutex> lock(parameter_mutex_);
+  if (aggregation_shards_.empty()) {
+    return;
+  }
+  // Concurrent updates start from different shards, so that they are not queued on the same shard lock.
+  UpdateAggregationShards(aggregation_shards_, feature_map, data_size, next_shard_index_.fetch_add(1));
+}
+
+void Executor::UpdateAggregationShards(const AggregationShards &shards,
+                                       const std::map<std::string, Address> &feature_map, size_t data_size,
+                                       size_t start_index) {
+  auto shard_num = shards.size();
+  for (size_t i = 0; i < shard_num; i++) {
+    auto &shard = shards[(start_index + i) % shard_num];
+    std::unique_lock<std::mutex> shard_lock(shard->shard_mutex);
+    for (auto &segment : shard->segments) {
+      auto &param_aggr = *segment.info;
+      if (!*(param_aggr.require_aggr)) {
+        continue;
+      }
+      auto it = feature_map.find(param_aggr.name);
+      if (it == feature_map.end()) {
+        continue;
+      }
+      kernel::FedAvgKernel<float, size_t>::LaunchSegment(it->second, data_size, segment.elem_offset, segment.elem_num,
+                                                         &param_aggr);
     }
-    auto upload_data = it->second;
+  }
+}
+
+void Executor::InitAggregationShards() {
+  aggregation_shards_ = SplitAggregationShards(&param_aggregation_info_,
+                                               FLContext::instance()->aggregation_config().aggregation_shard_num);
+}
 
-    MS_LOG(DEBUG) << "Do UpdateModel for parameter " << param_name;
-    kernel::FedAvgKernel<float, size_t>::Launch(upload_data, data_size, &param_aggr);
+Executor::AggregationShards Executor::SplitAggregationShards(
+  std::map<std::string, ParamAggregationInfo> *param_aggregation_info, size_t shard_num) {
+  AggregationShards shards;
+  size_t total_elem_num = 0;
+  for (auto &item : *param_aggregation_info) {
+    total_elem_num += item.second.weight_size / sizeof(float);
+  }
+  shard_num = std::max<size_t>(1, std::min(shard_num, total_elem_num));
+  size_t shard_elem_num = (total_elem_num + shard_num - 1) / shard_num;
+  for (size_t i = 0; i < shard_num; i++) {
+    shards.push_back(std::make_unique<AggregationShard>());
+  }
+  size_t shard_index = 0;
+  size_t shard_used = 0;
+  for (auto &item : *param_aggregation_info) {
+    auto &param_aggr = item.second;
+    size_t elem_num = param_aggr.weight_size / sizeof(float);
+    size_t elem_offset = 0;
+    // Parameters of size 0 still need a segment so that their data size is accumulated.
+    do {
+      if (shard_used >= shard_elem_num && shard_index + 1 < shard_num) {
+        shard_index++;
+        shard_used = 0;
+      }
+      size_t seg_num = elem_num - elem_offset;
+      // The last shard takes all the remaining elements.
+      if (shard_index + 1 < shard_num) {
+        seg_num = std::min(seg_num, shard_elem_num - shard_used);
+      }
+      // A parameter split between shards is cut at a cache line aligned address of its weight data, so the shards
+      // never write into the same cache line of the parameter. The parameters next to each other in memory may still
+      // share a cache line at their ends.
+      if (elem_offset + seg_num < elem_num) {
+        auto base_addr = reinterpret_cast<uintptr_t>(param_aggr.weight_data);
+        auto cut_addr = base_addr + (elem_offset + seg_num) * sizeof(float);
+        auto aligned_addr = (cut_addr + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+        seg_num = std::min(elem_num, (aligned_addr - base_addr) / sizeof(float)) - elem_offset;
+      }
+      shards[shard_index]->segments.push_back({&param_aggr, elem_offset, seg_num});
+      elem_offset += seg_num;
+      shard_used += seg_num;
+    } while (elem_offset < elem_num);
   }
+  MS_LOG(DEBUG) << "Aggregation buffer of " << total_elem_num << " elements is split into " << shard_num << " shards";
+  return shards;
 }
 
 bool Executor::OnReceiveModelWeight(const uint8_t *proto_model_data, size_t len) {
@@ -103,7 +178,7 @@ bool Executor::OnReceiveModelWeight(const uint8_t *proto_model_data, size_t len)
                    << iteration_num << " of local";
     return false;
   }
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::unique_lock<std::shared_mutex> lock(parameter_mutex_);
   for (const auto &param : proto_model.weights()) {
     const std::string &param_name = param.name();
     if (param_aggregation_info_.count(param_name) == 0) {
@@ -153,7 +228,7 @@ std::map<std::string, Address> Executor::ParseFeatureMap(const schema::RequestPu
 }
 
 bool Executor::HandlePushWeight(const std::map<std::string, Address> &feature_map) {
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::unique_lock<std::shared_mutex> lock(parameter_mutex_);
   for (const auto &trainable_param : feature_map) {
     const std::string &param_name = trainable_param.first;
     if (param_aggregation_info_.count(param_name) == 0) {
@@ -184,7 +259,7 @@ FlStatus Executor::BuildPullWeightRsp(size_t iteration, const std::vector<std::s
     MS_LOG(ERROR) << "fbb is nullptr.";
     return {kFlFailed, reason};
   }
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::unique_lock<std::shared_mutex> lock(parameter_mutex_);
   std::vector<flatbuffers::Offset<schema::FeatureMap>> fbs_feature_maps;
   for (const auto &param_name : param_names) {
     if (param_aggregation_info_.count(param_name) == 0) {
@@ -329,7 +404,7 @@ void Executor::BroadcastModelWeight(const std::map<std::string, std::string> &br
   auto model = GetModel();
   ProtoModel proto_model;
   TransModel2ProtoModel(curr_iter_num, model, &proto_model);
-  auto model_str = proto_model.SerializeAsString();
+  auto model_str = std::make_shared<std::string>(proto_model.SerializeAsString());
   server::Server::GetInstance().BroadcastModelWeight(model_str, broadcast_server_map);
 }
 
@@ -366,6 +441,8 @@ void Executor::RunWeightAggregation() {
   if (server_map.count(node_id) == 0) {
     MS_LOG_INFO << "Skip current node, this node does not contribute the updateModel count";
     Executor::GetInstance().SetSkipAggregation();
+    // The parked pullWeight requests should pull weight from other servers.
+    LongPollService::GetInstance().Notify();
     return;
   }
   valid = RunWeightAggregationInner(server_map);
@@ -378,6 +455,7 @@ void Executor::RunWeightAggregation() {
   size_t total_data_size = LocalMetaStore::GetInstance().value<size_t>(kCtxFedAvgTotalDataSize);
   MS_LOG(INFO) << "Run weight aggregation finished. Total data size for iteration " << curr_iter_num << " is "
                << total_data_size;
+  LongPollService::GetInstance().Notify();
   if (FLContext::instance()->resetter_round() == ResetterRound::kUpdateModel) {
     SetIterationModelFinished();
     BroadcastModelWeight(all_reduce_server_map_);
@@ -396,7 +474,7 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
   if (server_map.size() == 1) {
     MS_LOG_INFO << "Servers count for RunWeightAggregation is 1";
   }
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::unique_lock<std::shared_mutex> lock(parameter_mutex_);
   auto model = mindspore::fl::server::ModelStore::GetInstance().GetLatestModel().second;
   if (model == nullptr || model->weight_data.empty()) {
     MS_LOG_WARNING << "Failed to get latest model";
@@ -404,6 +482,17 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
   }
   auto weight_data_base = model->weight_data.data();
   auto aggregation_type = FLContext::instance()->aggregation_type();
+  // In fused mode, all the weights and data sizes are summed up over servers in a few buckets at first, then only the
+  // averaging of each weight is done in the loop below.
+  auto bucket_size = FLContext::instance()->aggregation_config().all_reduce_bucket_size;
+  bool fused = bucket_size > 0;
+  if (aggregation_type == kFedNovaAggregation && !kernel::FedAvgKernel<float, size_t>::CheckFedNovaConfig()) {
+    return false;
+  }
+  if (fused && !FusedAllReduce(server_map, bucket_size)) {
+    MS_LOG(ERROR) << "FusedAllReduce is failed.";
+    return false;
+  }
   for (auto &item : param_aggregation_info_) {
     auto &param_aggr = item.second;
     if (!(*param_aggr.require_aggr)) {
@@ -411,7 +500,8 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
     }
     auto name = item.first;
     if (aggregation_type == kScaffoldAggregation && startswith(name, kControlPrefix)) {
-      bool ret = kernel::FedAvgKernel<float, size_t>::ScaffoldAllReduce(server_map, &param_aggr);
+      bool ret = fused ? kernel::FedAvgKernel<float, size_t>::ScaffoldAverage(&param_aggr)
+                       : kernel::FedAvgKernel<float, size_t>::ScaffoldAllReduce(server_map, &param_aggr);
       if (!ret) {
         MS_LOG(ERROR) << "ScaffoldAllReduce is failed.";
         return false;
@@ -421,11 +511,10 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
       float *weight_addr = reinterpret_cast<float *>(param_aggr.weight_data);
       MS_ERROR_IF_NULL_W_RET_VAL(weight_addr, false);
       auto elem_num = param_aggr.weight_size / sizeof(float);
-      for (size_t i = 0; i < elem_num; i++) {
-        weight_addr[i] += weight_data[i];
-      }
+      kernel::VectorAdd(weight_addr, weight_data, elem_num);
     } else if (aggregation_type == kFedNovaAggregation) {
-      bool ret = kernel::FedAvgKernel<float, size_t>::FedNovaAllReduce(server_map, &param_aggr);
+      bool ret = fused ? kernel::FedAvgKernel<float, size_t>::FedNovaAverage(&param_aggr)
+                       : kernel::FedAvgKernel<float, size_t>::FedNovaAllReduce(server_map, &param_aggr);
       if (!ret) {
         MS_LOG(ERROR) << "FedNovaAllReduce is failed.";
         return false;
@@ -435,11 +524,10 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
       float *weight_addr = reinterpret_cast<float *>(param_aggr.weight_data);
       MS_ERROR_IF_NULL_W_RET_VAL(weight_addr, false);
       auto elem_num = param_aggr.weight_size / sizeof(float);
-      for (size_t i = 0; i < elem_num; i++) {
-        weight_addr[i] += weight_data[i];
-      }
+      kernel::VectorAdd(weight_addr, weight_data, elem_num);
     } else {
-      bool ret = kernel::FedAvgKernel<float, size_t>::AllReduce(server_map, &param_aggr);
+      bool ret = fused ? kernel::FedAvgKernel<float, size_t>::Average(&param_aggr)
+                       : kernel::FedAvgKernel<float, size_t>::AllReduce(server_map, &param_aggr);
       if (!ret) {
         MS_LOG(ERROR) << "AllReduce is failed.";
         return false;
@@ -450,6 +538,102 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
   return true;
 }
 
+bool Executor::FusedAllReduce(const std::map<std::string, std::string> &server_map, size_t bucket_size) {
+  std::vector<ParamAggregationInfo *> params;
+  std::vector<size_t> data_sizes;
+  for (auto &item : param_aggregation_info_) {
+    auto &param_aggr = item.second;
+    if (!(*param_aggr.require_aggr)) {
+      continue;
+    }
+    MS_ERROR_IF_NULL_W_RET_VAL(param_aggr.weight_data, false);
+    params.push_back(&param_aggr);
+    data_sizes.push_back(param_aggr.data_size);
+  }
+  if (params.empty()) {
+    return true;
+  }
+  // The data sizes of all the parameters are summed up in one collective.
+  if (!CollectiveOpsImpl::GetInstance().AllReduce<size_t>(kFusedDataSizeName, data_sizes.data(), data_sizes.data(),
+                                                          data_sizes.size(), server_map)) {
+    MS_LOG(ERROR) << "Fused allreduce of data size failed.";
+    return false;
+  }
+  for (size_t i = 0; i < params.size(); i++) {
+    params[i]->data_size = data_sizes[i];
+  }
+  std::vector<std::pair<float *, size_t>> weights;
+  weights.reserve(params.size());
+  for (auto param : params) {
+    weights.emplace_back(reinterpret_cast<float *>(param->weight_data), param->weight_size / sizeof(float));
+  }
+  auto all_reduce = [&server_map](const std::string &name, float *data, size_t elem_num) {
+    return CollectiveOpsImpl::GetInstance().AllReduce<float>(name, data, data, elem_num, server_map);
+  };
+  return BucketedAllReduce(weights, bucket_size, all_reduce);
+}
+
+bool Executor::BucketedAllReduce(const std::vector<std::pair<float *, size_t>> &weights, size_t bucket_size,
+                                 const BucketAllReduceFunc &all_reduce) {
+  size_t total_elem_num = 0;
+  for (const auto &weight : weights) {
+    total_elem_num += weight.second;
+  }
+  size_t bucket_elem_num = bucket_size / sizeof(float);
+  std::vector<float> bucket;
+  bucket.reserve(std::min(bucket_elem_num, total_elem_num));
+  std::vector<std::pair<float *, size_t>> bucket_weights;
+  size_t collective_index = 0;
+  // Every server has the same weights in the same order, so the collectives are named by their index.
+  auto reduce = [&all_reduce, &collective_index](float *data, size_t elem_num) {
+    auto name = kFusedBucketPrefix + std::to_string(collective_index++);
+    if (!all_reduce(name, data, elem_num)) {
+      MS_LOG(ERROR) << "Fused allreduce of " << name << " failed.";
+      return false;
+    }
+    return true;
+  };
+  auto flush = [&bucket, &bucket_weights, &reduce]() {
+    if (bucket.empty()) {
+      return true;
+    }
+    if (!reduce(bucket.data(), bucket.size())) {
+      return false;
+    }
+    size_t offset = 0;
+    for (const auto &weight : bucket_weights) {
+      (void)std::copy(bucket.begin() + offset, bucket.begin() + offset + weight.second, weight.first);
+      offset += weight.second;
+    }
+    bucket.clear();
+    bucket_weights.clear();
+    return true;
+  };
+  for (const auto &weight : weights) {
+    if (weight.second == 0) {
+      continue;
+    }
+    MS_ERROR_IF_NULL_W_RET_VAL(weight.first, false);
+    if (weight.second >= bucket_elem_num) {
+      if (!flush() || !reduce(weight.first, weight.second)) {
+        return false;
+      }
+      continue;
+    }
+    if (bucket.size() + weight.second > bucket_elem_num && !flush()) {
+      return false;
+    }
+    bucket.insert(bucket.end(), weight.first, weight.first + weight.second);
+    bucket_weights.push_back(weight);
+  }
+  if (!flush()) {
+    return false;
+  }
+  MS_LOG(DEBUG) << "Fused allreduce of " << weights.size() << " parameters finished in " << collective_index
+                << " collectives";
+  return true;
+}
+
 void Executor::FinishIteration(bool is_last_iter_valid, const std::string &in_reason) {
   cache::InstanceContext::Instance().NotifyNext(is_last_iter_valid, in_reason);
 }
@@ -460,7 +644,7 @@ bool Executor::ResetAggregationStatus() {
   unmasked_ = false;
   can_unmask_ = false;
   all_reduce_server_map_.clear();
-  std::unique_lock<std::mutex> lock(parameter_mutex_);
+  std::unique_lock<std::shared_mutex> lock(parameter_mutex_);
   model_finished_ = false;
   model_aggregation_ = ModelStore::GetInstance().AssignNewModelMemory();
   if (model_aggregation_ == nullptr) {
@@ -479,6 +663,7 @@ bool Executor::ResetAggregationStatus() {
     info.require_aggr = &weight_item.require_aggr;
     param_aggregation_info_[info.name] = info;
   }
+  InitAggregationShards();
   return true;
 }
 
@@ -602,6 +787,7 @@ void Executor::Unmask() {
     FinishIteration(true, reason);
   }
   unmasked_ = true;
+  LongPollService::GetInstance().Notify();
 }
 
 bool Executor::IsUnmasked() const {
@@ -17,12 +17,15 @@
 #ifndef MINDSPORE_CCSRC_FL_SERVER_EXECUTOR_H_
 #define MINDSPORE_CCSRC_FL_SERVER_EXECUTOR_H_
 
+#include <functional>
 #include <map>
 #include <set>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include "armour/cipher/cipher_unmask.h"
 #include "common/common.h"
@@ -40,6 +43,20 @@ struct ParamAggregationInfo {
   size_t data_size = 0;    // batch size, will be set to number of training steps in FedNova mode
   bool *require_aggr;
 };
+
+// A contiguous range of one parameter which belongs to an aggregation shard.
+struct AggregationSegment {
+  ParamAggregationInfo *info = nullptr;
+  size_t elem_offset = 0;
+  size_t elem_num = 0;
+};
+
+// The aggregation buffer is split into shards with their own locks, so that updates from different clients could be
+// accumulated into different shards in parallel.
+struct AggregationShard {
+  std::mutex shard_mutex;
+  std::vector<AggregationSegment> segments;
+};
 // Executor is the entrance for server to handle aggregation, optimizing, model querying, etc. It handles
 // logics relevant to kernel launching.
 class Executor {
@@ -95,6 +112,22 @@ class Executor {
   // Forcibly overwrite specific weights in overwriteWeights message.
   bool HandlePushWeight(const std::map<std::string, Address> &feature_map);
 
+  using BucketAllReduceFunc = std::function<bool(const std::string &name, float *data, size_t elem_num)>;
+  // Sum up the weights, each given by its address and element number, with one all_reduce per bucket of at most
+  // bucket_size bytes. A bucket is flushed before the weight which would overflow it, and a weight not smaller than
+  // bucket_size is reduced on its own in place without being copied.
+  static bool BucketedAllReduce(const std::vector<std::pair<float *, size_t>> &weights, size_t bucket_size,
+                                const BucketAllReduceFunc &all_reduce);
+
+  using AggregationShards = std::vector<std::unique_ptr<AggregationShard>>;
+  // Split the parameters into at most shard_num shards of contiguous segments. A parameter split between shards is cut
+  // at a cache line aligned address of its weight data.
+  static AggregationShards SplitAggregationShards(std::map<std::string, ParamAggregationInfo> *param_aggregation_info,
+                                                  size_t shard_num);
+  // Accumulate the update into every shard under the shard's lock, visiting the shards from start_index.
+  static void UpdateAggregationShards(const AggregationShards &shards, const std::map<std::string, Address> &feature_map,
+                                      size_t data_size, size_t start_index);
+
  private:
   Executor() = default;
   ~Executor() = default;
@@ -106,13 +139,22 @@ class Executor {
   FlStatus BuildPullWeightRsp(size_t iteration, const std::vector<std::string> &param_names, FBBuilder *fbb);
 
   void SetSkipAggregation();
+  // Split the parameters which require aggregation into contiguous shards.
+  void InitAggregationShards();
   bool RunWeightAggregationInner(const std::map<std::string, std::string> &server_map);
+  // Sum up all the parameters and their data sizes over servers with one collective per bucket of at most bucket_size
+  // bytes.
+  bool FusedAllReduce(const std::map<std::string, std::string> &server_map, size_t bucket_size);
   // The unmasking method for pairwise encrypt algorithm.
   void Unmask();
 
-  std::mutex parameter_mutex_;
+  // Shared by concurrent model updates which are serialized by the shard locks, exclusive for other operations.
+  std::shared_mutex parameter_mutex_;
   ModelItemPtr model_aggregation_ = nullptr;
   std::map<std::string, ParamAggregationInfo> param_aggregation_info_;
+  AggregationShards aggregation_shards_;
+  // Used to stagger the first shard visited by concurrent model updates.
+  std::atomic<size_t> next_shard_index_ = 0;
   // whether model in model_aggregation_ has finished
   bool model_finished_ = false;
 
@@ -28,6 +28,7 @@
 #include "server/collective_ops_impl.h"
 #include "server/local_meta_store.h"
 #include "server/executor.h"
+#include "server/kernel/vector_ops.h"
 
 namespace mindspore {
 namespace fl {
@@ -56,6 +57,14 @@ class FedAvgKernel {
       MS_LOG(ERROR) << "Federated average allreduce failed.";
       return false;
     }
+    return Average(info);
+  }
+
+  // Average the weight which has been summed up over all servers by its total data size.
+  static bool Average(ParamAggregationInfo *info) {
+    if (info == nullptr) {
+      return false;
+    }
     auto data_size = info->data_size;
     if (data_size == 0) {
       *info->require_aggr = false;
@@ -63,10 +72,9 @@ class FedAvgKernel {
       return true;
     }
     LocalMetaStore::GetInstance().put_value(kCtxFedAvgTotalDataSize, data_size);
+    T *weight_addr = reinterpret_cast<T *>(info->weight_data);
     auto elem_num = info->weight_size / sizeof(T);
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] /= data_size;
-    }
+    VectorDivT(weight_addr, data_size, elem_num);
     return true;
   }
 
@@ -78,19 +86,26 @@ class FedAvgKernel {
       MS_LOG(ERROR) << "Federated average allreduce failed.";
       return false;
     }
+    return ScaffoldAverage(info);
+  }
+
+  // Average the control variate which has been summed up over all servers by the total client number.
+  static bool ScaffoldAverage(ParamAggregationInfo *info) {
+    MS_EXCEPTION_IF_NULL(info);
+    T *weight_addr = reinterpret_cast<T *>(info->weight_data);
     auto elem_num = info->weight_size / sizeof(T);
     size_t total_client_num = FLContext::instance()->total_client_num();
     if (total_client_num == 0) {
       MS_LOG(ERROR) << "total_client_num is 0.";
       return false;
     }
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] /= total_client_num;
-    }
+    VectorDivT(weight_addr, total_client_num, elem_num);
     return true;
   }
 
-  static bool FedNovaAllReduce(const std::map<std::string, std::string> &server_map, ParamAggregationInfo *info) {
+  // The weight of FedNova is (start_fl_job_threshold / update_model_ratio)^2, which is checked before the collectives,
+  // so a misconfigured server fails without any network work.
+  static bool CheckFedNovaConfig() {
     uint64_t start_fl_job_threshold = FLContext::instance()->start_fl_job_threshold();
     float update_model_ratio = FLContext::instance()->update_model_ratio();
     if (start_fl_job_threshold == 0 || update_model_ratio == 0) {
@@ -98,7 +113,13 @@ class FedAvgKernel {
                        "incorrectly set to zero.";
       return false;
     }
-    float fednova_weight = pow(start_fl_job_threshold / update_model_ratio, 2);
+    return true;
+  }
+
+  static bool FedNovaAllReduce(const std::map<std::string, std::string> &server_map, ParamAggregationInfo *info) {
+    if (!CheckFedNovaConfig()) {
+      return false;
+    }
     MS_EXCEPTION_IF_NULL(info);
     T *weight_addr = reinterpret_cast<T *>(info->weight_data);
     if (!CollectiveOpsImpl::GetInstance().AllReduce<T>(info->name, weight_addr, weight_addr,
@@ -111,6 +132,19 @@ class FedAvgKernel {
       MS_LOG(ERROR) << "FedNovaAllReduce allreduce data_size failed.";
       return false;
     }
+    return FedNovaAverage(info);
+  }
+
+  // Normalize the weight which has been summed up over all servers by the total train steps.
+  static bool FedNovaAverage(ParamAggregationInfo *info) {
+    if (!CheckFedNovaConfig()) {
+      return false;
+    }
+    uint64_t start_fl_job_threshold = FLContext::instance()->start_fl_job_threshold();
+    float update_model_ratio = FLContext::instance()->update_model_ratio();
+    float fednova_weight = pow(start_fl_job_threshold / update_model_ratio, 2);
+    MS_EXCEPTION_IF_NULL(info);
+    T *weight_addr = reinterpret_cast<T *>(info->weight_data);
     auto train_step_num = info->data_size;
     if (train_step_num == 0) {
       *info->require_aggr = false;
@@ -118,9 +152,7 @@ class FedAvgKernel {
       return true;
     }
     auto elem_num = info->weight_size / sizeof(T);
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] = train_step_num * weight_addr[i] / fednova_weight;
-    }
+    VectorMulDivT(weight_addr, train_step_num, fednova_weight, elem_num);
     return true;
   }
 
@@ -134,11 +166,24 @@ class FedAvgKernel {
     auto new_weight_addr = reinterpret_cast<const T *>(update_weight.addr);
 
     auto elem_num = info->weight_size / sizeof(T);
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] += new_weight_addr[i];
-    }
+    VectorAddT(weight_addr, new_weight_addr, elem_num);
     info->data_size += update_data_size;
   }
+
+  // Accumulate elements [elem_offset, elem_offset + elem_num) of the update, used by the sharded aggregation. The data
+  // size is only accumulated by the segment which starts at the first element, so it is counted once per update.
+  static void LaunchSegment(const Address &update_weight, size_t update_data_size, size_t elem_offset, size_t elem_num,
+                            ParamAggregationInfo *info) {
+    if (info == nullptr || (elem_offset + elem_num) * sizeof(T) > info->weight_size) {
+      return;
+    }
+    auto weight_addr = reinterpret_cast<T *>(info->weight_data) + elem_offset;
+    auto new_weight_addr = reinterpret_cast<const T *>(update_weight.addr) + elem_offset;
+    VectorAddT(weight_addr, new_weight_addr, elem_num);
+    if (elem_offset == 0) {
+      info->data_size += update_data_size;
+    }
+  }
 };
 }  // namespace kernel
 }  // namespace server
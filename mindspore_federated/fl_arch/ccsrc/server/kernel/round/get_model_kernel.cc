@@ -15,6 +15,7 @@
  */
 
 #include "server/kernel/round/get_model_kernel.h"
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -77,14 +78,20 @@ void GetModelKernel::GetModel(const schema::RequestGetModel *get_model_req,
     SendResponseMsg(message, reason.c_str(), reason.size());
     return;
   }
+  // Read before checking the model, so that a model stored before the request is parked launches it again.
+  auto long_poll_generation = LongPollGeneration();
   auto next_req_time = LocalMetaStore::GetInstance().value<uint64_t>(kCtxIterationNextRequestTimestamp);
   ModelItemPtr model_item = nullptr;
   size_t current_iter = cache::InstanceContext::Instance().iteration_num();
   size_t get_model_iter = IntToSize(get_model_req->iteration());
   const auto &iter_to_model = ModelStore::GetInstance().iteration_to_model();
   size_t model_latest_iter_num = iter_to_model.rbegin()->first;
-  // If this iteration is not finished yet, return ResponseCode_SucNotReady so that clients could get model later.
+  // If this iteration is not finished yet, park the request until the model is stored when long poll is enabled,
+  // otherwise return ResponseCode_SucNotReady so that clients could get model later.
   if (current_iter == get_model_iter && model_latest_iter_num != current_iter) {
+    if (ParkRequest(message, long_poll_generation)) {
+      return;
+    }
     std::string reason = "The model is not ready yet for iteration " + std::to_string(get_model_iter) +
                          ". Maybe this is because\n" + "1. Client doesn't not send enough update model request.\n" +
                          "2. Worker has not push weights to server.";
@@ -105,6 +112,9 @@ void GetModelKernel::GetModel(const schema::RequestGetModel *get_model_req,
                   << " is invalid. Current iteration is " << std::to_string(current_iter);
     real_get_model_iter = current_iter - 1;
   }
+  if (GetModelDelta(get_model_req, message, current_iter, real_get_model_iter, next_req_time)) {
+    return;
+  }
   auto download_compress_types = get_model_req->download_compress_types();
   schema::CompressType compressType =
     mindspore::fl::compression::CompressExecutor::GetInstance().GetCompressType(download_compress_types);
@@ -153,8 +163,6 @@ void GetModelKernel::BuildGetModelRsp(const std::shared_ptr<FBBuilder> &fbb, con
     MS_LOG(ERROR) << "Input fbb is nullptr.";
     return;
   }
-  auto server_mode = FLContext::instance()->server_mode();
-  auto aggregation_type = FLContext::instance()->aggregation_type();
   auto fbs_reason = fbb->CreateString(reason);
   auto fbs_timestamp = fbb->CreateString(timestamp);
   std::vector<flatbuffers::Offset<schema::FeatureMap>> fbs_feature_maps;
@@ -162,9 +170,7 @@ void GetModelKernel::BuildGetModelRsp(const std::shared_ptr<FBBuilder> &fbb, con
     auto weight_data = model->weight_data.data();
     for (const auto &feature : model->weight_items) {
       auto weight_item = feature.second;
-      bool flag1 = (!weight_item.require_aggr && server_mode != kServerModeHybrid);
-      bool flag2 = (aggregation_type == kScaffoldAggregation && startswith(feature.first, kControlPrefix));
-      if (flag1 || flag2) {
+      if (!IsWeightDownloaded(feature.first, weight_item)) {
         continue;
       }
       auto fbs_weight_fullname = fbb->CreateString(feature.first);
@@ -216,6 +222,108 @@ void GetModelKernel::BuildGetModelRsp(const std::shared_ptr<FBBuilder> &fbb, con
   return;
 }
 
+bool GetModelKernel::GetModelDelta(const schema::RequestGetModel *get_model_req,
+                                   const std::shared_ptr<MessageHandler> &message, size_t current_iter,
+                                   size_t model_iter, uint64_t next_req_time) {
+  auto sparse_rate = FLContext::instance()->compression_config().download_sparse_rate;
+  int base_iter = get_model_req->base_iteration();
+  auto download_compress_types = get_model_req->download_compress_types();
+  if (sparse_rate <= 0.0f || base_iter < 0 || IntToSize(base_iter) > model_iter ||
+      download_compress_types == nullptr) {
+    return false;
+  }
+  auto support_types = download_compress_types->data();
+  if (std::find(support_types, support_types + download_compress_types->size(),
+                schema::CompressType_DIFF_SPARSE_QUANT) == support_types + download_compress_types->size()) {
+    return false;
+  }
+  // The delta of each base iteration is cached separately.
+  std::string compress_type = std::string(kDiffSparseQuant) + "_" + std::to_string(base_iter);
+  auto cache = ModelStore::GetInstance().GetModelResponseCache(name_, current_iter, model_iter, compress_type);
+  if (cache == nullptr) {
+    // ModelStore keeps the latest max_model_count_ models, so the base of the client is at most max_model_count_ - 1
+    // iterations behind the model. An older base is not stored, the full model is responded and becomes the new base.
+    auto base_model = ModelStore::GetInstance().GetModelByIterNum(IntToSize(base_iter));
+    auto model = ModelStore::GetInstance().GetModelByIterNum(model_iter);
+    if (base_model == nullptr || model == nullptr) {
+      MS_LOG(DEBUG) << "The model of iteration " << base_iter << " held by the client is not stored, respond the full "
+                    << "model of iteration " << model_iter;
+      return false;
+    }
+    std::map<std::string, compression::CompressWeight> delta_weights;
+    auto &compress_executor = compression::CompressExecutor::GetInstance();
+    if (!compress_executor.sparse_diff_quant(&delta_weights, base_model, model, sparse_rate,
+                                             compression::kCompressTypeMap.at(schema::CompressType_QUANT))) {
+      MS_LOG(INFO) << "Compress the model delta between iteration " << base_iter << " and " << model_iter
+                   << " failed, respond the full model.";
+      return false;
+    }
+    for (auto iter = delta_weights.begin(); iter != delta_weights.end();) {
+      if (!IsWeightDownloaded(iter->first, model->weight_items.at(iter->first))) {
+        iter = delta_weights.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    std::shared_ptr<FBBuilder> fbb = std::make_shared<FBBuilder>();
+    BuildGetModelDeltaRsp(fbb, "Get model delta for iteration " + std::to_string(model_iter), current_iter,
+                          std::to_string(next_req_time), IntToSize(base_iter), delta_weights);
+    cache = ModelStore::GetInstance().StoreModelResponseCache(name_, current_iter, model_iter, compress_type,
+                                                              fbb->GetBufferPointer(), fbb->GetSize());
+    if (cache == nullptr) {
+      SendResponseMsg(message, fbb->GetBufferPointer(), fbb->GetSize());
+      return true;
+    }
+  }
+  SendResponseMsgInference(message, cache->data(), cache->size(), ModelStore::GetInstance().RelModelResponseCache);
+  return true;
+}
+
+void GetModelKernel::BuildGetModelDeltaRsp(const std::shared_ptr<FBBuilder> &fbb, const std::string &reason,
+                                           const size_t iter, const std::string &timestamp, const size_t base_iter,
+                                           const std::map<std::string, compression::CompressWeight> &delta_weights) {
+  if (fbb == nullptr) {
+    MS_LOG(ERROR) << "Input fbb is nullptr.";
+    return;
+  }
+  auto fbs_reason = fbb->CreateString(reason);
+  auto fbs_timestamp = fbb->CreateString(timestamp);
+  std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> fbs_compress_feature_maps;
+  for (const auto &delta_weight : delta_weights) {
+    const auto &weight = delta_weight.second;
+    auto fbs_weight_fullname = fbb->CreateString(delta_weight.first);
+    auto fbs_compress_data = fbb->CreateVector(weight.compress_data);
+    auto fbs_index_array = fbb->CreateVector(weight.indices);
+    auto fbs_compress_feature_map =
+      schema::CreateCompressFeatureMap(*(fbb.get()), fbs_weight_fullname, fbs_compress_data, weight.min_val,
+                                       weight.max_val, fbs_index_array);
+    fbs_compress_feature_maps.push_back(fbs_compress_feature_map);
+  }
+  auto fbs_compress_feature_maps_vector = fbb->CreateVector(fbs_compress_feature_maps);
+  std::vector<flatbuffers::Offset<schema::FeatureMap>> fbs_feature_maps;
+  auto fbs_feature_maps_vector = fbb->CreateVector(fbs_feature_maps);
+
+  schema::ResponseGetModelBuilder rsp_get_model_builder(*(fbb.get()));
+  rsp_get_model_builder.add_retcode(static_cast<int>(schema::ResponseCode_SUCCEED));
+  rsp_get_model_builder.add_reason(fbs_reason);
+  rsp_get_model_builder.add_iteration(static_cast<int>(iter));
+  rsp_get_model_builder.add_feature_map(fbs_feature_maps_vector);
+  rsp_get_model_builder.add_timestamp(fbs_timestamp);
+  rsp_get_model_builder.add_download_compress_type(schema::CompressType_DIFF_SPARSE_QUANT);
+  rsp_get_model_builder.add_compress_feature_map(fbs_compress_feature_maps_vector);
+  rsp_get_model_builder.add_base_iteration(static_cast<int>(base_iter));
+  auto rsp_get_model = rsp_get_model_builder.Finish();
+  fbb->Finish(rsp_get_model);
+}
+
+bool GetModelKernel::IsWeightDownloaded(const std::string &weight_name, const WeightItem &weight_item) const {
+  auto server_mode = FLContext::instance()->server_mode();
+  auto aggregation_type = FLContext::instance()->aggregation_type();
+  bool flag1 = (!weight_item.require_aggr && server_mode != kServerModeHybrid);
+  bool flag2 = (aggregation_type == kScaffoldAggregation && startswith(weight_name, kControlPrefix));
+  return !(flag1 || flag2);
+}
+
 REG_ROUND_KERNEL(getModel, GetModelKernel)
 }  // namespace kernel
 }  // namespace server
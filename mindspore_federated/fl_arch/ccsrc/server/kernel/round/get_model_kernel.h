@@ -48,6 +48,15 @@ class GetModelKernel : public RoundKernel {
                         const std::string &timestamp,
                         const schema::CompressType &compressType = schema::CompressType_NO_COMPRESS,
                         const std::map<std::string, AddressPtr> &compress_feature_maps = {});
+  // Respond the delta of the model against the last full model downloaded by the client. Returns false if the delta
+  // download is not enabled or not supported by the client, the full model of the client is too old or not stored any
+  // more, or any weight cannot be diffed, in which case the full model should be responded.
+  bool GetModelDelta(const schema::RequestGetModel *get_model_req, const std::shared_ptr<MessageHandler> &message,
+                     size_t current_iter, size_t model_iter, uint64_t next_req_time);
+  void BuildGetModelDeltaRsp(const std::shared_ptr<FBBuilder> &fbb, const std::string &reason, const size_t iter,
+                             const std::string &timestamp, const size_t base_iter,
+                             const std::map<std::string, compression::CompressWeight> &delta_weights);
+  bool IsWeightDownloaded(const std::string &weight_name, const WeightItem &weight_item) const;
 
   // The count of retrying because the iteration is not finished.
   std::atomic<uint64_t> retry_count_ = 0;
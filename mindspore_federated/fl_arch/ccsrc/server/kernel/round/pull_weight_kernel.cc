@@ -37,6 +37,7 @@ bool PullWeightKernel::Launch(const uint8_t *req_data, size_t len, const std::sh
   }
   auto current_iter = cache::InstanceContext::Instance().iteration_num();
   FBBuilder fbb;
+  auto long_poll_generation = LongPollGeneration();
   auto status = Executor::GetInstance().HandlePullWeightRequest(req_data, len, &fbb);
   if (status == kAggregationNotDone) {
     // this server has skip aggregation, pull weight from other servers
@@ -48,6 +49,9 @@ bool PullWeightKernel::Launch(const uint8_t *req_data, size_t len, const std::sh
         SendResponseMsg(message, output->data(), output->size());
         return true;
       }
+    } else if (ParkRequest(message, long_poll_generation)) {
+      // Wait for the aggregation of this server instead of letting the worker retry later.
+      return true;
     }
   }
   // aggregation not done yet, or some other error happened
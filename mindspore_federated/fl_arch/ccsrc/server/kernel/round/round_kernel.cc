@@ -49,6 +49,14 @@ void RoundKernel::OnLastCountEvent() {}
 
 void RoundKernel::set_name(const std::string &name) { name_ = name; }
 
+void RoundKernel::set_resume_callback(const ResumeCallback &resume_callback) { resume_callback_ = resume_callback; }
+
+bool RoundKernel::ParkRequest(const std::shared_ptr<MessageHandler> &message, uint64_t generation) {
+  return LongPollService::GetInstance().Park(message, resume_callback_, generation);
+}
+
+uint64_t RoundKernel::LongPollGeneration() const { return LongPollService::GetInstance().generation(); }
+
 void RoundKernel::SendResponseMsg(const std::shared_ptr<MessageHandler> &message, const void *data, size_t len) {
   if (!verifyResponse(message, data, len)) {
     return;
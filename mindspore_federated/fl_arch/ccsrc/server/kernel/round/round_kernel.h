@@ -34,6 +34,7 @@
 #include "distributed_cache/counter.h"
 #include "distributed_cache/instance_context.h"
 #include "server/executor.h"
+#include "server/long_poll_service.h"
 
 namespace mindspore {
 namespace fl {
@@ -75,6 +76,9 @@ class RoundKernel {
   // Set round kernel name, which could be used in round kernel's methods.
   void set_name(const std::string &name);
 
+  // Set the callback which launches the parked requests of this round again.
+  void set_resume_callback(const ResumeCallback &resume_callback);
+
   void Summarize();
 
   void IncreaseTotalClientNum();
@@ -136,6 +140,11 @@ class RoundKernel {
   // Send response to client, and the data will be released by cb after finished send msg.
   void SendResponseMsgInference(const std::shared_ptr<MessageHandler> &message, const void *data, size_t len,
                                 RefBufferRelCallback cb);
+  // Park the request which is not ready yet until the model is updated. Returns false if the long poll is disabled or
+  // the request has timed out, and the request should be responded at once. The generation is read by
+  // LongPollGeneration before checking whether the request is ready.
+  bool ParkRequest(const std::shared_ptr<MessageHandler> &message, uint64_t generation);
+  uint64_t LongPollGeneration() const;
   sigVerifyResult VerifySignatureBase(const std::string &fl_id, const std::vector<std::string> &src_data,
                                       const flatbuffers::Vector<uint8_t> *signature, const std::string &timestamp);
   sigVerifyResult VerifySignatureBase(const std::string &fl_id, const std::vector<uint8_t> &src_data,
@@ -166,6 +175,7 @@ class RoundKernel {
 
   size_t iteration_time_window_ = 0;
   Executor *executor_ = nullptr;
+  ResumeCallback resume_callback_ = nullptr;
 
   // The mutex for send_data_and_time_
   std::mutex send_data_rate_mutex_;
@@ -0,0 +1,176 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "server/kernel/vector_ops.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+namespace {
+void ScalarAdd(float *dst, const float *src, size_t start, size_t elem_num) {
+  for (size_t i = start; i < elem_num; i++) {
+    dst[i] += src[i];
+  }
+}
+
+void ScalarDiv(float *dst, float divisor, size_t start, size_t elem_num) {
+  for (size_t i = start; i < elem_num; i++) {
+    dst[i] /= divisor;
+  }
+}
+
+void ScalarMulDiv(float *dst, float multiplier, float divisor, size_t start, size_t elem_num) {
+  for (size_t i = start; i < elem_num; i++) {
+    dst[i] = multiplier * dst[i] / divisor;
+  }
+}
+
+#if defined(__x86_64__)
+constexpr size_t kAvx512FloatNum = 16;
+constexpr size_t kAvx2FloatNum = 8;
+
+__attribute__((target("avx512f"))) void Avx512Add(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_loadu_ps(src + i)));
+  }
+  ScalarAdd(dst, src, i, elem_num);
+}
+
+__attribute__((target("avx512f"))) void Avx512Div(float *dst, float divisor, size_t elem_num) {
+  size_t i = 0;
+  __m512 div = _mm512_set1_ps(divisor);
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    _mm512_storeu_ps(dst + i, _mm512_div_ps(_mm512_loadu_ps(dst + i), div));
+  }
+  ScalarDiv(dst, divisor, i, elem_num);
+}
+
+__attribute__((target("avx512f"))) void Avx512MulDiv(float *dst, float multiplier, float divisor, size_t elem_num) {
+  size_t i = 0;
+  __m512 mul = _mm512_set1_ps(multiplier);
+  __m512 div = _mm512_set1_ps(divisor);
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    _mm512_storeu_ps(dst + i, _mm512_div_ps(_mm512_mul_ps(mul, _mm512_loadu_ps(dst + i)), div));
+  }
+  ScalarMulDiv(dst, multiplier, divisor, i, elem_num);
+}
+
+__attribute__((target("avx2"))) void Avx2Add(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+  }
+  ScalarAdd(dst, src, i, elem_num);
+}
+
+__attribute__((target("avx2"))) void Avx2Div(float *dst, float divisor, size_t elem_num) {
+  size_t i = 0;
+  __m256 div = _mm256_set1_ps(divisor);
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    _mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_loadu_ps(dst + i), div));
+  }
+  ScalarDiv(dst, divisor, i, elem_num);
+}
+
+__attribute__((target("avx2"))) void Avx2MulDiv(float *dst, float multiplier, float divisor, size_t elem_num) {
+  size_t i = 0;
+  __m256 mul = _mm256_set1_ps(multiplier);
+  __m256 div = _mm256_set1_ps(divisor);
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    _mm256_storeu_ps(dst + i, _mm256_div_ps(_mm256_mul_ps(mul, _mm256_loadu_ps(dst + i)), div));
+  }
+  ScalarMulDiv(dst, multiplier, divisor, i, elem_num);
+}
+#elif defined(__aarch64__)
+constexpr size_t kNeonFloatNum = 4;
+
+void NeonAdd(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+  }
+  ScalarAdd(dst, src, i, elem_num);
+}
+
+void NeonDiv(float *dst, float divisor, size_t elem_num) {
+  size_t i = 0;
+  float32x4_t div = vdupq_n_f32(divisor);
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vdivq_f32(vld1q_f32(dst + i), div));
+  }
+  ScalarDiv(dst, divisor, i, elem_num);
+}
+
+void NeonMulDiv(float *dst, float multiplier, float divisor, size_t elem_num) {
+  size_t i = 0;
+  float32x4_t mul = vdupq_n_f32(multiplier);
+  float32x4_t div = vdupq_n_f32(divisor);
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vdivq_f32(vmulq_f32(mul, vld1q_f32(dst + i)), div));
+  }
+  ScalarMulDiv(dst, multiplier, divisor, i, elem_num);
+}
+#endif
+
+void DefaultAdd(float *dst, const float *src, size_t elem_num) { ScalarAdd(dst, src, 0, elem_num); }
+void DefaultDiv(float *dst, float divisor, size_t elem_num) { ScalarDiv(dst, divisor, 0, elem_num); }
+void DefaultMulDiv(float *dst, float multiplier, float divisor, size_t elem_num) {
+  ScalarMulDiv(dst, multiplier, divisor, 0, elem_num);
+}
+
+const VectorOpsImpl &GetVectorOpsImpl() {
+  static const VectorOpsImpl impl = AvailableVectorOpsImpls().front();
+  return impl;
+}
+}  // namespace
+
+std::vector<VectorOpsImpl> AvailableVectorOpsImpls() {
+  std::vector<VectorOpsImpl> impls;
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    impls.push_back({"avx512", Avx512Add, Avx512Div, Avx512MulDiv});
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    impls.push_back({"avx2", Avx2Add, Avx2Div, Avx2MulDiv});
+  }
+#elif defined(__aarch64__)
+  impls.push_back({"neon", NeonAdd, NeonDiv, NeonMulDiv});
+#endif
+  impls.push_back({"scalar", DefaultAdd, DefaultDiv, DefaultMulDiv});
+  return impls;
+}
+
+void VectorAdd(float *dst, const float *src, size_t elem_num) { GetVectorOpsImpl().add(dst, src, elem_num); }
+
+void VectorDiv(float *dst, float divisor, size_t elem_num) { GetVectorOpsImpl().div(dst, divisor, elem_num); }
+
+void VectorMulDiv(float *dst, float multiplier, float divisor, size_t elem_num) {
+  GetVectorOpsImpl().mul_div(dst, multiplier, divisor, elem_num);
+}
+
+const char *VectorOpsImplName() { return GetVectorOpsImpl().name; }
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
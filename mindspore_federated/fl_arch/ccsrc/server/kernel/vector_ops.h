@@ -0,0 +1,88 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_KERNEL_VECTOR_OPS_H_
+#define MINDSPORE_CCSRC_FL_SERVER_KERNEL_VECTOR_OPS_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+// Element-wise float operations used by the aggregation kernels. The AVX-512, AVX2 or NEON implementation is chosen
+// once at runtime according to the cpu features, and the scalar implementation is used as the fallback.
+
+// dst[i] += src[i]
+void VectorAdd(float *dst, const float *src, size_t elem_num);
+// dst[i] /= divisor
+void VectorDiv(float *dst, float divisor, size_t elem_num);
+// dst[i] = multiplier * dst[i] / divisor
+void VectorMulDiv(float *dst, float multiplier, float divisor, size_t elem_num);
+
+// Returns the name of the implementation chosen at runtime, such as "avx512", "avx2", "neon" or "scalar".
+const char *VectorOpsImplName();
+
+struct VectorOpsImpl {
+  const char *name;
+  void (*add)(float *dst, const float *src, size_t elem_num);
+  void (*div)(float *dst, float divisor, size_t elem_num);
+  void (*mul_div)(float *dst, float multiplier, float divisor, size_t elem_num);
+};
+
+// Returns the implementations supported by the cpu from the fastest to the scalar one, the first is used by the
+// functions above. The tests check each of them against the scalar one.
+std::vector<VectorOpsImpl> AvailableVectorOpsImpls();
+
+template <typename T>
+void VectorAddT(T *dst, const T *src, size_t elem_num) {
+  if constexpr (std::is_same_v<T, float>) {
+    VectorAdd(dst, src, elem_num);
+  } else {
+    for (size_t i = 0; i < elem_num; i++) {
+      dst[i] += src[i];
+    }
+  }
+}
+
+template <typename T, typename S>
+void VectorDivT(T *dst, S divisor, size_t elem_num) {
+  if constexpr (std::is_same_v<T, float>) {
+    VectorDiv(dst, static_cast<float>(divisor), elem_num);
+  } else {
+    for (size_t i = 0; i < elem_num; i++) {
+      dst[i] /= divisor;
+    }
+  }
+}
+
+template <typename T, typename S>
+void VectorMulDivT(T *dst, S multiplier, float divisor, size_t elem_num) {
+  if constexpr (std::is_same_v<T, float>) {
+    VectorMulDiv(dst, static_cast<float>(multiplier), divisor, elem_num);
+  } else {
+    for (size_t i = 0; i < elem_num; i++) {
+      dst[i] = multiplier * dst[i] / divisor;
+    }
+  }
+}
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_KERNEL_VECTOR_OPS_H_
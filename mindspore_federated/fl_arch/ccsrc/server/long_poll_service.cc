@@ -0,0 +1,170 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "server/long_poll_service.h"
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+// The state of the request being resumed in this thread. The resume callback launches the round kernel synchronously,
+// so a request parked again in it keeps its deadline, and a timed out request is not parked again.
+thread_local bool g_resuming = false;
+thread_local bool g_timed_out = false;
+thread_local std::chrono::steady_clock::time_point g_resume_deadline;
+}  // namespace
+
+void LongPollService::Initialize(uint64_t timeout_in_ms) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (running_ || timeout_in_ms == 0) {
+    return;
+  }
+  MS_LOG(INFO) << "Long poll for the requests which are not ready is enabled, timeout: " << timeout_in_ms << "ms.";
+  timeout_in_ms_ = timeout_in_ms;
+  running_ = true;
+  resume_thread_ = std::thread([this]() { ResumeLoop(); });
+}
+
+void LongPollService::Stop() {
+  std::vector<ParkedRequest> requests;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+    for (auto &item : parked_requests_) {
+      requests.emplace_back(std::move(item.second));
+    }
+    parked_requests_.clear();
+  }
+  cv_.notify_all();
+  if (resume_thread_.joinable()) {
+    resume_thread_.join();
+  }
+  for (const auto &request : requests) {
+    Resume(request, true);
+  }
+}
+
+bool LongPollService::Park(const std::shared_ptr<MessageHandler> &message, const ResumeCallback &resume,
+                           uint64_t generation) {
+  if (message == nullptr || resume == nullptr) {
+    return false;
+  }
+  auto now = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (!running_) {
+    return false;
+  }
+  auto deadline = now + std::chrono::milliseconds(timeout_in_ms_);
+  if (g_resuming) {
+    if (g_timed_out || g_resume_deadline <= now) {
+      return false;
+    }
+    deadline = g_resume_deadline;
+  }
+  auto iter = parked_requests_.emplace(deadline, ParkedRequest{message, resume, deadline});
+  bool is_earliest = iter == parked_requests_.begin();
+  // Notify has been called since the request found it's not ready, so it may be ready now.
+  bool missed_notify = generation != generation_;
+  if (missed_notify) {
+    notified_ = true;
+  }
+  lock.unlock();
+  // The resume thread sleeps until the earliest deadline.
+  if (is_earliest || missed_notify) {
+    cv_.notify_all();
+  }
+  return true;
+}
+
+void LongPollService::Notify() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    generation_++;
+    if (!running_ || parked_requests_.empty()) {
+      return;
+    }
+    notified_ = true;
+  }
+  cv_.notify_all();
+}
+
+uint64_t LongPollService::generation() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return generation_;
+}
+
+void LongPollService::ResumeLoop() {
+  while (true) {
+    std::vector<ParkedRequest> requests;
+    bool timed_out = false;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      if (running_ && !notified_) {
+        if (parked_requests_.empty()) {
+          cv_.wait(lock);
+        } else {
+          (void)cv_.wait_until(lock, parked_requests_.begin()->first);
+        }
+      }
+      if (!running_) {
+        return;
+      }
+      auto end = parked_requests_.end();
+      if (notified_) {
+        notified_ = false;
+      } else {
+        end = parked_requests_.upper_bound(std::chrono::steady_clock::now());
+        timed_out = true;
+      }
+      for (auto iter = parked_requests_.begin(); iter != end; ++iter) {
+        requests.emplace_back(std::move(iter->second));
+      }
+      (void)parked_requests_.erase(parked_requests_.begin(), end);
+    }
+    for (const auto &request : requests) {
+      Resume(request, timed_out);
+    }
+  }
+}
+
+void LongPollService::Resume(const ParkedRequest &request, bool timed_out) {
+  auto message = request.message;
+  auto resume = request.resume;
+  auto deadline = request.deadline;
+  auto task = [message, resume, deadline, timed_out]() {
+    g_resuming = true;
+    g_timed_out = timed_out;
+    g_resume_deadline = deadline;
+    try {
+      resume(message);
+    } catch (const std::exception &e) {
+      MS_LOG(WARNING) << "Catch exception when resuming the parked request: " << e.what();
+    }
+    g_resuming = false;
+  };
+  if (!message->RunInResponseThread(std::move(task))) {
+    MS_LOG(WARNING) << "Resuming the parked request failed.";
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_LONG_POLL_SERVICE_H_
+#define MINDSPORE_CCSRC_FL_SERVER_LONG_POLL_SERVICE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "common/communicator/message_handler.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+// Launch the parked request again. It's called in the response thread of the message.
+using ResumeCallback = std::function<void(const std::shared_ptr<MessageHandler> &message)>;
+
+// LongPollService parks the requests which are not ready yet, such as getModel before the model of the iteration is
+// stored and pullWeight before the aggregation is done, instead of responding SucNotReady and being polled by the
+// clients. The parked requests are launched again once Notify is called. The requests which are still not ready are
+// parked again, until they reach the long poll timeout and are responded as before.
+// A request reads generation() before checking whether it's ready and passes it to Park. If Notify is called between
+// the check and Park, the generation has changed and the request is launched again at once instead of waiting for the
+// next Notify or the timeout.
+class LongPollService {
+ public:
+  static LongPollService &GetInstance() {
+    static LongPollService instance;
+    return instance;
+  }
+
+  // The long poll is disabled if timeout_in_ms is 0.
+  void Initialize(uint64_t timeout_in_ms);
+  // Resume all the parked requests as timed out.
+  void Stop();
+
+  // Returns false if the request should be responded at once: the long poll is disabled, or the request has been
+  // parked till the timeout. The generation is the one read before the request found it's not ready.
+  bool Park(const std::shared_ptr<MessageHandler> &message, const ResumeCallback &resume, uint64_t generation);
+
+  // Launch all the parked requests again, called when the model or the aggregation status is updated.
+  void Notify();
+
+  // The number of calls of Notify.
+  uint64_t generation();
+
+ private:
+  LongPollService() = default;
+  ~LongPollService() { Stop(); }
+
+  using TimePoint = std::chrono::steady_clock::time_point;
+  struct ParkedRequest {
+    std::shared_ptr<MessageHandler> message;
+    ResumeCallback resume;
+    TimePoint deadline;
+  };
+
+  void ResumeLoop();
+  void Resume(const ParkedRequest &request, bool timed_out);
+
+  uint64_t timeout_in_ms_ = 0;
+  std::thread resume_thread_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  bool notified_ = false;
+  uint64_t generation_ = 0;
+  // The parked requests sorted by deadline.
+  std::multimap<TimePoint, ParkedRequest> parked_requests_;
+};
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_LONG_POLL_SERVICE_H_
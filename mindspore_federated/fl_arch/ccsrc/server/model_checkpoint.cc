@@ -0,0 +1,473 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "server/model_checkpoint.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr char kCheckpointMagic[8] = {'M', 'S', 'F', 'L', 'M', 'D', 'L', '\0'};
+constexpr uint32_t kCheckpointVersion = 2;
+constexpr size_t kCheckpointAlignment = 4096;
+constexpr char kCheckpointSuffix[] = ".msmodel";
+constexpr char kTempFileSuffix[] = ".tmp";
+constexpr size_t kMaxIterationDigitNum = 19;
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+struct CheckpointHeader {
+  char magic[sizeof(kCheckpointMagic)];
+  uint32_t version;
+  uint32_t weight_num;
+  uint64_t iteration;
+  uint64_t index_offset;
+  uint64_t index_size;
+  uint64_t data_offset;
+  uint64_t data_size;
+  uint64_t index_checksum;
+  // The renamed file may have garbage weight data after the machine crashes if it is not synced, so the weight data is
+  // checksummed too.
+  uint64_t data_checksum;
+};
+
+uint64_t Checksum(const char *data, size_t len) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * kFnvPrime;
+  }
+  return hash;
+}
+
+// The weight data may be hundreds of megabytes, so it is hashed by 64-bit words instead of bytes.
+uint64_t DataChecksum(const uint8_t *data, size_t len) {
+  uint64_t hash = kFnvOffsetBasis;
+  size_t word_num = len / sizeof(uint64_t);
+  for (size_t i = 0; i < word_num; i++) {
+    uint64_t word = 0;
+    (void)memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+    hash = (hash ^ word) * kFnvPrime;
+  }
+  for (size_t i = word_num * sizeof(uint64_t); i < len; i++) {
+    hash = (hash ^ data[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+bool SyncDir(const std::string &dir_path) {
+  int fd = open(dir_path.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ret = fsync(fd) == 0;
+  ret = (close(fd) == 0) && ret;
+  return ret;
+}
+
+template <typename T>
+void AppendValue(std::string *buffer, T value) {
+  (void)buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void AppendString(std::string *buffer, const std::string &str) {
+  AppendValue<uint32_t>(buffer, static_cast<uint32_t>(str.size()));
+  (void)buffer->append(str);
+}
+
+// Reads the index with bounds check, since the file may be written by another version or corrupted.
+class IndexReader {
+ public:
+  IndexReader(const char *data, size_t len) : cur_(data), end_(data + len) {}
+
+  template <typename T>
+  bool ReadValue(T *value) {
+    if (static_cast<size_t>(end_ - cur_) < sizeof(T)) {
+      return false;
+    }
+    (void)memcpy(value, cur_, sizeof(T));
+    cur_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string *str) {
+    uint32_t len = 0;
+    if (!ReadValue(&len) || static_cast<size_t>(end_ - cur_) < len) {
+      return false;
+    }
+    str->assign(cur_, len);
+    cur_ += len;
+    return true;
+  }
+
+ private:
+  const char *cur_;
+  const char *end_;
+};
+
+std::string SerializeIndex(const std::map<std::string, WeightItem> &weight_items) {
+  std::string index;
+  for (const auto &item : weight_items) {
+    const auto &weight = item.second;
+    AppendString(&index, weight.name);
+    AppendValue<uint64_t>(&index, weight.offset);
+    AppendValue<uint64_t>(&index, weight.size);
+    AppendString(&index, weight.type);
+    AppendValue<uint32_t>(&index, static_cast<uint32_t>(weight.shape.size()));
+    for (auto dim : weight.shape) {
+      AppendValue<uint64_t>(&index, dim);
+    }
+    AppendValue<uint8_t>(&index, weight.require_aggr ? 1 : 0);
+  }
+  return index;
+}
+
+bool ParseIndex(const char *data, size_t len, uint32_t weight_num, std::map<std::string, WeightItem> *weight_items) {
+  IndexReader reader(data, len);
+  for (uint32_t i = 0; i < weight_num; i++) {
+    WeightItem weight;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t shape_num = 0;
+    uint8_t require_aggr = 0;
+    if (!reader.ReadString(&weight.name) || !reader.ReadValue(&offset) || !reader.ReadValue(&size) ||
+        !reader.ReadString(&weight.type) || !reader.ReadValue(&shape_num)) {
+      return false;
+    }
+    for (uint32_t j = 0; j < shape_num; j++) {
+      uint64_t dim = 0;
+      if (!reader.ReadValue(&dim)) {
+        return false;
+      }
+      weight.shape.push_back(dim);
+    }
+    if (!reader.ReadValue(&require_aggr)) {
+      return false;
+    }
+    weight.offset = offset;
+    weight.size = size;
+    weight.require_aggr = require_aggr != 0;
+    (*weight_items)[weight.name] = weight;
+  }
+  return true;
+}
+
+bool SameWeightItems(const std::map<std::string, WeightItem> &lhs, const std::map<std::string, WeightItem> &rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (const auto &item : lhs) {
+    auto it = rhs.find(item.first);
+    if (it == rhs.end()) {
+      return false;
+    }
+    const auto &l = item.second;
+    const auto &r = it->second;
+    if (l.offset != r.offset || l.size != r.size || l.type != r.type || l.shape != r.shape) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WriteAll(int fd, const void *data, size_t len) {
+  auto cur = reinterpret_cast<const char *>(data);
+  while (len > 0) {
+    auto ret = write(fd, cur, len);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    cur += ret;
+    len -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+}  // namespace
+
+ModelCheckpoint::~ModelCheckpoint() { Stop(); }
+
+bool ModelCheckpoint::Initialize(const std::string &checkpoint_dir, const std::string &file_prefix,
+                                 uint64_t sync_interval) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (running_) {
+    return true;
+  }
+  if (checkpoint_dir.empty()) {
+    MS_LOG(INFO) << "The checkpoint dir is not set, the models will not be persisted.";
+    return false;
+  }
+  if (mkdir(checkpoint_dir.c_str(), S_IRWXU) != 0 && errno != EEXIST) {
+    MS_LOG(WARNING) << "Failed to create checkpoint dir " << checkpoint_dir << ", errno: " << errno
+                    << ", the models will not be persisted.";
+    return false;
+  }
+  checkpoint_dir_ = checkpoint_dir;
+  file_prefix_ = file_prefix;
+  sync_interval_ = std::max<uint64_t>(sync_interval, 1);
+  unsynced_num_ = 0;
+  has_synced_ = false;
+  running_ = true;
+  write_thread_ = std::thread(&ModelCheckpoint::WriteLoop, this);
+  MS_LOG(INFO) << "Model store checkpoint dir is: " << checkpoint_dir_ << ", file prefix is " << file_prefix_
+               << ", sync interval is " << sync_interval_;
+  return true;
+}
+
+void ModelCheckpoint::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (write_thread_.joinable()) {
+    write_thread_.join();
+  }
+}
+
+void ModelCheckpoint::SaveAsync(size_t iteration, const ModelItemPtr &model) {
+  if (model == nullptr || model->empty()) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!running_) {
+      return;
+    }
+    if (has_pending_) {
+      MS_LOG(INFO) << "The checkpoint of iteration " << pending_iteration_ << " is replaced by iteration " << iteration
+                   << " before being written.";
+    }
+    has_pending_ = true;
+    pending_iteration_ = iteration;
+    pending_model_ = model;
+  }
+  cv_.notify_one();
+}
+
+void ModelCheckpoint::WriteLoop() {
+  while (true) {
+    size_t iteration = 0;
+    ModelItemPtr model = nullptr;
+    bool stopping = false;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this] { return !running_ || has_pending_; });
+      // The pending model is still written when stopping, which is the latest model of the server.
+      if (!has_pending_) {
+        return;
+      }
+      iteration = pending_iteration_;
+      model = pending_model_;
+      stopping = !running_;
+      has_pending_ = false;
+      pending_model_ = nullptr;
+    }
+    // The pending models are coalesced, so the written checkpoints are counted instead of checking the iteration. The
+    // last checkpoint written when stopping is always synced.
+    bool sync = stopping || unsynced_num_ + 1 >= sync_interval_;
+    if (!Write(iteration, model, sync)) {
+      continue;
+    }
+    if (sync) {
+      unsynced_num_ = 0;
+      has_synced_ = true;
+      synced_iteration_ = iteration;
+    } else {
+      unsynced_num_++;
+    }
+    RemoveStaleCheckpoints(iteration);
+  }
+}
+
+std::string ModelCheckpoint::CheckpointPath(size_t iteration) const {
+  return checkpoint_dir_ + "/" + file_prefix_ + "_" + std::to_string(iteration) + kCheckpointSuffix;
+}
+
+bool ModelCheckpoint::Write(size_t iteration, const ModelItemPtr &model, bool sync) {
+  auto file_path = CheckpointPath(iteration);
+  auto temp_path = file_path + kTempFileSuffix;
+  std::string index = SerializeIndex(model->weight_items);
+  CheckpointHeader header{};
+  (void)memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+  header.version = kCheckpointVersion;
+  header.weight_num = static_cast<uint32_t>(model->weight_items.size());
+  header.iteration = iteration;
+  header.index_offset = sizeof(CheckpointHeader);
+  header.index_size = index.size();
+  header.data_offset = (header.index_offset + index.size() + kCheckpointAlignment - 1) / kCheckpointAlignment *
+                       kCheckpointAlignment;
+  header.data_size = model->weight_data.size();
+  header.index_checksum = Checksum(index.data(), index.size());
+  header.data_checksum = DataChecksum(model->weight_data.data(), model->weight_data.size());
+
+  int fd = open(temp_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Failed to open checkpoint file " << temp_path << ", errno: " << errno;
+    return false;
+  }
+  std::string padding(header.data_offset - header.index_offset - index.size(), '\0');
+  bool ret = WriteAll(fd, &header, sizeof(header)) && WriteAll(fd, index.data(), index.size()) &&
+             WriteAll(fd, padding.data(), padding.size()) &&
+             WriteAll(fd, model->weight_data.data(), model->weight_data.size()) && (!sync || fsync(fd) == 0);
+  ret = (close(fd) == 0) && ret;
+  if (!ret || rename(temp_path.c_str(), file_path.c_str()) != 0) {
+    MS_LOG(WARNING) << "Failed to write checkpoint file " << file_path << ", errno: " << errno;
+    (void)unlink(temp_path.c_str());
+    return false;
+  }
+  // The rename is durable only after the directory is synced.
+  if (sync && !SyncDir(checkpoint_dir_)) {
+    MS_LOG(WARNING) << "Failed to sync checkpoint dir " << checkpoint_dir_ << ", errno: " << errno;
+  }
+  MS_LOG(INFO) << "Write checkpoint of iteration " << iteration << " to " << file_path << " successfully.";
+  return true;
+}
+
+bool ModelCheckpoint::LoadFile(const std::string &file_path, size_t iteration, const ModelItemPtr &model) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Failed to open checkpoint file " << file_path << ", errno: " << errno;
+    return false;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(CheckpointHeader)) {
+    MS_LOG(WARNING) << "The checkpoint file " << file_path << " is invalid.";
+    (void)close(fd);
+    return false;
+  }
+  auto file_size = static_cast<size_t>(file_stat.st_size);
+  void *addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (addr == MAP_FAILED) {
+    MS_LOG(WARNING) << "Failed to map checkpoint file " << file_path << ", errno: " << errno;
+    return false;
+  }
+  (void)madvise(addr, file_size, MADV_SEQUENTIAL);
+  auto base = reinterpret_cast<const char *>(addr);
+  CheckpointHeader header{};
+  (void)memcpy(&header, base, sizeof(header));
+  std::map<std::string, WeightItem> weight_items;
+  std::string reason;
+  if (memcmp(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+      header.version != kCheckpointVersion) {
+    reason = "magic number or version mismatch";
+  } else if (header.iteration != iteration) {
+    reason = "iteration " + std::to_string(header.iteration) + " mismatch";
+  } else if (header.index_offset + header.index_size > file_size || header.data_offset % kCheckpointAlignment != 0 ||
+             header.data_offset + header.data_size != file_size) {
+    reason = "file size mismatch";
+  } else if (Checksum(base + header.index_offset, header.index_size) != header.index_checksum ||
+             !ParseIndex(base + header.index_offset, header.index_size, header.weight_num, &weight_items)) {
+    reason = "index is corrupted";
+  } else if (header.data_size != model->weight_data.size() || !SameWeightItems(weight_items, model->weight_items)) {
+    reason = "weights are not the same as the model";
+  } else if (DataChecksum(reinterpret_cast<const uint8_t *>(base + header.data_offset), header.data_size) !=
+             header.data_checksum) {
+    reason = "weight data is corrupted";
+  } else {
+    auto ret = memcpy_s(model->weight_data.data(), model->weight_data.size(), base + header.data_offset,
+                        header.data_size);
+    if (ret != EOK) {
+      reason = "memcpy_s failed, ret " + std::to_string(ret);
+    }
+  }
+  (void)munmap(addr, file_size);
+  if (!reason.empty()) {
+    MS_LOG(WARNING) << "Skip checkpoint file " << file_path << ": " << reason;
+    return false;
+  }
+  return true;
+}
+
+bool ModelCheckpoint::Load(size_t iteration, const ModelItemPtr &model) {
+  MS_ERROR_IF_NULL_W_RET_VAL(model, false);
+  // A checkpoint of an earlier iteration is never loaded, or its model would be served as the model of this iteration.
+  auto file_path = CheckpointPath(iteration);
+  if (access(file_path.c_str(), F_OK) != 0) {
+    MS_LOG(INFO) << "There is no checkpoint file of iteration " << iteration << " in " << checkpoint_dir_;
+    return false;
+  }
+  if (!LoadFile(file_path, iteration, model)) {
+    return false;
+  }
+  MS_LOG(INFO) << "Recover model of iteration " << iteration << " from checkpoint file " << file_path;
+  return true;
+}
+
+std::vector<std::pair<size_t, std::string>> ModelCheckpoint::ListCheckpoints() {
+  std::vector<std::pair<size_t, std::string>> checkpoints;
+  DIR *dir = opendir(checkpoint_dir_.c_str());
+  if (dir == nullptr) {
+    return checkpoints;
+  }
+  std::string prefix = file_prefix_ + "_";
+  std::string suffix = kCheckpointSuffix;
+  struct dirent *entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name = entry->d_name;
+    if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+      continue;
+    }
+    auto iteration_str = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+    if (iteration_str.size() > kMaxIterationDigitNum ||
+        !std::all_of(iteration_str.begin(), iteration_str.end(), ::isdigit)) {
+      continue;
+    }
+    checkpoints.emplace_back(std::stoull(iteration_str), checkpoint_dir_ + "/" + name);
+  }
+  (void)closedir(dir);
+  std::sort(checkpoints.begin(), checkpoints.end());
+  return checkpoints;
+}
+
+void ModelCheckpoint::RemoveStaleCheckpoints(size_t saved_iteration) {
+  // As ModelStore, the checkpoints of the iterations after the saved one are stale, e.g. the job has been reset.
+  auto checkpoints = ListCheckpoints();
+  std::vector<std::pair<size_t, std::string>> kept;
+  for (const auto &checkpoint : checkpoints) {
+    if (checkpoint.first > saved_iteration) {
+      (void)unlink(checkpoint.second.c_str());
+    } else {
+      kept.push_back(checkpoint);
+    }
+  }
+  if (has_synced_ && synced_iteration_ > saved_iteration) {
+    has_synced_ = false;
+  }
+  // The latest synced checkpoint is kept besides the latest ones, since the unsynced ones may be lost on a crash.
+  for (size_t i = 0; i + kMaxCheckpointFileNum < kept.size(); i++) {
+    if (has_synced_ && kept[i].first == synced_iteration_) {
+      continue;
+    }
+    (void)unlink(kept[i].second.c_str());
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
+#define MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "common/common.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+// The number of the latest checkpoint files kept for each server, the latest synced one is kept besides them.
+constexpr size_t kMaxCheckpointFileNum = 2;
+
+// ModelCheckpoint persists the models stored in ModelStore to the checkpoint directory, so that a restarted server
+// recovers its latest model from local disk instead of syncing it from other servers.
+// The checkpoint file is: a fixed header, the index of the weight items, then the raw weight data which starts at a
+// page aligned offset, so the file can be mapped and the weight data used in place.
+// The files are written by a background thread to a temporary file which is renamed after being written, so a crash
+// of the server process never leaves a partial checkpoint. Only every sync_interval-th written checkpoint is synced to
+// disk before the rename, the others may be lost or partially written if the machine crashes. Both the index and the
+// weight data are checksummed, so such a checkpoint is rejected when loading instead of serving garbage weights.
+class ModelCheckpoint {
+ public:
+  ModelCheckpoint() = default;
+  ~ModelCheckpoint();
+
+  // The file_prefix identifies the server, so that the servers sharing one directory do not overwrite each other.
+  bool Initialize(const std::string &checkpoint_dir, const std::string &file_prefix, uint64_t sync_interval = 1);
+
+  // Queue the model to be written. If the writing thread is busy, only the latest queued model is kept.
+  void SaveAsync(size_t iteration, const ModelItemPtr &model);
+
+  // Load the checkpoint of the iteration into the model. The weight items of the checkpoint should be the same as those
+  // of the model, and the model is not changed if the checkpoint is missing or invalid.
+  bool Load(size_t iteration, const ModelItemPtr &model);
+
+  void Stop();
+
+ private:
+  void WriteLoop();
+  bool Write(size_t iteration, const ModelItemPtr &model, bool sync);
+  bool LoadFile(const std::string &file_path, size_t iteration, const ModelItemPtr &model);
+  // Returns the checkpoint files of this server sorted by iteration.
+  std::vector<std::pair<size_t, std::string>> ListCheckpoints();
+  void RemoveStaleCheckpoints(size_t saved_iteration);
+  std::string CheckpointPath(size_t iteration) const;
+
+  std::string checkpoint_dir_;
+  std::string file_prefix_;
+  uint64_t sync_interval_ = 1;
+  // Only accessed by the writing thread.
+  uint64_t unsynced_num_ = 0;
+  bool has_synced_ = false;
+  size_t synced_iteration_ = 0;
+  std::thread write_thread_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  bool has_pending_ = false;
+  size_t pending_iteration_ = 0;
+  ModelItemPtr pending_model_ = nullptr;
+};
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
@@ -15,6 +15,8 @@
  */
 
 #include "server/model_store.h"
+#include <algorithm>
+#include <cctype>
 #include <map>
 #include <string>
 #include <memory>
@@ -34,13 +36,31 @@ void ModelStore::Initialize(const std::vector<InputWeight> &feature_map, uint32_
   if (!LocalMetaStore::GetInstance().verifyAggregationFeatureMap(initial_model_)) {
     MS_LOG(EXCEPTION) << "Verify feature map failed for initial model.";
   }
+  InitCheckpoint(latest_iteration_num);
   iteration_to_model_[latest_iteration_num] = initial_model_;
   for (const auto &item : mindspore::fl::compression::kCompressTypeMap) {
     iteration_to_compress_model_[latest_iteration_num][item.first] =
       AssignNewCompressModelMemory(item.first, initial_model_);
   }
   model_size_ = initial_model_->model_size;
-  MS_LOG(INFO) << "Model store checkpoint dir is: " << FLContext::instance()->checkpoint_dir();
+}
+
+void ModelStore::InitCheckpoint(size_t latest_iteration_num) {
+  // Servers may share the checkpoint dir, the http server address distinguishes them and is kept after restarts.
+  std::string file_prefix = "model_store_" + FLContext::instance()->instance_name() + "_" +
+                            FLContext::instance()->http_server_address();
+  auto is_invalid_char = [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-'; };
+  std::replace_if(file_prefix.begin(), file_prefix.end(), is_invalid_char, '_');
+  if (!checkpoint_.Initialize(FLContext::instance()->checkpoint_dir(), file_prefix,
+                              FLContext::instance()->checkpoint_sync_interval())) {
+    return;
+  }
+  // The initial model from the feature map is replaced by the one persisted for the latest iteration before the server
+  // restarts. The model of an earlier iteration is not used, the initial model is kept instead.
+  if (!checkpoint_.Load(latest_iteration_num, initial_model_)) {
+    MS_LOG(WARNING) << "No valid checkpoint of the latest iteration " << latest_iteration_num
+                    << ", use the model of the feature map.";
+  }
 }
 
 void ModelStore::InitModel(const std::vector<InputWeight> &feature_map) {
@@ -165,6 +185,7 @@ bool ModelStore::StoreModelByIterNum(size_t iteration, const std::map<std::strin
     }
   }
   iteration_to_model_[iteration] = stored_model;
+  checkpoint_.SaveAsync(iteration, stored_model);
   OnIterationUpdate();
   return true;
 }
@@ -188,6 +209,7 @@ bool ModelStore::StoreModelByIterNum(size_t iteration, const ModelItemPtr &new_m
     (void)iteration_to_model_.erase(iteration_to_model_.begin());
   }
   iteration_to_model_[iteration] = new_model_ptr;
+  checkpoint_.SaveAsync(iteration, new_model_ptr);
   OnIterationUpdate();
   return true;
 }
@@ -239,6 +261,7 @@ void ModelStore::Reset() {
   initial_model_ = iteration_to_model_.rbegin()->second;
   iteration_to_model_.clear();
   iteration_to_model_[kInitIterationNum] = initial_model_;
+  checkpoint_.SaveAsync(kInitIterationNum, initial_model_);
   OnIterationUpdate();
 }
 
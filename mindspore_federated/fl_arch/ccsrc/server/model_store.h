@@ -25,6 +25,7 @@
 #include <utility>
 #include "common/common.h"
 #include "server/memory_register.h"
+#include "server/model_checkpoint.h"
 #include "compression/encode_executor.h"
 #include "server/local_meta_store.h"
 
@@ -130,6 +131,10 @@ class MS_EXPORT ModelStore {
   std::mutex model_cache_mtx_;
   // total weight size, ModelItemPtr
   std::map<size_t, std::vector<ModelItemPtr>> empty_model_cache_;
+
+  // Persist the stored models into the checkpoint dir and recover the latest one when initializing.
+  void InitCheckpoint(size_t latest_iteration_num);
+  ModelCheckpoint checkpoint_;
 };
 }  // namespace server
 }  // namespace fl
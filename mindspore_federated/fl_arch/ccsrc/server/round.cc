@@ -93,19 +93,32 @@ bool Round::ReInitForUpdatingHyperParams(uint64_t updated_threshold_count, uint6
 void Round::BindRoundKernel(const std::shared_ptr<kernel::RoundKernel> &kernel) {
   MS_EXCEPTION_IF_NULL(kernel);
   kernel_ = kernel;
+  // The data of the parked message has been counted when it was received.
+  kernel_->set_resume_callback(
+    [this](const std::shared_ptr<MessageHandler> &message) { (void)RunRoundKernel(message); });
 }
 
 void Round::LaunchRoundKernel(const std::shared_ptr<MessageHandler> &message) {
   MS_ERROR_IF_NULL_WO_RET_VAL(message);
   MS_ERROR_IF_NULL_WO_RET_VAL(kernel_);
+  if (!RunRoundKernel(message)) {
+    return;
+  }
+  if (DataRateKernels.find(name_) != DataRateKernels.end()) {
+    kernel_->CalculateReceiveData(message->len());
+  }
+}
+
+bool Round::RunRoundKernel(const std::shared_ptr<MessageHandler> &message) {
+  MS_ERROR_IF_NULL_W_RET_VAL(message, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(kernel_, false);
 
   std::string reason = "";
   if (!IsServerAvailable(&reason)) {
     if (!message->SendResponse(reason.c_str(), reason.size())) {
       MS_LOG(WARNING) << "Sending response failed.";
-      return;
     }
-    return;
+    return false;
   }
   Iteration::GetInstance().OnRoundLaunchStart();
   try {
@@ -136,9 +149,7 @@ void Round::LaunchRoundKernel(const std::shared_ptr<MessageHandler> &message) {
     }
   }
   Iteration::GetInstance().OnRoundLaunchEnd();
-  if (DataRateKernels.find(name_) != DataRateKernels.end()) {
-    kernel_->CalculateReceiveData(message->len());
-  }
+  return true;
 }
 
 void Round::Reset() {
@@ -104,6 +104,10 @@ class Round {
   // Judge whether the training service is available.
   bool IsServerAvailable(std::string *reason);
 
+  // Run the round kernel for the message, shared by the new messages and the parked messages which are resumed. Returns
+  // false if the server is not available and the round kernel is not launched.
+  bool RunRoundKernel(const std::shared_ptr<MessageHandler> &message);
+
   RoundConfig config_;
   std::string name_;
 
@@ -25,6 +25,7 @@
 #include "server/round.h"
 #include "server/model_store.h"
 #include "server/iteration.h"
+#include "server/long_poll_service.h"
 #include "server/collective_ops_impl.h"
 #include "server/cert_verify.h"
 #include "common/core/comm_util.h"
@@ -320,6 +321,8 @@ void Server::RunMainProcessInner() {
   }
   // Resume receiving client messages and events
   instance_context.SetSafeMode(false);
+  // The model of the finished iteration has been stored, complete the parked requests.
+  LongPollService::GetInstance().Notify();
   MS_LOG_INFO << "End handle instance event " << event_str
               << ". Move to next iteration: " << instance_context.iteration_num()
               << ", next instance name: " << instance_context.instance_name() << "\n";
@@ -330,6 +333,7 @@ void Server::Stop() {
     return;
   }
   fl_callback_ = FlCallback();
+  LongPollService::GetInstance().Stop();
   if (server_node_) {
     server_node_->Stop();
   }
@@ -360,7 +364,8 @@ void Server::InitServerContext() { FLContext::instance()->GenerateResetterRound(
 void Server::InitAndLoadDistributedCache(uint64_t recovery_iteration) {
   MS_EXCEPTION_IF_NULL(server_node_);
   auto config = FLContext::instance()->distributed_cache_config();
-  if (config.address.empty()) {
+  // The address is not required by the memory cache or a plugin.
+  if (config.address.empty() && config.type != cache::kMemoryCacheType && config.plugin_lib_path.empty()) {
     MS_LOG(EXCEPTION) << "Distributed cache address cannot be empty.";
   }
   if (!cache::DistributedCacheLoader::Instance().InitCacheImpl(config)) {
@@ -464,6 +469,7 @@ void Server::InitIteration() {
     MS_LOG(INFO) << "Parameters for secure aggregation have been initiated.";
   }
   Iteration::GetInstance().InitIteration(server_node_, rounds_config_, communicators_with_worker_);
+  LongPollService::GetInstance().Initialize(FLContext::instance()->long_poll_timeout());
 }
 
 void Server::InitCipher() {
@@ -620,7 +626,7 @@ void Server::StartCommunicator() {
   CollectiveOpsImpl::GetInstance().Initialize(server_node_);
 }
 
-void Server::BroadcastModelWeight(const std::string &proto_model,
+void Server::BroadcastModelWeight(const std::shared_ptr<std::string> &proto_model,
                                   const std::map<std::string, std::string> &broadcast_server_map) {
   if (server_node_ == nullptr) {
     MS_LOG_ERROR << "server_node_ cannot be nullptr";
@@ -68,7 +68,7 @@ class MS_EXPORT Server {
   void Run(const std::vector<InputWeight> &feature_map, const uint64_t &recovery_iteration,
            const FlCallback &fl_callback);
 
-  void BroadcastModelWeight(const std::string &proto_model,
+  void BroadcastModelWeight(const std::shared_ptr<std::string> &proto_model,
                             const std::map<std::string, std::string> &broadcast_server_map = {});
   bool PullWeight(const uint8_t *req_data, size_t len, VectorPtr *output);
 
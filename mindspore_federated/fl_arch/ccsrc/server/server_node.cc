@@ -333,16 +333,20 @@ void ServerNode::HandleGetModelWeight(const std::shared_ptr<TcpConnection> &conn
     conn->ErrorResponse(meta, error_msg);
     return;
   }
-  auto model_str = proto_model.SerializeAsString();
-  if (!conn->SendMessage(meta, Protos::PROTOBUF, model_str.data(), model_str.size())) {
+  auto model_str = std::make_shared<std::string>(proto_model.SerializeAsString());
+  if (!conn->SendMessage(meta, Protos::PROTOBUF, model_str->data(), model_str->size(), model_str)) {
     MS_LOG(WARNING) << "Server response message failed.";
   }
   MS_LOG_INFO << "End handle get model weight message";
 }
 
-void ServerNode::BroadcastModelWeight(const std::string &proto_model,
+void ServerNode::BroadcastModelWeight(const std::shared_ptr<std::string> &proto_model,
                                       const std::map<std::string, std::string> &broadcast_server_map) {
   MS_LOG_INFO << "Begin broadcast model weight";
+  if (proto_model == nullptr) {
+    MS_LOG_WARNING << "The model to be broadcast cannot be nullptr";
+    return;
+  }
   std::map<std::string, std::string> node_map;
   if (broadcast_server_map.empty()) {
     auto cache_ret = cache::Server::Instance().GetAllServersRealtime(&node_map);
@@ -375,7 +379,9 @@ void ServerNode::BroadcastModelWeight(const std::string &proto_model,
     message_meta.set_send_node(send_node);
     message_meta.set_recv_node(recv_node);
     message_meta.set_role(node_info_.node_role_);
-    auto ret = tcp_client->SendMessage(message_meta, Protos::PROTOBUF, proto_model.data(), proto_model.size());
+    // All servers share the same serialized model, which is kept alive by proto_model until it has been sent.
+    auto ret = tcp_client->SendMessage(message_meta, Protos::PROTOBUF, proto_model->data(), proto_model->size(),
+                                       proto_model);
     if (!ret) {
       MS_LOG(WARNING) << "Get model weight from tcp server " << recv_address << " failed";
       continue;
@@ -51,7 +51,7 @@ class ServerNode : public AbstractNode {
   void BroadcastEvent(ServerBroadcastMessage broadcast_msg);
   bool ServerPingPong();
   bool GetModelWeight(uint64_t iteration_num, VectorPtr *output);
-  void BroadcastModelWeight(const std::string &proto_model,
+  void BroadcastModelWeight(const std::shared_ptr<std::string> &proto_model,
                             const std::map<std::string, std::string> &broadcast_server_map);
   bool PullWeight(const uint8_t *req_data, size_t len, VectorPtr *output);
 
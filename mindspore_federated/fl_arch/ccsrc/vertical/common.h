@@ -41,11 +41,15 @@ struct SliceProto {
   std::string offset;
 };
 
-enum ResponseElem { SUCCESS, FAILED };
+// The response of a message pushed to the queue of the receiver is SUCCESS, or BUSY if the queue has not enough credit
+// for it, followed by the split sign and the credit of the queue, such as "SUCCESS,1073741824".
+enum ResponseElem { SUCCESS, FAILED, BUSY };
 
 using MessageQueuePtr = std::shared_ptr<MessageQueue<SliceProto>>;
 
 constexpr auto KTrainer = "trainer";
+// The trainer message type asking for the credit of the receiver, without sending any tensor.
+constexpr auto KCreditProbe = "creditProbe";
 constexpr auto KPsi = "psi";
 constexpr auto KBobPb = "bobPb";
 constexpr auto KClientPSIInit = "clientPSIInit";
@@ -54,6 +58,9 @@ constexpr auto KAlicePbaAndBF = "alicePbaAndBF";
 constexpr auto KBobAlignResult = "bobAlignResult";
 constexpr auto KAliceCheck = "aliceCheck";
 constexpr auto KPlainData = "plainData";
+// The stream bucket sizes of each party have their own message type, so a party never takes its own sizes.
+constexpr auto KAliceBucketSizes = "aliceBucketSizes";
+constexpr auto KBobBucketSizes = "bobBucketSizes";
 constexpr auto KDataJoin = "dataJoin";
 
 constexpr auto KTrainerUri = "/trainer";
@@ -61,12 +68,18 @@ constexpr auto KPsiUri = "/psi";
 constexpr auto KDataJoinUri = "/dataJoin";
 
 constexpr auto KProtoSplitSign = ',';
+// The psi message type is sent as the type, the split sign and the bin id, such as "bobPb#1".
+constexpr auto KPsiBinSplitSign = '#';
 
 constexpr size_t kPsiSliceSize = 0.6 * 1024 * 1024 * 1024 / 32;
 
 constexpr uint32_t kRetryCommunicateTimes = 900;
 constexpr uint32_t kSleepSecondsOfCommunicate = 1;
 
+// A sender waiting for the credit of the receiver retries with the interval doubled from the min to the max.
+constexpr uint32_t kMinCreditWaitMilliseconds = 10;
+constexpr uint32_t kMaxCreditWaitMilliseconds = 1000;
+
 constexpr uint32_t kCommunicateWaitTimes = 900;
 constexpr uint32_t kTrainerWaitSecondTimes = 3600 * 3;
 constexpr uint32_t kPsiWaitSecondTimes = 3600 * 3;
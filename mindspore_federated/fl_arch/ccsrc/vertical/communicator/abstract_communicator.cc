@@ -15,6 +15,10 @@
  */
 
 #include "vertical/communicator/abstract_communicator.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <thread>
 #include "common/communicator/communicator_base.h"
 #include "common/communicator/message_handler.h"
 
@@ -141,6 +145,24 @@ std::shared_ptr<std::vector<unsigned char>> AbstractCommunicator::SendMessage(co
   return response_msg;
 }
 
+std::future<std::shared_ptr<std::vector<uint8_t>>> AbstractCommunicator::SendMessageAsync(
+  const std::string &target_server_name, const void *data, size_t data_size, const std::string &http_uri_path,
+  const std::string &target_msg_type, const std::string &offset) {
+  if (data == nullptr) {
+    MS_LOG(EXCEPTION) << "Data for sending request is nullptr.";
+  }
+  if (data_size == 0) {
+    MS_LOG(EXCEPTION) << "Data size for sending request must be greater than 0";
+  }
+  auto iter = http_clients_.find(target_server_name);
+  if (iter == http_clients_.end() || iter->second == nullptr) {
+    MS_LOG(EXCEPTION) << "Remote server name is invalid. target_server_name is:" << target_server_name;
+  }
+  auto http_server_name = VFLContext::instance()->http_server_name();
+  return iter->second->SendMessageAsync(data, data_size, http_uri_path, target_msg_type, http_server_name, offset,
+                                        HTTP_CONTENT_TYPE_URL_ENCODED);
+}
+
 void AbstractCommunicator::SendResponseMsg(const std::shared_ptr<MessageHandler> &message, const void *data,
                                            size_t len) {
   if (!verifyResponse(message, data, len)) {
@@ -175,10 +197,54 @@ std::string AbstractCommunicator::toString(ResponseElem elem) {
       return "SUCCESS";
     case ResponseElem::FAILED:
       return "FAILED";
+    case ResponseElem::BUSY:
+      return "BUSY";
     default:
       return "";
   }
   return "";
 }
+
+std::string AbstractCommunicator::CreditResponse(ResponseElem elem, size_t credit) {
+  return toString(elem) + KProtoSplitSign + std::to_string(credit);
+}
+
+ResponseElem AbstractCommunicator::ParseResponse(const std::shared_ptr<std::vector<uint8_t>> &response_msg,
+                                                 size_t *credit) {
+  MS_EXCEPTION_IF_NULL(credit);
+  *credit = std::numeric_limits<size_t>::max();
+  if (response_msg == nullptr) {
+    return ResponseElem::FAILED;
+  }
+  std::string response(response_msg->begin(), response_msg->end());
+  size_t split_pos = response.find(KProtoSplitSign);
+  if (split_pos != std::string::npos) {
+    std::string credit_str = response.substr(split_pos + 1);
+    if (!credit_str.empty() && std::all_of(credit_str.begin(), credit_str.end(), ::isdigit)) {
+      *credit = std::stoull(credit_str);
+    }
+    response = response.substr(0, split_pos);
+  }
+  if (response == toString(ResponseElem::SUCCESS)) {
+    return ResponseElem::SUCCESS;
+  }
+  if (response == toString(ResponseElem::BUSY)) {
+    return ResponseElem::BUSY;
+  }
+  MS_LOG(WARNING) << "The response message is " << response;
+  return ResponseElem::FAILED;
+}
+
+void AbstractCommunicator::WaitForCredit(const std::string &target_msg_type,
+                                         const std::chrono::steady_clock::time_point &start, uint32_t timeout,
+                                         uint32_t *wait_ms) {
+  MS_EXCEPTION_IF_NULL(wait_ms);
+  if (std::chrono::steady_clock::now() - start > std::chrono::seconds(timeout)) {
+    MS_LOG(EXCEPTION) << "Wait for the credit of the receiver of " << target_msg_type << " timeout after " << timeout
+                      << " seconds.";
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(*wait_ms));
+  *wait_ms = std::min(*wait_ms * 2, kMaxCreditWaitMilliseconds);
+}
 }  // namespace fl
 }  // namespace mindspore
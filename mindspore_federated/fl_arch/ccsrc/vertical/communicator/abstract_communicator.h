@@ -16,6 +16,8 @@
 #ifndef MINDSPORE_FL_ARCH_CCSRC_VERTICAL_ABSTRACT_COMMUNICATOR_H_
 #define MINDSPORE_FL_ARCH_CCSRC_VERTICAL_ABSTRACT_COMMUNICATOR_H_
 
+#include <chrono>
+#include <future>
 #include <string>
 #include <memory>
 #include <mutex>
@@ -61,10 +63,29 @@ class AbstractCommunicator : public AbstractNode {
                                                     size_t data_size, const std::string &http_uri_path,
                                                     const std::string &target_msg_type, const std::string &offset = "");
 
+  // Send the message without waiting for the response, so that the transfers to the peers overlap. The response is
+  // nullptr if the request failed, and it's not retried.
+  std::future<std::shared_ptr<std::vector<uint8_t>>> SendMessageAsync(const std::string &target_server_name,
+                                                                      const void *data, size_t data_size,
+                                                                      const std::string &http_uri_path,
+                                                                      const std::string &target_msg_type,
+                                                                      const std::string &offset = "");
+
   std::string name() const;
 
   std::string toString(ResponseElem elem);
 
+  // The response of a message to a queue, with the credit of the queue advertised to the sender.
+  std::string CreditResponse(ResponseElem elem, size_t credit);
+
+  // Parse the response of a message. The credit is the max of size_t if the receiver doesn't advertise it.
+  ResponseElem ParseResponse(const std::shared_ptr<std::vector<uint8_t>> &response_msg, size_t *credit);
+
+  // Sleep before sending again to a receiver without credit, and double the interval wait_ms. Throw if the receiver has
+  // been busy for timeout seconds since start.
+  static void WaitForCredit(const std::string &target_msg_type, const std::chrono::steady_clock::time_point &start,
+                            uint32_t timeout, uint32_t *wait_ms);
+
  private:
   std::map<std::string, std::string> remote_server_address_;
 
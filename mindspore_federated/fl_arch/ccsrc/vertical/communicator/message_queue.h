@@ -24,45 +24,75 @@
 #include <condition_variable>
 #include <queue>
 #include <deque>
+#include <limits>
 
 #include "common/utils/log_adapter.h"
 
 namespace mindspore {
 namespace fl {
-constexpr size_t kMaxQueueSize = 128;
+// The default bound of the bytes of the messages waiting in a queue.
+constexpr size_t kMaxQueueBytes = 1024 * 1024 * 1024;
+
+// The queue is bounded by the bytes of the messages rather than their number. The bytes the queue can still accept
+// are its credit, which the receiver advertises to the senders in the responses, so a sender waits for the credit
+// instead of losing the message.
 template <typename T>
 class MessageQueue {
  private:
-  std::deque<T> queue_;
+  std::deque<std::pair<T, size_t>> queue_;
+  size_t max_bytes_;
+  size_t queue_bytes_ = 0;
   std::mutex msg_mutex_;
   std::condition_variable message_received_cond_;
 
+  size_t credit_without_lock() const {
+    // An empty queue accepts a message of any size, or else a message larger than the bound would never be accepted.
+    if (queue_.empty()) {
+      return std::numeric_limits<size_t>::max();
+    }
+    return queue_bytes_ >= max_bytes_ ? 0 : max_bytes_ - queue_bytes_;
+  }
+
+  T pop_front_without_lock() {
+    T ret = std::move(queue_.front().first);
+    queue_bytes_ -= queue_.front().second;
+    queue_.pop_front();
+    return ret;
+  }
+
  public:
-  void push(T data) {
+  explicit MessageQueue(size_t max_bytes = kMaxQueueBytes) : max_bytes_(max_bytes) {}
+
+  // Push the message of data_size bytes, or return false without pushing it if it's more than the credit, and the
+  // sender should send it again later.
+  bool push(T data, size_t data_size) {
     std::unique_lock<std::mutex> lock(msg_mutex_);
-    if (queue_.size() >= kMaxQueueSize) {
-      MS_LOG(WARNING) << "Reject the message because of over the queue size.";
-      return;
+    if (data_size > credit_without_lock()) {
+      MS_LOG(INFO) << "Reject the message of " << data_size << " bytes because of over the queue bytes.";
+      return false;
     }
-    queue_.push_back(data);
+    queue_.emplace_back(std::move(data), data_size);
+    queue_bytes_ += data_size;
     message_received_cond_.notify_all();
+    return true;
+  }
+
+  size_t credit() {
+    std::unique_lock<std::mutex> lock(msg_mutex_);
+    return credit_without_lock();
   }
 
   T pop(const uint32_t &timeout) {
     std::unique_lock<std::mutex> lock(msg_mutex_);
     T ret;
     if (queue_.size() > 0) {
-      ret = std::move(queue_.front());
-      queue_.pop_front();
-      return ret;
+      return pop_front_without_lock();
     }
     bool res = false;
     for (uint32_t i = 0; i < timeout; i++) {
       res = message_received_cond_.wait_for(lock, std::chrono::seconds(1), [this] { return queue_.size() > 0; });
       if (res) {
-        ret = std::move(queue_.front());
-        queue_.pop_front();
-        return ret;
+        return pop_front_without_lock();
       }
     }
     if (!res) {
@@ -20,6 +20,9 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <thread>
 
 namespace mindspore {
 namespace fl {
@@ -30,17 +33,97 @@ void PsiCommunicator::InitCommunicator(const std::shared_ptr<HttpCommunicator> &
   RegisterMsgCallBack(http_communicator, KPsi);
   InitHttpClient();
 
-  std::vector<VerticalConfig> psi_config = {{KBobPb},          {KClientPSIInit}, {KServerPSIInit}, {KAlicePbaAndBF},
-                                            {KBobAlignResult}, {KAliceCheck},    {KPlainData}};
+  std::vector<VerticalConfig> psi_config = {{KBobPb},          {KClientPSIInit},    {KServerPSIInit},
+                                            {KAlicePbaAndBF},  {KBobAlignResult},   {KAliceCheck},
+                                            {KPlainData},      {KAliceBucketSizes}, {KBobBucketSizes}};
+  for (const auto &config : psi_config) {
+    (void)message_types_.insert(config.name);
+  }
   auto remote_server_address = VFLContext::instance()->remote_server_address();
   for (const auto &address : remote_server_address) {
-    std::map<std::string, MessageQueuePtr> qmap;
-    auto target_server_name = address.first;
-    for (const auto &config : psi_config) {
-      auto queue = std::make_shared<MessageQueue<SliceProto>>();
-      qmap[config.name] = queue;
+    message_queues_[address.first] = {};
+  }
+}
+
+namespace {
+// The bin id is parsed as a size_t, so it has at most 19 digits.
+constexpr size_t kMaxBinIdDigitNum = 19;
+
+std::string BucketSizesMessageType(const std::string &role) {
+  return role == "alice" ? KAliceBucketSizes : KBobBucketSizes;
+}
+}  // namespace
+
+std::string PsiCommunicator::BinMessageType(const std::string &message_type, size_t bin_id) {
+  return message_type + KPsiBinSplitSign + std::to_string(bin_id);
+}
+
+MessageQueuePtr PsiCommunicator::GetMessageQueue(const std::string &target_server_name,
+                                                 const std::string &message_type, size_t bin_id) {
+  std::unique_lock<std::mutex> lock(message_queues_mutex_);
+  auto iter = message_queues_.find(target_server_name);
+  if (iter == message_queues_.end()) {
+    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
+  }
+  if (running_bins_.count(bin_id) == 0) {
+    return nullptr;
+  }
+  auto &queue = iter->second[BinMessageType(message_type, bin_id)];
+  if (queue == nullptr) {
+    queue = std::make_shared<MessageQueue<SliceProto>>();
+  }
+  return queue;
+}
+
+void PsiCommunicator::StartBins(const std::vector<size_t> &bin_ids) {
+  std::unique_lock<std::mutex> lock(message_queues_mutex_);
+  running_bins_.insert(bin_ids.begin(), bin_ids.end());
+}
+
+void PsiCommunicator::FinishBin(size_t bin_id) {
+  std::unique_lock<std::mutex> lock(message_queues_mutex_);
+  (void)running_bins_.erase(bin_id);
+  for (auto &server_queues : message_queues_) {
+    for (const auto &message_type : message_types_) {
+      (void)server_queues.second.erase(BinMessageType(message_type, bin_id));
     }
-    message_queues_[target_server_name] = qmap;
+  }
+}
+
+MessageQueuePtr PsiCommunicator::GetReceiveQueue(const std::string &target_server_name,
+                                                 const std::string &message_type, size_t bin_id) {
+  auto queue = GetMessageQueue(target_server_name, message_type, bin_id);
+  if (queue == nullptr) {
+    MS_LOG(EXCEPTION) << "The bin " << bin_id << " is not started when receiving " << message_type;
+  }
+  return queue;
+}
+
+bool PsiCommunicator::SendBinMessage(const std::string &target_server_name, const void *data, size_t data_size,
+                                     const std::string &message_type, size_t bin_id, const std::string &offset) {
+  auto bin_message_type = BinMessageType(message_type, bin_id);
+  auto start = std::chrono::steady_clock::now();
+  uint32_t wait_ms = kMinCreditWaitMilliseconds;
+  while (true) {
+    std::shared_ptr<std::vector<uint8_t>> response_msg;
+    for (uint32_t i = 0; i < kRetryCommunicateTimes; i++) {
+      response_msg = SendMessageAsync(target_server_name, data, data_size, KPsiUri, bin_message_type, offset).get();
+      if (response_msg) {
+        break;
+      }
+      MS_LOG(WARNING) << "Sending " << bin_message_type << " failed, now retry time is " << i;
+      std::this_thread::sleep_for(std::chrono::seconds(kSleepSecondsOfCommunicate));
+    }
+    if (!response_msg) {
+      MS_LOG(EXCEPTION) << "Send psi message timeout for retry " << kRetryCommunicateTimes << " times.";
+    }
+    // The queue of each message type and bin holds few messages, so the message is simply sent again if it's busy.
+    size_t credit = 0;
+    auto response = ParseResponse(response_msg, &credit);
+    if (response != ResponseElem::BUSY) {
+      return response == ResponseElem::SUCCESS;
+    }
+    WaitForCredit(bin_message_type, start, kPsiWaitSecondTimes, &wait_ms);
   }
 }
 
@@ -59,14 +142,23 @@ bool PsiCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler> &me
     std::string message_source = message->message_source();
     std::string message_type = message->message_type();
     std::string message_offset = message->message_offset();
-    if (message_queues_.count(message_source) <= 0) {
+    bool valid_source = false;
+    {
+      std::unique_lock<std::mutex> lock(message_queues_mutex_);
+      valid_source = message_queues_.count(message_source) > 0;
+    }
+    if (!valid_source) {
       std::string reason = "Request message source server name " + message_source + " is invalid.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
 
-    if (message_queues_[message_source].count(message_type) <= 0) {
+    size_t split_pos = message_type.rfind(KPsiBinSplitSign);
+    std::string bin_str = split_pos == std::string::npos ? "" : message_type.substr(split_pos + 1);
+    if (bin_str.empty() || bin_str.size() > kMaxBinIdDigitNum ||
+        !std::all_of(bin_str.begin(), bin_str.end(), ::isdigit) ||
+        message_types_.count(message_type.substr(0, split_pos)) <= 0) {
       std::string reason = "Request message type " + message_type + " is invalid.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
@@ -78,11 +170,21 @@ bool PsiCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler> &me
     auto msg_data = static_cast<uint8_t *>(const_cast<void *>(message->data()));
     std::vector<uint8_t> slice_data{msg_data, msg_data + message->len()};
     SliceProto slice_proto = {slice_data, message_offset};
-    auto queue = message_queues_[message_source][message_type];
-    MS_EXCEPTION_IF_NULL(queue);
-    queue->push(slice_proto);
+    auto queue = GetMessageQueue(message_source, message_type.substr(0, split_pos), std::stoull(bin_str));
+    if (queue == nullptr) {
+      std::string res = CreditResponse(ResponseElem::BUSY, 0);
+      SendResponseMsg(message, res.c_str(), res.size());
+      MS_LOG(INFO) << "The bin of " << message_type << " is not started. Response msg is " << res;
+      return false;
+    }
+    if (!queue->push(slice_proto, message->len())) {
+      std::string res = CreditResponse(ResponseElem::BUSY, queue->credit());
+      SendResponseMsg(message, res.c_str(), res.size());
+      MS_LOG(INFO) << "The queue of " << message_type << " is busy. Response msg is " << res;
+      return false;
+    }
 
-    std::string res = toString(ResponseElem::SUCCESS);
+    std::string res = CreditResponse(ResponseElem::SUCCESS, queue->credit());
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi message handler successful. Response msg is " << res;
   } catch (const std::exception &e) {
@@ -92,46 +194,35 @@ bool PsiCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler> &me
   return true;
 }
 
-bool PsiCommunicator::ResponseHandler(const std::shared_ptr<std::vector<uint8_t>> &response_msg) {
-  if (!response_msg) {
-    return false;
-  }
-  return reinterpret_cast<char *>(response_msg->data()) == toString(ResponseElem::SUCCESS);
-}
-
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::AliceCheck &aliceCheck) {
   auto slice_proto = CreateProtoWithSlices(aliceCheck);
   auto slice_data = slice_proto.slice_data;
   auto offset = slice_proto.offset;
-  auto response_msg =
-    SendMessage(target_server_name, slice_data.data(), slice_data.size(), KPsiUri, KAliceCheck, offset);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, slice_data.data(), slice_data.size(), KAliceCheck, aliceCheck.bin_id(),
+                        offset);
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::BobPb &bob_pb) {
   auto slice_proto = CreateProtoWithSlices(bob_pb);
   auto slice_data = slice_proto.slice_data;
   auto offset = slice_proto.offset;
-  auto response_msg = SendMessage(target_server_name, slice_data.data(), slice_data.size(), KPsiUri, KBobPb, offset);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, slice_data.data(), slice_data.size(), KBobPb, bob_pb.bin_id(), offset);
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::AlicePbaAndBF &alicePbaAndBF) {
   auto slice_proto = CreateProtoWithSlices(alicePbaAndBF);
   auto slice_data = slice_proto.slice_data;
   auto offset = slice_proto.offset;
-  auto response_msg =
-    SendMessage(target_server_name, slice_data.data(), slice_data.size(), KPsiUri, KAlicePbaAndBF, offset);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, slice_data.data(), slice_data.size(), KAlicePbaAndBF,
+                        alicePbaAndBF.bin_id(), offset);
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::BobAlignResult &bobAlignResult) {
   auto slice_proto = CreateProtoWithSlices(bobAlignResult);
   auto slice_data = slice_proto.slice_data;
   auto offset = slice_proto.offset;
-  auto response_msg =
-    SendMessage(target_server_name, slice_data.data(), slice_data.size(), KPsiUri, KBobAlignResult, offset);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, slice_data.data(), slice_data.size(), KBobAlignResult,
+                        bobAlignResult.bin_id(), offset);
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::ClientPSIInit &clientPSIInit) {
@@ -140,17 +231,15 @@ bool PsiCommunicator::Send(const std::string &target_server_name, const psi::Cli
   std::string data = client_psi_init_proto_ptr->SerializeAsString();
   size_t data_size = data.size();
   MS_LOG(INFO) << "Send clientPSIInitProto size is " << data_size;
-  auto response_msg = SendMessage(target_server_name, data.c_str(), data_size, KPsiUri, KClientPSIInit);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, data.c_str(), data_size, KClientPSIInit, clientPSIInit.bin_id());
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::PlainData &plain_data) {
   auto slice_proto = CreateProtoWithSlices(plain_data);
   auto slice_data = slice_proto.slice_data;
   auto offset = slice_proto.offset;
-  auto response_msg =
-    SendMessage(target_server_name, slice_data.data(), slice_data.size(), KPsiUri, KPlainData, offset);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, slice_data.data(), slice_data.size(), KPlainData, plain_data.bin_id(),
+                        offset);
 }
 
 bool PsiCommunicator::Send(const std::string &target_server_name, const psi::ServerPSIInit &serverPSIInit) {
@@ -159,18 +248,20 @@ bool PsiCommunicator::Send(const std::string &target_server_name, const psi::Ser
   std::string data = client_psi_init_proto_ptr->SerializeAsString();
   size_t data_size = data.size();
   MS_LOG(INFO) << "Send serverPSIInitProto size is " << data_size;
-  auto response_msg = SendMessage(target_server_name, data.c_str(), data_size, KPsiUri, KServerPSIInit);
-  return ResponseHandler(response_msg);
+  return SendBinMessage(target_server_name, data.c_str(), data_size, KServerPSIInit, serverPSIInit.bin_id());
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::AliceCheck *aliceCheck) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
-  MS_LOG(INFO) << "Begin receive AliceCheck message.";
+bool PsiCommunicator::Send(const std::string &target_server_name, const psi::StreamBucketSizes &bucketSizes) {
+  auto bucket_sizes_proto_ptr = std::make_shared<datajoin::StreamBucketSizesProto>();
+  CreateStreamBucketSizesProto(bucket_sizes_proto_ptr.get(), bucketSizes);
+  std::string data = bucket_sizes_proto_ptr->SerializeAsString();
+  return SendBinMessage(target_server_name, data.c_str(), data.size(), BucketSizesMessageType(bucketSizes.self_role()),
+                        bucketSizes.bin_id());
+}
 
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KAliceCheck];
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::AliceCheck *aliceCheck) {
+  MS_LOG(INFO) << "Begin receive AliceCheck message.";
+  auto queue = GetReceiveQueue(target_server_name, KAliceCheck, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -191,13 +282,9 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::AliceC
   *aliceCheck = std::move(ParseProtoWithSlices(protos));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::BobPb *bobPb) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::BobPb *bobPb) {
   MS_LOG(INFO) << "Begin receive BobPb message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KBobPb];
+  auto queue = GetReceiveQueue(target_server_name, KBobPb, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -218,13 +305,9 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::BobPb
   *bobPb = std::move(ParseProtoWithSlices(protos));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::AlicePbaAndBF *alicePbaAndBF) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::AlicePbaAndBF *alicePbaAndBF) {
   MS_LOG(INFO) << "Begin receive AlicePbaAndBF message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KAlicePbaAndBF];
+  auto queue = GetReceiveQueue(target_server_name, KAlicePbaAndBF, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -245,13 +328,10 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::AliceP
   *alicePbaAndBF = std::move(ParseProtoWithSlices(protos));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::BobAlignResult *bobAlignResult) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id,
+                              psi::BobAlignResult *bobAlignResult) {
   MS_LOG(INFO) << "Begin receive BobAlignResult message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KBobAlignResult];
+  auto queue = GetReceiveQueue(target_server_name, KBobAlignResult, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -272,13 +352,9 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::BobAli
   *bobAlignResult = std::move(ParseProtoWithSlices(protos));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::ClientPSIInit *clientPSIInit) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::ClientPSIInit *clientPSIInit) {
   MS_LOG(INFO) << "Begin receive ClientPSIInit message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KClientPSIInit];
+  auto queue = GetReceiveQueue(target_server_name, KClientPSIInit, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -288,13 +364,9 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::Client
   *clientPSIInit = std::move(ParseClientPSIInitProto(proto));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::PlainData *plainData) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::PlainData *plainData) {
   MS_LOG(INFO) << "Begin receive PlainData message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KPlainData];
+  auto queue = GetReceiveQueue(target_server_name, KPlainData, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -315,13 +387,9 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::PlainD
   *plainData = std::move(ParseProtoWithSlices(protos));
 }
 
-void PsiCommunicator::Receive(const std::string &target_server_name, psi::ServerPSIInit *serverPSIInit) {
-  std::unique_lock<std::mutex> message_lock(message_received_mutex_);
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, psi::ServerPSIInit *serverPSIInit) {
   MS_LOG(INFO) << "Begin receive ServerPSIInit message.";
-  if (message_queues_.count(target_server_name) == 0) {
-    MS_LOG(EXCEPTION) << "Target server name " << target_server_name << " for message queues is invalid.";
-  }
-  auto queue = message_queues_[target_server_name][KServerPSIInit];
+  auto queue = GetReceiveQueue(target_server_name, KServerPSIInit, bin_id);
   MS_EXCEPTION_IF_NULL(queue);
   auto slice_proto = queue->pop(kPsiWaitSecondTimes);
   auto slice_data = slice_proto.slice_data;
@@ -331,5 +399,24 @@ void PsiCommunicator::Receive(const std::string &target_server_name, psi::Server
 
   *serverPSIInit = std::move(ParseServerPSIInitProto(proto));
 }
+
+void PsiCommunicator::Receive(const std::string &target_server_name, size_t bin_id, const std::string &peer_role,
+                              psi::StreamBucketSizes *bucketSizes) {
+  MS_LOG(INFO) << "Begin receive StreamBucketSizes message.";
+  auto queue = GetReceiveQueue(target_server_name, BucketSizesMessageType(peer_role), bin_id);
+  MS_EXCEPTION_IF_NULL(queue);
+  auto slice_proto = queue->pop(kPsiWaitSecondTimes);
+  auto slice_data = slice_proto.slice_data;
+
+  datajoin::StreamBucketSizesProto proto;
+  if (!proto.ParseFromArray(slice_data.data(), static_cast<int>(slice_data.size()))) {
+    MS_LOG(EXCEPTION) << "Parsing the stream bucket sizes of bin " << bin_id << " failed.";
+  }
+  *bucketSizes = ParseStreamBucketSizesProto(proto);
+  if (bucketSizes->self_role() != peer_role || bucketSizes->bin_id() != bin_id) {
+    MS_LOG(EXCEPTION) << "The stream bucket sizes are of " << bucketSizes->self_role() << " and bin "
+                      << bucketSizes->bin_id() << ", but expected " << peer_role << " and bin " << bin_id;
+  }
+}
 }  // namespace fl
 }  // namespace mindspore
@@ -22,6 +22,8 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <set>
+#include <mutex>
 
 #include "vertical/communicator/abstract_communicator.h"
 #include "vertical/common.h"
@@ -50,32 +52,66 @@ class PsiCommunicator : public AbstractCommunicator {
 
   bool Send(const std::string &target_server_name, const psi::AlicePbaAndBF &alicePbaAndBF);
 
+  bool Send(const std::string &target_server_name, const psi::StreamBucketSizes &bucketSizes);
+
   bool LaunchMsgHandler(const std::shared_ptr<MessageHandler> &message) override;
 
   void InitCommunicator(const std::shared_ptr<HttpCommunicator> &http_communicator) override;
 
-  void Receive(const std::string &target_server_name, psi::AliceCheck *aliceCheck);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::AliceCheck *aliceCheck);
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::BobPb *bobPb);
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::BobAlignResult *bobAlignResult);
 
-  void Receive(const std::string &target_server_name, psi::BobPb *bobPb);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::ClientPSIInit *clientPSIInit);
 
-  void Receive(const std::string &target_server_name, psi::BobAlignResult *bobAlignResult);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::PlainData *plainData);
 
-  void Receive(const std::string &target_server_name, psi::ClientPSIInit *clientPSIInit);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::ServerPSIInit *serverPSIInit);
 
-  void Receive(const std::string &target_server_name, psi::PlainData *plainData);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::AlicePbaAndBF *alicePbaAndBF);
 
-  void Receive(const std::string &target_server_name, psi::ServerPSIInit *serverPSIInit);
+  // Receive the stream bucket sizes sent by the peer of peer_role.
+  void Receive(const std::string &target_server_name, size_t bin_id, const std::string &peer_role,
+               psi::StreamBucketSizes *bucketSizes);
 
-  void Receive(const std::string &target_server_name, psi::AlicePbaAndBF *alicePbaAndBF);
+  // The messages of a bin are only accepted after the bin is started, so a peer cannot make the receiver create the
+  // queues of arbitrary bins. The messages of a bin not started yet are responded busy and sent again later.
+  void StartBins(const std::vector<size_t> &bin_ids);
+
+  // Erase the queues of the bin, which should not receive any more messages.
+  void FinishBin(size_t bin_id);
 
  private:
   bool VerifyProtoMessage(const psi::PlainData &plain_data);
 
-  bool ResponseHandler(const std::shared_ptr<std::vector<uint8_t>> &response_msg);
+  // The message type is sent with the bin id, so that the messages of the bins running concurrently are routed to their
+  // own queues.
+  static std::string BinMessageType(const std::string &message_type, size_t bin_id);
+
+  // The messages are sent by the connection pool of the http client, so the bins send concurrently. The message is
+  // sent again if the queue of the receiver is busy.
+  bool SendBinMessage(const std::string &target_server_name, const void *data, size_t data_size,
+                      const std::string &message_type, size_t bin_id, const std::string &offset = "");
 
-  std::mutex message_received_mutex_;
+  // The queue is created by the first of the receiver and the message handler, since the message of a bin may arrive
+  // before the bin starts receiving. Returns nullptr if the bin is not started.
+  MessageQueuePtr GetMessageQueue(const std::string &target_server_name, const std::string &message_type,
+                                  size_t bin_id);
 
+  MessageQueuePtr GetReceiveQueue(const std::string &target_server_name, const std::string &message_type,
+                                  size_t bin_id);
+
+  std::set<std::string> message_types_ = {};
+
+  std::mutex message_queues_mutex_;
+
+  // The queues of each target server, indexed by the message type with the bin id.
   std::map<std::string, std::map<std::string, MessageQueuePtr>> message_queues_ = {};
+
+  // The bins started and not finished yet.
+  std::set<size_t> running_bins_ = {};
 };
 }  // namespace fl
 }  // namespace mindspore
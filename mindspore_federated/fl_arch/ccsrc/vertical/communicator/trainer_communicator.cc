@@ -19,12 +19,19 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cctype>
+#include <chrono>
+#include <limits>
 
 #include "vertical/vfl_context.h"
 #include "vertical/utils/tensor_utils.h"
 
 namespace mindspore {
 namespace fl {
+namespace {
+constexpr size_t kDecimalBase = 10;
+}  // namespace
+
 void TrainerCommunicator::InitCommunicator(const std::shared_ptr<HttpCommunicator> &http_communicator) {
   if (http_communicator == nullptr) {
     MS_LOG(EXCEPTION) << "Communicators for vertical trainer communicator is nullptr.";
@@ -46,6 +53,23 @@ bool TrainerCommunicator::VerifyTensorListItem(const TensorListItemPy &tensorLis
   return true;
 }
 
+bool TrainerCommunicator::ParseMessageOffset(const std::string &message_offset, size_t len, size_t *offset) {
+  MS_EXCEPTION_IF_NULL(offset);
+  // The offset is checked digit by digit against len, so a malformed header never throws.
+  size_t value = 0;
+  for (char c : message_offset) {
+    if (!std::isdigit(static_cast<unsigned char>(c))) {
+      return false;
+    }
+    value = value * kDecimalBase + static_cast<size_t>(c - '0');
+    if (value > len) {
+      return false;
+    }
+  }
+  *offset = value;
+  return true;
+}
+
 bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler> &message) {
   MS_ERROR_IF_NULL_W_RET_VAL(message, false);
   try {
@@ -65,12 +89,41 @@ bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler>
       return false;
     }
     MS_LOG(INFO) << "Request source server name is " << message_source << ", message type is " << message_type;
+    auto queue = message_queues_[message_source];
+    MS_EXCEPTION_IF_NULL(queue);
+    if (message_type == KCreditProbe) {
+      std::string res = CreditResponse(ResponseElem::SUCCESS, queue->credit());
+      SendResponseMsg(message, res.c_str(), res.size());
+      return true;
+    }
+    // The message is rejected before parsing if it's more than the credit, and the sender will send it again.
+    if (message->len() > queue->credit()) {
+      std::string res = CreditResponse(ResponseElem::BUSY, queue->credit());
+      SendResponseMsg(message, res.c_str(), res.size());
+      MS_LOG(INFO) << "The queue of " << message_source << " is busy. Response msg is " << res;
+      return false;
+    }
+    // The message offset is the size of the proto if the payloads of the tensors are attached after it.
+    size_t proto_size = message->len();
+    std::string message_offset = message->message_offset();
+    if (!message_offset.empty() && !ParseMessageOffset(message_offset, message->len(), &proto_size)) {
+      std::string reason = "Message offset " + message_offset + " is invalid or out of the message.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     TensorListProto tensorListProto;
-    if (!tensorListProto.ParseFromArray(message->data(), message->len())) {
+    if (!tensorListProto.ParseFromArray(message->data(), proto_size)) {
       MS_LOG(WARNING) << "Tensor list proto parse from array failed.";
     }
+    // The attachments are copied once out of the http request, and the received tensors refer to them.
+    std::shared_ptr<const std::string> attachments = nullptr;
+    if (proto_size < message->len()) {
+      attachments = std::make_shared<const std::string>(reinterpret_cast<const char *>(message->data()) + proto_size,
+                                                        message->len() - proto_size);
+    }
 
-    TensorListItemPy tensorListItemPy = ParseTensorListProto(tensorListProto);
+    TensorListItemPy tensorListItemPy = ParseTensorListProto(tensorListProto, attachments);
     if (!VerifyTensorListItem(tensorListItemPy)) {
       std::string reason = "Verify tensor list data failed for vertical trainer.";
       SendResponseMsg(message, reason.c_str(), reason.size());
@@ -78,10 +131,13 @@ bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler>
       return false;
     }
 
-    auto queue = message_queues_[message_source];
-    MS_EXCEPTION_IF_NULL(queue);
-    queue->push(tensorListItemPy);
-    std::string res = toString(ResponseElem::SUCCESS);
+    if (!queue->push(tensorListItemPy, message->len())) {
+      std::string res = CreditResponse(ResponseElem::BUSY, queue->credit());
+      SendResponseMsg(message, res.c_str(), res.size());
+      MS_LOG(INFO) << "The queue of " << message_source << " is busy. Response msg is " << res;
+      return false;
+    }
+    std::string res = CreditResponse(ResponseElem::SUCCESS, queue->credit());
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching vertical trainer message handler successful.";
   } catch (const std::exception &e) {
@@ -93,12 +149,60 @@ bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler>
 
 bool TrainerCommunicator::Send(const std::string &target_server_name, const TensorListItemPy &tensorListItemPy) {
   std::shared_ptr<TensorListProto> tensor_list_proto_ptr = std::make_shared<TensorListProto>();
-  CreateTensorListProto(tensor_list_proto_ptr.get(), tensorListItemPy);
-  std::string data = tensor_list_proto_ptr->SerializeAsString();
-  size_t data_size = data.size();
-  auto response_msg = SendMessage(target_server_name, data.c_str(), data_size, KTrainerUri, KTrainer);
-  std::string response_data = response_msg == nullptr ? "" : reinterpret_cast<char *>(response_msg->data());
-  return response_data == toString(ResponseElem::SUCCESS);
+  TensorAttachments attachments;
+  CreateTensorListProto(tensor_list_proto_ptr.get(), tensorListItemPy, &attachments);
+  // The payloads of the tensors are copied from the numpy arrays right after the proto, without base64 or the copies of
+  // the proto bytes fields.
+  size_t proto_size = tensor_list_proto_ptr->ByteSizeLong();
+  std::string data;
+  data.reserve(proto_size + attachments.size);
+  (void)tensor_list_proto_ptr->AppendToString(&data);
+  for (const auto &tensor : attachments.tensors) {
+    (void)data.append(reinterpret_cast<const char *>(tensor.data()), tensor.data_size());
+  }
+  std::string offset = attachments.tensors.empty() ? "" : std::to_string(proto_size);
+  return SendWithCredit(target_server_name, data, offset);
+}
+
+bool TrainerCommunicator::SendWithCredit(const std::string &target_server_name, const std::string &data,
+                                         const std::string &offset) {
+  auto start = std::chrono::steady_clock::now();
+  uint32_t wait_ms = kMinCreditWaitMilliseconds;
+  while (true) {
+    size_t new_credit = 0;
+    if (data.size() <= credit(target_server_name)) {
+      auto response_msg = SendMessage(target_server_name, data.c_str(), data.size(), KTrainerUri, KTrainer, offset);
+      auto response = ParseResponse(response_msg, &new_credit);
+      set_credit(target_server_name, new_credit);
+      if (response != ResponseElem::BUSY) {
+        return response == ResponseElem::SUCCESS;
+      }
+    } else {
+      std::string probe = KCreditProbe;
+      auto response_msg = SendMessage(target_server_name, probe.c_str(), probe.size(), KTrainerUri, KCreditProbe);
+      if (ParseResponse(response_msg, &new_credit) != ResponseElem::SUCCESS) {
+        return false;
+      }
+      set_credit(target_server_name, new_credit);
+      if (data.size() <= new_credit) {
+        continue;
+      }
+    }
+    MS_LOG(INFO) << "Wait for the credit of " << target_server_name << ", the credit is " << new_credit
+                 << " and the message size is " << data.size();
+    WaitForCredit(KTrainer, start, kTrainerWaitSecondTimes, &wait_ms);
+  }
+}
+
+size_t TrainerCommunicator::credit(const std::string &target_server_name) {
+  std::unique_lock<std::mutex> lock(credits_mutex_);
+  auto iter = credits_.find(target_server_name);
+  return iter == credits_.end() ? std::numeric_limits<size_t>::max() : iter->second;
+}
+
+void TrainerCommunicator::set_credit(const std::string &target_server_name, size_t credit) {
+  std::unique_lock<std::mutex> lock(credits_mutex_);
+  credits_[target_server_name] = credit;
 }
 
 TensorListItemPy TrainerCommunicator::Receive(const std::string &target_server_name, const uint32_t &timeout) {
@@ -46,11 +46,28 @@ class TrainerCommunicator : public AbstractCommunicator {
 
   TensorListItemPy Receive(const std::string &target_server_name, const uint32_t &timeout = 100000);
 
+  // Parse the Message-Offset header, which should be a decimal not larger than len, into offset.
+  static bool ParseMessageOffset(const std::string &message_offset, size_t len, size_t *offset);
+
  private:
   bool VerifyTensorListItem(const TensorListItemPy &tensorListItemPy);
 
+  // Send the message once the target has the credit for it. While the credit advertised by the last response is not
+  // enough, the credit is probed by KCreditProbe instead of sending the message, so the sender blocks rather than the
+  // receiver dropping the message.
+  bool SendWithCredit(const std::string &target_server_name, const std::string &data, const std::string &offset);
+
+  size_t credit(const std::string &target_server_name);
+
+  void set_credit(const std::string &target_server_name, size_t credit);
+
   std::mutex message_received_mutex_;
 
+  std::mutex credits_mutex_;
+
+  // The credits of the target servers advertised by their last responses.
+  std::map<std::string, size_t> credits_ = {};
+
   std::map<std::string, std::shared_ptr<MessageQueue<TensorListItemPy>>> message_queues_ = {};
 };
 }  // namespace fl
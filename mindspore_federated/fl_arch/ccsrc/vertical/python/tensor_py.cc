@@ -15,7 +15,9 @@
  */
 #include "vertical/python/tensor_py.h"
 #include <functional>
+#include <memory>
 #include <vector>
+#include "common/utils/log_adapter.h"
 
 namespace mindspore {
 namespace fl {
@@ -54,5 +56,47 @@ float TensorItemPy::offset() const { return offset_; }
 
 size_t TensorItemPy::raw_data_size() const { return raw_data_.size(); }
 
+void TensorItemPy::set_data(const py::buffer &data) {
+  auto *info = new py::buffer_info(data.request());
+  ssize_t stride = info->itemsize;
+  for (ssize_t i = info->ndim - 1; i >= 0; i--) {
+    if (info->shape[i] != 1 && info->strides[i] != stride) {
+      delete info;
+      MS_LOG(EXCEPTION) << "The data of tensor " << ref_key_ << " should be contiguous.";
+    }
+    stride *= info->shape[i];
+  }
+  // The buffer is released by the last copy of the item, which may be in a thread of the communicator, so the GIL is
+  // acquired to release the numpy array.
+  data_owner_ = std::shared_ptr<const void>(info->ptr, [info](const void *) {
+    py::gil_scoped_acquire acquire;
+    delete info;
+  });
+  data_ = reinterpret_cast<const uint8_t *>(info->ptr);
+  data_size_ = static_cast<size_t>(info->size * info->itemsize);
+}
+
+void TensorItemPy::set_data(const std::shared_ptr<const void> &data_owner, const uint8_t *data, size_t data_size) {
+  data_owner_ = data_owner;
+  data_ = data;
+  data_size_ = data_size;
+}
+
+const uint8_t *TensorItemPy::data() const { return data_; }
+
+size_t TensorItemPy::data_size() const { return data_size_; }
+
+py::buffer_info TensorItemPy::data_buffer() const {
+  // The data may point into the attachments shared by all the tensors of a received message, so it is exported as
+  // readonly. The readonly buffer is supported since pybind11 2.6, which is not used with python 3.7.
+#if PYBIND11_VERSION_MAJOR > 2 || (PYBIND11_VERSION_MAJOR == 2 && PYBIND11_VERSION_MINOR >= 6)
+  return py::buffer_info(const_cast<uint8_t *>(data_), sizeof(uint8_t), py::format_descriptor<uint8_t>::format(),
+                         static_cast<ssize_t>(data_size_), true);
+#else
+  return py::buffer_info(const_cast<uint8_t *>(data_), sizeof(uint8_t), py::format_descriptor<uint8_t>::format(),
+                         static_cast<ssize_t>(data_size_));
+#endif
+}
+
 }  // namespace fl
 }  // namespace mindspore
@@ -67,6 +67,17 @@ class MS_EXPORT TensorItemPy {
 
   size_t raw_data_size() const;
 
+  // The payload without compression, which is sent as an attachment after the proto instead of base64 in raw_data.
+  // The bytes are owned by data_owner, the numpy array to send or the received attachments, and shared by the copies
+  // of the item.
+  void set_data(const py::buffer &data);
+  void set_data(const std::shared_ptr<const void> &data_owner, const uint8_t *data, size_t data_size);
+  const uint8_t *data() const;
+  size_t data_size() const;
+
+  // The payload is exposed to python by the buffer protocol, so numpy arrays are built on it without copying.
+  py::buffer_info data_buffer() const;
+
  private:
   std::string name_;
   std::string ref_key_;
@@ -79,6 +90,9 @@ class MS_EXPORT TensorItemPy {
   size_t size_;
   size_t bit_num_;
   float offset_;
+  std::shared_ptr<const void> data_owner_ = nullptr;
+  const uint8_t *data_ = nullptr;
+  size_t data_size_ = 0;
 };
 }  // namespace fl
 }  // namespace mindspore
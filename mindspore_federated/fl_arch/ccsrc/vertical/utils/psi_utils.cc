@@ -15,11 +15,59 @@
  */
 
 #include "vertical/utils/psi_utils.h"
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include <string>
 
 namespace mindspore {
 namespace fl {
+namespace {
+// The points are packed in the bytes field with record_len, the repeated field is only sent by the older peers. All the
+// points of a message have the same length, otherwise they are misaligned when decompressed.
+void CheckRecordLen(size_t record_len, size_t size, const psi::PointBuffer &points) {
+  if (record_len == 0 || size % record_len != 0 || (points.record_len() != 0 && points.record_len() != record_len)) {
+    MS_LOG(EXCEPTION) << "The points of size " << size << " with record length " << record_len
+                      << " mismatch the received points with record length " << points.record_len() << ".";
+  }
+}
+
+template <typename Repeated>
+void AppendPoints(const std::string &points_buf, size_t record_len, const Repeated &points_vct,
+                  psi::PointBuffer *points) {
+  if (record_len != 0) {
+    CheckRecordLen(record_len, points_buf.size(), *points);
+    if (points->record_len() == 0) {
+      *points = psi::PointBuffer(0, record_len);
+    }
+    points->Append(points_buf);
+    return;
+  }
+  for (const auto &item : points_vct) {
+    CheckRecordLen(item.size(), item.size(), *points);
+    if (points->record_len() == 0) {
+      *points = psi::PointBuffer(0, item.size());
+    }
+    points->Append(item);
+  }
+}
+
+// Reserve the packed points of all the slices, so they are copied once.
+template <typename Proto, typename GetBuf>
+void ReservePoints(const std::vector<Proto> &protos, size_t record_len, const GetBuf &get_buf,
+                   psi::PointBuffer *points) {
+  if (record_len == 0) {
+    return;
+  }
+  size_t total_size = 0;
+  for (const auto &proto : protos) {
+    total_size += get_buf(proto).size();
+  }
+  *points = psi::PointBuffer(0, record_len);
+  points->Reserve(total_size / record_len);
+}
+}  // namespace
+
 void CreateAliceCheckProto(datajoin::AliceCheckProto *alice_check_proto, const psi::AliceCheck &alice_check) {
   MS_EXCEPTION_IF_NULL(alice_check_proto);
   alice_check_proto->set_bin_id(alice_check.bin_id());
@@ -51,10 +99,9 @@ void CreateBobPbProto(datajoin::BobPbProto *bob_p_b_proto, const psi::BobPb &bob
   MS_EXCEPTION_IF_NULL(bob_p_b_proto);
   bob_p_b_proto->set_bin_id(bob_p_b.bin_id());
 
-  auto p_b_vct = bob_p_b.p_b_vct();
-  for (const auto &item : p_b_vct) {
-    bob_p_b_proto->add_p_b_vct(item);
-  }
+  const auto &p_b_buf = bob_p_b.p_b_buf();
+  bob_p_b_proto->set_p_b_buf(p_b_buf.bytes());
+  bob_p_b_proto->set_record_len(p_b_buf.record_len());
 }
 
 void CreateAlicePbaAndBFProto(datajoin::AlicePbaAndBFProto *alice_pba_bf_proto,
@@ -62,10 +109,9 @@ void CreateAlicePbaAndBFProto(datajoin::AlicePbaAndBFProto *alice_pba_bf_proto,
   MS_EXCEPTION_IF_NULL(alice_pba_bf_proto);
   alice_pba_bf_proto->set_bin_id(alice_pba_bf.bin_id());
 
-  auto p_b_a_vct = alice_pba_bf.p_b_a_vct();
-  for (const auto &item : p_b_a_vct) {
-    alice_pba_bf_proto->add_p_b_a_vct(item);
-  }
+  const auto &p_b_a_buf = alice_pba_bf.p_b_a_buf();
+  alice_pba_bf_proto->set_p_b_a_buf(p_b_a_buf.bytes());
+  alice_pba_bf_proto->set_record_len(p_b_a_buf.record_len());
 
   alice_pba_bf_proto->set_bf_alice(alice_pba_bf.bf_alice());
 }
@@ -94,16 +140,23 @@ void CreatePlainDataProto(datajoin::PlainDataProto *plain_data_proto, const psi:
   plain_data_proto->set_msg(plain_data.msg());
 }
 
+void CreateStreamBucketSizesProto(datajoin::StreamBucketSizesProto *bucket_sizes_proto,
+                                  const psi::StreamBucketSizes &bucket_sizes) {
+  MS_EXCEPTION_IF_NULL(bucket_sizes_proto);
+  bucket_sizes_proto->set_bin_id(bucket_sizes.bin_id());
+  bucket_sizes_proto->set_self_role(bucket_sizes.self_role());
+  for (auto size : bucket_sizes.sizes()) {
+    bucket_sizes_proto->add_sizes(size);
+  }
+}
+
 psi::BobPb ParseBobPbProto(const datajoin::BobPbProto &bobPbProto) {
   psi::BobPb bobPb;
   bobPb.set_bin_id(bobPbProto.bin_id());
-  std::vector<std::string> p_b_vct;
-  int p_b_vct_size = bobPbProto.p_b_vct_size();
-  for (int i = 0; i < p_b_vct_size; i++) {
-    p_b_vct.push_back(bobPbProto.p_b_vct(i));
-  }
-  bobPb.set_p_b_vct(p_b_vct);
-  MS_LOG(INFO) << "(bob_p_b) bin_id is " << bobPb.bin_id() << ", vector size is " << bobPb.p_b_vct().size();
+  psi::PointBuffer p_b_buf;
+  AppendPoints(bobPbProto.p_b_buf(), bobPbProto.record_len(), bobPbProto.p_b_vct(), &p_b_buf);
+  bobPb.set_p_b_buf(std::move(p_b_buf));
+  MS_LOG(INFO) << "(bob_p_b) bin_id is " << bobPb.bin_id() << ", vector size is " << bobPb.p_b_buf().size();
   return bobPb;
 }
 
@@ -130,15 +183,13 @@ psi::ServerPSIInit ParseServerPSIInitProto(const datajoin::ServerPSIInitProto &s
 psi::AlicePbaAndBF ParseAlicePbaAndBFProto(const datajoin::AlicePbaAndBFProto &alicePbaAndBFProto) {
   psi::AlicePbaAndBF alicePbaAndBF;
   alicePbaAndBF.set_bin_id(alicePbaAndBFProto.bin_id());
-  std::vector<std::string> p_b_vct;
-  int p_b_a_vct_size = alicePbaAndBFProto.p_b_a_vct_size();
-  for (int i = 0; i < p_b_a_vct_size; i++) {
-    p_b_vct.push_back(alicePbaAndBFProto.p_b_a_vct(i));
-  }
-  alicePbaAndBF.set_p_b_a_vct(p_b_vct);
+  psi::PointBuffer p_b_a_buf;
+  AppendPoints(alicePbaAndBFProto.p_b_a_buf(), alicePbaAndBFProto.record_len(), alicePbaAndBFProto.p_b_a_vct(),
+               &p_b_a_buf);
+  alicePbaAndBF.set_p_b_a_buf(std::move(p_b_a_buf));
   alicePbaAndBF.set_bf_alice(alicePbaAndBFProto.bf_alice());
   MS_LOG(INFO) << "(alice_pba_bf) bin_id is " << alicePbaAndBF.bin_id() << ", alice_p_b_a size is "
-               << alicePbaAndBF.p_b_a_vct().size() << ", bf_alice size is " << alicePbaAndBF.bf_alice().size();
+               << alicePbaAndBF.p_b_a_buf().size() << ", bf_alice size is " << alicePbaAndBF.bf_alice().size();
   return alicePbaAndBF;
 }
 
@@ -186,6 +237,16 @@ psi::PlainData ParsePlainDataProto(const datajoin::PlainDataProto &plainDataProt
   return plainData;
 }
 
+psi::StreamBucketSizes ParseStreamBucketSizesProto(const datajoin::StreamBucketSizesProto &bucketSizesProto) {
+  psi::StreamBucketSizes bucketSizes;
+  bucketSizes.set_bin_id(bucketSizesProto.bin_id());
+  bucketSizes.set_self_role(bucketSizesProto.self_role());
+  bucketSizes.set_sizes(std::vector<size_t>(bucketSizesProto.sizes().begin(), bucketSizesProto.sizes().end()));
+  MS_LOG(INFO) << "(stream_bucket_sizes) bin_id is " << bucketSizes.bin_id() << ", role is "
+               << bucketSizes.self_role() << ", bucket number is " << bucketSizes.sizes().size();
+  return bucketSizes;
+}
+
 std::vector<std::string> GetSplitData(std::string *begin_ptr, size_t index, size_t data_size, const size_t slice_size) {
   size_t start = index * slice_size;
   size_t end = (index + 1) * slice_size;
@@ -216,10 +277,9 @@ void UpdateSliceData(std::string *proto_data, std::vector<uint8_t> *slice_data,
 }
 
 SliceProto CreateProtoWithSlices(const psi::AlicePbaAndBF &alice_pba_bf) {
-  auto p_b_a_vct = alice_pba_bf.p_b_a_vct();
-  size_t size = p_b_a_vct.size();
+  const auto &p_b_a_buf = alice_pba_bf.p_b_a_buf();
+  size_t size = p_b_a_buf.size();
   size_t slice_cnt = CalSliceCount(size, kPsiSliceSize);
-  auto begin_ptr = p_b_a_vct.data();
 
   std::vector<uint8_t> slice_data;
   std::string offset;
@@ -230,10 +290,10 @@ SliceProto CreateProtoWithSlices(const psi::AlicePbaAndBF &alice_pba_bf) {
     if (i == 0) {
       proto.set_bf_alice(alice_pba_bf.bf_alice());
     }
-    auto data = GetSplitData(begin_ptr, i, size, kPsiSliceSize);
-    for (auto &item : data) {
-      proto.add_p_b_a_vct(item);
-    }
+    size_t start = i * kPsiSliceSize;
+    size_t num = std::min(kPsiSliceSize, size - start);
+    proto.set_p_b_a_buf(p_b_a_buf.record(start), num * p_b_a_buf.record_len());
+    proto.set_record_len(p_b_a_buf.record_len());
     auto proto_data = proto.SerializeAsString();
     UpdateSliceData(&proto_data, &slice_data, &index, &offset, KProtoSplitSign);
   }
@@ -277,10 +337,9 @@ SliceProto CreateProtoWithSlices(const psi::AliceCheck &alice_check) {
 }
 
 SliceProto CreateProtoWithSlices(const psi::BobPb &bob_pb) {
-  auto p_b_vct = bob_pb.p_b_vct();
-  size_t size = p_b_vct.size();
+  const auto &p_b_buf = bob_pb.p_b_buf();
+  size_t size = p_b_buf.size();
   size_t slice_cnt = CalSliceCount(size, kPsiSliceSize);
-  auto begin_ptr = p_b_vct.data();
 
   std::vector<uint8_t> slice_data;
   std::string offset;
@@ -289,10 +348,10 @@ SliceProto CreateProtoWithSlices(const psi::BobPb &bob_pb) {
     datajoin::BobPbProto proto;
     proto.set_bin_id(bob_pb.bin_id());
 
-    auto data = GetSplitData(begin_ptr, i, size, kPsiSliceSize);
-    for (auto &item : data) {
-      proto.add_p_b_vct(item);
-    }
+    size_t start = i * kPsiSliceSize;
+    size_t num = std::min(kPsiSliceSize, size - start);
+    proto.set_p_b_buf(p_b_buf.record(start), num * p_b_buf.record_len());
+    proto.set_record_len(p_b_buf.record_len());
     auto proto_data = proto.SerializeAsString();
     UpdateSliceData(&proto_data, &slice_data, &index, &offset, KProtoSplitSign);
   }
@@ -369,16 +428,16 @@ SliceProto CreateProtoWithSlices(const psi::PlainData &plain_data) {
 psi::AlicePbaAndBF ParseProtoWithSlices(const std::vector<datajoin::AlicePbaAndBFProto> &protos) {
   psi::AlicePbaAndBF alicePbaAndBF;
   alicePbaAndBF.set_bin_id(protos[0].bin_id());
-  std::vector<std::string> p_b_vct;
+  psi::PointBuffer p_b_a_buf;
+  auto get_buf = [](const datajoin::AlicePbaAndBFProto &proto) -> const std::string & { return proto.p_b_a_buf(); };
+  ReservePoints(protos, protos[0].record_len(), get_buf, &p_b_a_buf);
   for (const auto &proto : protos) {
-    for (int i = 0; i < proto.p_b_a_vct_size(); i++) {
-      p_b_vct.push_back(proto.p_b_a_vct(i));
-    }
+    AppendPoints(proto.p_b_a_buf(), proto.record_len(), proto.p_b_a_vct(), &p_b_a_buf);
   }
-  alicePbaAndBF.set_p_b_a_vct(p_b_vct);
+  alicePbaAndBF.set_p_b_a_buf(std::move(p_b_a_buf));
   alicePbaAndBF.set_bf_alice(protos[0].bf_alice());
   MS_LOG(INFO) << "(alice_pba_bf) bin_id is " << alicePbaAndBF.bin_id() << ", alice_p_b_a size is "
-               << alicePbaAndBF.p_b_a_vct().size() << ", bf_alice size is " << alicePbaAndBF.bf_alice().size();
+               << alicePbaAndBF.p_b_a_buf().size() << ", bf_alice size is " << alicePbaAndBF.bf_alice().size();
   return alicePbaAndBF;
 }
 
@@ -401,14 +460,14 @@ psi::AliceCheck ParseProtoWithSlices(const std::vector<datajoin::AliceCheckProto
 psi::BobPb ParseProtoWithSlices(const std::vector<datajoin::BobPbProto> &protos) {
   psi::BobPb bobPb;
   bobPb.set_bin_id(protos[0].bin_id());
-  std::vector<std::string> p_b_vct;
+  psi::PointBuffer p_b_buf;
+  auto get_buf = [](const datajoin::BobPbProto &proto) -> const std::string & { return proto.p_b_buf(); };
+  ReservePoints(protos, protos[0].record_len(), get_buf, &p_b_buf);
   for (const auto &proto : protos) {
-    for (int i = 0; i < proto.p_b_vct_size(); i++) {
-      p_b_vct.push_back(proto.p_b_vct(i));
-    }
+    AppendPoints(proto.p_b_buf(), proto.record_len(), proto.p_b_vct(), &p_b_buf);
   }
-  bobPb.set_p_b_vct(p_b_vct);
-  MS_LOG(INFO) << "(bob_p_b) bin_id is " << bobPb.bin_id() << ", vector size is " << bobPb.p_b_vct().size();
+  bobPb.set_p_b_buf(std::move(p_b_buf));
+  MS_LOG(INFO) << "(bob_p_b) bin_id is " << bobPb.bin_id() << ", vector size is " << bobPb.p_b_buf().size();
   return bobPb;
 }
 
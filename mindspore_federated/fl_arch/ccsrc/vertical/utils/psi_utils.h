@@ -38,6 +38,9 @@ void CreateAliceCheckProto(datajoin::AliceCheckProto *alice_check_proto, const p
 
 void CreatePlainDataProto(datajoin::PlainDataProto *plain_data_proto, const psi::PlainData &plain_data);
 
+void CreateStreamBucketSizesProto(datajoin::StreamBucketSizesProto *bucket_sizes_proto,
+                                  const psi::StreamBucketSizes &bucket_sizes);
+
 psi::BobPb ParseBobPbProto(const datajoin::BobPbProto &bobPbProto);
 
 psi::ClientPSIInit ParseClientPSIInitProto(const datajoin::ClientPSIInitProto &clientPSIInitProto);
@@ -52,6 +55,8 @@ psi::AliceCheck ParseAliceCheckProto(const datajoin::AliceCheckProto &aliceCheck
 
 psi::PlainData ParsePlainDataProto(const datajoin::PlainDataProto &plainDataProto);
 
+psi::StreamBucketSizes ParseStreamBucketSizesProto(const datajoin::StreamBucketSizesProto &bucketSizesProto);
+
 std::vector<std::string> StringSplit(const std::string &str, char sign);
 
 std::vector<std::string> GetSplitData(std::string *begin_ptr, size_t index, size_t data_size, const size_t slice_size);
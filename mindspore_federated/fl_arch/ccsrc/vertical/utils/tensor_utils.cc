@@ -17,14 +17,17 @@
 #include "vertical/utils/tensor_utils.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
 
 namespace mindspore {
 namespace fl {
-TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto) {
+TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto,
+                                      const std::shared_ptr<const std::string> &attachments) {
   TensorListItemPy tensorListItemPy;
   std::string name = tensorListProto.name();
   tensorListItemPy.set_name(name);
-  auto tensors_proto = tensorListProto.tensors();
+  const auto &tensors_proto = tensorListProto.tensors();
   std::vector<TensorItemPy> tensors;
   for (const auto &item : tensors_proto) {
     TensorItemPy tensor;
@@ -32,6 +35,15 @@ TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto) {
     tensor.set_ref_key(item.ref_key());
     tensor.set_dtype(item.data_type());
     tensor.set_raw_data(item.raw_data());
+    if (item.attachment_size() > 0) {
+      auto offset = static_cast<uint64_t>(item.attachment_offset());
+      auto size = static_cast<uint64_t>(item.attachment_size());
+      if (attachments == nullptr || item.attachment_offset() < 0 || offset > attachments->size() ||
+          size > attachments->size() - offset) {
+        MS_LOG_EXCEPTION << "ParseTensorListProto: the attachment of tensor " << item.ref_key() << " is out of range.";
+      }
+      tensor.set_data(attachments, reinterpret_cast<const uint8_t *>(attachments->data()) + offset, size);
+    }
     tensor.set_compress_type(item.compress_type());
     tensor.set_min_val(item.min_val());
     tensor.set_max_val(item.max_val());
@@ -44,20 +56,22 @@ TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto) {
       shape.push_back(item.dims(i));
     }
     tensor.set_shape(shape);
-    tensors.push_back(tensor);
+    tensors.push_back(std::move(tensor));
   }
   tensorListItemPy.set_tensors(tensors);
 
   int tensor_list_size = tensorListProto.tensor_list_size();
   std::vector<TensorListItemPy> tensorListItems;
   for (int i = 0; i < tensor_list_size; i++) {
-    tensorListItems.push_back(ParseTensorListProto(tensorListProto.tensor_list(i)));
+    tensorListItems.push_back(ParseTensorListProto(tensorListProto.tensor_list(i), attachments));
   }
   tensorListItemPy.set_tensor_list_items(tensorListItems);
   return tensorListItemPy;
 }
 
-void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, std::string ref_key) {
+void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, std::string ref_key,
+                       TensorAttachments *attachments) {
+  MS_EXCEPTION_IF_NULL(attachments);
   if (!ref_key.empty()) {
     tensor_proto->set_ref_key(ref_key);
   }
@@ -71,6 +85,12 @@ void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, st
     tensor_proto->add_dims(dim);
   }
   tensor_proto->set_raw_data(tensor.raw_data());
+  if (tensor.data_size() > 0) {
+    tensor_proto->set_attachment_offset(static_cast<int64_t>(attachments->size));
+    tensor_proto->set_attachment_size(static_cast<int64_t>(tensor.data_size()));
+    attachments->tensors.push_back(tensor);
+    attachments->size += tensor.data_size();
+  }
   tensor_proto->set_compress_type(tensor.compress_type());
   tensor_proto->set_min_val(tensor.min_val());
   tensor_proto->set_max_val(tensor.max_val());
@@ -79,7 +99,8 @@ void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, st
   tensor_proto->set_offset(tensor.offset());
 }
 
-void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListItemPy &tensorListItemPy) {
+void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListItemPy &tensorListItemPy,
+                           TensorAttachments *attachments) {
   MS_EXCEPTION_IF_NULL(tensor_list_proto);
   tensor_list_proto->set_name(tensorListItemPy.name());
 
@@ -88,12 +109,12 @@ void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListI
 
   for (const auto &tensor : tensors) {
     TensorProto *tensor_proto = tensor_list_proto->add_tensors();
-    CreateTensorProto(tensor_proto, tensor, tensor.ref_key());
+    CreateTensorProto(tensor_proto, tensor, tensor.ref_key(), attachments);
   }
 
   for (const auto &tensorListItem : tensorListItems) {
     TensorListProto *sub_tensor_list_proto = tensor_list_proto->add_tensor_list();
-    CreateTensorListProto(sub_tensor_list_proto, tensorListItem);
+    CreateTensorListProto(sub_tensor_list_proto, tensorListItem, attachments);
   }
 }
 }  // namespace fl
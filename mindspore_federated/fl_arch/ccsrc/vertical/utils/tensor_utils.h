@@ -18,6 +18,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "vertical/python/tensor_list_py.h"
 #include "vertical/python/tensor_py.h"
 #include "common/protos/vfl.pb.h"
@@ -25,11 +26,21 @@
 
 namespace mindspore {
 namespace fl {
-TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto);
+// The payloads of the tensors attached after the proto of a message, in the order of their attachment_offset.
+struct TensorAttachments {
+  std::vector<TensorItemPy> tensors;
+  size_t size = 0;
+};
 
-void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, std::string ref_key);
+// The tensors with attachments refer to the attachments, which follow the proto in the received message.
+TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto,
+                                      const std::shared_ptr<const std::string> &attachments = nullptr);
 
-void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListItemPy &tensorListItemPy);
+void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, std::string ref_key,
+                       TensorAttachments *attachments);
+
+void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListItemPy &tensorListItemPy,
+                           TensorAttachments *attachments);
 }  // namespace fl
 }  // namespace mindspore
 #endif  // MINDSPORE_FL_ARCH_CCSRC_VERTICAL_UTILS_TENSOR_UTILS_H_
@@ -123,6 +123,12 @@ bool VerticalServer::Send(const std::string &target_server_name, const psi::Plai
   return communicator_ptr->Send(target_server_name, plainData);
 }
 
+bool VerticalServer::Send(const std::string &target_server_name, const psi::StreamBucketSizes &bucketSizes) {
+  auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  return communicator_ptr->Send(target_server_name, bucketSizes);
+}
+
 WorkerConfigItemPy VerticalServer::Send(const std::string &target_server_name,
                                         const WorkerRegisterItemPy &workerRegisterItem) {
   auto communicator_ptr = reinterpret_cast<DataJoinCommunicator *>(communicators_[KDataJoin].get());
@@ -137,53 +143,74 @@ void VerticalServer::Receive(const std::string &target_server_name, TensorListIt
   *tensorListItemPy = std::move(communicator_ptr->Receive(target_server_name));
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::BobPb *bobPb) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::BobPb *bobPb) {
   MS_EXCEPTION_IF_NULL(bobPb);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, bobPb);
+  communicator_ptr->Receive(target_server_name, bin_id, bobPb);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::ClientPSIInit *clientPSIInit) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::ClientPSIInit *clientPSIInit) {
   MS_EXCEPTION_IF_NULL(clientPSIInit);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, clientPSIInit);
+  communicator_ptr->Receive(target_server_name, bin_id, clientPSIInit);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::ServerPSIInit *serverPSIInit) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::ServerPSIInit *serverPSIInit) {
   MS_EXCEPTION_IF_NULL(serverPSIInit);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, serverPSIInit);
+  communicator_ptr->Receive(target_server_name, bin_id, serverPSIInit);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::BobAlignResult *bobAlignResult) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id,
+                             psi::BobAlignResult *bobAlignResult) {
   MS_EXCEPTION_IF_NULL(bobAlignResult);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, bobAlignResult);
+  communicator_ptr->Receive(target_server_name, bin_id, bobAlignResult);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::AlicePbaAndBF *alicePbaAndBF) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::AlicePbaAndBF *alicePbaAndBF) {
   MS_EXCEPTION_IF_NULL(alicePbaAndBF);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, alicePbaAndBF);
+  communicator_ptr->Receive(target_server_name, bin_id, alicePbaAndBF);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::AliceCheck *aliceCheck) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::AliceCheck *aliceCheck) {
   MS_EXCEPTION_IF_NULL(aliceCheck);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, aliceCheck);
+  communicator_ptr->Receive(target_server_name, bin_id, aliceCheck);
 }
 
-void VerticalServer::Receive(const std::string &target_server_name, psi::PlainData *plainData) {
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, psi::PlainData *plainData) {
   MS_EXCEPTION_IF_NULL(plainData);
   auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
-  communicator_ptr->Receive(target_server_name, plainData);
+  communicator_ptr->Receive(target_server_name, bin_id, plainData);
+}
+
+void VerticalServer::Receive(const std::string &target_server_name, size_t bin_id, const std::string &peer_role,
+                             psi::StreamBucketSizes *bucketSizes) {
+  MS_EXCEPTION_IF_NULL(bucketSizes);
+  auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  communicator_ptr->Receive(target_server_name, bin_id, peer_role, bucketSizes);
+}
+
+void VerticalServer::StartPsiBins(const std::vector<size_t> &bin_ids) {
+  auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  communicator_ptr->StartBins(bin_ids);
+}
+
+void VerticalServer::FinishPsiBin(size_t bin_id) {
+  auto communicator_ptr = reinterpret_cast<PsiCommunicator *>(communicators_[KPsi].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  communicator_ptr->FinishBin(bin_id);
 }
 
 bool VerticalServer::DataJoinWaitForStart() {
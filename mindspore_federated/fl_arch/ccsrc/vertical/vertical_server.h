@@ -63,23 +63,35 @@ class VerticalServer {
 
   bool Send(const std::string &target_server_name, const psi::PlainData &plainData);
 
+  bool Send(const std::string &target_server_name, const psi::StreamBucketSizes &bucketSizes);
+
   WorkerConfigItemPy Send(const std::string &target_server_name, const WorkerRegisterItemPy &workerRegisterItem);
 
   void Receive(const std::string &target_server_name, TensorListItemPy *tensorListItemPy);
 
-  void Receive(const std::string &target_server_name, psi::BobPb *bobPb);
+  // The psi messages are received from the queues of the bin, so the bins run concurrently.
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::BobPb *bobPb);
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::ClientPSIInit *clientPSIInit);
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::ServerPSIInit *serverPSIInit);
+
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::BobAlignResult *bobAlignResult);
 
-  void Receive(const std::string &target_server_name, psi::ClientPSIInit *clientPSIInit);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::AlicePbaAndBF *alicePbaAndBF);
 
-  void Receive(const std::string &target_server_name, psi::ServerPSIInit *serverPSIInit);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::AliceCheck *aliceCheck);
 
-  void Receive(const std::string &target_server_name, psi::BobAlignResult *bobAlignResult);
+  void Receive(const std::string &target_server_name, size_t bin_id, psi::PlainData *plainData);
 
-  void Receive(const std::string &target_server_name, psi::AlicePbaAndBF *alicePbaAndBF);
+  void Receive(const std::string &target_server_name, size_t bin_id, const std::string &peer_role,
+               psi::StreamBucketSizes *bucketSizes);
 
-  void Receive(const std::string &target_server_name, psi::AliceCheck *aliceCheck);
+  // The psi messages of a bin are only accepted between starting and finishing the bin.
+  void StartPsiBins(const std::vector<size_t> &bin_ids);
 
-  void Receive(const std::string &target_server_name, psi::PlainData *plainData);
+  void FinishPsiBin(size_t bin_id);
 
   bool DataJoinWaitForStart();
 
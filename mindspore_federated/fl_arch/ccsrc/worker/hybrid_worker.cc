@@ -128,6 +128,11 @@ void HybridWorker::Stop() {
 
 void HybridWorker::InitAndLoadDistributedCache() {
   auto config = FLContext::instance()->distributed_cache_config();
+  // The memory cache is only visible to the server process, the worker cannot share the states through it.
+  if (config.type == cache::kMemoryCacheType) {
+    MS_LOG(EXCEPTION) << "Distributed cache type " << config.type << " is only supported by the server, please use "
+                      << "redis or a plugin for the worker.";
+  }
   if (config.address.empty()) {
     MS_LOG(EXCEPTION) << "Distributed cache address cannot be empty.";
   }
@@ -17,7 +17,9 @@
 #ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_PS_FUSED_PULL_WEIGHT_KERNEL_H_
 #define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_PS_FUSED_PULL_WEIGHT_KERNEL_H_
 
+#include <chrono>
 #include <map>
+#include <thread>
 #include <vector>
 #include <string>
 #include <memory>
@@ -32,7 +34,7 @@ namespace mindspore {
 namespace fl {
 namespace worker {
 namespace kernel {
-// The duration between two PullWeight requests when return code is ResponseCode_SucNotReady.
+// The min duration between the starts of two PullWeight requests when return code is ResponseCode_SucNotReady.
 constexpr int kRetryDurationOfPullWeights = 500;
 class FusedPullWeightKernelMod : public AbstractKernel {
  public:
@@ -64,6 +66,7 @@ class FusedPullWeightKernelMod : public AbstractKernel {
         MS_LOG(WARNING) << "Worker has finished.";
         return dict_data;
       }
+      auto send_time = std::chrono::steady_clock::now();
       if (!fl::worker::HybridWorker::GetInstance().SendToServer(
             fbb.GetBufferPointer(), fbb.GetSize(), fl::TcpUserCommand::kPullWeight, &pull_weight_rsp_msg)) {
         MS_LOG(WARNING) << "Sending request for FusedPullWeight to server 0 failed. Retry later.";
@@ -90,7 +93,9 @@ class FusedPullWeightKernelMod : public AbstractKernel {
 
       retcode = pull_weight_rsp->retcode();
       if (retcode == schema::ResponseCode_SucNotReady) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(kRetryDurationOfPullWeights));
+        // The request which has been parked on server until the long poll timeout is retried at once.
+        auto retry_time = send_time + std::chrono::milliseconds(kRetryDurationOfPullWeights);
+        std::this_thread::sleep_until(retry_time);
         uint64_t pull_weight_iteration = IntToUint(pull_weight_rsp->iteration());
         if (pull_weight_iteration > fl_iteration_) {
           fl_iteration_ = pull_weight_iteration;
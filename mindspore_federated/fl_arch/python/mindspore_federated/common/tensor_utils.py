@@ -64,17 +64,16 @@ def tensor_to_tensor_pybind_obj(ts, ref_key, compress_config=None):
             compress_type = tensor.compress_type()
             logger.info("The compress_type is {}.".format(compress_type))
             if compress_type == NO_COMPRESS_TYPE:
-                np_data_b64 = base64.b64encode(np_data.tobytes())
-                tensor.set_raw_data(np_data_b64)
+                tensor.set_data(np_data)
         else:
             raise ValueError('compress_type: {} is not supported now.'.format(compress_config.compress_type))
     else:
         tensor = TensorItem_()
         tensor.set_compress_type(NO_COMPRESS_TYPE)
-        np_data_b64 = base64.b64encode(np_data.tobytes())
-        tensor.set_raw_data(np_data_b64)
+        # The data is sent as an attachment of the message, which refers to np_data until the tensor is released.
+        tensor.set_data(np_data)
     logger.info("Encode end.")
-    raw_data_size = tensor.raw_data_size()
+    raw_data_size = tensor.raw_data_size() + tensor.data_size()
     logger.info("The send size of {} is about {} B.".format(ref_key, raw_data_size))
     if ref_key:
         tensor.set_ref_key(ref_key)
@@ -134,13 +133,17 @@ def tensor_pybind_obj_to_tensor(tensor_item):
         list_data = decompress_func(tensor_item)
         np_data = np.array(list_data, dtype=dtype).reshape(shape)
     elif compress_type == NO_COMPRESS_TYPE:
-        raw_data = tensor_item.raw_data()
-        values = base64.b64decode(raw_data)
-        np_data = np.frombuffer(values, dtype=dtype).reshape(shape)
+        if tensor_item.data_size() > 0:
+            # The array is built on the received attachment by the buffer protocol, without copying.
+            np_data = np.frombuffer(tensor_item, dtype=dtype).reshape(shape)
+        else:
+            raw_data = tensor_item.raw_data()
+            values = base64.b64decode(raw_data)
+            np_data = np.frombuffer(values, dtype=dtype).reshape(shape)
     else:
         raise ValueError('compress_type: {} is not supported now.'.format(compress_type))
     logger.info("Decode end.")
-    raw_data_size = tensor_item.raw_data_size()
+    raw_data_size = tensor_item.raw_data_size() + tensor_item.data_size()
     logger.info("The receive size of {} is about {} B.".format(ref_key, raw_data_size))
     ts = Tensor(np_data)
     return ref_key, ts
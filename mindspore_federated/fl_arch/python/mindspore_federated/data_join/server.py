@@ -13,7 +13,7 @@
 # limitations under the License.
 # ============================================================================
 """Communicator server in data join."""
-from mindspore_federated._mindspore_federated import RunPSI
+from mindspore_federated._mindspore_federated import RunPSI, RunMultiBinPSI
 
 
 class _DataJoinServer:
@@ -51,3 +51,24 @@ class _DataJoinServer:
             intersection_keys = RunPSI(input_vct, "server", self._target_server_name, bucket_id, thread_num)
             return intersection_keys
         raise ValueError("join type: {} is not support currently".format(self._worker_config.join_type))
+
+    def join_bins_func(self, bucket_inputs, bucket_ids, concurrent_bin_num):
+        """
+        Join the buckets concurrently over the same communicator.
+
+        Args:
+            bucket_inputs (list(list(str))): The keys need to be joined of each bucket.
+            bucket_ids (list(int)): The ids of the buckets, which must be the same as the peer.
+            concurrent_bin_num (int): The max number of the buckets joined at a time.
+
+        Returns:
+            - intersection_keys (list(list(str))): The intersection keys of each bucket.
+
+        Raises:
+            ValueError: If the join type is not supported.
+        """
+        if self._worker_config.join_type == "psi":
+            thread_num = self._worker_config.thread_num
+            return RunMultiBinPSI(bucket_inputs, bucket_ids, "server", self._target_server_name, thread_num,
+                                  concurrent_bin_num)
+        raise ValueError("join type: {} is not support currently".format(self._worker_config.join_type))
@@ -33,6 +33,9 @@ from .io import export_mindrecord
 
 SUPPORT_JOIN_TYPES = ("psi",)
 SUPPORT_STORE_TYPES = ("csv",)
+# The number of buckets joined concurrently. The intersections are exported and released group by group, so at most
+# this number of intersections are held in memory. Both parties must use the same value.
+CONCURRENT_BUCKET_NUM = 4
 
 
 class _DivideKeyTobucket:
@@ -146,19 +149,6 @@ class FLDataWorker:
     def __init__(self, config: dict):
         self._config = config
 
-    def _join_func(self, input_vct, bucket_id):
-        """
-        Join function.
-
-        Args:
-            input_vct (list(str)): The keys need to be joined. The type of each key must be "str".
-            bucket_id (int): The id of the bucket.
-
-        Returns:
-            - intersection_keys (list(str)): The intersection keys.
-        """
-        return self.data_join_obj.join_func(input_vct, bucket_id)
-
     def _export(self):
         """
         Export MindRecord by intersection keys.
@@ -168,14 +158,21 @@ class FLDataWorker:
         buckets = divide_key_to_bucket.get_buckets()
         shard_num = self._worker_config.shard_num
         export_count = 0
-        for bucket_id, input_vct in enumerate(buckets):
-            intersection_keys = self._join_func(input_vct, bucket_id + 1)
-            if not intersection_keys:
-                continue
-            file_name = "mindrecord_{}_".format(bucket_id) if shard_num > 1 else "mindrecord_{}".format(bucket_id)
-            output_file_name = os.path.join(self._worker_config.output_dir, file_name)
-            export_mindrecord(output_file_name, self._raw_data, intersection_keys, shard_num=shard_num)
-            export_count += 1
+        # The buckets of a group are joined concurrently, so the network latency of a bucket is hidden behind the
+        # others. The intersections of a group are exported before joining the next group.
+        for group_begin in range(0, len(buckets), CONCURRENT_BUCKET_NUM):
+            group_end = min(group_begin + CONCURRENT_BUCKET_NUM, len(buckets))
+            bucket_intersection_keys = self.data_join_obj.join_bins_func(buckets[group_begin:group_end],
+                                                                         list(range(group_begin + 1, group_end + 1)),
+                                                                         CONCURRENT_BUCKET_NUM)
+            for bucket_id, intersection_keys in enumerate(bucket_intersection_keys, group_begin):
+                if not intersection_keys:
+                    continue
+                file_name = "mindrecord_{}_".format(bucket_id) if shard_num > 1 else "mindrecord_{}".format(bucket_id)
+                output_file_name = os.path.join(self._worker_config.output_dir, file_name)
+                export_mindrecord(output_file_name, self._raw_data, intersection_keys, shard_num=shard_num)
+                export_count += 1
+            del bucket_intersection_keys
         if export_count == 0:
             raise ValueError("The intersection_keys of all buckets is empty")
 
@@ -0,0 +1,117 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/base_crypto/bloom_filter.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+namespace {
+constexpr size_t kRecordLen = 32;
+constexpr size_t kThreadNum = 4;
+
+PointBuffer GenRecords(size_t num, std::mt19937_64 *rng) {
+  PointBuffer buffer(num, kRecordLen);
+  for (size_t i = 0; i < num; i++) {
+    for (size_t j = 0; j < kRecordLen; j++) {
+      buffer.mutable_record(i)[j] = static_cast<uint8_t>((*rng)());
+    }
+  }
+  return buffer;
+}
+
+size_t CountPositives(const BloomFilter &filter, const PointBuffer &items) {
+  std::vector<uint8_t> results;
+  filter.LookUp(items, 0, items.size(), &results);
+  size_t count = 0;
+  for (auto result : results) {
+    count += result;
+  }
+  return count;
+}
+}  // namespace
+
+class TestBloomFilter : public testing::Test {};
+
+/// Feature: Bloom filter of the filter PSI.
+/// Description: Build filters of random records with several false positive rates, and look up the inserted records
+/// one by one and in a batch.
+/// Expectation: Every inserted record is found.
+TEST_F(TestBloomFilter, NoFalseNegatives) {
+  std::mt19937_64 rng(2022);
+  for (int neg_log_fp_rate : {1, 10, 20, 40}) {
+    for (size_t num : {1, 100, 10000}) {
+      auto items = GenRecords(num, &rng);
+      BloomFilter filter(items, kThreadNum, neg_log_fp_rate);
+      EXPECT_EQ(CountPositives(filter, items), num) << "neg_log_fp_rate " << neg_log_fp_rate << ", num " << num;
+      for (size_t i = 0; i < num; i += 97) {
+        EXPECT_TRUE(filter.LookUp(items.Get(i)));
+      }
+    }
+  }
+}
+
+/// Feature: Bloom filter of the filter PSI.
+/// Description: Look up records which are not inserted in filters with false positive rates 2^-8 and 2^-10.
+/// Expectation: The measured false positive rate is near 2^-neg_log_fp_rate: not above 1.5 times of it, and not far
+/// below, which would mean the filter is larger than needed.
+TEST_F(TestBloomFilter, FalsePositiveRate) {
+  std::mt19937_64 rng(2022);
+  constexpr size_t kInputNum = 20000;
+  constexpr size_t kQueryNum = 400000;
+  for (int neg_log_fp_rate : {8, 10}) {
+    BloomFilter filter(GenRecords(kInputNum, &rng), kThreadNum, neg_log_fp_rate);
+    double fp_rate = static_cast<double>(CountPositives(filter, GenRecords(kQueryNum, &rng))) / kQueryNum;
+    double target = std::pow(2.0, -neg_log_fp_rate);
+    EXPECT_LE(fp_rate, target * 1.5) << "neg_log_fp_rate " << neg_log_fp_rate;
+    EXPECT_GE(fp_rate, target / 4) << "neg_log_fp_rate " << neg_log_fp_rate;
+  }
+}
+
+/// Feature: Bloom filter of the filter PSI.
+/// Description: Rebuild a filter from GetData of another one with the same peer input number, as the peer of the
+/// filter PSI does.
+/// Expectation: The rebuilt filter has the same data, and the same results for inserted and other records.
+TEST_F(TestBloomFilter, GetDataRoundTrip) {
+  std::mt19937_64 rng(2022);
+  constexpr size_t kInputNum = 5000;
+  constexpr int kNegLogFpRate = 20;
+  auto items = GenRecords(kInputNum, &rng);
+  auto others = GenRecords(kInputNum, &rng);
+  BloomFilter filter(items, kThreadNum, kNegLogFpRate);
+  auto data = filter.GetData();
+  ASSERT_EQ(data.size(), filter.bitArrayByteLen());
+
+  BloomFilter received(data, kInputNum, kNegLogFpRate);
+  EXPECT_EQ(received.bitArrayByteLen(), filter.bitArrayByteLen());
+  EXPECT_EQ(received.GetData(), data);
+  EXPECT_EQ(CountPositives(received, items), kInputNum);
+  std::vector<uint8_t> expected;
+  std::vector<uint8_t> results;
+  filter.LookUp(others, 0, others.size(), &expected);
+  received.LookUp(others, 0, others.size(), &results);
+  EXPECT_EQ(results, expected);
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/secure_protocol/masking.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+class TestMasking : public testing::Test {
+ public:
+  void SetUp() override {
+    for (size_t i = 0; i < KEY_LENGTH_32; i++) {
+      secret[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    // The low bytes of the counter carry into the higher ones while generating.
+    for (size_t i = 0; i < AES_IV_SIZE; i++) {
+      ivec[i] = i < AES_IV_SIZE - 2 ? static_cast<uint8_t>(i) : 0xff;
+    }
+  }
+
+  uint8_t secret[KEY_LENGTH_32] = {0};
+  uint8_t ivec[AES_IV_SIZE] = {0};
+};
+
+/// Feature: Masking of secure aggregation.
+/// Description: Add the masking over chunks of arbitrary [begin, end), including the starts not aligned to the 16 bytes
+/// AES block and the chunks across the key stream batches.
+/// Expectation: The noise is the same as the serial GetMasking, and subtracting it again gives zero.
+TEST_F(TestMasking, ChunkedEqualsSerial) {
+  constexpr int kNoiseLen = 40000;
+  std::vector<float> expected;
+  ASSERT_EQ(Masking::GetMasking(&expected, kNoiseLen, secret, KEY_LENGTH_32, ivec, AES_IV_SIZE), 0);
+  ASSERT_EQ(expected.size(), kNoiseLen);
+
+  const std::vector<size_t> bounds = {0, 1, 3, 4, 5, 11, 16383, 16385, 20000, 32771, 32772, 39999, kNoiseLen};
+  std::vector<float> noise(kNoiseLen, 0.0f);
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    ASSERT_EQ(Masking::AddMasking(noise.data(), bounds[i], bounds[i + 1], 1.0f, secret, KEY_LENGTH_32, ivec,
+                                  AES_IV_SIZE),
+              0);
+  }
+  for (size_t i = 0; i < noise.size(); i++) {
+    ASSERT_EQ(noise[i], expected[i]) << i;
+  }
+
+  ASSERT_EQ(Masking::AddMasking(noise.data(), 0, kNoiseLen, -1.0f, secret, KEY_LENGTH_32, ivec, AES_IV_SIZE), 0);
+  for (size_t i = 0; i < noise.size(); i++) {
+    ASSERT_EQ(noise[i], 0.0f) << i;
+  }
+}
+
+/// Feature: Masking of secure aggregation.
+/// Description: Add the masking of every single element starting from each offset in a block.
+/// Expectation: Each element is the same as the serial GetMasking.
+TEST_F(TestMasking, SingleElements) {
+  constexpr int kNoiseLen = 64;
+  std::vector<float> expected;
+  ASSERT_EQ(Masking::GetMasking(&expected, kNoiseLen, secret, KEY_LENGTH_32, ivec, AES_IV_SIZE), 0);
+  std::vector<float> noise(kNoiseLen, 0.0f);
+  for (size_t i = 0; i < kNoiseLen; i++) {
+    ASSERT_EQ(Masking::AddMasking(noise.data(), i, i + 1, 1.0f, secret, KEY_LENGTH_32, ivec, AES_IV_SIZE), 0);
+    EXPECT_EQ(noise[i], expected[i]) << i;
+  }
+  // An empty range adds nothing.
+  ASSERT_EQ(Masking::AddMasking(noise.data(), 3, 3, 1.0f, secret, KEY_LENGTH_32, ivec, AES_IV_SIZE), 0);
+  EXPECT_EQ(noise[3], expected[3]);
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,150 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/secure_protocol/secret_sharing.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+namespace {
+constexpr size_t kShareNum = 5;
+constexpr size_t kThreshold = 3;
+constexpr size_t kSecretNum = 64;
+constexpr unsigned int kSeed = 2022;
+}  // namespace
+
+class TestSecretSharing : public testing::Test {
+ public:
+  void SetUp() override {
+    prime_ = BN_new();
+    ASSERT_NE(prime_, nullptr);
+    ASSERT_EQ(GetPrime(prime_), 0);
+  }
+
+  void TearDown() override { BN_clear_free(prime_); }
+
+  // Split the secret into shares of index 1 to kShareNum with a random polynomial of degree kThreshold - 1.
+  std::vector<std::unique_ptr<Share>> Split(const std::vector<uint8_t> &secret) {
+    BN_CTX *ctx = BN_CTX_new();
+    std::vector<BIGNUM *> coefficients(kThreshold, nullptr);
+    for (size_t i = 0; i < kThreshold; i++) {
+      coefficients[i] = BN_new();
+      if (i == 0) {
+        (void)BN_bin2bn(secret.data(), static_cast<int>(secret.size()), coefficients[i]);
+      } else {
+        (void)BN_rand_range(coefficients[i], prime_);
+      }
+    }
+    BIGNUM *x = BN_new();
+    BIGNUM *y = BN_new();
+    std::vector<std::unique_ptr<Share>> shares;
+    for (unsigned int index = 1; index <= kShareNum; index++) {
+      // Horner's rule from the highest coefficient.
+      (void)BN_zero(y);
+      (void)BN_set_word(x, index);
+      for (size_t i = kThreshold; i > 0; i--) {
+        (void)BN_mod_mul(y, y, x, prime_, ctx);
+        (void)BN_mod_add(y, y, coefficients[i - 1], prime_, ctx);
+      }
+      auto share = std::make_unique<Share>();
+      share->index = index;
+      share->len = static_cast<size_t>(BN_num_bytes(y));
+      share->data = static_cast<unsigned char *>(malloc(share->len + 1));
+      share->len = static_cast<size_t>(BN_bn2bin(y, share->data));
+      shares.emplace_back(std::move(share));
+    }
+    BN_clear_free(x);
+    BN_clear_free(y);
+    for (auto coefficient : coefficients) {
+      BN_clear_free(coefficient);
+    }
+    BN_CTX_free(ctx);
+    return shares;
+  }
+
+  BIGNUM *prime_ = nullptr;
+};
+
+/// Feature: Batched reconstruction of secure aggregation secrets.
+/// Description: Split random secrets, some with leading zero bytes or all zeros, and combine them in one batch from
+/// share sets of different indices and orders.
+/// Expectation: Each secret equals Combine over the same shares, and the original secret without leading zeros.
+TEST_F(TestSecretSharing, CombineBatchEqualsCombine) {
+  const std::vector<std::vector<unsigned int>> index_sets = {{1, 2, 3}, {3, 1, 2}, {2, 4, 5}, {5, 3, 1}, {4, 5, 1}};
+  std::mt19937 rng(kSeed);
+  std::vector<std::vector<uint8_t>> secrets(kSecretNum, std::vector<uint8_t>(SECRET_MAX_LEN));
+  std::vector<std::vector<std::unique_ptr<Share>>> all_shares;
+  std::vector<std::vector<Share *>> shares_list(kSecretNum);
+  for (size_t i = 0; i < kSecretNum; i++) {
+    auto &secret = secrets[i];
+    for (auto &byte : secret) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    // leading zero bytes, which are not kept by the reconstruction
+    size_t zero_num = i % 4 == 0 ? 0 : (i % 4 == 3 ? SECRET_MAX_LEN : i % 4 * 3);
+    for (size_t j = 0; j < zero_num; j++) {
+      secret[j] = 0;
+    }
+    all_shares.emplace_back(Split(secret));
+    for (auto index : index_sets[i % index_sets.size()]) {
+      shares_list[i].push_back(all_shares[i][index - 1].get());
+    }
+  }
+
+  SecretSharing secret_sharing(prime_);
+  std::vector<std::vector<uint8_t>> combined;
+  ASSERT_EQ(secret_sharing.CombineBatch(kThreshold, shares_list, &combined), 0);
+  ASSERT_EQ(combined.size(), kSecretNum);
+  for (size_t i = 0; i < kSecretNum; i++) {
+    uint8_t secret[SECRET_MAX_LEN + 1] = {0};
+    size_t length = SECRET_MAX_LEN + 1;
+    ASSERT_EQ(secret_sharing.Combine(kThreshold, shares_list[i], secret, &length), 0);
+    EXPECT_EQ(combined[i], std::vector<uint8_t>(secret, secret + length)) << i;
+
+    auto first = secrets[i].begin();
+    while (first != secrets[i].end() && *first == 0) {
+      ++first;
+    }
+    EXPECT_EQ(combined[i], std::vector<uint8_t>(first, secrets[i].end())) << i;
+  }
+}
+
+/// Feature: Batched reconstruction of secure aggregation secrets.
+/// Description: Combine a batch in which one secret has duplicated share indices.
+/// Expectation: CombineBatch fails, since the lagrange coefficients of duplicated indices do not exist.
+TEST_F(TestSecretSharing, CombineBatchRejectsDuplicateIndices) {
+  std::vector<uint8_t> secret(SECRET_MAX_LEN, 0x5a);
+  auto shares = Split(secret);
+  SecretSharing secret_sharing(prime_);
+  std::vector<std::vector<uint8_t>> combined;
+
+  std::vector<std::vector<Share *>> shares_list = {{shares[0].get(), shares[1].get(), shares[2].get()},
+                                                   {shares[0].get(), shares[0].get(), shares[2].get()}};
+  EXPECT_EQ(secret_sharing.CombineBatch(kThreshold, shares_list, &combined), -1);
+
+  // a different share with the same index
+  auto other_shares = Split(secret);
+  shares_list = {{shares[3].get(), other_shares[3].get(), shares[4].get()}};
+  EXPECT_EQ(secret_sharing.CombineBatch(kThreshold, shares_list, &combined), -1);
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,280 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "distributed_cache/redis/redis.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+namespace {
+constexpr uint64_t kExpireSeconds = 100;
+
+// The hashes of the fake redis server, whose values are strings as redis keeps them.
+struct FakeHashStore {
+  std::map<std::string, std::map<std::string, std::string>> hashes;
+  std::map<std::string, std::vector<uint64_t>> expires;
+
+  CacheStatus HIncr(const std::string &key, const std::string &filed, uint64_t *new_value) {
+    auto &value = hashes[key][filed];
+    uint64_t old_value = 0;
+    if (!value.empty() && !Str2Uint64(value, &old_value)) {
+      return kCacheTypeErr;
+    }
+    *new_value = old_value + 1;
+    value = std::to_string(*new_value);
+    return kCacheSuccess;
+  }
+
+  static bool Str2Uint64(const std::string &str, uint64_t *value) {
+    if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos) {
+      return false;
+    }
+    *value = std::stoull(str);
+    return true;
+  }
+};
+
+// A client implementing only the commands used by the default RedisClientBase::HIncrAndSum.
+class FakeHashClient : public RedisClientBase {
+ public:
+  explicit FakeHashClient(FakeHashStore *store) : store_(store) {}
+
+  bool IsValid() override { return true; }
+  void Disconnect() override {}
+  CacheStatus Connect(bool) override { return kCacheSuccess; }
+  CacheStatus Reconnect() override { return kCacheSuccess; }
+  CacheStatus Del(const std::vector<std::string> &) override { return kCacheInnerErr; }
+  CacheStatus Expire(const std::string &key, uint64_t seconds) override {
+    store_->expires[key].push_back(seconds);
+    return kCacheSuccess;
+  }
+  CacheStatus SAdd(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus SIsMember(const std::string &, const std::string &, bool *) override { return kCacheInnerErr; }
+  CacheStatus SMembers(const std::string &, std::vector<std::string> *) override { return kCacheInnerErr; }
+  CacheStatus HExists(const std::string &, const std::string &, bool *) override { return kCacheInnerErr; }
+  CacheStatus HSet(const std::string &, const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus HSetNx(const std::string &, const std::string &, const std::string &) override {
+    return kCacheInnerErr;
+  }
+  CacheStatus HMSet(const std::string &, const std::unordered_map<std::string, std::string> &) override {
+    return kCacheInnerErr;
+  }
+  CacheStatus HGet(const std::string &, const std::string &, std::string *) override { return kCacheInnerErr; }
+  CacheStatus HGetAll(const std::string &key, std::unordered_map<std::string, std::string> *items) override {
+    if (hgetall_fail_) {
+      return kCacheNetErr;
+    }
+    items->clear();
+    auto it = store_->hashes.find(key);
+    if (it != store_->hashes.end()) {
+      items->insert(it->second.begin(), it->second.end());
+    }
+    return kCacheSuccess;
+  }
+  CacheStatus HIncr(const std::string &key, const std::string &filed, uint64_t *new_value) override {
+    return store_->HIncr(key, filed, new_value);
+  }
+  CacheStatus HDel(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus Get(const std::string &, std::string *) override { return kCacheInnerErr; }
+  CacheStatus SetEx(const std::string &, const std::string &, uint64_t) override { return kCacheInnerErr; }
+  CacheStatus SetNx(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus SetExNx(const std::string &, const std::string &, uint64_t) override { return kCacheInnerErr; }
+  CacheStatus Incr(const std::string &, uint64_t *) override { return kCacheInnerErr; }
+  CacheStatus LPush(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus LRange(const std::string &, size_t, size_t, std::vector<std::string> *) override {
+    return kCacheInnerErr;
+  }
+  CacheStatus LTrim(const std::string &, size_t, size_t) override { return kCacheInnerErr; }
+
+  void set_hgetall_fail(bool hgetall_fail) { hgetall_fail_ = hgetall_fail; }
+
+ private:
+  FakeHashStore *store_;
+  bool hgetall_fail_ = false;
+};
+
+// Parse the reply in the redis protocol as hiredis does for the replies from the server.
+RedisReply CreateReply(const std::string &protocol_reply) {
+  auto reader = redisReaderCreate();
+  void *reply = nullptr;
+  if (redisReaderFeed(reader, protocol_reply.data(), protocol_reply.size()) != REDIS_OK ||
+      redisReaderGetReply(reader, &reply) != REDIS_OK) {
+    reply = nullptr;
+  }
+  redisReaderFree(reader);
+  return RedisReply(reinterpret_cast<redisReply *>(reply));
+}
+
+// A redis client whose server runs the HIncrAndSum script on the fake hashes, or replies the given reply.
+class FakeEvalRedisClient : public RedisClient {
+ public:
+  explicit FakeEvalRedisClient(FakeHashStore *store) : RedisClient("127.0.0.1:6379", nullptr, 0), store_(store) {}
+
+  void set_reply(const std::string &protocol_reply) { protocol_reply_ = protocol_reply; }
+  const std::vector<std::string> &keys() const { return keys_; }
+  const std::vector<std::string> &args() const { return args_; }
+  const std::string &script() const { return script_; }
+
+ protected:
+  RedisReply Eval(const std::string &script, const std::vector<std::string> &keys,
+                  const std::vector<std::string> &args) override {
+    script_ = script;
+    keys_ = keys;
+    args_ = args;
+    if (!protocol_reply_.empty()) {
+      return CreateReply(protocol_reply_);
+    }
+    return CreateReply(RunHIncrAndSumScript(keys, args));
+  }
+
+ private:
+  // Do what the script does with KEYS[1] and ARGV, and reply {new value, total, has unknown} as an array.
+  std::string RunHIncrAndSumScript(const std::vector<std::string> &keys, const std::vector<std::string> &args) {
+    if (keys.size() != 1 || args.size() < 2) {
+      return "-ERR wrong number of arguments\r\n";
+    }
+    uint64_t new_value = 0;
+    if (!store_->HIncr(keys[0], args[0], &new_value).IsSuccess()) {
+      return "-ERR hash value is not an integer\r\n";
+    }
+    if (new_value == 1) {
+      store_->expires[keys[0]].push_back(std::stoull(args[1]));
+    }
+    uint64_t total = 0;
+    uint64_t has_unknown = 0;
+    for (auto &item : store_->hashes[keys[0]]) {
+      uint64_t value = 0;
+      if (!FakeHashStore::Str2Uint64(item.second, &value)) {
+        return "-ERR user_script: attempt to perform arithmetic on a nil value\r\n";
+      }
+      total += value;
+      if (std::find(args.begin() + 2, args.end(), item.first) == args.end()) {
+        has_unknown = 1;
+      }
+    }
+    return "*3\r\n:" + std::to_string(new_value) + "\r\n:" + std::to_string(total) + "\r\n:" +
+           std::to_string(has_unknown) + "\r\n";
+  }
+
+  FakeHashStore *store_;
+  std::string protocol_reply_;
+  std::string script_;
+  std::vector<std::string> keys_;
+  std::vector<std::string> args_;
+};
+}  // namespace
+
+class TestHIncrAndSum : public testing::Test {
+ public:
+  // Increase the fileds in turn, and check the totals and whether there are unknown fileds after each increase.
+  static void CheckIncrease(RedisClientBase *client, const FakeHashStore &store) {
+    std::vector<std::string> known = {"a", "b"};
+    std::vector<std::pair<std::string, std::pair<uint64_t, bool>>> steps = {
+      {"a", {1, false}}, {"a", {2, false}}, {"b", {3, false}}, {"c", {4, true}}, {"a", {5, true}}};
+    for (auto &step : steps) {
+      uint64_t total = 0;
+      bool has_unknown = false;
+      ASSERT_TRUE(client->HIncrAndSum("count", step.first, kExpireSeconds, known, &total, &has_unknown).IsSuccess());
+      EXPECT_EQ(total, step.second.first) << step.first;
+      EXPECT_EQ(has_unknown, step.second.second) << step.first;
+    }
+    // the expire time is set when each of the fileds a, b and c is created, not when the fileds are increased again
+    ASSERT_EQ(store.expires.count("count"), 1);
+    EXPECT_EQ(store.expires.at("count"), std::vector<uint64_t>(3, kExpireSeconds));
+    EXPECT_EQ(store.hashes.at("count"), (std::map<std::string, std::string>({{"a", "3"}, {"b", "1"}, {"c", "1"}})));
+  }
+};
+
+/// Feature: HIncrAndSum of the distributed cache.
+/// Description: Increase the fileds of a hash with the default HIncrAndSum, which calls HIncr, Expire and HGetAll.
+/// Expectation: The totals and the unknown fileds are right, and the expire time is set only for the new fileds.
+TEST_F(TestHIncrAndSum, DefaultImplementation) {
+  FakeHashStore store;
+  FakeHashClient client(&store);
+  CheckIncrease(&client, store);
+}
+
+/// Feature: HIncrAndSum of the distributed cache.
+/// Description: Call the default HIncrAndSum without outputs, with a non-integer filed, and with HGetAll failing.
+/// Expectation: The errors are returned.
+TEST_F(TestHIncrAndSum, DefaultImplementationErrors) {
+  FakeHashStore store;
+  FakeHashClient client(&store);
+  uint64_t total = 0;
+  bool has_unknown = false;
+  EXPECT_EQ(client.HIncrAndSum("count", "a", kExpireSeconds, {}, nullptr, &has_unknown), kCacheInnerErr);
+  EXPECT_EQ(client.HIncrAndSum("count", "a", kExpireSeconds, {}, &total, nullptr), kCacheInnerErr);
+
+  store.hashes["count"]["a"] = "x";
+  EXPECT_EQ(client.HIncrAndSum("count", "a", kExpireSeconds, {}, &total, &has_unknown), kCacheTypeErr);
+  EXPECT_EQ(client.HIncrAndSum("count", "b", kExpireSeconds, {}, &total, &has_unknown), kCacheTypeErr);
+
+  client.set_hgetall_fail(true);
+  EXPECT_EQ(client.HIncrAndSum("other", "a", kExpireSeconds, {}, &total, &has_unknown), kCacheNetErr);
+}
+
+/// Feature: HIncrAndSum of the redis client.
+/// Description: Increase the fileds of a hash with the lua script of the redis client, on a fake server running the
+/// script.
+/// Expectation: The script is called with the hash key and the arguments in the order it reads them, and the results
+/// are the same as the default HIncrAndSum.
+TEST_F(TestHIncrAndSum, RedisScript) {
+  FakeHashStore store;
+  FakeEvalRedisClient client(&store);
+  CheckIncrease(&client, store);
+  EXPECT_EQ(client.keys(), std::vector<std::string>({"count"}));
+  EXPECT_EQ(client.args(), std::vector<std::string>({"a", std::to_string(kExpireSeconds), "a", "b"}));
+  EXPECT_NE(client.script().find("HINCRBY"), std::string::npos);
+  EXPECT_NE(client.script().find("EXPIRE"), std::string::npos);
+  EXPECT_NE(client.script().find("HGETALL"), std::string::npos);
+}
+
+/// Feature: HIncrAndSum of the redis client.
+/// Description: The script replies a big total, an error, a nil, or an array of the wrong size or type.
+/// Expectation: The big total is kept, an error reply is a net error and the others are inner errors.
+TEST_F(TestHIncrAndSum, RedisScriptReplies) {
+  FakeHashStore store;
+  FakeEvalRedisClient client(&store);
+  uint64_t total = 0;
+  bool has_unknown = false;
+  client.set_reply("*3\r\n:1\r\n:4294967296\r\n:1\r\n");
+  EXPECT_TRUE(client.HIncrAndSum("count", "a", kExpireSeconds, {}, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 4294967296);
+  EXPECT_TRUE(has_unknown);
+
+  std::vector<std::pair<std::string, CacheStatusCode>> replies = {
+    {"-ERR user_script: attempt to perform arithmetic on a nil value\r\n", kCacheNetErr},
+    {"$-1\r\n", kCacheInnerErr},
+    {"*2\r\n:1\r\n:1\r\n", kCacheInnerErr},
+    {"*3\r\n:1\r\n$1\r\n1\r\n:0\r\n", kCacheInnerErr},
+  };
+  for (auto &reply : replies) {
+    client.set_reply(reply.first);
+    EXPECT_EQ(client.HIncrAndSum("count", "a", kExpireSeconds, {}, &total, &has_unknown), reply.second)
+      << reply.first;
+  }
+}
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "distributed_cache/memory/memory_cache.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+class TestMemoryCache : public testing::Test {
+ public:
+  void SetUp() override { client_ = std::make_shared<MemoryClient>(std::make_shared<MemoryCacheStore>()); }
+
+ protected:
+  std::shared_ptr<MemoryClient> client_ = nullptr;
+};
+
+/// Feature: Memory distributed cache.
+/// Description: Set the expire time of the keys of each type, and access them after they expire.
+/// Expectation: The expired keys are not visible, and SETNX succeeds again after the key expires.
+TEST_F(TestMemoryCache, Expire) {
+  std::string value;
+  EXPECT_TRUE(client_->SetEx("str", "a", 100).IsSuccess());
+  EXPECT_TRUE(client_->Get("str", &value).IsSuccess());
+  EXPECT_EQ(value, "a");
+  EXPECT_TRUE(client_->Expire("str", 0).IsSuccess());
+  EXPECT_TRUE(client_->Get("str", &value).IsNil());
+  EXPECT_TRUE(client_->SetExNx("str", "b", 0).IsSuccess());
+  EXPECT_TRUE(client_->SetNx("str", "c").IsSuccess());
+  EXPECT_EQ(client_->SetNx("str", "d"), kCacheExist);
+  EXPECT_TRUE(client_->Get("str", &value).IsSuccess());
+  EXPECT_EQ(value, "c");
+
+  bool exists = false;
+  EXPECT_TRUE(client_->HSet("hash", "f", "1").IsSuccess());
+  EXPECT_TRUE(client_->SAdd("set", "m").IsSuccess());
+  EXPECT_TRUE(client_->LPush("list", "x").IsSuccess());
+  for (const auto &key : {"hash", "set", "list"}) {
+    EXPECT_TRUE(client_->Expire(key, 0).IsSuccess());
+  }
+  EXPECT_TRUE(client_->HExists("hash", "f", &exists).IsSuccess());
+  EXPECT_FALSE(exists);
+  EXPECT_TRUE(client_->SIsMember("set", "m", &exists).IsSuccess());
+  EXPECT_FALSE(exists);
+  std::vector<std::string> items;
+  EXPECT_TRUE(client_->LRange("list", 0, 10, &items).IsSuccess());
+  EXPECT_TRUE(items.empty());
+}
+
+/// Feature: Memory distributed cache.
+/// Description: Set a string over a list with an expire time, and wait until the expire time of the list passes.
+/// Expectation: SET overwrites the key whatever its type is, and replaces its expire time.
+TEST_F(TestMemoryCache, SetClearsExpire) {
+  EXPECT_TRUE(client_->LPush("key", "x").IsSuccess());
+  EXPECT_TRUE(client_->Expire("key", 1).IsSuccess());
+  EXPECT_TRUE(client_->SetEx("key", "v", 100).IsSuccess());
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  std::string value;
+  EXPECT_TRUE(client_->Get("key", &value).IsSuccess());
+  EXPECT_EQ(value, "v");
+  std::vector<std::string> items;
+  EXPECT_EQ(client_->LRange("key", 0, 1, &items), kCacheTypeErr);
+}
+
+/// Feature: Memory distributed cache.
+/// Description: Increase the fields of a hash with HIncrAndSum, including unknown and non-integer fields.
+/// Expectation: The total and the unknown flag are the same as the redis script, the expire time is set by the first
+/// increment of a field, and a non-integer field fails with the type error.
+TEST_F(TestMemoryCache, HIncrAndSum) {
+  uint64_t total = 0;
+  bool has_unknown = true;
+  const std::vector<std::string> known = {"a", "b"};
+  EXPECT_TRUE(client_->HIncrAndSum("count", "a", 100, known, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 1);
+  EXPECT_FALSE(has_unknown);
+  EXPECT_TRUE(client_->HIncrAndSum("count", "a", 100, known, &total, &has_unknown).IsSuccess());
+  EXPECT_TRUE(client_->HIncrAndSum("count", "b", 100, known, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 3);
+  EXPECT_FALSE(has_unknown);
+  EXPECT_TRUE(client_->HIncrAndSum("count", "c", 100, known, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 4);
+  EXPECT_TRUE(has_unknown);
+  std::string value;
+  EXPECT_TRUE(client_->HGet("count", "a", &value).IsSuccess());
+  EXPECT_EQ(value, "2");
+
+  // The first increment of a new field sets the expire time of the hash.
+  EXPECT_TRUE(client_->HIncrAndSum("count", "d", 0, known, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 5);
+  EXPECT_TRUE(client_->HIncrAndSum("count", "a", 100, known, &total, &has_unknown).IsSuccess());
+  EXPECT_EQ(total, 1);
+  EXPECT_FALSE(has_unknown);
+
+  EXPECT_TRUE(client_->HSet("count", "e", "abc").IsSuccess());
+  EXPECT_EQ(client_->HIncrAndSum("count", "a", 100, known, &total, &has_unknown), kCacheTypeErr);
+  EXPECT_TRUE(client_->SetEx("str", "v", 100).IsSuccess());
+  EXPECT_EQ(client_->HIncrAndSum("str", "a", 100, known, &total, &has_unknown), kCacheTypeErr);
+}
+
+/// Feature: Memory distributed cache.
+/// Description: Get and trim the ranges of a list with the indexes in, across and out of the list.
+/// Expectation: The end is inclusive as LRANGE and LTRIM, an end out of the list stops at the last item, and a range
+/// out of the list gets nothing or removes the list.
+TEST_F(TestMemoryCache, ListRange) {
+  for (const auto &item : {"0", "1", "2", "3", "4"}) {
+    EXPECT_TRUE(client_->LPush("list", item).IsSuccess());
+  }
+  constexpr size_t kMaxIndex = std::numeric_limits<size_t>::max();
+  std::vector<std::string> items;
+  EXPECT_TRUE(client_->LRange("list", 0, 1, &items).IsSuccess());
+  EXPECT_EQ(items, std::vector<std::string>({"4", "3"}));
+  EXPECT_TRUE(client_->LRange("list", 3, 100, &items).IsSuccess());
+  EXPECT_EQ(items, std::vector<std::string>({"1", "0"}));
+  EXPECT_TRUE(client_->LRange("list", 0, kMaxIndex, &items).IsSuccess());
+  EXPECT_EQ(items.size(), 5);
+  EXPECT_TRUE(client_->LRange("list", 4, 4, &items).IsSuccess());
+  EXPECT_EQ(items, std::vector<std::string>({"0"}));
+  EXPECT_TRUE(client_->LRange("list", 5, 10, &items).IsSuccess());
+  EXPECT_TRUE(items.empty());
+  EXPECT_TRUE(client_->LRange("list", 3, 2, &items).IsSuccess());
+  EXPECT_TRUE(items.empty());
+  EXPECT_TRUE(client_->LRange("missing", 0, 10, &items).IsSuccess());
+  EXPECT_TRUE(items.empty());
+
+  EXPECT_TRUE(client_->LTrim("list", 1, kMaxIndex).IsSuccess());
+  EXPECT_TRUE(client_->LRange("list", 0, kMaxIndex, &items).IsSuccess());
+  EXPECT_EQ(items, std::vector<std::string>({"3", "2", "1", "0"}));
+  EXPECT_TRUE(client_->LTrim("list", 1, 2).IsSuccess());
+  EXPECT_TRUE(client_->LRange("list", 0, kMaxIndex, &items).IsSuccess());
+  EXPECT_EQ(items, std::vector<std::string>({"2", "1"}));
+  EXPECT_TRUE(client_->LTrim("list", 2, 10).IsSuccess());
+  EXPECT_TRUE(client_->LRange("list", 0, kMaxIndex, &items).IsSuccess());
+  EXPECT_TRUE(items.empty());
+  // The list is removed, so the key can be set as another type.
+  EXPECT_TRUE(client_->SetNx("list", "v").IsSuccess());
+}
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,241 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <event2/event.h>
+#include <event2/http.h>
+#include <event2/buffer.h>
+#include <event2/keyvalq_struct.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common/communicator/http_client.h"
+
+namespace mindspore {
+namespace fl {
+namespace {
+constexpr size_t kMaxConnectionNum = 2;
+constexpr size_t kRequestNum = 16;
+constexpr int64_t kReplyDelayInMs = 20;
+constexpr int64_t kWaitResponseInSec = 30;
+constexpr auto kUriPath = "/loopback";
+
+// A http server in its own event loop, which replies the body of each request back after a delay.
+class LoopbackServer {
+ public:
+  enum Mode { kEcho, kEchoAndClose, kHold };
+
+  explicit LoopbackServer(Mode mode) : mode_(mode) {}
+  ~LoopbackServer() { Stop(); }
+
+  bool Start() {
+    base_ = event_base_new();
+    http_ = base_ == nullptr ? nullptr : evhttp_new(base_);
+    if (http_ == nullptr) {
+      return false;
+    }
+    evhttp_set_gencb(http_, OnRequest, this);
+    auto handle = evhttp_bind_socket_with_handle(http_, "127.0.0.1", 0);
+    if (handle == nullptr) {
+      return false;
+    }
+    sockaddr_in addr = {};
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(evhttp_bound_socket_get_fd(handle), reinterpret_cast<sockaddr *>(&addr), &addr_len) != 0) {
+      return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this]() { (void)event_base_loop(base_, EVLOOP_NO_EXIT_ON_EMPTY); });
+    return true;
+  }
+
+  void Stop() {
+    if (thread_.joinable()) {
+      (void)event_base_loopbreak(base_);
+      thread_.join();
+    }
+    if (http_ != nullptr) {
+      evhttp_free(http_);
+      http_ = nullptr;
+    }
+    if (base_ != nullptr) {
+      event_base_free(base_);
+      base_ = nullptr;
+    }
+  }
+
+  std::string address() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+  size_t max_in_flight() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return max_in_flight_;
+  }
+
+  size_t received_num() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return received_num_;
+  }
+
+ private:
+  static void OnRequest(evhttp_request *req, void *arg) {
+    auto server = reinterpret_cast<LoopbackServer *>(arg);
+    {
+      std::lock_guard<std::mutex> lock(server->mtx_);
+      server->received_num_++;
+      server->in_flight_++;
+      server->max_in_flight_ = std::max(server->max_in_flight_, server->in_flight_);
+    }
+    if (server->mode_ == kHold) {
+      return;
+    }
+    timeval delay = {0, kReplyDelayInMs * 1000};
+    (void)event_base_once(server->base_, -1, EV_TIMEOUT, Reply, new std::pair<LoopbackServer *, evhttp_request *>(
+                                                                   server, req), &delay);
+  }
+
+  static void Reply(evutil_socket_t, int16_t, void *arg) {
+    std::unique_ptr<std::pair<LoopbackServer *, evhttp_request *>> item(
+      reinterpret_cast<std::pair<LoopbackServer *, evhttp_request *> *>(arg));
+    auto server = item->first;
+    auto req = item->second;
+    {
+      std::lock_guard<std::mutex> lock(server->mtx_);
+      server->in_flight_--;
+    }
+    auto message_id = evhttp_find_header(evhttp_request_get_input_headers(req), "Message-Id");
+    if (message_id != nullptr) {
+      (void)evhttp_add_header(evhttp_request_get_output_headers(req), "Message-Id", message_id);
+    }
+    if (server->mode_ == kEchoAndClose) {
+      (void)evhttp_add_header(evhttp_request_get_output_headers(req), "Connection", "close");
+    }
+    evhttp_send_reply(req, HTTP_OK, "OK", evhttp_request_get_input_buffer(req));
+  }
+
+  Mode mode_;
+  event_base *base_ = nullptr;
+  evhttp *http_ = nullptr;
+  uint16_t port_ = 0;
+  std::thread thread_;
+  std::mutex mtx_;
+  size_t in_flight_ = 0;
+  size_t max_in_flight_ = 0;
+  size_t received_num_ = 0;
+};
+}  // namespace
+
+class TestHttpClientAsync : public testing::Test {
+ public:
+  static std::unique_ptr<HttpClient> CreateClient(const LoopbackServer &server) {
+    auto client = std::make_unique<HttpClient>(server.address());
+    client->Init();
+    client->set_max_connection_num(kMaxConnectionNum);
+    return client;
+  }
+
+  static std::future<std::shared_ptr<std::vector<uint8_t>>> Send(HttpClient *client, const std::string &payload) {
+    return client->SendMessageAsync(payload.data(), payload.size(), kUriPath, "loopback", "test", "0",
+                                    HTTP_CONTENT_TYPE_URL_ENCODED);
+  }
+
+  static std::string Payload(size_t i) { return "message " + std::to_string(i) + std::string(i * 1000, 'x'); }
+};
+
+/// Feature: Asynchronous requests of the http client.
+/// Description: Send more concurrent requests than the connections from several threads, with payloads released right
+/// after sending.
+/// Expectation: Every response is the echo of its request, and at most max_connection_num requests are in flight.
+TEST_F(TestHttpClientAsync, MoreRequestsThanConnections) {
+  LoopbackServer server(LoopbackServer::kEcho);
+  ASSERT_TRUE(server.Start());
+  auto client = CreateClient(server);
+  std::vector<std::future<std::shared_ptr<std::vector<uint8_t>>>> futures(kRequestNum);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kRequestNum; t += kRequestNum / 4) {
+    threads.emplace_back([&client, &futures, t]() {
+      for (size_t i = t; i < t + kRequestNum / 4; i++) {
+        futures[i] = Send(client.get(), Payload(i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < kRequestNum; i++) {
+    ASSERT_EQ(futures[i].wait_for(std::chrono::seconds(kWaitResponseInSec)), std::future_status::ready) << i;
+    auto response = futures[i].get();
+    ASSERT_NE(response, nullptr) << i;
+    auto payload = Payload(i);
+    EXPECT_EQ(std::string(response->begin(), response->end()), payload) << i;
+  }
+  EXPECT_LE(server.max_in_flight(), kMaxConnectionNum);
+  EXPECT_EQ(server.received_num(), kRequestNum);
+}
+
+/// Feature: Asynchronous requests of the http client.
+/// Description: The server closes the connection after each response.
+/// Expectation: The client connects again for the next requests, and all of them succeed.
+TEST_F(TestHttpClientAsync, ReconnectAfterServerClose) {
+  LoopbackServer server(LoopbackServer::kEchoAndClose);
+  ASSERT_TRUE(server.Start());
+  auto client = CreateClient(server);
+  for (size_t round = 0; round < 3; round++) {
+    std::vector<std::future<std::shared_ptr<std::vector<uint8_t>>>> futures;
+    for (size_t i = 0; i < kMaxConnectionNum * 2; i++) {
+      futures.push_back(Send(client.get(), Payload(i)));
+    }
+    for (size_t i = 0; i < futures.size(); i++) {
+      ASSERT_EQ(futures[i].wait_for(std::chrono::seconds(kWaitResponseInSec)), std::future_status::ready) << i;
+      auto response = futures[i].get();
+      ASSERT_NE(response, nullptr) << "round " << round << ", request " << i;
+      EXPECT_EQ(std::string(response->begin(), response->end()), Payload(i));
+    }
+  }
+}
+
+/// Feature: Asynchronous requests of the http client.
+/// Description: Stop the client while its requests are in flight or waiting for a connection, and the server never
+/// replies.
+/// Expectation: All the requests fail with a null response instead of hanging.
+TEST_F(TestHttpClientAsync, StopFailsPendingRequests) {
+  LoopbackServer server(LoopbackServer::kHold);
+  ASSERT_TRUE(server.Start());
+  auto client = CreateClient(server);
+  std::vector<std::future<std::shared_ptr<std::vector<uint8_t>>>> futures;
+  for (size_t i = 0; i < kMaxConnectionNum * 3; i++) {
+    futures.push_back(Send(client.get(), Payload(i)));
+  }
+  // wait until the connections are busy, the other requests are pending
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kWaitResponseInSec);
+  while (server.received_num() < kMaxConnectionNum && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(server.received_num(), kMaxConnectionNum);
+  // the destructor stops the asynchronous event loop
+  client.reset();
+  for (auto &future : futures) {
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(future.get(), nullptr);
+  }
+}
+}  // namespace fl
+}  // namespace mindspore
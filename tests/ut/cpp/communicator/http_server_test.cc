@@ -0,0 +1,164 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include "gtest/gtest.h"
+#include "common/communicator/http_server.h"
+#include "common/fl_context.h"
+
+namespace mindspore {
+namespace fl {
+namespace {
+constexpr auto kServerIp = "127.0.0.1";
+constexpr auto kUrl = "/reusePort";
+constexpr auto kReply = "ok";
+constexpr size_t kThreadNum = 4;
+// With new connections hashed to the sockets, the chance that a socket accepts none of them is about 4 * 0.75^64.
+constexpr size_t kConnectionNum = 64;
+// The max connections to wait for the duplicate server to accept one, which takes a fifth of the connections.
+constexpr size_t kMaxDuplicateConnectionNum = 256;
+
+// Connect to the port, send a request and read the response till the server closes the connection.
+std::string Request(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return "";
+  }
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = inet_addr(kServerIp);
+  addr.sin_port = htons(port);
+  std::string response;
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+    std::string request =
+      std::string("GET ") + kUrl + " HTTP/1.1\r\nHost: " + kServerIp + "\r\nConnection: close\r\n\r\n";
+    if (::send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+      char buffer[1024];
+      ssize_t len = 0;
+      while ((len = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(len));
+      }
+    }
+  }
+  (void)close(fd);
+  return response;
+}
+
+// Get a port not in use by binding to port 0.
+uint16_t GetFreePort() {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return 0;
+  }
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = inet_addr(kServerIp);
+  addr.sin_port = 0;
+  socklen_t addr_len = sizeof(addr);
+  uint16_t port = 0;
+  if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0 &&
+      getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) == 0) {
+    port = ntohs(addr.sin_port);
+  }
+  (void)close(fd);
+  return port;
+}
+}  // namespace
+
+class TestHttpServer : public testing::Test {
+ public:
+  void SetUp() override {
+    FLContext::instance()->set_http_server_reuse_port(true);
+    handler_ = [this](const std::shared_ptr<HttpMessageHandler> &message) {
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        thread_ids_.insert(std::this_thread::get_id());
+      }
+      message->QuickResponse(HTTP_OK, kReply, strlen(kReply));
+    };
+  }
+
+  void TearDown() override { FLContext::instance()->set_http_server_reuse_port(false); }
+
+  size_t thread_num() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return thread_ids_.size();
+  }
+
+ protected:
+  OnRequestReceive handler_;
+  std::mutex mtx_;
+  std::set<std::thread::id> thread_ids_;
+};
+
+/// Feature: Http server in the reuse port mode.
+/// Description: Start the http server whose threads listen on their own SO_REUSEPORT sockets, and connect to it many
+/// times.
+/// Expectation: All the sockets bind the port, every request is responded, and each thread accepts some connections.
+TEST_F(TestHttpServer, ReusePortSocketsAccept) {
+  auto port = GetFreePort();
+  ASSERT_NE(port, 0);
+  HttpServer server(kServerIp, port, kThreadNum);
+  ASSERT_TRUE(server.RegisterRoute(kUrl, &handler_));
+  ASSERT_TRUE(server.Start());
+  for (size_t i = 0; i < kConnectionNum; i++) {
+    auto response = Request(port);
+    ASSERT_EQ(response.find("HTTP/1.1 200"), 0) << response;
+    EXPECT_EQ(response.substr(response.size() - strlen(kReply)), kReply);
+  }
+  server.Stop();
+  EXPECT_EQ(thread_num(), kThreadNum);
+}
+
+/// Feature: Http server in the reuse port mode.
+/// Description: Start a second http server on the port of a running one, with and without the reuse port mode.
+/// Expectation: The server without the reuse port mode fails to bind, while the one in the reuse port mode binds the
+/// port silently and takes a part of the connections, which is why the reuse port mode is warned.
+TEST_F(TestHttpServer, ReusePortSharedWithDuplicateServer) {
+  auto port = GetFreePort();
+  ASSERT_NE(port, 0);
+  HttpServer server(kServerIp, port, kThreadNum);
+  ASSERT_TRUE(server.RegisterRoute(kUrl, &handler_));
+  ASSERT_TRUE(server.Start());
+
+  FLContext::instance()->set_http_server_reuse_port(false);
+  HttpServer exclusive_server(kServerIp, port, 1);
+  ASSERT_TRUE(exclusive_server.RegisterRoute(kUrl, &handler_));
+  EXPECT_FALSE(exclusive_server.Start());
+
+  FLContext::instance()->set_http_server_reuse_port(true);
+  HttpServer duplicate_server(kServerIp, port, 1);
+  ASSERT_TRUE(duplicate_server.RegisterRoute(kUrl, &handler_));
+  ASSERT_TRUE(duplicate_server.Start());
+  for (size_t i = 0; i < kMaxDuplicateConnectionNum && thread_num() < kThreadNum + 1; i++) {
+    auto response = Request(port);
+    ASSERT_EQ(response.find("HTTP/1.1 200"), 0) << response;
+  }
+  EXPECT_EQ(thread_num(), kThreadNum + 1);
+  duplicate_server.Stop();
+  server.Stop();
+}
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include "gtest/gtest.h"
+#include "common/communicator/task_executor.h"
+
+namespace mindspore {
+namespace fl {
+namespace {
+constexpr size_t kLongSubmitTimeoutInMs = 10000;
+constexpr size_t kShortSubmitTimeoutInMs = 100;
+constexpr int64_t kBlockCheckInMs = 200;
+}  // namespace
+
+class TestTaskExecutor : public testing::Test {
+ public:
+  // Occupy the only thread of the executor with a task waiting for the gate, and fill its queue of one task.
+  static void FillExecutor(TaskExecutor *executor, const std::shared_future<void> &gate, std::atomic<size_t> *run_num) {
+    std::promise<void> started;
+    auto started_future = started.get_future();
+    EXPECT_TRUE(executor->Submit([&started, gate, run_num]() {
+      started.set_value();
+      gate.wait();
+      (*run_num)++;
+    }));
+    started_future.wait();
+    EXPECT_TRUE(executor->Submit([run_num]() { (*run_num)++; }));
+  }
+};
+
+/// Feature: Blocking submission of TaskExecutor.
+/// Description: Submit a task when the task queue is full, then let the worker take a task out of the queue.
+/// Expectation: Submit blocks until the queue has room, then returns true and the task runs.
+TEST_F(TestTaskExecutor, SubmitBlocksUntilNotFull) {
+  TaskExecutor executor(1, 1, kLongSubmitTimeoutInMs);
+  std::promise<void> gate;
+  std::shared_future<void> gate_future = gate.get_future().share();
+  std::atomic<size_t> run_num(0);
+  FillExecutor(&executor, gate_future, &run_num);
+
+  auto submit_future =
+    std::async(std::launch::async, [&executor, &run_num]() { return executor.Submit([&run_num]() { run_num++; }); });
+  EXPECT_EQ(submit_future.wait_for(std::chrono::milliseconds(kBlockCheckInMs)), std::future_status::timeout);
+  gate.set_value();
+  EXPECT_TRUE(submit_future.get());
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kLongSubmitTimeoutInMs);
+  while (run_num.load() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(run_num.load(), 3);
+  executor.Stop();
+}
+
+/// Feature: Blocking submission of TaskExecutor.
+/// Description: Submit a task when the task queue stays full longer than the submit timeout.
+/// Expectation: Submit returns false after the timeout.
+TEST_F(TestTaskExecutor, SubmitTimeout) {
+  TaskExecutor executor(1, 1, kShortSubmitTimeoutInMs);
+  std::promise<void> gate;
+  std::shared_future<void> gate_future = gate.get_future().share();
+  std::atomic<size_t> run_num(0);
+  FillExecutor(&executor, gate_future, &run_num);
+
+  auto begin = std::chrono::steady_clock::now();
+  EXPECT_FALSE(executor.Submit([&run_num]() { run_num++; }));
+  EXPECT_GE(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(kShortSubmitTimeoutInMs));
+  gate.set_value();
+  executor.Stop();
+}
+
+/// Feature: Blocking submission of TaskExecutor.
+/// Description: Stop the executor while a submission is blocked on the full queue.
+/// Expectation: The blocked Submit wakes up and returns false.
+TEST_F(TestTaskExecutor, StopWakesBlockedSubmit) {
+  TaskExecutor executor(1, 1, kLongSubmitTimeoutInMs);
+  std::promise<void> gate;
+  std::shared_future<void> gate_future = gate.get_future().share();
+  std::atomic<size_t> run_num(0);
+  FillExecutor(&executor, gate_future, &run_num);
+
+  auto submit_future =
+    std::async(std::launch::async, [&executor, &run_num]() { return executor.Submit([&run_num]() { run_num++; }); });
+  EXPECT_EQ(submit_future.wait_for(std::chrono::milliseconds(kBlockCheckInMs)), std::future_status::timeout);
+  // Stop joins the worker, so the gate is opened by another thread once the submission has returned.
+  auto stop_future = std::async(std::launch::async, [&executor]() { executor.Stop(); });
+  EXPECT_EQ(submit_future.wait_for(std::chrono::milliseconds(kLongSubmitTimeoutInMs)), std::future_status::ready);
+  EXPECT_FALSE(submit_future.get());
+  gate.set_value();
+  stop_future.wait();
+}
+}  // namespace fl
+}  // namespace mindspore
@@ -14,10 +14,19 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <limits>
+#include <string>
+#include <vector>
 #include "gtest/gtest.h"
+#include "armour/secure_protocol/psi.h"
 #include "vertical/vfl_context.h"
 #include "vertical/vertical_server.h"
+#include "vertical/communicator/message_queue.h"
+#include "vertical/utils/tensor_utils.h"
 
 namespace mindspore {
 namespace fl {
@@ -64,7 +73,7 @@ class TestVerticalCommunicator : public testing::Test {
     aliceCheck.set_wrong_id(wrong_id);
     EXPECT_TRUE(verticalServer.Send(target_server_name, aliceCheck));
     psi::AliceCheck aliceCheckResp;
-    verticalServer.Receive(target_server_name, &aliceCheckResp);
+    verticalServer.Receive(target_server_name, 10, &aliceCheckResp);
 
     EXPECT_TRUE(aliceCheck.bin_id() == aliceCheckResp.bin_id());
     EXPECT_TRUE(aliceCheck.wrong_num() == aliceCheckResp.wrong_num());
@@ -75,16 +84,15 @@ class TestVerticalCommunicator : public testing::Test {
     auto &verticalServer = VerticalServer::GetInstance();
     psi::AlicePbaAndBF alicePbaAndBF;
     alicePbaAndBF.set_bin_id(10);
-    std::vector<std::string> p_b_a_vct = {"123"};
-    alicePbaAndBF.set_p_b_a_vct(p_b_a_vct);
+    alicePbaAndBF.set_p_b_a_buf(psi::PointBuffer("123", 3));
     alicePbaAndBF.set_bf_alice("20");
 
     EXPECT_TRUE(verticalServer.Send(target_server_name, alicePbaAndBF));
     psi::AlicePbaAndBF alicePbaAndBFResp;
-    verticalServer.Receive(target_server_name, &alicePbaAndBFResp);
+    verticalServer.Receive(target_server_name, 10, &alicePbaAndBFResp);
 
     EXPECT_TRUE(alicePbaAndBF.bin_id() == alicePbaAndBFResp.bin_id());
-    EXPECT_TRUE(alicePbaAndBF.p_b_a_vct()[0] == alicePbaAndBFResp.p_b_a_vct()[0]);
+    EXPECT_TRUE(alicePbaAndBF.p_b_a_buf().bytes() == alicePbaAndBFResp.p_b_a_buf().bytes());
     EXPECT_TRUE(alicePbaAndBF.bf_alice() == alicePbaAndBFResp.bf_alice());
   }
 
@@ -97,25 +105,210 @@ class TestVerticalCommunicator : public testing::Test {
 
     EXPECT_TRUE(verticalServer.Send(target_server_name, bobAlignResult));
     psi::BobAlignResult bobAlignResultResp;
-    verticalServer.Receive(target_server_name, &bobAlignResultResp);
+    verticalServer.Receive(target_server_name, 10, &bobAlignResultResp);
 
     EXPECT_TRUE(bobAlignResult.bin_id() == bobAlignResultResp.bin_id());
     EXPECT_TRUE(bobAlignResult.align_result()[0] == bobAlignResultResp.align_result()[0]);
   }
+
+  static void TestBinRoutingMsg(const std::string &target_server_name) {
+    auto &verticalServer = VerticalServer::GetInstance();
+    for (size_t bin_id : {11, 12}) {
+      psi::PlainData plainData(bin_id, {std::to_string(bin_id)}, "bin");
+      EXPECT_TRUE(verticalServer.Send(target_server_name, plainData));
+    }
+    psi::PlainData plainDataResp;
+    verticalServer.Receive(target_server_name, 12, &plainDataResp);
+    EXPECT_TRUE(plainDataResp.bin_id() == 12);
+    EXPECT_TRUE(plainDataResp.plain_data_vct()[0] == "12");
+    verticalServer.Receive(target_server_name, 11, &plainDataResp);
+    EXPECT_TRUE(plainDataResp.bin_id() == 11);
+    EXPECT_TRUE(plainDataResp.plain_data_vct()[0] == "11");
+  }
+
+  static void TestBinNotStartedMsg(const std::string &target_server_name) {
+    auto &verticalServer = VerticalServer::GetInstance();
+    // The message of a bin not started is responded busy and sent again until the bin is started.
+    auto send_future = std::async(std::launch::async, [&verticalServer, &target_server_name]() {
+      psi::PlainData plainData(13, {"13"}, "bin");
+      return verticalServer.Send(target_server_name, plainData);
+    });
+    EXPECT_EQ(send_future.wait_for(std::chrono::milliseconds(500)), std::future_status::timeout);
+    verticalServer.StartPsiBins({13});
+    EXPECT_TRUE(send_future.get());
+    psi::PlainData plainDataResp;
+    verticalServer.Receive(target_server_name, 13, &plainDataResp);
+    EXPECT_TRUE(plainDataResp.plain_data_vct()[0] == "13");
+    // The queues of a finished bin are erased, and it cannot receive any more.
+    verticalServer.FinishPsiBin(13);
+    EXPECT_ANY_THROW(verticalServer.Receive(target_server_name, 13, &plainDataResp));
+  }
+
+  static std::vector<std::string> GenIds(size_t begin, size_t end) {
+    std::vector<std::string> ids;
+    for (size_t i = begin; i < end; i++) {
+      ids.emplace_back("id_" + std::to_string(i));
+    }
+    return ids;
+  }
+
+  // Run the streaming psi of alice and bob over the loopback server, and expect both of them get expect_result.
+  static void RunStreamingPsiPair(const std::string &target_server_name, size_t bin_id,
+                                  const std::vector<std::string> &alice_input, size_t alice_bucket_num,
+                                  const std::vector<std::string> &bob_input, size_t bob_bucket_num,
+                                  std::vector<std::string> expect_result) {
+    auto create_ctx = [bin_id](const std::vector<std::string> &input, size_t bucket_num, const std::string &role,
+                               const std::string &peer_role, size_t peer_num) {
+      psi::PsiCtx psi_ctx;
+      psi_ctx.bin_id = bin_id;
+      psi_ctx.thread_num = 2;
+      psi_ctx.ecc = std::make_shared<psi::ECC>(psi_ctx.curve_name, psi_ctx.thread_num, psi_ctx.chunk_size);
+      psi_ctx.input_vct = &input;
+      psi_ctx.self_num = input.size();
+      psi_ctx.peer_num = peer_num;
+      psi_ctx.role = role;
+      psi_ctx.peer_role = peer_role;
+      psi_ctx.stream_bucket_num = bucket_num;
+      return psi_ctx;
+    };
+    auto alice_ctx = create_ctx(alice_input, alice_bucket_num, "alice", "bob", bob_input.size());
+    auto bob_ctx = create_ctx(bob_input, bob_bucket_num, "bob", "alice", alice_input.size());
+    auto &verticalServer = VerticalServer::GetInstance();
+    verticalServer.StartPsiBins({bin_id});
+    auto alice_future = std::async(std::launch::async, [&target_server_name, &alice_ctx]() {
+      return psi::RunStreamingFilterEcdhPsi(target_server_name, alice_ctx);
+    });
+    auto bob_ret = psi::RunStreamingFilterEcdhPsi(target_server_name, bob_ctx);
+    auto alice_ret = alice_future.get();
+    verticalServer.FinishPsiBin(bin_id);
+    std::sort(expect_result.begin(), expect_result.end());
+    EXPECT_EQ(alice_ret, expect_result);
+    EXPECT_EQ(bob_ret, expect_result);
+  }
+
+  static void TestStreamingPsi(const std::string &target_server_name) {
+    // The buckets are prepared in background while the previous ones are running.
+    RunStreamingPsiPair(target_server_name, 20, GenIds(0, 200), 4, GenIds(150, 300), 4, GenIds(150, 200));
+    // Most of the buckets of bob are empty, and are skipped by both parties.
+    RunStreamingPsiPair(target_server_name, 21, GenIds(0, 100), 8, {"id_5"}, 8, {"id_5"});
+    RunStreamingPsiPair(target_server_name, 22, GenIds(0, 100), 8, {"id_500"}, 8, {});
+    // The bucket numbers of the parties mismatch, and both of them fail without any result.
+    RunStreamingPsiPair(target_server_name, 23, GenIds(0, 100), 4, GenIds(50, 150), 8, {});
+  }
 };
 
 /// Feature: Vertical communicator.
-/// Description: Test Vertical Communicator message success for send and receive.
+/// Description: Test Vertical Communicator message success for send and receive, and run the streaming psi of alice
+/// and bob over it.
 /// Expectation: Get the correct result
 TEST_F(TestVerticalCommunicator, TestVerticalCommMsgSuccess) {
   std::string http_server_address = "127.0.0.1:5123";
   std::string http_server_name = "server1";
   std::map<std::string, std::string> remote_server_address = {{http_server_name, http_server_address}};
   LaunchHttpServer(http_server_address, http_server_name, remote_server_address);
+  VerticalServer::GetInstance().StartPsiBins({10, 11, 12});
   TestDataJoinMsg(http_server_name);
   TestAliceCheckMsg(http_server_name);
   TestAlicePbaAndBFMsg(http_server_name);
   TestBobAlignResultCommMsg(http_server_name);
+  TestBinRoutingMsg(http_server_name);
+  TestBinNotStartedMsg(http_server_name);
+  TestStreamingPsi(http_server_name);
+}
+
+/// Feature: Attachments of the tensors in vertical trainer messages.
+/// Description: Create the proto of a nested tensor list whose tensors have attachments or raw data, append the
+/// attachments after the proto as the trainer communicator sends them, then parse the message.
+/// Expectation: The parsed tensors have the same attributes and payloads as the sent ones.
+TEST_F(TestVerticalCommunicator, TestTensorListAttachmentsRoundTrip) {
+  auto make_tensor = [](const std::string &ref_key, const std::string &payload, const std::string &raw_data) {
+    TensorItemPy tensor;
+    tensor.set_name(ref_key);
+    tensor.set_ref_key(ref_key);
+    tensor.set_dtype("float32");
+    tensor.set_shape({payload.size() / sizeof(float), 1});
+    tensor.set_raw_data(raw_data);
+    if (!payload.empty()) {
+      auto owner = std::make_shared<const std::string>(payload);
+      tensor.set_data(owner, reinterpret_cast<const uint8_t *>(owner->data()), owner->size());
+    }
+    return tensor;
+  };
+  TensorListItemPy sub_list;
+  sub_list.set_name("sub");
+  sub_list.add_tensor(make_tensor("c", std::string(12, 'c'), ""));
+  TensorListItemPy tensor_list;
+  tensor_list.set_name("top");
+  tensor_list.add_tensor(make_tensor("a", std::string(8, 'a'), ""));
+  tensor_list.add_tensor(make_tensor("b", "", "raw"));
+  tensor_list.add_tensor_list_item(sub_list);
+
+  TensorListProto proto;
+  TensorAttachments attachments;
+  CreateTensorListProto(&proto, tensor_list, &attachments);
+  EXPECT_EQ(attachments.tensors.size(), 2);
+  EXPECT_EQ(attachments.size, 20);
+  auto message = std::make_shared<std::string>();
+  for (const auto &tensor : attachments.tensors) {
+    (void)message->append(reinterpret_cast<const char *>(tensor.data()), tensor.data_size());
+  }
+  TensorListProto parsed_proto;
+  ASSERT_TRUE(parsed_proto.ParseFromString(proto.SerializeAsString()));
+  auto parsed = ParseTensorListProto(parsed_proto, message);
+
+  EXPECT_EQ(parsed.name(), "top");
+  auto tensors = parsed.tensors();
+  ASSERT_EQ(tensors.size(), 2);
+  EXPECT_EQ(tensors[0].ref_key(), "a");
+  EXPECT_EQ(tensors[0].shape(), std::vector<size_t>({2, 1}));
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(tensors[0].data()), tensors[0].data_size()), "aaaaaaaa");
+  EXPECT_EQ(tensors[1].ref_key(), "b");
+  EXPECT_EQ(tensors[1].data_size(), 0);
+  EXPECT_EQ(tensors[1].raw_data(), "raw");
+  auto sub_lists = parsed.tensorListItems();
+  ASSERT_EQ(sub_lists.size(), 1);
+  auto sub_tensors = sub_lists[0].tensors();
+  ASSERT_EQ(sub_tensors.size(), 1);
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(sub_tensors[0].data()), sub_tensors[0].data_size()),
+            std::string(12, 'c'));
+
+  // An attachment out of the message is rejected.
+  auto short_message = std::make_shared<std::string>(message->substr(0, 10));
+  EXPECT_ANY_THROW(ParseTensorListProto(parsed_proto, short_message));
+}
+
+/// Feature: Message offset of vertical trainer messages.
+/// Description: Parse valid and malformed Message-Offset headers.
+/// Expectation: Only decimals not larger than the message length are accepted, and nothing throws.
+TEST_F(TestVerticalCommunicator, TestParseMessageOffset) {
+  size_t offset = 0;
+  EXPECT_TRUE(TrainerCommunicator::ParseMessageOffset("0", 100, &offset));
+  EXPECT_EQ(offset, 0);
+  EXPECT_TRUE(TrainerCommunicator::ParseMessageOffset("100", 100, &offset));
+  EXPECT_EQ(offset, 100);
+  for (const std::string &bad : {"101", "-1", "1a", " 1", "0x10", "99999999999999999999999999"}) {
+    EXPECT_FALSE(TrainerCommunicator::ParseMessageOffset(bad, 100, &offset)) << bad;
+  }
+}
+
+/// Feature: Message queue of vertical communicator.
+/// Description: Push messages to a queue bounded by bytes, and pop them.
+/// Expectation: The messages over the credit are rejected, an empty queue accepts a message of any size, and the
+/// credit is released by pop.
+TEST_F(TestVerticalCommunicator, TestMessageQueueCredit) {
+  MessageQueue<std::string> queue(10);
+  EXPECT_EQ(queue.credit(), std::numeric_limits<size_t>::max());
+  EXPECT_TRUE(queue.push("a", 6));
+  EXPECT_EQ(queue.credit(), 4);
+  EXPECT_FALSE(queue.push("b", 5));
+  EXPECT_TRUE(queue.push("c", 4));
+  EXPECT_EQ(queue.credit(), 0);
+  EXPECT_EQ(queue.pop(1), "a");
+  EXPECT_EQ(queue.credit(), 6);
+  EXPECT_EQ(queue.pop(1), "c");
+  EXPECT_TRUE(queue.push("d", 100));
+  EXPECT_EQ(queue.credit(), 0);
+  EXPECT_EQ(queue.pop(1), "d");
 }
 }  // namespace fl
 }  // namespace mindspore
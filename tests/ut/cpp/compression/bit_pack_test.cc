@@ -0,0 +1,69 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "compression/bit_pack.h"
+#include "compression/bit_unpack.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+class TestBitPack : public testing::Test {};
+
+/// Feature: Bit packing of the compressed weights.
+/// Description: Pack and unpack random signed values of every width from 1 to 32 bits, including the widths which do
+/// not divide the 64-bit word such as 13 and 31, with lengths that are not multiples of 8.
+/// Expectation: The unpacked values equal the original values and the packed size is bit_packed_size.
+TEST_F(TestBitPack, PackUnpackRoundTrip) {
+  std::mt19937 rng(2022);
+  for (size_t bit_num = 1; bit_num <= kMaxPackBitNum; ++bit_num) {
+    int64_t min_val = -(int64_t{1} << (bit_num - 1));
+    int64_t max_val = (int64_t{1} << (bit_num - 1)) - 1;
+    std::uniform_int_distribution<int64_t> dist(min_val, max_val);
+    for (size_t size : {1, 3, 7, 8, 9, 63, 64, 65, 127, 1001}) {
+      std::vector<int> values(size);
+      for (auto &value : values) {
+        value = static_cast<int>(dist(rng));
+      }
+      // The extreme values check the sign extension of the top bit.
+      values[0] = static_cast<int>(min_val);
+      values[size - 1] = static_cast<int>(max_val);
+      auto packed = bit_pack(values, bit_num);
+      ASSERT_EQ(packed.size(), bit_packed_size(size, bit_num));
+      std::vector<int> unpacked(size);
+      ASSERT_TRUE(bit_unpack(packed.data(), packed.size(), size, bit_num,
+                             [&unpacked](size_t i, int value) { unpacked[i] = value; }));
+      EXPECT_EQ(unpacked, values) << "bit_num: " << bit_num << ", size: " << size;
+    }
+  }
+}
+
+/// Feature: Bit packing of the compressed weights.
+/// Description: Unpack from a buffer shorter than the packed size, and pack with bit numbers 0 and 33.
+/// Expectation: All the calls fail.
+TEST_F(TestBitPack, RejectInvalidInput) {
+  std::vector<int> values(9, 1);
+  auto packed = bit_pack(values, 3);
+  EXPECT_FALSE(bit_unpack(packed.data(), packed.size() - 1, values.size(), 3, [](size_t, int) {}));
+  EXPECT_TRUE(bit_pack(values, 0).empty());
+  EXPECT_TRUE(bit_pack(values, kMaxPackBitNum + 1).empty());
+}
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
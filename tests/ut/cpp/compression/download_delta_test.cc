@@ -0,0 +1,149 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "compression/decode_executor.h"
+#include "compression/encode_executor.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+namespace {
+constexpr size_t kQuantBitNum = 8;
+}  // namespace
+
+class TestDownloadDelta : public testing::Test {
+ public:
+  static ModelItemPtr CreateModel(const std::map<std::string, std::vector<float>> &weights) {
+    auto model = std::make_shared<ModelItem>();
+    size_t offset = 0;
+    for (const auto &weight : weights) {
+      auto &item = model->weight_items[weight.first];
+      item.name = weight.first;
+      item.offset = offset;
+      item.size = weight.second.size() * sizeof(float);
+      item.shape = {weight.second.size()};
+      item.type = "float32";
+      offset += item.size;
+    }
+    model->model_size = offset;
+    model->weight_data.resize(offset);
+    for (const auto &weight : weights) {
+      (void)memcpy(model->weight_data.data() + model->weight_items[weight.first].offset, weight.second.data(),
+                   weight.second.size() * sizeof(float));
+    }
+    return model;
+  }
+
+  // Encodes the delta between the models and decodes it against the base model as the client does.
+  static std::map<std::string, std::vector<float>> RoundTrip(const ModelItemPtr &base_model, const ModelItemPtr &model,
+                                                             float sparse_rate,
+                                                             std::map<std::string, CompressWeight> *delta_weights) {
+    EXPECT_TRUE(CompressExecutor::GetInstance().sparse_diff_quant(delta_weights, base_model, model, sparse_rate,
+                                                                  kQuantBitNum));
+    std::vector<CompressFeatureMap> compress_feature_maps;
+    for (const auto &delta_weight : *delta_weights) {
+      CompressFeatureMap compress_feature_map;
+      compress_feature_map.weight_fullname = delta_weight.first;
+      compress_feature_map.compress_data = delta_weight.second.compress_data;
+      compress_feature_map.min_val = delta_weight.second.min_val;
+      compress_feature_map.max_val = delta_weight.second.max_val;
+      compress_feature_map.indices = delta_weight.second.indices;
+      compress_feature_maps.push_back(compress_feature_map);
+    }
+    std::map<std::string, std::vector<float>> weight_map;
+    EXPECT_TRUE(
+      DecodeExecutor::GetInstance().DeQuantSparseDelta(&weight_map, base_model, compress_feature_maps, kQuantBitNum));
+    return weight_map;
+  }
+};
+
+/// Feature: Sparse delta download of getModel.
+/// Description: Encode the delta between two models with sparse rates 0.25 and 1, then decode it against the base.
+/// Expectation: The elements with the largest differences are within half a quantization step of the model and the
+/// others keep the value of the base model.
+TEST_F(TestDownloadDelta, EncodeDecodeRoundTrip) {
+  std::mt19937 rng(2022);
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  std::map<std::string, std::vector<float>> base_weights = {{"conv.weight", std::vector<float>(1000)},
+                                                            {"fc.bias", std::vector<float>(10)}};
+  std::map<std::string, std::vector<float>> weights;
+  for (auto &base_weight : base_weights) {
+    auto &weight = weights[base_weight.first];
+    for (auto &value : base_weight.second) {
+      value = dist(rng);
+      weight.push_back(value + dist(rng) * 0.1f);
+    }
+  }
+  auto base_model = CreateModel(base_weights);
+  auto model = CreateModel(weights);
+  for (float sparse_rate : {0.25f, 1.0f}) {
+    std::map<std::string, CompressWeight> delta_weights;
+    auto weight_map = RoundTrip(base_model, model, sparse_rate, &delta_weights);
+    ASSERT_EQ(weight_map.size(), weights.size());
+    for (const auto &weight : weights) {
+      const auto &base_weight = base_weights[weight.first];
+      const auto &decoded = weight_map[weight.first];
+      const auto &delta_weight = delta_weights[weight.first];
+      size_t size = weight.second.size();
+      size_t k = static_cast<size_t>(std::ceil(static_cast<double>(size) * sparse_rate));
+      ASSERT_EQ(decoded.size(), size);
+      ASSERT_EQ(delta_weight.compress_data.size(), k);
+      float step = (delta_weight.max_val - delta_weight.min_val) / 255.0f;
+      std::vector<float> abs_diff(size);
+      for (size_t i = 0; i < size; ++i) {
+        abs_diff[i] = std::fabs(weight.second[i] - base_weight[i]);
+      }
+      std::vector<float> sorted_diff = abs_diff;
+      std::sort(sorted_diff.begin(), sorted_diff.end(), std::greater<float>());
+      for (size_t i = 0; i < size; ++i) {
+        if (decoded[i] == base_weight[i]) {
+          // Not sent, so its difference is not larger than the smallest sent one.
+          EXPECT_LE(abs_diff[i], sorted_diff[k - 1]) << weight.first << " " << i;
+        } else {
+          EXPECT_NEAR(decoded[i], weight.second[i], step / 2 + 1e-5f) << weight.first << " " << i;
+        }
+      }
+    }
+  }
+}
+
+/// Feature: Sparse delta download of getModel.
+/// Description: Encode the delta of a model whose weight is resized or missing in the base model.
+/// Expectation: The encoding fails so that the full model is downloaded instead of keeping stale weights.
+TEST_F(TestDownloadDelta, WeightNotDiffable) {
+  auto model = CreateModel({{"conv.weight", std::vector<float>(16, 1.0f)}, {"fc.bias", std::vector<float>(4, 1.0f)}});
+  auto resized_base =
+    CreateModel({{"conv.weight", std::vector<float>(16, 0.0f)}, {"fc.bias", std::vector<float>(8, 0.0f)}});
+  auto missing_base = CreateModel({{"conv.weight", std::vector<float>(16, 0.0f)}});
+  auto renamed_base =
+    CreateModel({{"conv.weight", std::vector<float>(16, 0.0f)}, {"fc.weight", std::vector<float>(4, 0.0f)}});
+  for (const auto &base_model : {resized_base, missing_base, renamed_base}) {
+    std::map<std::string, CompressWeight> delta_weights;
+    EXPECT_FALSE(
+      CompressExecutor::GetInstance().sparse_diff_quant(&delta_weights, base_model, model, 0.5f, kQuantBitNum));
+  }
+}
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/base_crypto/ecc.h"
+#include "armour/base_crypto/ecc_engine.h"
+#include "armour/base_crypto/hash.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestEccEngine : public testing::Test {
+ public:
+  // Compare the engine with ECPointClass, which multiplies the points one by one with EC_POINT_mul.
+  static void CheckHashToCurveAndMul(const std::string &curve_name, const BigNumClass &key, size_t compress_length) {
+    int nid = ECC::GetNID(curve_name);
+    ECGroupClass group(nid);
+    std::vector<std::string> input_vct;
+    for (size_t i = 0; i < kInputNum; i++) {
+      input_vct.emplace_back("id_" + std::to_string(i));
+    }
+    auto hash_buf = HashInputsToBuffer(&input_vct, 0, 1);
+    std::vector<uint8_t> out(kInputNum * compress_length);
+    EccEngine engine(nid, key);
+    engine.Mul(hash_buf.data(), kInputNum, LENGTH_32, true, compress_length, compress_length, out.data());
+    for (size_t i = 0; i < kInputNum; i++) {
+      auto expect =
+        ECPointClass::GenPointFromString(group, hash_buf.Get(i), true).BNMul(key).CompressToString(compress_length);
+      EXPECT_EQ(std::string(reinterpret_cast<char *>(out.data() + i * compress_length), compress_length), expect);
+    }
+  }
+
+  static constexpr size_t kInputNum = 300;
+};
+
+/// Feature: Multiply points by a fixed scalar in batch.
+/// Description: Test the engine on sm2, brainpool and p256, with odd, even and random keys, and the compressed length
+/// 32 and 33.
+/// Expectation: Get the same results as multiplying the points one by one.
+TEST_F(TestEccEngine, HashToCurveAndMul) {
+  for (const std::string curve_name : {"sm2", "brainpoolP256r1", "p256"}) {
+    ECGroupClass group(ECC::GetNID(curve_name));
+    BigNumClass one;
+    BN_set_word(one.get(), 1);
+    BigNumClass two;
+    BN_set_word(two.get(), 2);
+    BigNumClass max_key;
+    BN_sub(max_key.get(), group.bn_n.get(), one.get());
+    BigNumClass random_key;
+    BN_rand_range(random_key.get(), group.bn_n.get());
+    for (const auto *key : {&one, &two, &max_key, &random_key}) {
+      CheckHashToCurveAndMul(curve_name, *key, LENGTH_32);
+      CheckHashToCurveAndMul(curve_name, *key, LENGTH_33);
+    }
+  }
+}
+
+/// Feature: ECDH with the batch operations of ECC.
+/// Description: Compute p^b, p^b^a and p^b^a^(b^-1) on contiguous buffers.
+/// Expectation: p^b^a^(b^-1) equals p^a, and invalid points result in zeros.
+TEST_F(TestEccEngine, ECDHRoundTrip) {
+  for (const std::string curve_name : {"sm2", "p256"}) {
+    ECC alice(curve_name, 0, 1);
+    ECC bob(curve_name, 0, 1);
+    std::vector<std::string> input_vct;
+    for (size_t i = 0; i < kInputNum; i++) {
+      input_vct.emplace_back("id_" + std::to_string(i));
+    }
+    auto hash_buf = HashInputsToBuffer(&input_vct, 0, 1);
+    auto p_b_buf = bob.HashToCurveAndMul(hash_buf, LENGTH_33, LENGTH_33);
+    auto p_b_a_buf = alice.DcpsAndMul(p_b_buf, LENGTH_33);
+    auto p_b_a_bI_buf = bob.DcpsAndInverseMul(p_b_a_buf, LENGTH_32);
+    EXPECT_EQ(p_b_a_bI_buf.ToStrings(), alice.HashToCurveAndMul(hash_buf, LENGTH_32, LENGTH_32).ToStrings());
+    EXPECT_EQ(p_b_a_buf.ToStrings(), alice.DcpsAndMul(p_b_buf.ToStrings(), LENGTH_33, LENGTH_33));
+
+    PointBuffer invalid_buf(std::string(LENGTH_33 * 2, '\xff'), LENGTH_33);
+    auto invalid_result = alice.DcpsAndMul(invalid_buf, LENGTH_33);
+    EXPECT_EQ(invalid_result.bytes(), std::string(LENGTH_33 * 2, '\0'));
+  }
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
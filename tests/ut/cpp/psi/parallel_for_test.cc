@@ -14,12 +14,22 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 #include "gtest/gtest.h"
 #include "common/parallel_for.h"
+#include "common/thread_pool.h"
 
 namespace mindspore {
 namespace fl {
+namespace {
+constexpr size_t kNestedItemNum = 1000;
+constexpr int64_t kNestedWaitSeconds = 30;
+}  // namespace
+
 class TestParallelFor : public testing::Test {
  public:
   static size_t ParallelSum(size_t begin_num, size_t end_num, size_t thread_num) {
@@ -79,5 +89,60 @@ TEST_F(TestParallelFor, AddItemTest) {
   EXPECT_TRUE(ParallelAddItem(10, 0) == vec2);
 }
 
+/// Feature: Nested parallel_for in the shared thread pool.
+/// Description: Run parallel_for inside more pool tasks than the pool has workers, so every worker blocks in an outer
+/// task while the inner chunks are pending.
+/// Expectation: The callers run the inner chunks themselves, all the tasks finish with correct sums and no deadlock.
+TEST_F(TestParallelFor, NestedInPoolTask) {
+  auto &pool = ThreadPool::Instance();
+  size_t task_num = pool.worker_num() * 2 + 1;
+  std::vector<size_t> sums(task_num, 0);
+  std::atomic<size_t> done_num(0);
+  for (size_t t = 0; t < task_num; t++) {
+    pool.Submit([&sums, &done_num, t]() {
+      std::vector<std::atomic<size_t>> chunk_sums(kNestedItemNum);
+      ParallelSync parallel_sync(0);
+      parallel_sync.parallel_for(0, kNestedItemNum, 0, [&chunk_sums](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; i++) {
+          chunk_sums[i] = i;
+        }
+      });
+      size_t sum = 0;
+      for (auto &item : chunk_sums) sum += item;
+      sums[t] = sum;
+      done_num++;
+    });
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kNestedWaitSeconds);
+  while (done_num.load() < task_num && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(done_num.load(), task_num);
+  for (auto sum : sums) {
+    EXPECT_EQ(sum, kNestedItemNum * (kNestedItemNum - 1) / 2);
+  }
+}
+
+/// Feature: Exceptions in parallel_for.
+/// Description: Throw from one chunk of parallel_for while the other chunks run in the pool.
+/// Expectation: The exception is rethrown to the caller after all the chunks finish, and the pool still works.
+TEST_F(TestParallelFor, ExceptionPropagation) {
+  constexpr size_t kItemNum = 1000;
+  constexpr size_t kThrowItem = 517;
+  std::atomic<size_t> visited_num(0);
+  ParallelSync parallel_sync(0);
+  EXPECT_THROW(parallel_sync.parallel_for(0, kItemNum, 0,
+                                          [&visited_num](size_t beg, size_t end) {
+                                            visited_num += end - beg;
+                                            if (beg <= kThrowItem && kThrowItem < end) {
+                                              throw std::runtime_error("chunk failed");
+                                            }
+                                          }),
+               std::runtime_error);
+  // every chunk has been run before the exception is rethrown
+  EXPECT_EQ(visited_num.load(), kItemNum);
+  EXPECT_EQ(ParallelSum(1, 100, 0), 5050);
+}
+
 }  // namespace fl
 }  // namespace mindspore
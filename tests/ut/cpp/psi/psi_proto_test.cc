@@ -0,0 +1,80 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "vertical/utils/psi_utils.h"
+
+namespace mindspore {
+namespace fl {
+namespace {
+constexpr size_t kRecordLen32 = 32;
+constexpr size_t kRecordLen33 = 33;
+}  // namespace
+
+class TestPsiProto : public testing::Test {
+ public:
+  static datajoin::BobPbProto CreateBobPbProto(size_t num, size_t record_len) {
+    datajoin::BobPbProto proto;
+    proto.set_bin_id(1);
+    proto.set_p_b_buf(std::string(num * record_len, 'p'));
+    proto.set_record_len(record_len);
+    return proto;
+  }
+};
+
+/// Feature: Points in the PSI messages.
+/// Description: Parse the slices of BobPb whose points have the same record length.
+/// Expectation: The points of all the slices are parsed with the record length.
+TEST_F(TestPsiProto, ParseSlices) {
+  std::vector<datajoin::BobPbProto> protos = {CreateBobPbProto(3, kRecordLen33), CreateBobPbProto(2, kRecordLen33)};
+  auto bob_pb = ParseProtoWithSlices(protos);
+  EXPECT_EQ(bob_pb.p_b_buf().record_len(), kRecordLen33);
+  EXPECT_EQ(bob_pb.p_b_buf().size(), 5);
+}
+
+/// Feature: Points in the PSI messages.
+/// Description: Parse BobPb whose slices have different record lengths, or whose points are not a multiple of the
+/// record length.
+/// Expectation: The parsing fails instead of decompressing misaligned points.
+TEST_F(TestPsiProto, ParseMismatchedRecordLen) {
+  std::vector<datajoin::BobPbProto> protos = {CreateBobPbProto(3, kRecordLen32), CreateBobPbProto(2, kRecordLen33)};
+  EXPECT_ANY_THROW(ParseProtoWithSlices(protos));
+
+  auto proto = CreateBobPbProto(3, kRecordLen32);
+  proto.set_p_b_buf(proto.p_b_buf() + "p");
+  EXPECT_ANY_THROW(ParseBobPbProto(proto));
+}
+
+/// Feature: Stream bucket sizes in the PSI messages.
+/// Description: Create the proto of the stream bucket sizes and parse it back, including sizes beyond 32 bits.
+/// Expectation: The bin id, the role and the sizes are kept.
+TEST_F(TestPsiProto, StreamBucketSizesRoundTrip) {
+  std::vector<size_t> sizes = {0, 1, 4096, (static_cast<size_t>(1) << 40) + 7};
+  psi::StreamBucketSizes bucket_sizes(3, "bob", sizes);
+  datajoin::StreamBucketSizesProto proto;
+  CreateStreamBucketSizesProto(&proto, bucket_sizes);
+
+  datajoin::StreamBucketSizesProto proto_recv;
+  ASSERT_TRUE(proto_recv.ParseFromString(proto.SerializeAsString()));
+  auto bucket_sizes_recv = ParseStreamBucketSizesProto(proto_recv);
+  EXPECT_EQ(bucket_sizes_recv.bin_id(), 3);
+  EXPECT_EQ(bucket_sizes_recv.self_role(), "bob");
+  EXPECT_EQ(bucket_sizes_recv.sizes(), sizes);
+}
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/secure_protocol/psi.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestStreamPsi : public testing::Test {
+ public:
+  // The ids of alice and bob overlap in [bob_num - intersect_num, bob_num), and the expected intersection is sorted.
+  void GenData(size_t alice_num, size_t bob_num, size_t intersect_num) {
+    alice_input.clear();
+    bob_input.clear();
+    expect_result.clear();
+    for (size_t i = 0; i < bob_num; i++) {
+      bob_input.emplace_back("id_" + std::to_string(i));
+    }
+    for (size_t i = bob_num - intersect_num; i < bob_num - intersect_num + alice_num; i++) {
+      alice_input.emplace_back("id_" + std::to_string(i));
+      if (i < bob_num) {
+        expect_result.emplace_back(alice_input.back());
+      }
+    }
+    std::mt19937 rng(std::random_device{}());
+    std::shuffle(alice_input.begin(), alice_input.end(), rng);
+    std::shuffle(bob_input.begin(), bob_input.end(), rng);
+    std::sort(expect_result.begin(), expect_result.end());
+  }
+
+  std::vector<std::string> alice_input;
+  std::vector<std::string> bob_input;
+  std::vector<std::string> expect_result;
+};
+
+/// Feature: Streaming mode of ECDH PSI.
+/// Description: Intersect the same inputs with and without the streaming mode, with more buckets than ids as well.
+/// Expectation: Both modes get the same sorted intersection.
+TEST_F(TestStreamPsi, StreamAndNonStreamResultsEqual) {
+  GenData(500, 800, 300);
+  auto result = RunPSIDemo(alice_input, bob_input, 1);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(result, expect_result);
+  for (size_t stream_bucket_num : {2, 16, 1024}) {
+    EXPECT_EQ(RunPSIDemo(alice_input, bob_input, 1, stream_bucket_num), expect_result);
+  }
+}
+
+/// Feature: Streaming mode of ECDH PSI.
+/// Description: Intersect the inputs without any common id in the streaming mode.
+/// Expectation: Get an empty intersection.
+TEST_F(TestStreamPsi, StreamEmptyIntersection) {
+  GenData(100, 100, 0);
+  EXPECT_TRUE(RunPSIDemo(alice_input, bob_input, 1, 8).empty());
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+#include "server/cert_verify.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr int64_t kStartTime = 1000000;
+constexpr time_t kFileTime = 1600000000;
+// the serial number 3 bytes longer than the ones below 128, so that the certificate file is larger
+constexpr int64_t kLongSerial = 1 << 28;
+}  // namespace
+
+class TestCertCache : public testing::Test {
+ public:
+  void SetUp() override {
+    char dir_template[] = "/tmp/cert_cache_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    cert_dir_ = dir_template;
+    auto ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+    ASSERT_NE(ctx, nullptr);
+    EVP_PKEY *key = nullptr;
+    if (EVP_PKEY_keygen_init(ctx) == 1) {
+      (void)EVP_PKEY_keygen(ctx, &key);
+    }
+    EVP_PKEY_CTX_free(ctx);
+    ASSERT_NE(key, nullptr);
+    key_ = std::shared_ptr<EVP_PKEY>(key, EVP_PKEY_free);
+  }
+
+  void TearDown() override {
+    for (const auto &name : {"root_first.pem", "root_second.pem"}) {
+      (void)unlink((cert_dir_ + "/" + name).c_str());
+    }
+    (void)rmdir(cert_dir_.c_str());
+  }
+
+  // Write a self-signed certificate with the serial number, the certificates of the serial numbers below 128 have the
+  // same size. The modify time of the file is set if it's not 0.
+  void WriteCert(const std::string &path, int64_t serial, time_t mtime = 0) {
+    std::shared_ptr<X509> cert(X509_new(), X509_free);
+    ASSERT_NE(cert, nullptr);
+    ASSERT_EQ(ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), serial), 1);
+    ASSERT_NE(X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0), nullptr);
+    ASSERT_NE(X509_gmtime_adj(X509_getm_notAfter(cert.get()), 3600), nullptr);
+    auto name = X509_get_subject_name(cert.get());
+    ASSERT_EQ(X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("root"), -1,
+                                         -1, 0),
+              1);
+    ASSERT_EQ(X509_set_issuer_name(cert.get(), name), 1);
+    ASSERT_EQ(X509_set_pubkey(cert.get(), key_.get()), 1);
+    ASSERT_GT(X509_sign(cert.get(), key_.get(), nullptr), 0);
+    auto bio = BIO_new_file(path.c_str(), "w");
+    ASSERT_NE(bio, nullptr);
+    EXPECT_EQ(PEM_write_bio_X509(bio, cert.get()), 1);
+    BIO_free_all(bio);
+    if (mtime != 0) {
+      struct timespec times[2] = {{mtime, 0}, {mtime, 0}};
+      ASSERT_EQ(utimensat(AT_FDCWD, path.c_str(), times, 0), 0);
+    }
+  }
+
+  static int64_t Serial(const std::shared_ptr<X509> &cert) {
+    return cert == nullptr ? -1 : ASN1_INTEGER_get(X509_get_serialNumber(cert.get()));
+  }
+
+  static std::shared_ptr<X509> GetCert(const std::string &path, int64_t now, CertVerify::CachedPemObject<X509> *cache) {
+    return CertVerify::getCachedPemObject(path, now, CertVerify::readCertFromFile, X509_free, cache);
+  }
+
+ protected:
+  std::string cert_dir_;
+  std::shared_ptr<EVP_PKEY> key_ = nullptr;
+};
+
+/// Feature: Cache of the root CA certificates.
+/// Description: Rewrite the certificate file, and get the certificate before and after the check interval.
+/// Expectation: The file is parsed again only after the check interval, and the certificate got before the rewrite is
+/// still valid.
+TEST_F(TestCertCache, ReloadAfterInterval) {
+  auto path = cert_dir_ + "/root_first.pem";
+  WriteCert(path, 1, kFileTime);
+  CertVerify::CachedPemObject<X509> cache;
+  auto cert = GetCert(path, kStartTime, &cache);
+  EXPECT_EQ(Serial(cert), 1);
+
+  WriteCert(path, 2, kFileTime + 1);
+  EXPECT_EQ(Serial(GetCert(path, kStartTime + certCacheCheckInterval - 1, &cache)), 1);
+  EXPECT_EQ(Serial(GetCert(path, kStartTime + certCacheCheckInterval, &cache)), 2);
+  EXPECT_EQ(Serial(cert), 1);
+}
+
+/// Feature: Cache of the root CA certificates.
+/// Description: Rewrite the certificate file with the same size and modify time, then change the modify time or the
+/// size only.
+/// Expectation: The file is not parsed again if both its size and modify time are not changed.
+TEST_F(TestCertCache, ReloadOnlyIfModified) {
+  auto path = cert_dir_ + "/root_first.pem";
+  WriteCert(path, 1, kFileTime);
+  CertVerify::CachedPemObject<X509> cache;
+  auto now = kStartTime;
+  EXPECT_EQ(Serial(GetCert(path, now, &cache)), 1);
+
+  WriteCert(path, 2, kFileTime);
+  now += certCacheCheckInterval;
+  EXPECT_EQ(Serial(GetCert(path, now, &cache)), 1);
+
+  WriteCert(path, 3, kFileTime + 1);
+  now += certCacheCheckInterval;
+  EXPECT_EQ(Serial(GetCert(path, now, &cache)), 3);
+
+  WriteCert(path, kLongSerial, kFileTime + 1);
+  now += certCacheCheckInterval;
+  EXPECT_EQ(Serial(GetCert(path, now, &cache)), kLongSerial);
+}
+
+/// Feature: Cache of the root CA certificates.
+/// Description: Change the path of the certificate within the check interval, then remove the file or make it invalid.
+/// Expectation: The new path is loaded at once, and the certificate is nullptr after the file is removed or invalid.
+TEST_F(TestCertCache, PathChangedOrRemoved) {
+  auto first_path = cert_dir_ + "/root_first.pem";
+  auto second_path = cert_dir_ + "/root_second.pem";
+  WriteCert(first_path, 1, kFileTime);
+  WriteCert(second_path, 2, kFileTime);
+  CertVerify::CachedPemObject<X509> cache;
+  auto now = kStartTime;
+  EXPECT_EQ(Serial(GetCert(first_path, now, &cache)), 1);
+  EXPECT_EQ(Serial(GetCert(second_path, now + 1, &cache)), 2);
+
+  ASSERT_EQ(unlink(second_path.c_str()), 0);
+  now += certCacheCheckInterval + 1;
+  EXPECT_EQ(GetCert(second_path, now, &cache), nullptr);
+
+  auto file = fopen(second_path.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  (void)fputs("-----BEGIN CERTIFICATE-----\n", file);
+  (void)fclose(file);
+  now += certCacheCheckInterval;
+  EXPECT_EQ(GetCert(second_path, now, &cache), nullptr);
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/executor.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+// Sums up the data of the servers running in threads for each collective name, as CollectiveOpsImpl::AllReduce does.
+class FakeCollective {
+ public:
+  explicit FakeCollective(size_t server_num) : server_num_(server_num) {}
+
+  bool AllReduce(const std::string &name, float *data, size_t elem_num) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto &op = ops_[name];
+    if (op.arrived == 0) {
+      op.sum.assign(elem_num, 0.0f);
+    }
+    if (op.sum.size() != elem_num) {
+      return false;
+    }
+    for (size_t i = 0; i < elem_num; i++) {
+      op.sum[i] += data[i];
+    }
+    op.arrived++;
+    cv_.notify_all();
+    cv_.wait(lock, [this, &op]() { return op.arrived == server_num_; });
+    std::copy(op.sum.begin(), op.sum.end(), data);
+    return true;
+  }
+
+ private:
+  struct Op {
+    std::vector<float> sum;
+    size_t arrived = 0;
+  };
+  size_t server_num_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::map<std::string, Op> ops_;
+};
+
+struct Collective {
+  float *data;
+  size_t elem_num;
+};
+}  // namespace
+
+class TestFusedAllReduce : public testing::Test {};
+
+/// Feature: Fused AllReduce of the weight aggregation.
+/// Description: Reduce weights of mixed sizes over 3 simulated servers with several bucket sizes, including weights
+/// larger than the bucket.
+/// Expectation: The scattered results equal the per-parameter sums, every bucket is at most bucket_size bytes, and the
+/// weights not smaller than the bucket are reduced in place.
+TEST_F(TestFusedAllReduce, BucketedEqualsPerParameter) {
+  constexpr size_t kServerNum = 3;
+  const std::vector<size_t> elem_nums = {3, 5, 100, 0, 2, 7, 7, 16, 40, 1};
+  for (size_t bucket_size : {4, 40, 64, 1 << 20}) {
+    std::mt19937 rng(static_cast<unsigned int>(bucket_size));
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::vector<std::vector<float>>> server_weights(kServerNum);
+    std::vector<std::vector<float>> expected(elem_nums.size());
+    for (size_t i = 0; i < elem_nums.size(); i++) {
+      expected[i].assign(elem_nums[i], 0.0f);
+      for (size_t server = 0; server < kServerNum; server++) {
+        std::vector<float> weight(elem_nums[i]);
+        for (size_t j = 0; j < weight.size(); j++) {
+          weight[j] = dist(rng);
+          expected[i][j] += weight[j];
+        }
+        server_weights[server].push_back(std::move(weight));
+      }
+    }
+
+    FakeCollective collective(kServerNum);
+    std::vector<std::vector<Collective>> server_collectives(kServerNum);
+    std::vector<bool> results(kServerNum, false);
+    std::vector<std::thread> threads;
+    for (size_t server = 0; server < kServerNum; server++) {
+      threads.emplace_back([&, server]() {
+        std::vector<std::pair<float *, size_t>> weights;
+        for (auto &weight : server_weights[server]) {
+          weights.emplace_back(weight.data(), weight.size());
+        }
+        auto all_reduce = [&collective, &server_collectives, server](const std::string &name, float *data,
+                                                                     size_t elem_num) {
+          server_collectives[server].push_back({data, elem_num});
+          return collective.AllReduce(name, data, elem_num);
+        };
+        results[server] = Executor::BucketedAllReduce(weights, bucket_size, all_reduce);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    size_t bucket_elem_num = bucket_size / sizeof(float);
+    for (size_t server = 0; server < kServerNum; server++) {
+      ASSERT_TRUE(results[server]);
+      for (size_t i = 0; i < elem_nums.size(); i++) {
+        for (size_t j = 0; j < elem_nums[i]; j++) {
+          EXPECT_FLOAT_EQ(server_weights[server][i][j], expected[i][j]) << "bucket size " << bucket_size;
+        }
+      }
+      for (const auto &op : server_collectives[server]) {
+        if (op.elem_num > bucket_elem_num) {
+          bool in_place = false;
+          for (const auto &weight : server_weights[server]) {
+            in_place = in_place || (op.data == weight.data() && op.elem_num == weight.size());
+          }
+          EXPECT_TRUE(in_place) << "A bucket of " << op.elem_num << " elements exceeds bucket size " << bucket_size;
+        }
+      }
+    }
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,159 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "gtest/gtest.h"
+#include "server/long_poll_service.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr uint64_t kLongTimeoutInMs = 10000;
+constexpr uint64_t kShortTimeoutInMs = 100;
+
+class FakeMessage : public MessageHandler {
+ public:
+  const void *data() const override { return nullptr; }
+  size_t len() const override { return 0; }
+  std::string message_type() const override { return ""; }
+  std::string message_source() const override { return ""; }
+  std::string message_id() const override { return ""; }
+  std::string message_offset() const override { return ""; }
+  bool SendResponse(const void *, const size_t &) override { return true; }
+  bool SendResponse(const void *, const size_t &, const std::string &) override { return true; }
+};
+
+// Records the resumes of a request. A resumed request tries to park again, as a round kernel does if it's still not
+// ready, which fails once the request has timed out.
+class ParkedRequest {
+ public:
+  ParkedRequest() : message_(std::make_shared<FakeMessage>()) {}
+
+  bool Park(uint64_t generation) {
+    park_time_ = Clock::now();
+    return LongPollService::GetInstance().Park(
+      message_,
+      [this](const std::shared_ptr<MessageHandler> &) {
+        bool parked_again = LongPollService::GetInstance().Park(message_, [](const std::shared_ptr<MessageHandler> &) {},
+                                                                LongPollService::GetInstance().generation());
+        std::unique_lock<std::mutex> lock(mtx_);
+        resumed_ = true;
+        parked_again_ = parked_again;
+        resume_time_ = Clock::now();
+        cv_.notify_all();
+      },
+      generation);
+  }
+
+  // Returns the time from parking to the first resume, or a negative duration if it's not resumed in wait_ms.
+  std::chrono::milliseconds WaitResumed(uint64_t wait_ms) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!cv_.wait_for(lock, std::chrono::milliseconds(wait_ms), [this]() { return resumed_; })) {
+      return std::chrono::milliseconds(-1);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(resume_time_ - park_time_);
+  }
+
+  bool parked_again() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    return parked_again_;
+  }
+
+ private:
+  std::shared_ptr<FakeMessage> message_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool resumed_ = false;
+  bool parked_again_ = false;
+  Clock::time_point park_time_;
+  Clock::time_point resume_time_;
+};
+}  // namespace
+
+class TestLongPollService : public testing::Test {
+ protected:
+  void TearDown() override { LongPollService::GetInstance().Stop(); }
+};
+
+/// Feature: Long poll of the requests which are not ready.
+/// Description: Park a request and call Notify.
+/// Expectation: The request is resumed long before the timeout, and can be parked again as it has not timed out.
+TEST_F(TestLongPollService, NotifyResumesParked) {
+  auto &service = LongPollService::GetInstance();
+  service.Initialize(kLongTimeoutInMs);
+  ParkedRequest request;
+  ASSERT_TRUE(request.Park(service.generation()));
+  EXPECT_LT(request.WaitResumed(kShortTimeoutInMs).count(), 0);
+  service.Notify();
+  auto elapsed = request.WaitResumed(kLongTimeoutInMs);
+  EXPECT_GE(elapsed.count(), 0);
+  EXPECT_LT(elapsed.count(), static_cast<int64_t>(kLongTimeoutInMs / 2));
+  EXPECT_TRUE(request.parked_again());
+}
+
+/// Feature: Long poll of the requests which are not ready.
+/// Description: Call Notify after the request reads the generation and before it's parked, as the model may be stored
+/// between the readiness check of getModel and Park.
+/// Expectation: The request is resumed at once instead of waiting for the timeout.
+TEST_F(TestLongPollService, NotifyBeforePark) {
+  auto &service = LongPollService::GetInstance();
+  service.Initialize(kLongTimeoutInMs);
+  auto generation = service.generation();
+  service.Notify();
+  ParkedRequest request;
+  ASSERT_TRUE(request.Park(generation));
+  auto elapsed = request.WaitResumed(kLongTimeoutInMs);
+  EXPECT_GE(elapsed.count(), 0);
+  EXPECT_LT(elapsed.count(), static_cast<int64_t>(kLongTimeoutInMs / 2));
+}
+
+/// Feature: Long poll of the requests which are not ready.
+/// Description: Park a request without Notify.
+/// Expectation: The request is resumed after the timeout, and can't be parked again.
+TEST_F(TestLongPollService, Timeout) {
+  auto &service = LongPollService::GetInstance();
+  service.Initialize(kShortTimeoutInMs);
+  ParkedRequest request;
+  ASSERT_TRUE(request.Park(service.generation()));
+  auto elapsed = request.WaitResumed(kLongTimeoutInMs);
+  EXPECT_GE(elapsed.count(), static_cast<int64_t>(kShortTimeoutInMs));
+  EXPECT_FALSE(request.parked_again());
+}
+
+/// Feature: Long poll of the requests which are not ready.
+/// Description: Park a request after the service is stopped, and stop the service with a request parked.
+/// Expectation: The request isn't parked after stopping, and the parked request is resumed as timed out by Stop.
+TEST_F(TestLongPollService, Stop) {
+  auto &service = LongPollService::GetInstance();
+  service.Initialize(kLongTimeoutInMs);
+  ParkedRequest request;
+  ASSERT_TRUE(request.Park(service.generation()));
+  service.Stop();
+  EXPECT_GE(request.WaitResumed(kLongTimeoutInMs).count(), 0);
+  EXPECT_FALSE(request.parked_again());
+  ParkedRequest stopped_request;
+  EXPECT_FALSE(stopped_request.Park(service.generation()));
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include "gtest/gtest.h"
+#include "server/model_checkpoint.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+class TestModelCheckpoint : public testing::Test {
+ public:
+  void SetUp() override {
+    char dir_template[] = "/tmp/model_checkpoint_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    checkpoint_dir_ = dir_template;
+  }
+
+  void TearDown() override {
+    DIR *dir = opendir(checkpoint_dir_.c_str());
+    if (dir != nullptr) {
+      struct dirent *entry = nullptr;
+      while ((entry = readdir(dir)) != nullptr) {
+        (void)unlink((checkpoint_dir_ + "/" + entry->d_name).c_str());
+      }
+      (void)closedir(dir);
+    }
+    (void)rmdir(checkpoint_dir_.c_str());
+  }
+
+  static ModelItemPtr CreateModel(uint8_t value, size_t weight_size = 16) {
+    auto model = std::make_shared<ModelItem>();
+    size_t offset = 0;
+    for (const std::string &name : {"conv.weight", "fc.bias"}) {
+      auto &weight = model->weight_items[name];
+      weight.name = name;
+      weight.offset = offset;
+      weight.size = weight_size;
+      weight.shape = {weight_size / sizeof(float)};
+      weight.type = "float32";
+      offset += weight_size;
+    }
+    model->model_size = offset;
+    model->weight_data.assign(offset, value);
+    return model;
+  }
+
+  // Saves the models of the iterations with the writing thread stopped at the end, so that the files are written.
+  void Save(const std::vector<std::pair<size_t, ModelItemPtr>> &models) {
+    ModelCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+    for (const auto &model : models) {
+      checkpoint.SaveAsync(model.first, model.second);
+    }
+    checkpoint.Stop();
+  }
+
+  std::string CheckpointPath(size_t iteration) const {
+    return checkpoint_dir_ + "/model_store_test_" + std::to_string(iteration) + ".msmodel";
+  }
+
+  // Waits for the writing thread to write the checkpoint, so that the next saved model is not coalesced with it.
+  bool WaitForCheckpoint(size_t iteration) const {
+    constexpr int kMaxWaitMs = 5000;
+    constexpr int kWaitStepMs = 10;
+    for (int waited = 0; waited < kMaxWaitMs; waited += kWaitStepMs) {
+      if (access(CheckpointPath(iteration).c_str(), F_OK) == 0) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWaitStepMs));
+    }
+    return false;
+  }
+
+  std::string checkpoint_dir_;
+};
+
+/// Feature: Checkpoint of the model store.
+/// Description: Save the model of an iteration and load it into a model of the same weights.
+/// Expectation: The loaded weight data equals the saved one.
+TEST_F(TestModelCheckpoint, SaveAndLoad) {
+  Save({{3, CreateModel(3)}});
+  ModelCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+  auto model = CreateModel(0);
+  ASSERT_TRUE(checkpoint.Load(3, model));
+  EXPECT_EQ(model->weight_data, CreateModel(3)->weight_data);
+}
+
+/// Feature: Checkpoint of the model store.
+/// Description: Load the checkpoint of an iteration that is not the saved one, or into a model of other weights.
+/// Expectation: The loading fails and the model is not changed.
+TEST_F(TestModelCheckpoint, LoadMismatch) {
+  Save({{3, CreateModel(3)}});
+  ModelCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+  auto model = CreateModel(0);
+  EXPECT_FALSE(checkpoint.Load(4, model));
+  EXPECT_FALSE(checkpoint.Load(2, model));
+  EXPECT_EQ(model->weight_data, CreateModel(0)->weight_data);
+  auto other_model = CreateModel(0, 32);
+  EXPECT_FALSE(checkpoint.Load(3, other_model));
+  EXPECT_EQ(other_model->weight_data, CreateModel(0, 32)->weight_data);
+  // The checkpoints of another server sharing the directory are not loaded.
+  ModelCheckpoint other_checkpoint;
+  ASSERT_TRUE(other_checkpoint.Initialize(checkpoint_dir_, "model_store_other"));
+  EXPECT_FALSE(other_checkpoint.Load(3, model));
+}
+
+/// Feature: Checkpoint of the model store.
+/// Description: Save the models of several iterations, then the model of an earlier iteration after a reset.
+/// Expectation: Only the latest checkpoints are kept and those after the reset iteration are removed.
+TEST_F(TestModelCheckpoint, RemoveStaleCheckpoints) {
+  Save({{1, CreateModel(1)}});
+  Save({{2, CreateModel(2)}});
+  Save({{3, CreateModel(3)}});
+  ModelCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+  auto model = CreateModel(0);
+  EXPECT_FALSE(checkpoint.Load(1, model));
+  EXPECT_TRUE(checkpoint.Load(2, model));
+  EXPECT_TRUE(checkpoint.Load(3, model));
+  checkpoint.Stop();
+
+  Save({{1, CreateModel(1)}});
+  ModelCheckpoint reset_checkpoint;
+  ASSERT_TRUE(reset_checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+  EXPECT_TRUE(reset_checkpoint.Load(1, model));
+  EXPECT_EQ(model->weight_data, CreateModel(1)->weight_data);
+  EXPECT_FALSE(reset_checkpoint.Load(2, model));
+  EXPECT_FALSE(reset_checkpoint.Load(3, model));
+}
+
+/// Feature: Checkpoint of the model store.
+/// Description: Corrupt the weight data of a checkpoint file without changing its size, as an unsynced file may be
+/// after the machine crashes.
+/// Expectation: The loading fails and the model is not changed.
+TEST_F(TestModelCheckpoint, LoadCorruptedWeightData) {
+  Save({{3, CreateModel(3)}});
+  int fd = open(CheckpointPath(3).c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  auto file_size = lseek(fd, 0, SEEK_END);
+  const char zero = 0;
+  ASSERT_EQ(pwrite(fd, &zero, 1, file_size - 1), 1);
+  (void)close(fd);
+
+  ModelCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test"));
+  auto model = CreateModel(0);
+  EXPECT_FALSE(checkpoint.Load(3, model));
+  EXPECT_EQ(model->weight_data, CreateModel(0)->weight_data);
+}
+
+/// Feature: Checkpoint of the model store.
+/// Description: Save the models of several iterations with a sync interval of 3.
+/// Expectation: The latest synced checkpoint is kept besides the latest checkpoints.
+TEST_F(TestModelCheckpoint, KeepSyncedCheckpoint) {
+  constexpr uint64_t kSyncInterval = 3;
+  ModelCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Initialize(checkpoint_dir_, "model_store_test", kSyncInterval));
+  for (size_t iteration = 1; iteration <= 5; iteration++) {
+    checkpoint.SaveAsync(iteration, CreateModel(static_cast<uint8_t>(iteration)));
+    ASSERT_TRUE(WaitForCheckpoint(iteration));
+  }
+  checkpoint.Stop();
+  // The checkpoint of iteration 3 is the third written one, which is synced and kept besides the latest two.
+  for (size_t iteration : {3, 4, 5}) {
+    EXPECT_EQ(access(CheckpointPath(iteration).c_str(), F_OK), 0) << "iteration " << iteration;
+  }
+  for (size_t iteration : {1, 2}) {
+    EXPECT_NE(access(CheckpointPath(iteration).c_str(), F_OK), 0) << "iteration " << iteration;
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,197 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/collective_ops_impl.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+// The messages of the ranks in threads, keyed by the receiver and the position in the ring. The data is copied when it
+// is sent and the send is acknowledged at once, as the server node does.
+class FakeRing {
+ public:
+  void Send(const CollectiveMessageMeta &meta, const void *data, size_t size) {
+    auto msg = std::make_shared<std::vector<uint8_t>>(size);
+    std::copy_n(reinterpret_cast<const uint8_t *>(data), size, msg->data());
+    std::unique_lock<std::mutex> lock(mtx_);
+    messages_[Key(meta)] = msg;
+    cv_.notify_all();
+  }
+
+  bool Recv(const CollectiveMessageMeta &meta, size_t expect_size, VectorPtr *output) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto key = Key(meta);
+    if (!cv_.wait_for(lock, std::chrono::seconds(kCollectiveCommTimeout),
+                      [this, &key]() { return messages_.count(key) != 0; })) {
+      return false;
+    }
+    *output = messages_[key];
+    messages_.erase(key);
+    return (*output)->size() == expect_size;
+  }
+
+ private:
+  static std::string Key(const CollectiveMessageMeta &meta) {
+    return meta.send_node() + "->" + meta.recv_node() + "/" + meta.phase() + "/" + std::to_string(meta.chunk_index()) +
+           "/" + std::to_string(meta.for_index());
+  }
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::map<std::string, VectorPtr> messages_;
+};
+
+// The transport of a rank, which counts the sends not waited yet.
+class FakeRingTransport : public RingTransport {
+ public:
+  explicit FakeRingTransport(FakeRing *ring) : ring_(ring) {}
+  ~FakeRingTransport() override = default;
+
+  std::shared_ptr<ResponseTrack> SendAsync(const CollectiveMessageMeta &meta, const void *data, size_t size) override {
+    ring_->Send(meta, data, size);
+    inflight_sends_++;
+    max_inflight_sends_ = std::max(max_inflight_sends_, inflight_sends_);
+    return std::make_shared<ResponseTrack>(nullptr, ++request_id_, 1, nullptr);
+  }
+  bool RecvWait(const CollectiveMessageMeta &meta, size_t expect_size, VectorPtr *output) override {
+    return ring_->Recv(meta, expect_size, output);
+  }
+  bool Wait(const std::shared_ptr<ResponseTrack> &request_track) override {
+    if (request_track == nullptr || inflight_sends_ == 0) {
+      return false;
+    }
+    inflight_sends_--;
+    return true;
+  }
+
+  size_t inflight_sends() const { return inflight_sends_; }
+  size_t max_inflight_sends() const { return max_inflight_sends_; }
+
+ private:
+  FakeRing *ring_;
+  uint64_t request_id_ = 0;
+  size_t inflight_sends_ = 0;
+  size_t max_inflight_sends_ = 0;
+};
+
+std::string NodeId(size_t rank) { return "server_" + std::to_string(rank); }
+
+// Runs RingAllReduce on the data of each rank in threads, with the pipeline if sub_chunk_elem_num is positive.
+void RunRanks(std::vector<std::vector<float>> *rank_data, size_t sub_chunk_elem_num,
+              std::vector<size_t> *max_inflight_sends) {
+  size_t rank_size = rank_data->size();
+  size_t count = (*rank_data)[0].size();
+  std::vector<size_t> chunk_sizes(rank_size, count / rank_size);
+  for (size_t i = 0; i < count % rank_size; i++) {
+    chunk_sizes[i]++;
+  }
+  std::vector<size_t> chunk_offset(rank_size, 0);
+  std::partial_sum(chunk_sizes.begin(), chunk_sizes.end() - 1, chunk_offset.begin() + 1);
+
+  FakeRing ring;
+  std::vector<bool> results(rank_size, false);
+  max_inflight_sends->assign(rank_size, 0);
+  std::vector<std::thread> threads;
+  for (size_t rank = 0; rank < rank_size; rank++) {
+    threads.emplace_back([&, rank]() {
+      CollectiveMessageMeta send_meta;
+      send_meta.set_enable_flag(true);
+      send_meta.set_send_node(NodeId(rank));
+      send_meta.set_recv_node(NodeId((rank + 1) % rank_size));
+      send_meta.set_weight_name("weight");
+      CollectiveMessageMeta recv_meta = send_meta;
+      recv_meta.set_send_node(NodeId((rank - 1 + rank_size) % rank_size));
+      recv_meta.set_recv_node(NodeId(rank));
+      FakeRingTransport transport(&ring);
+      float *output_buff = (*rank_data)[rank].data();
+      if (sub_chunk_elem_num > 0) {
+        results[rank] = CollectiveOpsImpl::RunPipelinedRingAllReduce<float>(
+          &transport, rank, rank_size, send_meta, recv_meta, chunk_sizes, chunk_offset, sub_chunk_elem_num,
+          output_buff);
+      } else {
+        results[rank] = CollectiveOpsImpl::RunRingAllReduce<float>(&transport, rank, rank_size, send_meta, recv_meta,
+                                                                   chunk_sizes, chunk_offset, output_buff);
+      }
+      EXPECT_EQ(transport.inflight_sends(), 0);
+      (*max_inflight_sends)[rank] = transport.max_inflight_sends();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t rank = 0; rank < rank_size; rank++) {
+    EXPECT_TRUE(results[rank]) << "rank " << rank;
+  }
+}
+}  // namespace
+
+class TestRingAllReduce : public testing::Test {};
+
+/// Feature: Pipelined RingAllReduce of the server.
+/// Description: Reduce data of several sizes over 2 to 4 simulated ranks, with sub-chunks of 1, 3, 7 and 1000
+/// elements, and with the unpipelined RingAllReduce.
+/// Expectation: Every rank gets the same result as RunRingAllReduce, which equals the sum of the data, and at most
+/// kRingMaxInflightSends sends of a rank wait for their responses.
+TEST_F(TestRingAllReduce, PipelinedEqualsRing) {
+  for (size_t rank_size : {2, 3, 4}) {
+    for (size_t count : {4, 10, 97, 1000}) {
+      std::mt19937 rng(static_cast<unsigned int>(rank_size * 10000 + count));
+      std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+      std::vector<std::vector<float>> rank_data(rank_size, std::vector<float>(count));
+      std::vector<float> expected(count, 0.0f);
+      for (auto &data : rank_data) {
+        for (size_t i = 0; i < count; i++) {
+          data[i] = dist(rng);
+          expected[i] += data[i];
+        }
+      }
+      auto ring_data = rank_data;
+      std::vector<size_t> max_inflight_sends;
+      RunRanks(&ring_data, 0, &max_inflight_sends);
+      for (size_t rank = 0; rank < rank_size; rank++) {
+        for (size_t i = 0; i < count; i++) {
+          ASSERT_NEAR(ring_data[rank][i], expected[i], 1e-5f) << "rank " << rank << ", index " << i;
+        }
+      }
+      for (size_t sub_chunk_elem_num : {1, 3, 7, 1000}) {
+        auto pipelined_data = rank_data;
+        RunRanks(&pipelined_data, sub_chunk_elem_num, &max_inflight_sends);
+        for (size_t rank = 0; rank < rank_size; rank++) {
+          EXPECT_EQ(pipelined_data[rank], ring_data[rank])
+            << "rank size " << rank_size << ", count " << count << ", sub-chunk " << sub_chunk_elem_num;
+          EXPECT_LE(max_inflight_sends[rank], kRingMaxInflightSends);
+        }
+      }
+    }
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,163 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/executor.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr size_t kThreadNum = 8;
+constexpr size_t kUpdateNumPerThread = 50;
+constexpr size_t kCacheLineSize = 64;
+constexpr unsigned int kSeed = 2022;
+// The weights are small integers, so the float sums are exact in any order.
+constexpr int kMaxWeightValue = 8;
+constexpr size_t kMaxDataSize = 100;
+}  // namespace
+
+class TestShardedAggregation : public testing::Test {
+ public:
+  void SetUp() override {
+    // Sizes which are not multiples of the cache line or the shard size, including an empty parameter.
+    const std::map<std::string, size_t> param_sizes = {{"conv", 1000}, {"bias", 37}, {"empty", 0}, {"fc", 4099},
+                                                       {"scale", 1}};
+    for (const auto &item : param_sizes) {
+      // The weight data starts off the cache line, the cuts are still aligned to the cache line.
+      buffers_[item.first].assign(item.second + 1, 0.0f);
+      auto &info = param_aggregation_info_[item.first];
+      info.name = item.first;
+      info.weight_data = reinterpret_cast<uint8_t *>(buffers_[item.first].data() + 1);
+      info.weight_size = item.second * sizeof(float);
+      info.require_aggr = &require_aggr_;
+    }
+  }
+
+  // Each segment is checked to be in range, and the segments of each parameter cover it exactly once.
+  void CheckSegments(const Executor::AggregationShards &shards) {
+    std::map<std::string, std::vector<size_t>> covered;
+    std::map<std::string, size_t> first_segment_num;
+    for (const auto &shard : shards) {
+      for (const auto &segment : shard->segments) {
+        auto &info = *segment.info;
+        size_t elem_num = info.weight_size / sizeof(float);
+        ASSERT_LE(segment.elem_offset + segment.elem_num, elem_num) << info.name;
+        auto &counts = covered[info.name];
+        counts.resize(elem_num, 0);
+        for (size_t i = segment.elem_offset; i < segment.elem_offset + segment.elem_num; i++) {
+          counts[i]++;
+        }
+        if (segment.elem_offset == 0) {
+          first_segment_num[info.name]++;
+        }
+        size_t cut = segment.elem_offset + segment.elem_num;
+        if (cut < elem_num) {
+          auto cut_addr = reinterpret_cast<uintptr_t>(info.weight_data) + cut * sizeof(float);
+          EXPECT_EQ(cut_addr % kCacheLineSize, 0) << info.name << " is cut at " << cut;
+        }
+      }
+    }
+    for (const auto &item : param_aggregation_info_) {
+      // only the segment at offset 0 accumulates the data size
+      EXPECT_EQ(first_segment_num[item.first], 1) << item.first;
+      for (auto count : covered[item.first]) {
+        ASSERT_EQ(count, 1) << item.first;
+      }
+    }
+  }
+
+  std::map<std::string, std::vector<float>> buffers_;
+  std::map<std::string, ParamAggregationInfo> param_aggregation_info_;
+  bool require_aggr_ = true;
+};
+
+/// Feature: Sharded aggregation of the model updates.
+/// Description: Split the parameters into shards, and let threads accumulate updates concurrently with staggered start
+/// shards, for several shard numbers.
+/// Expectation: The segments cover each parameter once with cache line aligned cuts, and the aggregated weights and
+/// data sizes equal the serial sums of all the updates.
+TEST_F(TestShardedAggregation, ConcurrentUpdatesEqualSerialSum) {
+  for (size_t shard_num : {1, 2, 3, 7, 64}) {
+    for (auto &item : param_aggregation_info_) {
+      item.second.data_size = 0;
+      auto elem_num = item.second.weight_size / sizeof(float);
+      std::fill_n(reinterpret_cast<float *>(item.second.weight_data), elem_num, 0.0f);
+    }
+    auto shards = Executor::SplitAggregationShards(&param_aggregation_info_, shard_num);
+    EXPECT_EQ(shards.size(), shard_num);
+    CheckSegments(shards);
+
+    // the updates of each thread, and their serial sums
+    std::vector<std::vector<std::map<std::string, std::vector<float>>>> updates(kThreadNum);
+    std::vector<std::vector<size_t>> data_sizes(kThreadNum);
+    std::map<std::string, std::vector<float>> expected;
+    size_t expected_data_size = 0;
+    std::mt19937 rng(kSeed + shard_num);
+    std::uniform_int_distribution<int> weight_dist(-kMaxWeightValue, kMaxWeightValue);
+    for (size_t t = 0; t < kThreadNum; t++) {
+      for (size_t u = 0; u < kUpdateNumPerThread; u++) {
+        std::map<std::string, std::vector<float>> update;
+        for (const auto &item : param_aggregation_info_) {
+          auto elem_num = item.second.weight_size / sizeof(float);
+          auto &weights = update[item.first];
+          auto &sums = expected[item.first];
+          sums.resize(elem_num, 0.0f);
+          for (size_t i = 0; i < elem_num; i++) {
+            weights.push_back(static_cast<float>(weight_dist(rng)));
+            sums[i] += weights[i];
+          }
+        }
+        updates[t].push_back(std::move(update));
+        data_sizes[t].push_back(rng() % kMaxDataSize + 1);
+        expected_data_size += data_sizes[t].back();
+      }
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreadNum; t++) {
+      threads.emplace_back([&, t]() {
+        for (size_t u = 0; u < kUpdateNumPerThread; u++) {
+          std::map<std::string, Address> feature_map;
+          for (const auto &item : updates[t][u]) {
+            feature_map[item.first] = Address(item.second.data(), item.second.size() * sizeof(float));
+          }
+          Executor::UpdateAggregationShards(shards, feature_map, data_sizes[t][u], t * kUpdateNumPerThread + u);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    for (const auto &item : param_aggregation_info_) {
+      EXPECT_EQ(item.second.data_size, expected_data_size) << item.first << ", shard num " << shard_num;
+      auto weights = reinterpret_cast<const float *>(item.second.weight_data);
+      const auto &sums = expected[item.first];
+      for (size_t i = 0; i < sums.size(); i++) {
+        ASSERT_EQ(weights[i], sums[i]) << item.first << "[" << i << "], shard num " << shard_num;
+      }
+    }
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/kernel/vector_ops.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+namespace {
+constexpr size_t kMaxElemNum = 67;
+// Larger than the widest vector of 16 floats, so every start alignment is covered.
+constexpr size_t kMaxOffset = 17;
+constexpr size_t kBufferSize = kMaxOffset + kMaxElemNum + kMaxOffset;
+constexpr unsigned int kSeed = 2022;
+constexpr float kMultiplier = 3.7f;
+constexpr float kDivisor = 1.3f;
+}  // namespace
+
+class TestVectorOps : public testing::Test {
+ public:
+  void SetUp() override {
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    dst_.resize(kBufferSize);
+    src_.resize(kBufferSize);
+    for (size_t i = 0; i < kBufferSize; i++) {
+      dst_[i] = dist(rng);
+      src_[i] = dist(rng);
+    }
+    impls_ = AvailableVectorOpsImpls();
+    ASSERT_FALSE(impls_.empty());
+    scalar_ = impls_.back();
+    ASSERT_STREQ(scalar_.name, "scalar");
+  }
+
+  // Run op of the implementation and of the scalar one over [offset, offset + elem_num) of the same input. The results
+  // should be the same bits, and the elements out of the range should not be touched.
+  template <typename Op>
+  void CheckSameAsScalar(const VectorOpsImpl &impl, const Op &op) {
+    for (size_t offset = 0; offset <= kMaxOffset; offset++) {
+      for (size_t elem_num = 0; elem_num <= kMaxElemNum; elem_num++) {
+        std::vector<float> actual = dst_;
+        std::vector<float> expected = dst_;
+        op(impl, actual.data() + offset, src_.data() + offset, elem_num);
+        op(scalar_, expected.data() + offset, src_.data() + offset, elem_num);
+        for (size_t i = 0; i < kBufferSize; i++) {
+          ASSERT_EQ(actual[i], expected[i]) << impl.name << ", offset " << offset << ", elem_num " << elem_num;
+          if (i < offset || i >= offset + elem_num) {
+            ASSERT_EQ(actual[i], dst_[i]) << impl.name << ", offset " << offset << ", elem_num " << elem_num;
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<float> dst_;
+  std::vector<float> src_;
+  std::vector<VectorOpsImpl> impls_;
+  VectorOpsImpl scalar_ = {};
+};
+
+/// Feature: Vectorized element-wise operations of the aggregation kernels.
+/// Description: Run add, div and mul-div of every implementation supported by the cpu over lengths 0 to 67 and
+/// unaligned start offsets.
+/// Expectation: The results are the same as the scalar implementation, and the elements out of range are unchanged.
+TEST_F(TestVectorOps, SameAsScalar) {
+  for (const auto &impl : impls_) {
+    CheckSameAsScalar(impl, [](const VectorOpsImpl &ops, float *dst, const float *src, size_t elem_num) {
+      ops.add(dst, src, elem_num);
+    });
+    CheckSameAsScalar(impl, [](const VectorOpsImpl &ops, float *dst, const float *, size_t elem_num) {
+      ops.div(dst, kDivisor, elem_num);
+    });
+    CheckSameAsScalar(impl, [](const VectorOpsImpl &ops, float *dst, const float *, size_t elem_num) {
+      ops.mul_div(dst, kMultiplier, kDivisor, elem_num);
+    });
+  }
+}
+
+/// Feature: Vectorized element-wise operations of the aggregation kernels.
+/// Description: Check the implementation chosen at runtime.
+/// Expectation: It is the fastest one supported by the cpu.
+TEST_F(TestVectorOps, ChooseFastest) { EXPECT_STREQ(VectorOpsImplName(), impls_.front().name); }
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore